@@ -51,6 +51,9 @@
 /// maximum grow size for dynamic container classes (num elements)
 #define ORYOL_CONTAINER_DEFAULT_MAX_GROW (1<<16)
 
+/// size of the per-RunLoop frame allocator in bytes
+#define ORYOL_FRAME_ALLOCATOR_SIZE (1<<20)
+
 #ifndef __GNUC__
 #define __attribute__(x)
 #endif
@@ -0,0 +1,264 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::HashMap
+    @brief key-value map using open-addressing hashing
+
+    An unordered key-value container with O(1) lookup. Differences
+    to Map:
+
+    - elements are not sorted, iteration order is undefined
+    - keys are unique, inserting an existing key with Insert() will
+      trigger an assertion (use InsertUnique() if this is expected)
+    - inserting or erasing elements invalidates iterators and
+      pointers returned by Find()
+
+    HASHER is a functor which returns a uint32 hash for a key, KEY
+    must have an equality operator. Trying to access a non-existing
+    element with operator[] will trigger an assertion, use Find() to
+    look up elements which may not exist.
+
+    @see Map, HashSet, KeyValuePair
+*/
+#include "Core/Config.h"
+#include "Core/Containers/hashTable.h"
+#include "Core/Containers/KeyValuePair.h"
+
+namespace Oryol {
+namespace Core {
+
+template<class KEY, class VALUE, class HASHER> class HashMap {
+private:
+    struct keyOf {
+        const KEY& operator()(const KeyValuePair<KEY, VALUE>& kvp) const {
+            return kvp.key;
+        };
+    };
+    typedef hashTable<KeyValuePair<KEY, VALUE>, KEY, keyOf, HASHER> tableType;
+
+public:
+    /// iterator type
+    typedef hashTableIterator<tableType, KeyValuePair<KEY, VALUE>> Iterator;
+    /// read-only iterator type
+    typedef hashTableIterator<const tableType, const KeyValuePair<KEY, VALUE>> ConstIterator;
+
+    /// set allocation strategy (minGrow is the number of elements reserved on first insert)
+    void SetAllocStrategy(int32 minGrow, int32 maxGrow=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    /// get min grow value
+    int32 GetMinGrow() const;
+    /// get max grow value
+    int32 GetMaxGrow() const;
+    /// get number of elements
+    int32 Size() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get number of slots (elements + free slots)
+    int32 Capacity() const;
+
+    /// read/write access single element (must exist)
+    VALUE& operator[](const KEY& key);
+    /// read-only access single element (must exist)
+    const VALUE& operator[](const KEY& key) const;
+
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int32 numElements);
+    /// clear the map (deletes elements, keeps capacity)
+    void Clear();
+
+    /// test if an element exists
+    bool Contains(const KEY& key) const;
+    /// find value by key, return nullptr if not exists (r/w)
+    VALUE* Find(const KEY& key);
+    /// find value by key, return nullptr if not exists (r/o)
+    const VALUE* Find(const KEY& key) const;
+    /// insert new element (key must not exist)
+    void Insert(const KeyValuePair<KEY, VALUE>& kvp);
+    /// insert new element with move-semantics (key must not exist)
+    void Insert(KeyValuePair<KEY, VALUE>&& kvp);
+    /// insert new element (key must not exist)
+    void Insert(const KEY& key, const VALUE& value);
+    /// insert new element, return false if element with key already existed
+    bool InsertUnique(const KeyValuePair<KEY, VALUE>& kvp);
+    /// insert new element with move-semantics, return false if element with key already existed
+    bool InsertUnique(KeyValuePair<KEY, VALUE>&& kvp);
+    /// insert new element, return false if element with key already existed
+    bool InsertUnique(const KEY& key, const VALUE& value);
+    /// erase element matching key, does nothing if key not contained
+    void Erase(const KEY& key);
+
+    /// C++ begin
+    Iterator begin();
+    /// C++ begin
+    ConstIterator begin() const;
+    /// C++ end
+    Iterator end();
+    /// C++ end
+    ConstIterator end() const;
+
+private:
+    tableType table;
+};
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::SetAllocStrategy(int32 minGrow, int32 maxGrow) {
+    this->table.setAllocStrategy(minGrow, maxGrow);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::GetMinGrow() const {
+    return this->table.getMinGrow();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::GetMaxGrow() const {
+    return this->table.getMaxGrow();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::Size() const {
+    return this->table.size();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Empty() const {
+    return 0 == this->table.size();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> int32
+HashMap<KEY, VALUE, HASHER>::Capacity() const {
+    return this->table.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) {
+    const int32 index = this->table.find(key);
+    o_assert(InvalidIndex != index);
+    return this->table.slot(index).value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE&
+HashMap<KEY, VALUE, HASHER>::operator[](const KEY& key) const {
+    const int32 index = this->table.find(key);
+    o_assert(InvalidIndex != index);
+    return this->table.slot(index).value;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Reserve(int32 numElements) {
+    this->table.reserve(numElements);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Clear() {
+    this->table.clear();
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::Contains(const KEY& key) const {
+    return InvalidIndex != this->table.find(key);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) {
+    const int32 index = this->table.find(key);
+    return (InvalidIndex != index) ? &(this->table.slot(index).value) : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> const VALUE*
+HashMap<KEY, VALUE, HASHER>::Find(const KEY& key) const {
+    const int32 index = this->table.find(key);
+    return (InvalidIndex != index) ? &(this->table.slot(index).value) : nullptr;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Insert(const KeyValuePair<KEY, VALUE>& kvp) {
+    bool inserted = false;
+    this->table.insert(kvp, inserted);
+    o_assert(inserted);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Insert(KeyValuePair<KEY, VALUE>&& kvp) {
+    bool inserted = false;
+    this->table.insert(std::move(kvp), inserted);
+    o_assert(inserted);
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Insert(const KEY& key, const VALUE& value) {
+    this->Insert(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::InsertUnique(const KeyValuePair<KEY, VALUE>& kvp) {
+    bool inserted = false;
+    this->table.insert(kvp, inserted);
+    return inserted;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::InsertUnique(KeyValuePair<KEY, VALUE>&& kvp) {
+    bool inserted = false;
+    this->table.insert(std::move(kvp), inserted);
+    return inserted;
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> bool
+HashMap<KEY, VALUE, HASHER>::InsertUnique(const KEY& key, const VALUE& value) {
+    return this->InsertUnique(KeyValuePair<KEY, VALUE>(key, value));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> void
+HashMap<KEY, VALUE, HASHER>::Erase(const KEY& key) {
+    const int32 index = this->table.find(key);
+    if (InvalidIndex != index) {
+        this->table.eraseIndex(index);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> typename HashMap<KEY, VALUE, HASHER>::Iterator
+HashMap<KEY, VALUE, HASHER>::begin() {
+    return Iterator(&this->table, this->table.next(0));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> typename HashMap<KEY, VALUE, HASHER>::ConstIterator
+HashMap<KEY, VALUE, HASHER>::begin() const {
+    return ConstIterator(&this->table, this->table.next(0));
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> typename HashMap<KEY, VALUE, HASHER>::Iterator
+HashMap<KEY, VALUE, HASHER>::end() {
+    return Iterator(&this->table, this->table.capacity());
+}
+
+//------------------------------------------------------------------------------
+template<class KEY, class VALUE, class HASHER> typename HashMap<KEY, VALUE, HASHER>::ConstIterator
+HashMap<KEY, VALUE, HASHER>::end() const {
+    return ConstIterator(&this->table, this->table.capacity());
+}
+
+} // namespace Core
+} // namespace Oryol
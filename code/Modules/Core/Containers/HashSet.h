@@ -4,19 +4,34 @@
     @class Oryol::Core::HashSet
     @brief a Set using hashing for fast access
     
-    Implements a hash set with a fixed number of buckets, each
-    bucket is a binary-sorted set.
+    Implements an unordered set with open-addressing hashing
+    (see hashTable.h for details). HASHER is a functor which returns
+    a uint32 hash for a value, VALUETYPE must have an equality operator.
+    NUMBUCKETS is a capacity hint: room for at least NUMBUCKETS 
+    values is reserved on first insertion. Inserting or erasing
+    values invalidates iterators and pointers returned by Find().
     
-    @see Array, ArrayMap, Map, Set
+    @see Array, ArrayMap, HashMap, Map, Set
 */
 #include "Core/Config.h"
-#include "Core/Containers/Set.h"
+#include "Core/Containers/hashTable.h"
 
 namespace Oryol {
 namespace Core {
 
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> class HashSet {
+private:
+    struct keyOf {
+        const VALUETYPE& operator()(const VALUETYPE& val) const {
+            return val;
+        };
+    };
+    typedef hashTable<VALUETYPE, VALUETYPE, keyOf, HASHER> tableType;
+
 public:
+    /// read-only iterator type
+    typedef hashTableIterator<const tableType, const VALUETYPE> ConstIterator;
+
     /// default constructor
     HashSet();
     /// copy constructor
@@ -28,7 +43,7 @@ public:
     /// move-assignment operator (same capacity and size)
     void operator=(HashSet&& rhs);
     
-    /// set allocation strategy
+    /// set allocation strategy (minGrow is the number of elements reserved on first insert)
     void SetAllocStrategy(int32 minGrow, int32 maxGrow=ORYOL_CONTAINER_DEFAULT_MAX_GROW);
     /// get min grow value
     int32 GetMinGrow() const;
@@ -38,148 +53,156 @@ public:
     int32 Size() const;
     /// return true if empty
     bool Empty() const;
+    /// get number of slots (elements + free slots)
+    int32 Capacity() const;
+    /// increase capacity to hold at least numElements more elements
+    void Reserve(int32 numElements);
+    /// clear the set (deletes elements, keeps capacity)
+    void Clear();
     
     /// test if an element exists
     bool Contains(const VALUETYPE& val) const;
     /// find element
     const VALUETYPE* Find(const VALUETYPE& val) const;
-    /// insert element
+    /// insert element (must not exist)
     void Insert(const VALUETYPE& val);
-    /// erase element
+    /// erase element, does nothing if element doesn't exist
     void Erase(const VALUETYPE& val);
+
+    /// C++ begin
+    ConstIterator begin() const;
+    /// C++ end
+    ConstIterator end() const;
     
 private:
-    /// get the bucket for a value
-    const Set<VALUETYPE>& findBucket(const VALUETYPE& val) const;
-    /// get the bucket for a value
-    Set<VALUETYPE>& findBucket(const VALUETYPE& val);
-
-    int32 size;
-    Set<VALUETYPE> buckets[NUMBUCKETS];
+    tableType table;
 };
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS>
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet() :
-size(0) {
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet() {
     // empty
 };
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS>
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(const HashSet& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = rhs.buckets[i];
-    };
+table(rhs.table) {
+    // empty
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS>
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::HashSet(HashSet&& rhs) :
-size(rhs.size) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i] = std::move(rhs.buckets[i]);
-    }
-    rhs.size = 0;
+table(std::move(rhs.table)) {
+    // empty
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(const HashSet& rhs) {
-    if (&rhs != this) {
-        this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = rhs.buckets[i];
-        }
-    }
+    this->table = rhs.table;
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::operator=(HashSet&& rhs) {
-    if (&rhs != this) {
-        this->size = rhs.size;
-        for (int i = 0; i < NUMBUCKETS; i++) {
-            this->buckets[i] = std::move(rhs.buckets[i]);
-        }
-        rhs.size = 0;
-    }
+    this->table = std::move(rhs.table);
 }
     
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::SetAllocStrategy(int32 minGrow, int32 maxGrow) {
-    for (int i = 0; i < NUMBUCKETS; i++) {
-        this->buckets[i].SetAllocStrategy(minGrow, maxGrow);
-    }
+    this->table.setAllocStrategy(minGrow, maxGrow);
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> int32
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMinGrow() const {
-    return this->buckets[0].GetMinGrow();
+    return this->table.getMinGrow();
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> int32
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::GetMaxGrow() const {
-    return this->buckets[0].GetMaxGrow();
+    return this->table.getMaxGrow();
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> int32
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Size() const {
-    return this->size;
+    return this->table.size();
 }
 
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> bool
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Empty() const {
-    return (0 == this->size);
+    return (0 == this->table.size());
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> int32
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Capacity() const {
+    return this->table.capacity();
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Reserve(int32 numElements) {
+    this->table.reserve(numElements);
+}
+
+//------------------------------------------------------------------------------
+template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> void
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Clear() {
+    this->table.clear();
 }
     
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> bool
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Contains(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Contains(val);
+    return InvalidIndex != this->table.find(val);
 }
     
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> const VALUETYPE*
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Find(const VALUETYPE& val) const {
-    const auto& bucket = this->findBucket(val);
-    return bucket.Find(val);
+    const int32 index = this->table.find(val);
+    return (InvalidIndex != index) ? &(this->table.slot(index)) : nullptr;
 }
     
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Insert(const VALUETYPE& val) {
-    this->size++;
-    auto& bucket = this->findBucket(val);
-    bucket.Insert(val);
+    if (0 == this->table.capacity()) {
+        this->table.reserve(NUMBUCKETS);
+    }
+    bool inserted = false;
+    this->table.insert(val, inserted);
+    if (!inserted) {
+        o_error("Trying to insert duplicate element!\n");
+    }
 }
     
 //------------------------------------------------------------------------------
 template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> void
 HashSet<VALUETYPE, HASHER, NUMBUCKETS>::Erase(const VALUETYPE& val) {
-    o_assert(this->size > 0);
-    this->size--;
-    auto& bucket = this->findBucket(val);
-    bucket.Erase(val);
+    const int32 index = this->table.find(val);
+    if (InvalidIndex != index) {
+        this->table.eraseIndex(index);
+    }
 };
-    
+
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> const Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) const {
-    return this->buckets[uint32(HASHER()(val)) % NUMBUCKETS];
+template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> typename HashSet<VALUETYPE, HASHER, NUMBUCKETS>::ConstIterator
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::begin() const {
+    return ConstIterator(&this->table, this->table.next(0));
 }
 
 //------------------------------------------------------------------------------
-template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> Set<VALUETYPE>&
-HashSet<VALUETYPE, HASHER, NUMBUCKETS>::findBucket(const VALUETYPE& val) {
-    return this->buckets[uint32(HASHER()(val)) % NUMBUCKETS];
+template<class VALUETYPE, class HASHER, int32 NUMBUCKETS> typename HashSet<VALUETYPE, HASHER, NUMBUCKETS>::ConstIterator
+HashSet<VALUETYPE, HASHER, NUMBUCKETS>::end() const {
+    return ConstIterator(&this->table, this->table.capacity());
 }
 
 } // namespace Core
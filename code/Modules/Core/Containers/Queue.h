@@ -42,6 +42,8 @@ public:
     int32 SpareDequeue() const;
     /// get number of free slots at enqueue-side
     int32 SpareEnqueue() const;
+    /// read-only access to element at index (0 is the next element to dequeue)
+    const TYPE& operator[](int32 index) const;
     
     /// increase capacity to hold at least numElements more elements
     void Reserve(int32 numElements);
@@ -242,6 +244,12 @@ Queue<TYPE>::SpareEnqueue() const {
     return this->buffer.backSpare();
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> const TYPE&
+Queue<TYPE>::operator[](int32 index) const {
+    return this->buffer[index];
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> void
 Queue<TYPE>::Reserve(int32 numElements) {
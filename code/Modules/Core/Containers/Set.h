@@ -49,6 +49,8 @@ public:
     void Insert(const VALUE& val);
     /// erase element
     void Erase(const VALUE& val);
+    /// remove all elements (keeps capacity)
+    void Clear();
     /// get value at index
     const VALUE& ValueAtIndex(int32 index);
     
@@ -182,6 +184,12 @@ Set<VALUE>::Erase(const VALUE& val) {
     }
 }
 
+//------------------------------------------------------------------------------
+template<class VALUE> void
+Set<VALUE>::Clear() {
+    this->valueArray.Clear();
+}
+
 //------------------------------------------------------------------------------
 template<class VALUE> const VALUE&
 Set<VALUE>::ValueAtIndex(int32 index) {
@@ -17,9 +17,16 @@
     
     '----' - empty memory slot (guaranteed to be destructed)
     'XXXX' - valid element (guaranteed to be constructed)
+
+    The buffer memory comes from the thread's allocator at the time
+    the elementBuffer was constructed (see Memory::SetThreadAllocator()),
+    or from the heap if no allocator was installed. This costs one
+    Allocator pointer per elementBuffer and a thread-local read on
+    construction.
 */
 #include <new>
 #include <utility>
+#include <type_traits>
 #include "Core/Types.h"
 #include "Core/Assert.h"
 #include "Core/Memory/Memory.h"
@@ -89,6 +96,8 @@ public:
     void pushBack(TYPE&& elm);
     /// emplace element at back (backSpare must be > 0!)
     template<class... ARGS> void emplaceBack(ARGS&&... args);
+    /// copy a range of elements to back (backSpare must be >= num!)
+    void pushBack(const TYPE* elms, int32 num);
     /// pop back element
     TYPE popBack();
 
@@ -130,6 +139,7 @@ public:
     TYPE* bufEnd;       // end of allocated buffer
     TYPE* elmStart;     // start of valid elements
     TYPE* elmEnd;       // end of valid elements (one-past-last)
+    Allocator* allocator;   // allocator for buffer memory (nullptr: heap)
 };
 
 //------------------------------------------------------------------------------
@@ -138,7 +148,8 @@ elementBuffer<TYPE>::elementBuffer() :
     bufStart(nullptr),
     bufEnd(nullptr),
     elmStart(nullptr),
-    elmEnd(nullptr)
+    elmEnd(nullptr),
+    allocator(Memory::ThreadAllocator())
 {
     // empty
 }
@@ -149,7 +160,8 @@ elementBuffer<TYPE>::elementBuffer(const elementBuffer& rhs) :
     bufStart(nullptr),
     bufEnd(nullptr),
     elmStart(nullptr),
-    elmEnd(nullptr)
+    elmEnd(nullptr),
+    allocator(Memory::ThreadAllocator())
 {
     this->alloc(rhs.size(), 0);
     copyConstruct(rhs.elmStart, this->elmStart, rhs.size());
@@ -162,7 +174,8 @@ elementBuffer<TYPE>::elementBuffer(elementBuffer&& rhs) :
     bufStart(rhs.bufStart),
     bufEnd(rhs.bufEnd),
     elmStart(rhs.elmStart),
-    elmEnd(rhs.elmEnd)
+    elmEnd(rhs.elmEnd),
+    allocator(rhs.allocator)
 {
     rhs.bufStart = nullptr;
     rhs.bufEnd = nullptr;
@@ -195,10 +208,12 @@ elementBuffer<TYPE>::operator=(const elementBuffer<TYPE>& rhs) {
 template<class TYPE> void
 elementBuffer<TYPE>::operator=(elementBuffer<TYPE>&& rhs) {
     if (&rhs != this) {
+        this->destroy();
         this->bufStart = rhs.bufStart;
         this->bufEnd   = rhs.bufEnd;
         this->elmStart = rhs.elmStart;
         this->elmEnd   = rhs.elmEnd;
+        this->allocator = rhs.allocator;
         rhs.bufStart = 0;
         rhs.bufEnd   = 0;
         rhs.elmStart = 0;
@@ -290,7 +305,7 @@ elementBuffer<TYPE>::alloc(int32 newCapacity, int32 newFrontSpare) {
 
     // allocate new buffer
     const int32 newBufSize = newCapacity * sizeof(TYPE);
-    TYPE* newBuffer = (TYPE*) Memory::Alloc(newBufSize);
+    TYPE* newBuffer = (TYPE*) Memory::Alloc(this->allocator, newBufSize);
     TYPE* newElmStart = newBuffer + newFrontSpare;
     
     // need to move any elements?
@@ -307,7 +322,7 @@ elementBuffer<TYPE>::alloc(int32 newCapacity, int32 newFrontSpare) {
     
     // need to free old buffer?
     if (nullptr != this->bufStart) {
-        Memory::Free(this->bufStart);
+        Memory::Free(this->allocator, this->bufStart);
     }
     
     // replace pointers
@@ -329,7 +344,7 @@ elementBuffer<TYPE>::destroy() {
     
     // free buffer
     if (nullptr != this->bufStart) {
-        Memory::Free(this->bufStart);
+        Memory::Free(this->allocator, this->bufStart);
     }
     
     // clear all pointers
@@ -407,6 +422,21 @@ elementBuffer<TYPE>::emplaceBack(ARGS&&... args) {
     new(this->elmEnd++) TYPE(std::forward<ARGS>(args)...);
 }
 
+//------------------------------------------------------------------------------
+template<class TYPE> void
+elementBuffer<TYPE>::pushBack(const TYPE* elms, int32 num) {
+    o_assert((nullptr != elms) && (num >= 0));
+    o_assert((nullptr != this->elmEnd) && ((this->elmEnd + num) <= this->bufEnd));
+    if (std::is_pod<TYPE>::value) {
+        // POD elements don't need to be constructed, copy them in one go
+        Memory::Copy(elms, this->elmEnd, num * sizeof(TYPE));
+    }
+    else {
+        copyConstruct(elms, this->elmEnd, num);
+    }
+    this->elmEnd += num;
+}
+
 //------------------------------------------------------------------------------
 template<class TYPE> void
 elementBuffer<TYPE>::pushFront(const TYPE& elm) {
@@ -509,6 +539,13 @@ elementBuffer<TYPE>::prepareInsert(int32 index, bool& outSlotConstructed) {
             outSlotConstructed = false;
             return this->elmEnd++;
         }
+        else if (0 == size) {
+            // empty, but all room is at the front (after erasing front elements)
+            this->elmStart = this->bufStart;
+            this->elmEnd = this->bufStart;
+            outSlotConstructed = false;
+            return this->elmEnd++;
+        }
         else if (this->elmStart > this->bufStart) {
             // make room by moving towards front (this should always be faster then reallocating)
             return this->moveInsertFront(index);
@@ -0,0 +1,596 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    Open-addressing hash table which is used as base for HashMap and
+    HashSet. The slots are organized in groups of 15, and each group
+    has 16 control bytes: one per slot (0 for an empty slot, or 7 bits
+    of the element's hash with the top bit set), followed by an
+    overflow byte. A lookup computes the home group from the hash and
+    compares all control bytes of a group at once (with SSE2 if
+    available), only slots with a matching control byte are compared
+    by key.
+
+    When an insertion finds a group full, it sets a bit (selected by
+    the hash) in the group's overflow byte and probes the next group.
+    A lookup only moves on to the next group if the overflow bit for its
+    hash is set, so erasing an element simply clears its control byte,
+    there are no tombstones. Overflow bytes are only cleared on rehash,
+    so under insert/erase churn they accumulate and missing-key lookups
+    get longer. To bound this, the table rehashes at the same size once
+    more new overflow bits have been set since the last rehash than
+    there are groups (each new bit costs an insert, so this amortizes).
+
+    KEYOF extracts the key from an element, HASHER computes a 32-bit
+    hash from a key (the table mixes the hash, so HASHER doesn't need
+    to spread the bits). The home group is selected by multiplying
+    the upper 32 bits of the mixed hash with the number of groups, so
+    the number of groups doesn't need to be a power of 2. The first
+    allocation has room for at least minGrow elements, after that
+    the table grows whenever the load factor would exceed 7/8, like
+    Array it grows by half its capacity, clamped to [minGrow, maxGrow].
+
+    Like elementBuffer, the memory comes from the thread's allocator
+    at the time the table was constructed (see Memory::SetThreadAllocator()).
+*/
+#include <new>
+#include <utility>
+#include "Core/Types.h"
+#include "Core/Config.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define ORYOL_HASHTABLE_SSE2 (1)
+#include <emmintrin.h>
+#else
+#define ORYOL_HASHTABLE_SSE2 (0)
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace Oryol {
+namespace Core {
+
+template<class TYPE, class KEY, class KEYOF, class HASHER> class hashTable {
+public:
+    /// number of element slots per group
+    static const int32 SlotsPerGroup = 15;
+    /// number of control bytes per group
+    static const int32 GroupSize = 16;
+
+    /// default constructor
+    hashTable();
+    /// copy constructor
+    hashTable(const hashTable& rhs);
+    /// move constructor
+    hashTable(hashTable&& rhs);
+    /// destructor
+    ~hashTable();
+
+    /// copy-assignment operator
+    void operator=(const hashTable& rhs);
+    /// move-assignment operator
+    void operator=(hashTable&& rhs);
+
+    /// set allocation strategy
+    void setAllocStrategy(int32 minGrow, int32 maxGrow);
+    /// get min grow value
+    int32 getMinGrow() const;
+    /// get max grow value
+    int32 getMaxGrow() const;
+    /// get number of elements
+    int32 size() const;
+    /// get number of slots
+    int32 capacity() const;
+    /// make room for at least numElements more elements without rehashing
+    void reserve(int32 numElements);
+    /// destroy all elements, keep capacity
+    void clear();
+
+    /// find slot index of element with key, or InvalidIndex
+    int32 find(const KEY& key) const;
+    /// insert element if key doesn't exist yet, return slot index
+    int32 insert(const TYPE& elm, bool& outInserted);
+    /// insert element with move-semantics if key doesn't exist yet, return slot index
+    int32 insert(TYPE&& elm, bool& outInserted);
+    /// erase element at slot index
+    void eraseIndex(int32 slotIndex);
+
+    /// access element at slot index (r/w)
+    TYPE& slot(int32 slotIndex);
+    /// access element at slot index (r/o)
+    const TYPE& slot(int32 slotIndex) const;
+    /// get the next occupied slot index at or after slotIndex (capacity() if none)
+    int32 next(int32 slotIndex) const;
+
+private:
+    /// mix the user hash into the probing hash
+    static uint64 mix(uint32 hash);
+    /// get index of lowest set bit
+    static int32 lowestBit(uint32 mask);
+    /// get a bit mask of the slots in a group whose control byte matches
+    uint32 match(int32 group, uint8 ctl) const;
+    /// get the home group of a hash
+    uint32 homeGroup(uint64 hash) const;
+    /// grow the table when the load factor is exceeded
+    void grow();
+    /// find slot index with precomputed hash
+    int32 findWithHash(const KEY& key, uint64 hash) const;
+    /// claim an empty slot for a hash, return slot index
+    int32 claim(uint64 hash);
+    /// generic insert
+    template<class T> int32 insertElement(T&& elm, bool& outInserted);
+    /// allocate a new table and move all elements over
+    void rehash(int32 newNumGroups);
+    /// destroy elements and free memory
+    void destroy();
+    /// copy elements from other table (this table must be empty)
+    void copy(const hashTable& rhs);
+    /// move from other table (this table must be empty)
+    void move(hashTable&& rhs);
+
+    Allocator* allocator;
+    uint8* ctrl;
+    TYPE* elms;
+    int32 numGroups;
+    int32 numElements;
+    int32 numOverflowBits;
+    int32 rehashOverflowBits;
+    int32 minGrow;
+    int32 maxGrow;
+};
+
+//------------------------------------------------------------------------------
+/*
+    iterator over the occupied slots of a hashTable
+*/
+template<class TABLE, class TYPE> class hashTableIterator {
+public:
+    /// constructor
+    hashTableIterator(TABLE* table_, int32 index_) : table(table_), index(index_) { };
+    /// dereference
+    TYPE& operator*() const {
+        return this->table->slot(this->index);
+    };
+    /// member access
+    TYPE* operator->() const {
+        return &this->table->slot(this->index);
+    };
+    /// advance to next occupied slot
+    hashTableIterator& operator++() {
+        this->index = this->table->next(this->index + 1);
+        return *this;
+    };
+    /// equality
+    bool operator==(const hashTableIterator& rhs) const {
+        return this->index == rhs.index;
+    };
+    /// inequality
+    bool operator!=(const hashTableIterator& rhs) const {
+        return this->index != rhs.index;
+    };
+private:
+    TABLE* table;
+    int32 index;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+hashTable<TYPE, KEY, KEYOF, HASHER>::hashTable() :
+allocator(Memory::ThreadAllocator()),
+ctrl(nullptr),
+elms(nullptr),
+numGroups(0),
+numElements(0),
+numOverflowBits(0),
+rehashOverflowBits(0),
+minGrow(ORYOL_CONTAINER_DEFAULT_MIN_GROW),
+maxGrow(ORYOL_CONTAINER_DEFAULT_MAX_GROW) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+hashTable<TYPE, KEY, KEYOF, HASHER>::hashTable(const hashTable& rhs) :
+allocator(Memory::ThreadAllocator()),
+ctrl(nullptr),
+elms(nullptr),
+numGroups(0),
+numElements(0),
+numOverflowBits(0),
+rehashOverflowBits(0),
+minGrow(rhs.minGrow),
+maxGrow(rhs.maxGrow) {
+    this->copy(rhs);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+hashTable<TYPE, KEY, KEYOF, HASHER>::hashTable(hashTable&& rhs) :
+allocator(nullptr),
+ctrl(nullptr),
+elms(nullptr),
+numGroups(0),
+numElements(0),
+numOverflowBits(0),
+rehashOverflowBits(0),
+minGrow(rhs.minGrow),
+maxGrow(rhs.maxGrow) {
+    this->move(std::move(rhs));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+hashTable<TYPE, KEY, KEYOF, HASHER>::~hashTable() {
+    this->destroy();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::operator=(const hashTable& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->minGrow = rhs.minGrow;
+        this->maxGrow = rhs.maxGrow;
+        this->copy(rhs);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::operator=(hashTable&& rhs) {
+    if (&rhs != this) {
+        this->destroy();
+        this->minGrow = rhs.minGrow;
+        this->maxGrow = rhs.maxGrow;
+        this->move(std::move(rhs));
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::setAllocStrategy(int32 minGrow_, int32 maxGrow_) {
+    this->minGrow = minGrow_;
+    this->maxGrow = maxGrow_;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::getMinGrow() const {
+    return this->minGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::getMaxGrow() const {
+    return this->maxGrow;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::size() const {
+    return this->numElements;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::capacity() const {
+    return this->numGroups * SlotsPerGroup;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::reserve(int32 num) {
+    int32 required = this->numElements + num;
+    if ((0 == this->numGroups) && (required < this->minGrow)) {
+        required = this->minGrow;
+    }
+    int32 newNumGroups = ((required * 8) / 7 + SlotsPerGroup) / SlotsPerGroup;
+    if (newNumGroups > this->numGroups) {
+        this->rehash(newNumGroups);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::grow() {
+    if (0 == this->numGroups) {
+        this->reserve(1);
+    }
+    else {
+        int32 growBy = this->capacity() >> 1;
+        if (growBy < this->minGrow) {
+            growBy = this->minGrow;
+        }
+        else if (growBy > this->maxGrow) {
+            growBy = this->maxGrow;
+        }
+        o_assert(growBy > 0);
+        this->rehash(this->numGroups + (growBy + SlotsPerGroup - 1) / SlotsPerGroup);
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::clear() {
+    if (this->numElements > 0) {
+        const int32 cap = this->capacity();
+        for (int32 i = this->next(0); i < cap; i = this->next(i + 1)) {
+            this->elms[i].~TYPE();
+        }
+        this->numElements = 0;
+    }
+    if (this->numGroups > 0) {
+        Memory::Clear(this->ctrl, this->numGroups * GroupSize);
+    }
+    this->numOverflowBits = 0;
+    this->rehashOverflowBits = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> uint64
+hashTable<TYPE, KEY, KEYOF, HASHER>::mix(uint32 hash) {
+    // Fibonacci hashing, the upper 32 bits select the group,
+    // bits 22..31 provide the control byte and overflow bit
+    return uint64(hash) * 0x9E3779B97F4A7C15ULL;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> uint32
+hashTable<TYPE, KEY, KEYOF, HASHER>::homeGroup(uint64 hash) const {
+    // map the upper 32 bits into [0, numGroups) without a division
+    return uint32(((hash >> 32) * uint64(this->numGroups)) >> 32);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::lowestBit(uint32 mask) {
+    o_assert_dbg(0 != mask);
+    #if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return int32(index);
+    #else
+    return __builtin_ctz(mask);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> uint32
+hashTable<TYPE, KEY, KEYOF, HASHER>::match(int32 group, uint8 ctl) const {
+    const uint8* groupCtrl = this->ctrl + group * GroupSize;
+    #if ORYOL_HASHTABLE_SSE2
+    const __m128i bytes = _mm_loadu_si128((const __m128i*) groupCtrl);
+    const __m128i cmp = _mm_cmpeq_epi8(bytes, _mm_set1_epi8((char) ctl));
+    return uint32(_mm_movemask_epi8(cmp)) & 0x7FFF;
+    #else
+    uint32 mask = 0;
+    for (int32 i = 0; i < SlotsPerGroup; i++) {
+        if (groupCtrl[i] == ctl) {
+            mask |= (1 << i);
+        }
+    }
+    return mask;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::findWithHash(const KEY& key, uint64 hash) const {
+    const uint8 ctl = uint8(hash >> 25) | 0x80;
+    const uint8 overflowBit = uint8(1 << ((hash >> 22) & 7));
+    uint32 group = this->homeGroup(hash);
+    for (uint32 i = 1; ; i++) {
+        uint32 mask = this->match(group, ctl);
+        while (0 != mask) {
+            const int32 slotIndex = group * SlotsPerGroup + lowestBit(mask);
+            if (KEYOF()(this->elms[slotIndex]) == key) {
+                return slotIndex;
+            }
+            mask &= mask - 1;
+        }
+        if ((0 == (this->ctrl[group * GroupSize + SlotsPerGroup] & overflowBit)) || (i >= uint32(this->numGroups))) {
+            return InvalidIndex;
+        }
+        if (++group == uint32(this->numGroups)) {
+            group = 0;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::find(const KEY& key) const {
+    if (0 == this->numElements) {
+        return InvalidIndex;
+    }
+    return this->findWithHash(key, mix(uint32(HASHER()(key))));
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::claim(uint64 hash) {
+    const uint8 ctl = uint8(hash >> 25) | 0x80;
+    const uint8 overflowBit = uint8(1 << ((hash >> 22) & 7));
+    uint32 group = this->homeGroup(hash);
+    for (;;) {
+        const uint32 mask = this->match(group, 0);
+        if (0 != mask) {
+            const int32 pos = lowestBit(mask);
+            this->ctrl[group * GroupSize + pos] = ctl;
+            return group * SlotsPerGroup + pos;
+        }
+        uint8& overflow = this->ctrl[group * GroupSize + SlotsPerGroup];
+        if (0 == (overflow & overflowBit)) {
+            overflow |= overflowBit;
+            this->numOverflowBits++;
+        }
+        if (++group == uint32(this->numGroups)) {
+            group = 0;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER>
+template<class T> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::insertElement(T&& elm, bool& outInserted) {
+    const uint64 hash = mix(uint32(HASHER()(KEYOF()(elm))));
+    if (this->numElements > 0) {
+        const int32 slotIndex = this->findWithHash(KEYOF()(elm), hash);
+        if (InvalidIndex != slotIndex) {
+            outInserted = false;
+            return slotIndex;
+        }
+    }
+    if (this->numElements >= ((this->capacity() * 7) / 8)) {
+        this->grow();
+    }
+    else if ((this->numOverflowBits - this->rehashOverflowBits) > this->numGroups) {
+        // erased elements left too many overflow bits behind
+        this->rehash(this->numGroups);
+    }
+    const int32 slotIndex = this->claim(hash);
+    new(&this->elms[slotIndex]) TYPE(std::forward<T>(elm));
+    this->numElements++;
+    outInserted = true;
+    return slotIndex;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::insert(const TYPE& elm, bool& outInserted) {
+    return this->insertElement(elm, outInserted);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::insert(TYPE&& elm, bool& outInserted) {
+    return this->insertElement(std::move(elm), outInserted);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::eraseIndex(int32 slotIndex) {
+    o_assert_dbg((slotIndex >= 0) && (slotIndex < this->capacity()));
+    uint8& ctl = this->ctrl[(slotIndex / SlotsPerGroup) * GroupSize + (slotIndex % SlotsPerGroup)];
+    o_assert_dbg(0 != ctl);
+    this->elms[slotIndex].~TYPE();
+    ctl = 0;
+    this->numElements--;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> TYPE&
+hashTable<TYPE, KEY, KEYOF, HASHER>::slot(int32 slotIndex) {
+    o_assert_dbg((slotIndex >= 0) && (slotIndex < this->capacity()));
+    return this->elms[slotIndex];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> const TYPE&
+hashTable<TYPE, KEY, KEYOF, HASHER>::slot(int32 slotIndex) const {
+    o_assert_dbg((slotIndex >= 0) && (slotIndex < this->capacity()));
+    return this->elms[slotIndex];
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> int32
+hashTable<TYPE, KEY, KEYOF, HASHER>::next(int32 slotIndex) const {
+    const int32 cap = this->capacity();
+    for (; slotIndex < cap; slotIndex++) {
+        if (0 != this->ctrl[(slotIndex / SlotsPerGroup) * GroupSize + (slotIndex % SlotsPerGroup)]) {
+            return slotIndex;
+        }
+    }
+    return cap;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::rehash(int32 newNumGroups) {
+    o_assert(newNumGroups > 0);
+
+    uint8* oldCtrl = this->ctrl;
+    TYPE* oldElms = this->elms;
+    const int32 oldCapacity = this->capacity();
+
+    // control bytes and elements live in the same allocation
+    const int32 ctrlSize = newNumGroups * GroupSize;
+    const int32 allocSize = ctrlSize + newNumGroups * SlotsPerGroup * int32(sizeof(TYPE));
+    this->ctrl = (uint8*) Memory::Alloc(this->allocator, allocSize);
+    this->elms = (TYPE*) (this->ctrl + ctrlSize);
+    this->numGroups = newNumGroups;
+    this->numOverflowBits = 0;
+    Memory::Clear(this->ctrl, ctrlSize);
+
+    if (nullptr != oldCtrl) {
+        if (this->numElements > 0) {
+            for (int32 i = 0; i < oldCapacity; i++) {
+                if (0 != oldCtrl[(i / SlotsPerGroup) * GroupSize + (i % SlotsPerGroup)]) {
+                    const uint64 hash = mix(uint32(HASHER()(KEYOF()(oldElms[i]))));
+                    const int32 slotIndex = this->claim(hash);
+                    new(&this->elms[slotIndex]) TYPE(std::move(oldElms[i]));
+                    oldElms[i].~TYPE();
+                }
+            }
+        }
+        Memory::Free(this->allocator, oldCtrl);
+    }
+    this->rehashOverflowBits = this->numOverflowBits;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::destroy() {
+    this->clear();
+    if (nullptr != this->ctrl) {
+        Memory::Free(this->allocator, this->ctrl);
+        this->ctrl = nullptr;
+        this->elms = nullptr;
+    }
+    this->numGroups = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::copy(const hashTable& rhs) {
+    o_assert((nullptr == this->ctrl) && (0 == this->numElements));
+    if (rhs.numElements > 0) {
+        // same layout, so elements can be copied slot by slot
+        this->rehash(rhs.numGroups);
+        Memory::Copy(rhs.ctrl, this->ctrl, rhs.numGroups * GroupSize);
+        const int32 cap = rhs.capacity();
+        for (int32 i = rhs.next(0); i < cap; i = rhs.next(i + 1)) {
+            new(&this->elms[i]) TYPE(rhs.elms[i]);
+        }
+        this->numElements = rhs.numElements;
+        this->numOverflowBits = rhs.numOverflowBits;
+        this->rehashOverflowBits = rhs.rehashOverflowBits;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE, class KEY, class KEYOF, class HASHER> void
+hashTable<TYPE, KEY, KEYOF, HASHER>::move(hashTable&& rhs) {
+    o_assert((nullptr == this->ctrl) && (0 == this->numElements));
+    this->allocator = rhs.allocator;
+    this->ctrl = rhs.ctrl;
+    this->elms = rhs.elms;
+    this->numGroups = rhs.numGroups;
+    this->numElements = rhs.numElements;
+    this->numOverflowBits = rhs.numOverflowBits;
+    this->rehashOverflowBits = rhs.rehashOverflowBits;
+    rhs.ctrl = nullptr;
+    rhs.elms = nullptr;
+    rhs.numGroups = 0;
+    rhs.numElements = 0;
+    rhs.numOverflowBits = 0;
+    rhs.rehashOverflowBits = 0;
+}
+
+} // namespace Core
+} // namespace Oryol
@@ -4,6 +4,7 @@
 #include "Pre.h"
 #include "CoreFacade.h"
 #include "Core/Ptr.h"
+#include "Core/Memory/poolMagazine.h"
 
 namespace Oryol {
 namespace Core {
@@ -16,10 +17,13 @@ ORYOL_THREAD_LOCAL RunLoop* CoreFacade::threadRunLoop = 0;
 CoreFacade::CoreFacade() {
     this->SingletonEnsureUnique();
     this->mainThreadId = std::this_thread::get_id();
-    stringAtomTable::CreateSingle();
     auto ptr = RunLoop::Create();
     ptr->addRef();
     threadRunLoop = ptr.get();
+
+    // release idle pool allocator puddles once per frame, this is
+    // kept out of the pool allocators' Create()/Destroy()
+    threadRunLoop->Add(Core::RunLoop::Callback("Core::ReleaseIdlePuddles", 100, std::function<void()>(&poolMagazine::ReleaseIdlePuddles)));
 }
 
 //------------------------------------------------------------------------------
@@ -28,9 +32,6 @@ CoreFacade::~CoreFacade() {
     o_assert(nullptr != threadRunLoop);
     threadRunLoop->release();
     threadRunLoop = 0;
-
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data!!!    
 }
 
 //------------------------------------------------------------------------------
@@ -56,9 +57,6 @@ CoreFacade::EnterThread() {
     #if ORYOL_HAS_THREADS
     o_assert(nullptr == threadRunLoop);
     
-    // create thread-local string atom table
-    stringAtomTable::CreateSingle();
-    
     // create thread-local run loop
     auto ptr = RunLoop::Create();
     ptr->addRef();
@@ -73,8 +71,8 @@ CoreFacade::LeaveThread() {
     o_assert(nullptr != threadRunLoop);
     threadRunLoop->release();
 
-    // do NOT destroy the thread-local string atom table to
-    // ensure that string atom data pointers still point to valid data
+    // return nodes cached in this thread's pool allocator magazines
+    poolMagazine::ReleaseThreadMagazines();
     #endif
 }
 
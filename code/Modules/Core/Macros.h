@@ -25,6 +25,32 @@ public:\
 #define OryolClassPoolAllocImpl(TYPE) \
 Oryol::Core::poolAllocator<TYPE> TYPE::allocator;
 
+/// implementation-side macro for Oryol class with pool allocator and custom puddle size (located in .cc source file)
+#define OryolClassPoolAllocImplWithPuddleSize(TYPE, PUDDLESIZE) \
+Oryol::Core::poolAllocator<TYPE> TYPE::allocator(PUDDLESIZE);
+
+/// declare an Oryol class with pool allocator and object recycling, TYPE must have a Reset() method (located inside class declaration)
+#define OryolClassRecycleDecl(TYPE) \
+private:\
+    static Oryol::Core::poolAllocator<TYPE> allocator;\
+    static Oryol::Core::objectRecycler<TYPE> recycler;\
+protected:\
+    virtual void destroy() {\
+        TYPE::recycler.Destroy(this);\
+    };\
+public:\
+    static Core::Ptr<TYPE> Create() {\
+        return Core::Ptr<TYPE>(TYPE::recycler.Create());\
+    };\
+    static int32 NumRecycled() {\
+        return TYPE::recycler.NumReused();\
+    };\
+
+/// implementation-side macro for Oryol class with object recycling (located in .cc source file)
+#define OryolClassRecycleImpl(TYPE) \
+Oryol::Core::poolAllocator<TYPE> TYPE::allocator;\
+Oryol::Core::objectRecycler<TYPE> TYPE::recycler(TYPE::allocator);
+
 /// implementation-side macro for template classes with pool allocator (located in .cc source file)
 #define OryolTemplClassPoolAllocImpl(TEMPLATE_TYPE, CLASS_TYPE) \
 template<class TEMPLATE_TYPE> Oryol::Core::poolAllocator<CLASS_TYPE<TEMPLATE_TYPE>> CLASS_TYPE<TEMPLATE_TYPE>::allocator;
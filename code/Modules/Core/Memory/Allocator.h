@@ -0,0 +1,36 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::Allocator
+    @brief abstract memory allocator interface
+
+    Allocators can be installed per thread with Memory::SetThreadAllocator(),
+    or handed directly to a subsystem (e.g. MemoryStream::SetAllocator()).
+    Objects which allocate memory through an allocator remember it and
+    return their memory to the same allocator. A nullptr allocator
+    always means the global heap (Memory::Alloc / Memory::Free).
+
+    All allocations must be aligned to ORYOL_MAX_PLATFORM_ALIGN.
+
+    @see LinearAllocator, ArenaAllocator, TrackingAllocator
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace Core {
+
+class Allocator {
+public:
+    /// destructor
+    virtual ~Allocator() { };
+
+    /// allocate a chunk of memory
+    virtual void* Alloc(int32 numBytes) = 0;
+    /// re-allocate a chunk of memory (ptr may be nullptr)
+    virtual void* ReAlloc(void* ptr, int32 numBytes) = 0;
+    /// free a chunk of memory (ptr may be nullptr)
+    virtual void Free(void* ptr) = 0;
+};
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,128 @@
+//------------------------------------------------------------------------------
+//  ArenaAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ArenaAllocator.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assert.h"
+
+namespace Oryol {
+namespace Core {
+
+//------------------------------------------------------------------------------
+ArenaAllocator::ArenaAllocator() :
+pages(nullptr),
+numPages(0) {
+    Memory::Clear(this->freeLists, sizeof(this->freeLists));
+}
+
+//------------------------------------------------------------------------------
+ArenaAllocator::~ArenaAllocator() {
+    while (nullptr != this->pages) {
+        uint8* next = *(uint8**)this->pages;
+        Memory::Free(this->pages);
+        this->pages = next;
+    }
+    this->numPages = 0;
+}
+
+//------------------------------------------------------------------------------
+int32
+ArenaAllocator::sizeClass(int32 numBytes) {
+    int32 cls = 0;
+    while ((1 << (cls + MinSizeClassShift)) < numBytes) {
+        cls++;
+    }
+    return cls;
+}
+
+//------------------------------------------------------------------------------
+void
+ArenaAllocator::allocPage(int32 cls) {
+    o_assert_range(cls, NumSizeClasses);
+    uint8* page = (uint8*) Memory::Alloc(PageSize);
+    *(uint8**)page = this->pages;
+    this->pages = page;
+    this->numPages++;
+
+    // the first block is skipped to keep room for the page link
+    const int32 blockSize = sizeof(header) + (1 << (cls + MinSizeClassShift));
+    for (uint8* ptr = page + sizeof(header); (ptr + blockSize) <= (page + PageSize); ptr += blockSize) {
+        header* hdr = (header*) ptr;
+        hdr->sizeClass = cls;
+        freeBlock* block = (freeBlock*) (hdr + 1);
+        block->next = this->freeLists[cls];
+        this->freeLists[cls] = block;
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+ArenaAllocator::Alloc(int32 numBytes) {
+    o_assert(numBytes >= 0);
+    header* hdr = nullptr;
+    if (numBytes > MaxSmallSize) {
+        hdr = (header*) Memory::Alloc(sizeof(header) + numBytes);
+        hdr->sizeClass = InvalidIndex;
+    }
+    else {
+        const int32 cls = sizeClass(numBytes);
+        if (nullptr == this->freeLists[cls]) {
+            this->allocPage(cls);
+        }
+        freeBlock* block = this->freeLists[cls];
+        this->freeLists[cls] = block->next;
+        hdr = ((header*)block) - 1;
+        o_assert(hdr->sizeClass == cls);
+    }
+    hdr->size = numBytes;
+    return (void*) (hdr + 1);
+}
+
+//------------------------------------------------------------------------------
+void*
+ArenaAllocator::ReAlloc(void* ptr, int32 numBytes) {
+    if (nullptr == ptr) {
+        return this->Alloc(numBytes);
+    }
+    header* hdr = ((header*)ptr) - 1;
+    if ((InvalidIndex != hdr->sizeClass) && (numBytes <= MaxSmallSize) && (sizeClass(numBytes) == hdr->sizeClass)) {
+        // still fits into the same size class
+        hdr->size = numBytes;
+        return ptr;
+    }
+    void* newPtr = this->Alloc(numBytes);
+    Memory::Copy(ptr, newPtr, hdr->size < numBytes ? hdr->size : numBytes);
+    this->Free(ptr);
+    return newPtr;
+}
+
+//------------------------------------------------------------------------------
+void
+ArenaAllocator::Free(void* ptr) {
+    if (nullptr == ptr) {
+        return;
+    }
+    header* hdr = ((header*)ptr) - 1;
+    if (InvalidIndex == hdr->sizeClass) {
+        Memory::Free(hdr);
+    }
+    else {
+        o_assert_range_dbg(hdr->sizeClass, NumSizeClasses);
+        #if ORYOL_ALLOCATOR_DEBUG
+        Memory::Fill(ptr, 1 << (hdr->sizeClass + MinSizeClassShift), ORYOL_MEMORY_DEBUG_BYTE);
+        #endif
+        freeBlock* block = (freeBlock*) ptr;
+        block->next = this->freeLists[hdr->sizeClass];
+        this->freeLists[hdr->sizeClass] = block;
+    }
+}
+
+//------------------------------------------------------------------------------
+int32
+ArenaAllocator::NumPages() const {
+    return this->numPages;
+}
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,68 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::ArenaAllocator
+    @brief size-class arena allocator for small allocations
+
+    Small allocations (up to MaxSmallSize bytes) are rounded up to
+    a power-of-2 size class, and are carved from pages of PageSize
+    bytes. Freed blocks go into a free-list per size class and are
+    re-used by the next allocation of the same class. Pages are only
+    returned to the heap when the arena is destroyed. Larger
+    allocations go to the heap.
+
+    NOTE: not thread-safe, install it per thread or per subsystem!
+*/
+#include "Core/Memory/Allocator.h"
+
+namespace Oryol {
+namespace Core {
+
+class ArenaAllocator : public Allocator {
+public:
+    /// number of bytes per page
+    static const int32 PageSize = 64 * 1024;
+    /// biggest allocation handled by the arena
+    static const int32 MaxSmallSize = 2048;
+
+    /// constructor
+    ArenaAllocator();
+    /// destructor
+    virtual ~ArenaAllocator();
+
+    /// allocate a chunk of memory
+    virtual void* Alloc(int32 numBytes) override;
+    /// re-allocate a chunk of memory
+    virtual void* ReAlloc(void* ptr, int32 numBytes) override;
+    /// free a chunk of memory
+    virtual void Free(void* ptr) override;
+
+    /// get number of pages allocated from the heap
+    int32 NumPages() const;
+
+private:
+    static const int32 MinSizeClassShift = 4;
+    static const int32 NumSizeClasses = 8;      // 16, 32, ... 2048 bytes
+
+    /// per-block header
+    struct header {
+        int32 sizeClass;    // InvalidIndex for heap allocations
+        int32 size;
+        int32 padding[2];
+    };
+    /// free-list link, lives in the payload of free blocks
+    struct freeBlock {
+        freeBlock* next;
+    };
+    /// get size-class index for a size
+    static int32 sizeClass(int32 numBytes);
+    /// allocate a new page and carve it into blocks of a size class
+    void allocPage(int32 sizeClass);
+
+    freeBlock* freeLists[NumSizeClasses];
+    uint8* pages;       // pages are linked through their first bytes
+    int32 numPages;
+};
+
+} // namespace Core
+} // namespace Oryol
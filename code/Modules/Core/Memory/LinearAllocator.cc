@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------------
+//  LinearAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "LinearAllocator.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assert.h"
+
+namespace Oryol {
+namespace Core {
+
+//------------------------------------------------------------------------------
+LinearAllocator::LinearAllocator(int32 capacity_) :
+capacity(capacity_),
+numOverflowAllocs(0),
+buffer(nullptr),
+cur(nullptr),
+last(nullptr) {
+    o_assert(capacity_ > 0);
+}
+
+//------------------------------------------------------------------------------
+LinearAllocator::~LinearAllocator() {
+    if (nullptr != this->buffer) {
+        Memory::Free(this->buffer);
+        this->buffer = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+LinearAllocator::owns(void* ptr) const {
+    return (ptr >= this->buffer) && (ptr < (this->buffer + this->capacity));
+}
+
+//------------------------------------------------------------------------------
+bool
+LinearAllocator::isLive(void* ptr) const {
+    #if ORYOL_HAS_THREADS
+    if (std::this_thread::get_id() != this->ownerThread) {
+        return false;
+    }
+    #endif
+    return ptr < this->cur;
+}
+
+//------------------------------------------------------------------------------
+void*
+LinearAllocator::Alloc(int32 numBytes) {
+    o_assert(numBytes >= 0);
+    if (nullptr == this->buffer) {
+        this->buffer = (uint8*) Memory::Alloc(this->capacity);
+        this->cur = this->buffer;
+        #if ORYOL_HAS_THREADS
+        this->ownerThread = std::this_thread::get_id();
+        #endif
+    }
+    #if ORYOL_HAS_THREADS
+    o_assert2_dbg(std::this_thread::get_id() == this->ownerThread, "LinearAllocator used from another thread!\n");
+    #endif
+    const int32 requiredSize = sizeof(header) + Memory::RoundUp(numBytes, sizeof(header));
+    if ((this->cur + requiredSize) > (this->buffer + this->capacity)) {
+        // buffer exhausted, fall through to the heap
+        this->numOverflowAllocs++;
+        return Memory::Alloc(numBytes);
+    }
+    header* hdr = (header*) this->cur;
+    hdr->size = numBytes;
+    this->last = this->cur;
+    this->cur += requiredSize;
+    return (void*) (hdr + 1);
+}
+
+//------------------------------------------------------------------------------
+void*
+LinearAllocator::ReAlloc(void* ptr, int32 numBytes) {
+    if (nullptr == ptr) {
+        return this->Alloc(numBytes);
+    }
+    if (!this->owns(ptr)) {
+        return Memory::ReAlloc(ptr, numBytes);
+    }
+    o_assert2_dbg(this->isLive(ptr), "LinearAllocator: ReAlloc() of stale or foreign pointer!\n");
+    header* hdr = ((header*)ptr) - 1;
+    if ((uint8*)hdr == this->last) {
+        // most recent allocation, try to grow in place
+        const int32 requiredSize = sizeof(header) + Memory::RoundUp(numBytes, sizeof(header));
+        if ((this->last + requiredSize) <= (this->buffer + this->capacity)) {
+            hdr->size = numBytes;
+            this->cur = this->last + requiredSize;
+            return ptr;
+        }
+    }
+    void* newPtr = this->Alloc(numBytes);
+    Memory::Copy(ptr, newPtr, hdr->size < numBytes ? hdr->size : numBytes);
+    this->Free(ptr);
+    return newPtr;
+}
+
+//------------------------------------------------------------------------------
+void
+LinearAllocator::Free(void* ptr) {
+    if (nullptr == ptr) {
+        return;
+    }
+    if (!this->owns(ptr)) {
+        Memory::Free(ptr);
+    }
+    else {
+        // no roll back, the pointer may be stale (from before Reset()),
+        // just make sure a freed allocation is never grown in place
+        o_assert2_dbg(this->isLive(ptr), "LinearAllocator: Free() of stale or foreign pointer!\n");
+        if ((uint8*)(((header*)ptr) - 1) == this->last) {
+            this->last = nullptr;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+LinearAllocator::Reset() {
+    #if ORYOL_ALLOCATOR_DEBUG
+    if (nullptr != this->buffer) {
+        Memory::Fill(this->buffer, int32(this->cur - this->buffer), ORYOL_MEMORY_DEBUG_BYTE);
+    }
+    #endif
+    this->cur = this->buffer;
+    this->last = nullptr;
+}
+
+//------------------------------------------------------------------------------
+int32
+LinearAllocator::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+int32
+LinearAllocator::Size() const {
+    return int32(this->cur - this->buffer);
+}
+
+//------------------------------------------------------------------------------
+int32
+LinearAllocator::NumOverflowAllocs() const {
+    return this->numOverflowAllocs;
+}
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,77 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::LinearAllocator
+    @brief bump allocator for short-lived (e.g. per-frame) allocations
+
+    Allocates from a fixed-size buffer by bumping a pointer, Free() is
+    a no-op for buffer memory (only ReAlloc() of the most recent allocation
+    grows in place). All allocations are invalidated by Reset(). Each
+    RunLoop owns a LinearAllocator which is reset at the end of
+    RunLoop::Run(), see RunLoop::FrameAllocator().
+
+    Free() never rolls back, a stale Free() of an allocation from before
+    Reset() could otherwise release a newer allocation at the same address.
+    Freeing (or re-allocating) buffer memory from before Reset() or from
+    another thread than the one which allocated from the buffer asserts
+    in debug mode.
+
+    The buffer is allocated on first use. When the buffer is exhausted,
+    allocations fall through to the heap (these must be freed as usual).
+
+    NOTE: not thread-safe, install it per thread!
+*/
+#include "Core/Memory/Allocator.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+namespace Oryol {
+namespace Core {
+
+class LinearAllocator : public Allocator {
+public:
+    /// constructor with buffer size in bytes
+    LinearAllocator(int32 capacity);
+    /// destructor
+    virtual ~LinearAllocator();
+
+    /// allocate a chunk of memory
+    virtual void* Alloc(int32 numBytes) override;
+    /// re-allocate a chunk of memory
+    virtual void* ReAlloc(void* ptr, int32 numBytes) override;
+    /// free a chunk of memory
+    virtual void Free(void* ptr) override;
+
+    /// invalidate all allocations from the buffer
+    void Reset();
+    /// get buffer size in bytes
+    int32 Capacity() const;
+    /// get number of bytes currently allocated from the buffer
+    int32 Size() const;
+    /// get number of allocations which didn't fit into the buffer
+    int32 NumOverflowAllocs() const;
+
+private:
+    /// per-allocation header
+    struct header {
+        int32 size;
+        int32 padding[3];
+    };
+    /// test if a pointer is inside the buffer
+    bool owns(void* ptr) const;
+    /// test if a buffer pointer is live (allocated since the last Reset() by the owner thread)
+    bool isLive(void* ptr) const;
+
+    int32 capacity;
+    int32 numOverflowAllocs;
+    uint8* buffer;
+    uint8* cur;
+    uint8* last;
+    #if ORYOL_HAS_THREADS
+    std::thread::id ownerThread;
+    #endif
+};
+
+} // namespace Core
+} // namespace Oryol
@@ -5,9 +5,12 @@
 #include <cstdlib>
 #include <cstring>
 #include "Memory.h"
+#include "Allocator.h"
 
 namespace Oryol {
 namespace Core {
+
+ORYOL_THREAD_LOCAL Allocator* Memory::threadAllocator = nullptr;
     
 //------------------------------------------------------------------------------
 void*
@@ -38,6 +41,47 @@ Memory::Free(void* p) {
     std::free(p);
 }
 
+//------------------------------------------------------------------------------
+Allocator*
+Memory::SetThreadAllocator(Allocator* allocator) {
+    Allocator* prev = threadAllocator;
+    threadAllocator = allocator;
+    return prev;
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::Alloc(Allocator* allocator, int32 numBytes) {
+    if (nullptr != allocator) {
+        return allocator->Alloc(numBytes);
+    }
+    else {
+        return Memory::Alloc(numBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+Memory::ReAlloc(Allocator* allocator, void* ptr, int32 numBytes) {
+    if (nullptr != allocator) {
+        return allocator->ReAlloc(ptr, numBytes);
+    }
+    else {
+        return Memory::ReAlloc(ptr, numBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Memory::Free(Allocator* allocator, void* ptr) {
+    if (nullptr != allocator) {
+        allocator->Free(ptr);
+    }
+    else {
+        Memory::Free(ptr);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 Memory::Copy(const void* from, void* to, int32 numBytes) {
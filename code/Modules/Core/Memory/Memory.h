@@ -8,17 +8,44 @@
     differs by platforms (e.g. platforms with SSE support return 16-byte
     aligned memory.
     
-    @todo for now this simply calls malloc()/free(), may be more
-    advanced in the future.
+    Alloc(), ReAlloc() and Free() directly call malloc()/free(). An
+    Allocator object can be installed for the current thread with
+    SetThreadAllocator(), memory-owning objects (container buffers,
+    String data, MemoryStream) created while an allocator is installed
+    allocate through it. The overloads which take an Allocator pointer
+    fall back to the heap if the pointer is nullptr.
+
+    Objects keep the allocator they captured for their whole lifetime,
+    so install an allocator only around scoped temporaries (use a
+    ThreadAllocatorScope), never around objects which outlive the scope,
+    are handed to another thread or survive a RunLoop frame.
+
+    NOTE: the capture has a cost even with no allocator installed: every
+    elementBuffer (Array, Queue, Map, ...), hashTable and MemoryStream
+    carries an extra Allocator pointer and reads the thread-local
+    allocator on construction, String reads it when allocating heap data.
 */
 #include "Core/Types.h"
 #include "Core/Config.h"
 
 namespace Oryol {
 namespace Core {
+
+class Allocator;
     
 class Memory {
 public:
+    /// install an allocator for the current thread (nullptr for heap), returns previous allocator
+    static Allocator* SetThreadAllocator(Allocator* allocator);
+    /// get the current thread's allocator, nullptr means heap
+    static Allocator* ThreadAllocator();
+    /// allocate through an allocator (heap if nullptr)
+    static void* Alloc(Allocator* allocator, int32 numBytes);
+    /// re-allocate through an allocator (heap if nullptr)
+    static void* ReAlloc(Allocator* allocator, void* ptr, int32 numBytes);
+    /// free through an allocator (heap if nullptr)
+    static void Free(Allocator* allocator, void* ptr);
+
     /// allocate a raw chunk of memory
     static void* Alloc(int32 numBytes);
     /// re-allocate a raw chunk of memory
@@ -37,8 +64,34 @@ public:
     static void* Align(void* ptr, int32 byteSize);
     /// round-up a value to the next multiple of byteSize
     static int32 RoundUp(int32 val, int32 byteSize);
+
+private:
+    static ORYOL_THREAD_LOCAL Allocator* threadAllocator;
+};
+
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::ThreadAllocatorScope
+    @brief installs a thread allocator for the lifetime of the scope object
+*/
+class ThreadAllocatorScope {
+public:
+    /// install allocator
+    ThreadAllocatorScope(Allocator* allocator) : prev(Memory::SetThreadAllocator(allocator)) { };
+    /// restore previous allocator
+    ~ThreadAllocatorScope() { Memory::SetThreadAllocator(this->prev); };
+private:
+    ThreadAllocatorScope(const ThreadAllocatorScope&) = delete;
+    void operator=(const ThreadAllocatorScope&) = delete;
+    Allocator* prev;
 };
 
+//------------------------------------------------------------------------------
+inline Allocator*
+Memory::ThreadAllocator() {
+    return threadAllocator;
+}
+
 //------------------------------------------------------------------------------
 inline void*
 Memory::Align(void* ptr, int32 byteSize) {
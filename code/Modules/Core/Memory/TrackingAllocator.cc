@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+//  TrackingAllocator.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "TrackingAllocator.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assert.h"
+
+namespace Oryol {
+namespace Core {
+
+//------------------------------------------------------------------------------
+TrackingAllocator::TrackingAllocator(const char* tag_, Allocator* wrapped_) :
+tag(tag_),
+wrapped(wrapped_),
+numBytes(0),
+peakBytes(0),
+numAllocs(0),
+totalAllocs(0) {
+    o_assert(nullptr != tag_);
+}
+
+//------------------------------------------------------------------------------
+void
+TrackingAllocator::added(int32 size) {
+    const int64 curBytes = (this->numBytes += size);
+    int64 peak = this->peakBytes.load(std::memory_order_relaxed);
+    while ((curBytes > peak) && !this->peakBytes.compare_exchange_weak(peak, curBytes)) {
+        // retry...
+    }
+}
+
+//------------------------------------------------------------------------------
+void*
+TrackingAllocator::Alloc(int32 size) {
+    o_assert(size >= 0);
+    header* hdr = (header*) Memory::Alloc(this->wrapped, sizeof(header) + size);
+    hdr->size = size;
+    this->numAllocs++;
+    this->totalAllocs++;
+    this->added(size);
+    return (void*) (hdr + 1);
+}
+
+//------------------------------------------------------------------------------
+void*
+TrackingAllocator::ReAlloc(void* ptr, int32 size) {
+    if (nullptr == ptr) {
+        return this->Alloc(size);
+    }
+    header* hdr = ((header*)ptr) - 1;
+    const int32 oldSize = hdr->size;
+    hdr = (header*) Memory::ReAlloc(this->wrapped, hdr, sizeof(header) + size);
+    hdr->size = size;
+    this->numBytes -= oldSize;
+    this->added(size);
+    return (void*) (hdr + 1);
+}
+
+//------------------------------------------------------------------------------
+void
+TrackingAllocator::Free(void* ptr) {
+    if (nullptr == ptr) {
+        return;
+    }
+    header* hdr = ((header*)ptr) - 1;
+    this->numBytes -= hdr->size;
+    this->numAllocs--;
+    Memory::Free(this->wrapped, hdr);
+}
+
+//------------------------------------------------------------------------------
+const char*
+TrackingAllocator::Tag() const {
+    return this->tag;
+}
+
+//------------------------------------------------------------------------------
+int64
+TrackingAllocator::NumBytes() const {
+    return this->numBytes;
+}
+
+//------------------------------------------------------------------------------
+int64
+TrackingAllocator::PeakBytes() const {
+    return this->peakBytes;
+}
+
+//------------------------------------------------------------------------------
+int32
+TrackingAllocator::NumAllocs() const {
+    return this->numAllocs;
+}
+
+//------------------------------------------------------------------------------
+int32
+TrackingAllocator::TotalAllocs() const {
+    return this->totalAllocs;
+}
+
+} // namespace Core
+} // namespace Oryol
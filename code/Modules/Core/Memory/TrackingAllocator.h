@@ -0,0 +1,61 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::TrackingAllocator
+    @brief allocator decorator which records memory statistics per tag
+
+    Wraps another allocator (or the heap if nullptr) and counts the
+    number of allocated bytes and allocations and the peak byte size.
+    Create one TrackingAllocator per tag (e.g. "IO", "Render") and
+    install it for a thread or subsystem. The counters are atomic,
+    so a TrackingAllocator can be shared between threads if the
+    wrapped allocator can.
+*/
+#include <atomic>
+#include "Core/Memory/Allocator.h"
+
+namespace Oryol {
+namespace Core {
+
+class TrackingAllocator : public Allocator {
+public:
+    /// constructor with tag and wrapped allocator
+    TrackingAllocator(const char* tag, Allocator* wrapped=nullptr);
+
+    /// allocate a chunk of memory
+    virtual void* Alloc(int32 numBytes) override;
+    /// re-allocate a chunk of memory
+    virtual void* ReAlloc(void* ptr, int32 numBytes) override;
+    /// free a chunk of memory
+    virtual void Free(void* ptr) override;
+
+    /// get the tag
+    const char* Tag() const;
+    /// get number of currently allocated bytes
+    int64 NumBytes() const;
+    /// get peak number of allocated bytes
+    int64 PeakBytes() const;
+    /// get number of current allocations
+    int32 NumAllocs() const;
+    /// get number of allocations since creation
+    int32 TotalAllocs() const;
+
+private:
+    /// per-allocation header
+    struct header {
+        int32 size;
+        int32 padding[3];
+    };
+    /// update counters after allocation
+    void added(int32 numBytes);
+
+    const char* tag;
+    Allocator* wrapped;
+    std::atomic<int64> numBytes;
+    std::atomic<int64> peakBytes;
+    std::atomic<int32> numAllocs;
+    std::atomic<int32> totalAllocs;
+};
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,145 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, don't use!
+
+    Per-type free-list of constructed objects on top of a poolAllocator,
+    used by the OryolClassRecycleDecl macro. Destroy() doesn't call the
+    destructor, but resets the object in place (TYPE must have a
+    Reset() method which releases references, and clears containers
+    without releasing their capacity), and keeps the object for reuse
+    by the next Create(). Only if the free-list is full is the object
+    really destroyed. Thus steady-state object traffic doesn't touch
+    the heap at all, not even for the containers inside the objects.
+
+    Recycled objects outlive any scoped thread allocator, so new objects
+    are always constructed with the heap as thread allocator, their
+    containers never capture a ThreadAllocatorScope's allocator.
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/poolAllocator.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace Core {
+
+template<class TYPE> class objectRecycler {
+public:
+    /// default max number of objects in the free-list
+    static const int32 DefaultMaxNumFree = 256;
+
+    /// constructor
+    objectRecycler(poolAllocator<TYPE>& allocator, int32 maxNumFree=DefaultMaxNumFree);
+    /// destructor
+    ~objectRecycler();
+
+    /// get a recycled object, or create a new one
+    TYPE* Create();
+    /// reset the object and keep it for reuse, or destroy it if the free-list is full
+    void Destroy(TYPE* obj);
+    /// get the number of objects in the free-list
+    int32 NumFree() const;
+    /// get the number of Create() calls which returned a recycled object
+    int32 NumReused() const;
+
+private:
+    poolAllocator<TYPE>& allocator;
+    const int32 maxNumFree;
+    TYPE** freeObjects;
+    int32 numFree;
+    int32 numReused;
+    #if ORYOL_HAS_THREADS
+    mutable std::mutex lock;
+    #endif
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+objectRecycler<TYPE>::objectRecycler(poolAllocator<TYPE>& allocator_, int32 maxNumFree_) :
+allocator(allocator_),
+maxNumFree(maxNumFree_),
+freeObjects(nullptr),
+numFree(0),
+numReused(0) {
+    o_assert(maxNumFree_ > 0);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+objectRecycler<TYPE>::~objectRecycler() {
+    // only call the destructors (which release the container memory),
+    // the object memory goes away with the pool allocator's puddles,
+    // the thread-local pool caches may already be gone at this point
+    for (int32 i = 0; i < this->numFree; i++) {
+        this->freeObjects[i]->~TYPE();
+    }
+    this->numFree = 0;
+    if (nullptr != this->freeObjects) {
+        Memory::Free(this->freeObjects);
+        this->freeObjects = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+objectRecycler<TYPE>::Create() {
+    {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> scopedLock(this->lock);
+        #endif
+        if (this->numFree > 0) {
+            this->numReused++;
+            return this->freeObjects[--this->numFree];
+        }
+    }
+    ThreadAllocatorScope heapScope(nullptr);
+    return this->allocator.Create();
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+objectRecycler<TYPE>::Destroy(TYPE* obj) {
+    o_assert(nullptr != obj);
+
+    // reset outside the lock, this may release other objects
+    obj->Reset();
+    {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> scopedLock(this->lock);
+        #endif
+        if (nullptr == this->freeObjects) {
+            this->freeObjects = (TYPE**) Memory::Alloc(this->maxNumFree * sizeof(TYPE*));
+        }
+        if (this->numFree < this->maxNumFree) {
+            this->freeObjects[this->numFree++] = obj;
+            return;
+        }
+    }
+    this->allocator.Destroy(obj);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+objectRecycler<TYPE>::NumFree() const {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> scopedLock(this->lock);
+    #endif
+    return this->numFree;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+objectRecycler<TYPE>::NumReused() const {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> scopedLock(this->lock);
+    #endif
+    return this->numReused;
+}
+
+} // namespace Core
+} // namespace Oryol
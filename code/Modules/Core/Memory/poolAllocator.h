@@ -2,237 +2,554 @@
 //------------------------------------------------------------------------------
 /*
     private class, don't use!
- 
-    Thread-safe pool allocator with placement-new/delete. Uses 32-bit
-    tags with a unique-count masked-in for its forward-linked list 
-    instead of pointers because of the ABA problem (which I was actually 
-    running into with many threads and high object reuse). The pool
-    is split into up to 256 "puddles", where each puddle can hold
-    up to 256 elements. When no elements are in the free list, 
-    a new puddle is allocated. Thus one pool can hold up to
-    65536 elements.
+
+    Thread-safe pool allocator with placement-new/delete. The free-list
+    head is a 64-bit tag with a 32-bit unique-count masked-in, and nodes
+    are linked by 32-bit node indices instead of pointers because of
+    the ABA problem (which I was actually running into with many threads
+    and high object reuse). The pool is split into up to 65536 "puddles",
+    where each puddle holds a power-of-2 number of elements (default 256,
+    configurable through the constructor). When no elements are in the
+    free list, a new puddle is allocated. Thus with the default puddle
+    size one pool can hold up to 16 million elements.
+
+    Create() and Destroy() go through a small thread-local node cache
+    (see poolMagazine) and only touch the shared free-list when the
+    cache runs empty or full. The shared free-list is a lock-free stack
+    of node batches (linked through node::nextBatch), where the nodes
+    of a batch are linked through node::next, so that a whole batch
+    is moved with a single CAS.
+
+    When less than a quarter of the pool's capacity has been in use
+    for a while, puddles whose elements are all back in the free-list
+    can be released (see ReleaseIdlePuddles()). This is never done
+    inside Create() or Destroy(), Destroy() only counts low-usage
+    batch pushes. CoreFacade calls poolMagazine::ReleaseIdlePuddles()
+    once per frame from the main thread's RunLoop, which releases
+    the idle puddles of all allocators that have been idle long enough.
+
+    The shared free-list needs lock-free 64-bit atomics (checked with
+    a static_assert on platforms with threads).
 */
 #include <atomic>
 #include <utility>
 #include "Core/Types.h"
 #include "Core/Memory/Memory.h"
+#include "Core/Memory/poolMagazine.h"
 
 namespace Oryol {
 namespace Core {
-    
+
 template<class TYPE> class poolAllocator {
 public:
-    /// constructor
-    poolAllocator();
+    /// default number of elements per puddle
+    static const int32 DefaultPuddleSize = 256;
+    /// max number of elements per puddle
+    static const int32 MaxPuddleSize = (1<<15);
+
+    /// constructor with number of elements per puddle (must be 2^N)
+    poolAllocator(int32 puddleSize=DefaultPuddleSize);
     /// destructor
     ~poolAllocator();
-    
+
     /// allocate and construct an object of type T
     template<typename... ARGS> TYPE* Create(ARGS&&... args);
     /// delete and free an object
     void Destroy(TYPE* obj);
-    
+    /// release puddles whose elements are all in the shared free-list
+    void ReleaseIdlePuddles();
+    /// release idle puddles if usage has been low for a while
+    void ReleaseIdlePuddlesIfIdle();
+    /// get the current number of allocated puddles
+    int32 NumPuddles() const;
+
 private:
     enum class nodeState : uint8 {
         init, free, used,
     };
-    
-    typedef uint32 nodeTag;    // [16bit counter] | [8bit puddle index ] | [8bit elm_index])
-    static const uint32 invalidTag = 0xFFFFFFFF;
+
+    typedef uint32 nodeIndex;   // [puddle index] | [elm index]
+    typedef uint64 nodeTag;     // [32bit counter] | [32bit node index]
+    static const nodeIndex invalidIndex = 0xFFFFFFFF;
 
     struct node {
-        nodeTag next;          // tag of next node
-        nodeTag myTag;        // my own tag
-        nodeState state;       // current state
-        uint8 padding[16 - (2*sizeof(nodeTag) + sizeof(nodeState))];      // pad to 16 bytes
+        nodeIndex next;         // index of next node in same batch
+        nodeIndex myIndex;      // my own index
+        nodeIndex nextBatch;    // index of next batch (only valid in batch head)
+        nodeState state;        // current state
+        uint8 padding[16 - (3*sizeof(nodeIndex) + sizeof(nodeState))];      // pad to 16 bytes
     };
 
-    /// pop a new node from the free-list, return 0 if empty
-    node* pop();
-    /// push a node onto the free-list
-    void push(node*);
+    static const int32 BatchSize = 32;
+    static const int32 MagazineSize = 2 * BatchSize;
+    /// number of magazines per type and thread (must be 2^N)
+    static const uint32 NumThreadMagazines = 4;
+
+    /// thread-local node cache
+    struct magazine : public poolMagazine {
+        node* nodes[MagazineSize];
+    };
+
+    /// pop a batch of nodes from the free-list, return 0 if empty
+    node* popBatch();
+    /// link nodes into a batch and push onto the free-list
+    void pushBatch(node** nodes, int32 num);
+    /// get the calling thread's magazine, bound to this allocator
+    magazine* threadMagazine();
+    /// refill an empty magazine from the free-list
+    void refill(magazine* mag);
+    /// return the content of a magazine to the free-list (called by poolMagazine)
+    static void releaseMagazine(void* owner, poolMagazine* mag);
+    /// release idle puddles (called by poolMagazine::ReleaseIdlePuddles())
+    static void releaseIdle(void* owner);
     /// allocate a new puddle and add entries to free-list
     void allocPuddle();
-    /// get node address from a tag
-    node* addressFromTag(nodeTag tag) const;
-    /// get tag from a node address
-    nodeTag tagFromAddress(node* n) const;
+    /// get pointer to a puddle slot
+    uint8** puddleSlot(uint32 puddleIndex) const;
+    /// get node address from an index
+    node* addressFromIndex(nodeIndex index) const;
     /// test if a pointer is owned by this allocator (SLOW)
     bool isOwned(TYPE* obj) const;
-    
-    static const uint32 MaxNumPuddles = 256;
-    static const uint32 NumPuddleElements = 256;
-    
+    /// acquire the puddle lock
+    void lockPuddles();
+    /// release the puddle lock
+    void unlockPuddles();
+
+    static const uint32 PuddleDirBlockSize = 256;
+    static const uint32 MaxNumPuddleDirBlocks = 256;
+    static const uint32 MaxNumPuddles = PuddleDirBlockSize * MaxNumPuddleDirBlocks;
+    /// number of batches returned at low usage before idle puddles are released
+    static const int32 IdleReleaseThreshold = 1024;
+
     int32 elmSize;                      // offset to next element in bytes
+    int32 puddleSize;                   // number of elements per puddle
+    uint32 puddleShift;                 // log2(puddleSize)
+    uint32 ownerId;                     // unique id to bind thread magazines
 
-    #if ORYOL_HAS_ATOMIC
-        std::atomic<uint32> uniqueCount;
-        std::atomic<nodeTag> head;          // free-list head
-        std::atomic<uint32> numPuddles;     // current number of puddles
-    #else
-        uint32 uniqueCount;
-        nodeTag head;
-        uint32 numPuddles;
-    #endif
-    uint8* puddles[MaxNumPuddles];
+    std::atomic<nodeTag> head;          // free-list head
+    std::atomic<int32> numOutstanding;  // number of nodes taken from the free-list
+    std::atomic<int32> idleCount;       // number of batch-pushes at low usage
+    std::atomic<int32> numPoppers;      // number of threads currently in popBatch()
+    std::atomic<bool> releasing;        // true while idle puddles are released
+    std::atomic<bool> puddleLock;       // protects puddle allocation and release
+    std::atomic<int32> numPuddles;      // current number of puddles
+    uint32 numPuddleSlots;              // number of used puddle slots (released slots are 0)
+    uint32* freeSlots;                  // stack of released puddle slots
+    uint32 numFreeSlots;                // number of entries in freeSlots
+    uint32 maxFreeSlots;                // capacity of freeSlots
+    uint8** puddleDir[MaxNumPuddleDirBlocks];
 };
 
 //------------------------------------------------------------------------------
 template<class TYPE>
-poolAllocator<TYPE>::poolAllocator()
+poolAllocator<TYPE>::poolAllocator(int32 numElements) :
+puddleSize(numElements),
+puddleShift(0),
+head(invalidIndex),
+numOutstanding(0),
+idleCount(0),
+numPoppers(0),
+releasing(false),
+puddleLock(false),
+numPuddles(0),
+numPuddleSlots(0),
+freeSlots(nullptr),
+numFreeSlots(0),
+maxFreeSlots(0)
 {
     static_assert(sizeof(node) == 16, "pool_allocator::node should be 16 bytes!");
+    #if ORYOL_HAS_THREADS
+    static_assert(ATOMIC_LLONG_LOCK_FREE == 2, "poolAllocator needs lock-free 64-bit atomics!");
+    #endif
+    o_assert((numElements > 0) && (numElements <= MaxPuddleSize));
+    o_assert(0 == (numElements & (numElements - 1)));
 
-    Memory::Clear(this->puddles, sizeof(this->puddles));
-    this->numPuddles = 0;
+    while ((1 << this->puddleShift) < numElements) {
+        this->puddleShift++;
+    }
+    Memory::Clear(this->puddleDir, sizeof(this->puddleDir));
     this->elmSize = Memory::RoundUp(sizeof(node) + sizeof(TYPE), sizeof(node));
     o_assert((this->elmSize & (sizeof(node) - 1)) == 0);
     o_assert(this->elmSize >= (int32)(2*sizeof(node)));
-    this->uniqueCount = 0;
-    this->head = invalidTag;
+    this->ownerId = poolMagazine::registerOwner(this, &releaseIdle);
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
 poolAllocator<TYPE>::~poolAllocator() {
 
-    const uint32 num = this->numPuddles;
-    for (uint32 i = 0; i < num; i++) {
-        Memory::Free(this->puddles[i]);
-        this->puddles[i] = 0;
+    // after this, nodes in thread magazines will no longer be returned to us
+    poolMagazine::unregisterOwner(this->ownerId);
+
+    for (uint32 i = 0; i < this->numPuddleSlots; i++) {
+        uint8** slot = this->puddleSlot(i);
+        if (nullptr != *slot) {
+            Memory::Free(*slot);
+            *slot = nullptr;
+        }
+    }
+    for (uint32 i = 0; i < MaxNumPuddleDirBlocks; i++) {
+        if (nullptr != this->puddleDir[i]) {
+            Memory::Free(this->puddleDir[i]);
+            this->puddleDir[i] = nullptr;
+        }
+    }
+    if (nullptr != this->freeSlots) {
+        Memory::Free(this->freeSlots);
+        this->freeSlots = nullptr;
     }
 }
 
 //------------------------------------------------------------------------------
-template<class TYPE>
-typename poolAllocator<TYPE>::node*
-poolAllocator<TYPE>::addressFromTag(nodeTag tag) const {
-    uint32 elmIndex = tag & 0xFF;
-    uint32 puddleIndex = (tag & 0xFF00) >> 8;
-    uint8* ptr = this->puddles[puddleIndex] + elmIndex * elmSize;
-    return (node*) ptr;
+template<class TYPE> int32
+poolAllocator<TYPE>::NumPuddles() const {
+    return this->numPuddles;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::lockPuddles() {
+    while (this->puddleLock.exchange(true, std::memory_order_acquire)) {
+        // spinning...
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::unlockPuddles() {
+    this->puddleLock.store(false, std::memory_order_release);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> uint8**
+poolAllocator<TYPE>::puddleSlot(uint32 puddleIndex) const {
+    o_assert_dbg(puddleIndex < MaxNumPuddles);
+    uint8** block = this->puddleDir[puddleIndex / PuddleDirBlockSize];
+    o_assert_dbg(nullptr != block);
+    return &block[puddleIndex & (PuddleDirBlockSize - 1)];
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
-typename poolAllocator<TYPE>::nodeTag
-poolAllocator<TYPE>::tagFromAddress(node* n) const {
-    o_assert(nullptr != n);
-    nodeTag tag = n->myTag;
-    #if ORYOL_ALLOCATOR_DEBUG
-    o_assert(n == addressFromTag(tag));
-    #endif
-    return tag;
+typename poolAllocator<TYPE>::node*
+poolAllocator<TYPE>::addressFromIndex(nodeIndex index) const {
+    uint32 elmIndex = index & (this->puddleSize - 1);
+    uint32 puddleIndex = index >> this->puddleShift;
+    uint8* ptr = *this->puddleSlot(puddleIndex) + elmIndex * this->elmSize;
+    return (node*) ptr;
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE> void
 poolAllocator<TYPE>::allocPuddle() {
 
-    // increment the puddle-counter (this must happen first because the
-    // method can be called from different threads
-    #if ORYOL_HAS_ATOMIC
-        uint32 newPuddleIndex = this->numPuddles.fetch_add(1, std::memory_order_relaxed);
-    #else 
-        uint32 newPuddleIndex = this->numPuddles++;
-    #endif
+    // find a free puddle slot, this can be called from different threads
+    // and can race with ReleaseIdlePuddles()
+    this->lockPuddles();
+    uint32 newPuddleIndex = this->numPuddleSlots;
+    if (this->numFreeSlots > 0) {
+        // re-use a previously released slot
+        newPuddleIndex = this->freeSlots[--this->numFreeSlots];
+        o_assert_dbg(nullptr == *this->puddleSlot(newPuddleIndex));
+    }
     o_assert(newPuddleIndex < MaxNumPuddles);
-    
+    const uint32 dirIndex = newPuddleIndex / PuddleDirBlockSize;
+    if (nullptr == this->puddleDir[dirIndex]) {
+        const int32 dirBlockByteSize = PuddleDirBlockSize * sizeof(uint8*);
+        this->puddleDir[dirIndex] = (uint8**) Memory::Alloc(dirBlockByteSize);
+        Memory::Clear(this->puddleDir[dirIndex], dirBlockByteSize);
+    }
+
     // allocate new puddle
-    const uint32 puddleByteSize = NumPuddleElements * this->elmSize;
-    this->puddles[newPuddleIndex] = (uint8*) Memory::Alloc(puddleByteSize);
-    Memory::Clear(this->puddles[newPuddleIndex], puddleByteSize);
-    
-    // populate the free stack
-    for (int32 elmIndex = (NumPuddleElements - 1); elmIndex >= 0; elmIndex--) {
-        uint8* ptr = this->puddles[newPuddleIndex] + elmIndex * this->elmSize;
-        node* nodePtr = (node*) ptr;
-        nodePtr->next  = invalidTag;
-        nodePtr->myTag = (newPuddleIndex << 8) | elmIndex;
-        nodePtr->state = nodeState::init;
-        this->push(nodePtr);
+    const int32 puddleByteSize = this->puddleSize * this->elmSize;
+    uint8* puddle = (uint8*) Memory::Alloc(puddleByteSize);
+    Memory::Clear(puddle, puddleByteSize);
+    *this->puddleSlot(newPuddleIndex) = puddle;
+    if (newPuddleIndex == this->numPuddleSlots) {
+        this->numPuddleSlots++;
+    }
+    this->numPuddles++;
+    this->unlockPuddles();
+
+    // populate the free stack in batches
+    node* batch[BatchSize];
+    int32 batchNum = 0;
+    for (int32 elmIndex = 0; elmIndex < this->puddleSize; elmIndex++) {
+        node* nodePtr = (node*) (puddle + elmIndex * this->elmSize);
+        nodePtr->next  = invalidIndex;
+        nodePtr->myIndex = (newPuddleIndex << this->puddleShift) | elmIndex;
+        nodePtr->nextBatch = invalidIndex;
+        nodePtr->state = nodeState::free;
+        batch[batchNum++] = nodePtr;
+        if (BatchSize == batchNum) {
+            this->numOutstanding += batchNum;
+            this->pushBatch(batch, batchNum);
+            batchNum = 0;
+        }
+    }
+    if (batchNum > 0) {
+        this->numOutstanding += batchNum;
+        this->pushBatch(batch, batchNum);
     }
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE> void
-poolAllocator<TYPE>::push(node* newHead) {
-    
+poolAllocator<TYPE>::pushBatch(node** nodes, int32 num) {
+
     // see http://www.boost.org/doc/libs/1_53_0/boost/lockfree/stack.hpp
-    o_assert((nodeState::init == newHead->state) || (nodeState::used == newHead->state));
-    
-    o_assert(invalidTag == newHead->next);
-    #if ORYOL_ALLOCATOR_DEBUG
-    Memory::Fill((void*) (newHead + 1), sizeof(TYPE), 0xAA);
-    #endif
-    
-    newHead->state = nodeState::free;
-    newHead->myTag = (newHead->myTag & 0x0000FFFF) | (++this->uniqueCount & 0xFFFF) << 16;
-    #if ORYOL_HAS_ATOMIC
-        nodeTag oldHeadTag = this->head.load(std::memory_order_relaxed);
-        for (;;) {
-            newHead->next = oldHeadTag;
-            if (this->head.compare_exchange_weak(oldHeadTag, newHead->myTag)) {
-                break;
-            }
+    o_assert((num > 0) && (num <= BatchSize));
+
+    // link the nodes into a batch, the first node is the batch head
+    for (int32 i = 0; i < num; i++) {
+        o_assert(nodeState::free == nodes[i]->state);
+        nodes[i]->next = (i < (num - 1)) ? nodes[i + 1]->myIndex : invalidIndex;
+    }
+
+    // every push increments the unique-count in the head tag
+    node* newHead = nodes[0];
+    nodeTag oldHeadTag = this->head.load(std::memory_order_relaxed);
+    for (;;) {
+        newHead->nextBatch = nodeIndex(oldHeadTag & 0xFFFFFFFF);
+        nodeTag newHeadTag = ((oldHeadTag + (nodeTag(1) << 32)) & 0xFFFFFFFF00000000) | newHead->myIndex;
+        if (this->head.compare_exchange_weak(oldHeadTag, newHeadTag)) {
+            break;
         }
-    #else
-        nodeTag oldHeadTag = this->head;
-        newHead->next = oldHeadTag;
-        this->head = newHead->myTag;
-    #endif
+    }
+
+    // count low-usage pushes, the idle puddles are released
+    // later through ReleaseIdlePuddlesIfIdle() (computed in 64 bits,
+    // the products overflow int32 with many big puddles)
+    const int64 outstanding = (this->numOutstanding -= num);
+    const int64 curNumPuddles = this->numPuddles.load(std::memory_order_relaxed);
+    if ((curNumPuddles > 1) && ((outstanding * 4) < (curNumPuddles * this->puddleSize))) {
+        if (this->idleCount.load(std::memory_order_relaxed) < IdleReleaseThreshold) {
+            ++this->idleCount;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::ReleaseIdlePuddlesIfIdle() {
+    if (this->idleCount.load(std::memory_order_relaxed) >= IdleReleaseThreshold) {
+        this->idleCount = 0;
+        this->ReleaseIdlePuddles();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::releaseIdle(void* owner) {
+    ((poolAllocator<TYPE>*)owner)->ReleaseIdlePuddlesIfIdle();
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
 typename poolAllocator<TYPE>::node*
-poolAllocator<TYPE>::pop()
+poolAllocator<TYPE>::popBatch()
 {
+    // register as popper, puddles must not be released while we're
+    // looking at nodes which might be popped by other threads
+    for (;;) {
+        ++this->numPoppers;
+        if (!this->releasing) {
+            break;
+        }
+        --this->numPoppers;
+        while (this->releasing) {
+            // spinning...
+        }
+    }
+
     // see http://www.boost.org/doc/libs/1_53_0/boost/lockfree/stack.hpp
+    node* nodePtr = nullptr;
+    nodeTag oldHeadTag = this->head.load(std::memory_order_acquire);
     for (;;) {
-        #if ORYOL_HAS_ATOMIC
-            nodeTag oldHeadTag = this->head.load(std::memory_order_consume);
-        #else 
-            nodeTag oldHeadTag = this->head;
-        #endif
-        if (invalidTag == oldHeadTag) {
-            return nullptr;
+        const nodeIndex oldHeadIndex = nodeIndex(oldHeadTag & 0xFFFFFFFF);
+        if (invalidIndex == oldHeadIndex) {
+            break;
         }
-        nodeTag newHeadTag = this->addressFromTag(oldHeadTag)->next;
-        #if ORYOL_HAS_ATOMIC
+        node* oldHead = this->addressFromIndex(oldHeadIndex);
+        nodeTag newHeadTag = (oldHeadTag & 0xFFFFFFFF00000000) | oldHead->nextBatch;
         if (this->head.compare_exchange_weak(oldHeadTag, newHeadTag)) {
-        #else
-        this->head = newHeadTag;
-        #endif
-            o_assert(invalidTag != oldHeadTag);
-            node* nodePtr = this->addressFromTag(oldHeadTag);
+            nodePtr = oldHead;
             o_assert(nodeState::free == nodePtr->state);
-            #if ORYOL_ALLOCATOR_DEBUG
-            Memory::Fill((void*) (nodePtr+ 1), sizeof(TYPE), 0xBB);
-            #endif
-            nodePtr->next = invalidTag;
-            nodePtr->state = nodeState::used;
-            return nodePtr;
-        #if ORYOL_HAS_ATOMIC
+            nodePtr->nextBatch = invalidIndex;
+            break;
         }
-        #endif
     }
+    --this->numPoppers;
+    return nodePtr;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::ReleaseIdlePuddles() {
+
+    // only one thread at a time, and wait until no other thread is popping
+    if (this->releasing.exchange(true)) {
+        return;
+    }
+    while (this->numPoppers > 0) {
+        // spinning...
+    }
+
+    // take the whole free-list (this bumps the unique-count like a push)
+    nodeTag oldHeadTag = this->head.load(std::memory_order_acquire);
+    for (;;) {
+        nodeTag emptyTag = ((oldHeadTag + (nodeTag(1) << 32)) & 0xFFFFFFFF00000000) | invalidIndex;
+        if (this->head.compare_exchange_weak(oldHeadTag, emptyTag)) {
+            break;
+        }
+    }
+    const nodeIndex listIndex = nodeIndex(oldHeadTag & 0xFFFFFFFF);
+
+    // count the free nodes per puddle
+    this->lockPuddles();
+    const uint32 numSlots = this->numPuddleSlots;
+    int32* numFree = (int32*) Memory::Alloc(numSlots * sizeof(int32));
+    Memory::Clear(numFree, numSlots * sizeof(int32));
+    for (nodeIndex batchIndex = listIndex; invalidIndex != batchIndex; ) {
+        const nodeIndex nextBatchIndex = this->addressFromIndex(batchIndex)->nextBatch;
+        for (nodeIndex index = batchIndex; invalidIndex != index; index = this->addressFromIndex(index)->next) {
+            numFree[index >> this->puddleShift]++;
+        }
+        batchIndex = nextBatchIndex;
+    }
+
+    // push back nodes of puddles which are still in use, pushBatch()
+    // only overwrites the links of nodes which have already been visited
+    node* batch[BatchSize];
+    int32 batchNum = 0;
+    for (nodeIndex batchIndex = listIndex; invalidIndex != batchIndex; ) {
+        const nodeIndex nextBatchIndex = this->addressFromIndex(batchIndex)->nextBatch;
+        for (nodeIndex index = batchIndex; invalidIndex != index; ) {
+            node* n = this->addressFromIndex(index);
+            const nodeIndex nextIndex = n->next;
+            if (numFree[index >> this->puddleShift] != this->puddleSize) {
+                batch[batchNum++] = n;
+                if (BatchSize == batchNum) {
+                    this->numOutstanding += batchNum;
+                    this->pushBatch(batch, batchNum);
+                    batchNum = 0;
+                }
+            }
+            index = nextIndex;
+        }
+        batchIndex = nextBatchIndex;
+    }
+    if (batchNum > 0) {
+        this->numOutstanding += batchNum;
+        this->pushBatch(batch, batchNum);
+    }
+
+    // and free the idle puddles, remember their slots for re-use
+    int32 numReleased = 0;
+    for (uint32 i = 0; i < numSlots; i++) {
+        if (numFree[i] == this->puddleSize) {
+            uint8** slot = this->puddleSlot(i);
+            Memory::Free(*slot);
+            *slot = nullptr;
+            if (this->numFreeSlots == this->maxFreeSlots) {
+                this->maxFreeSlots = (0 == this->maxFreeSlots) ? 64 : this->maxFreeSlots * 2;
+                this->freeSlots = (uint32*) Memory::ReAlloc(this->freeSlots, this->maxFreeSlots * sizeof(uint32));
+            }
+            this->freeSlots[this->numFreeSlots++] = i;
+            numReleased++;
+        }
+    }
+    Memory::Free(numFree);
+    this->numPuddles -= numReleased;
+    this->unlockPuddles();
+
+    this->releasing = false;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+typename poolAllocator<TYPE>::magazine*
+poolAllocator<TYPE>::threadMagazine() {
+    // the magazines are per type, so pick one by allocator id, several
+    // allocators of the same type only evict each other on collisions
+    static ORYOL_THREAD_LOCAL magazine mags[NumThreadMagazines];
+    magazine& mag = mags[this->ownerId & (NumThreadMagazines - 1)];
+    if (mag.ownerId != this->ownerId) {
+        // first use in this thread, or bound to another allocator
+        // of the same type, hand nodes back to the previous owner
+        poolMagazine::release(&mag);
+        mag.owner = this;
+        mag.ownerId = this->ownerId;
+        mag.releaser = &releaseMagazine;
+        if (!mag.attached) {
+            poolMagazine::attach(&mag);
+        }
+    }
+    return &mag;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::refill(magazine* mag) {
+    o_assert(0 == mag->numNodes);
+
+    // pop a batch from the free-list, or allocate new puddles until
+    // we get one (another thread may steal the new batches)
+    node* n;
+    while (nullptr == (n = this->popBatch())) {
+        this->allocPuddle();
+    }
+    for (;;) {
+        o_assert(mag->numNodes < MagazineSize);
+        mag->nodes[mag->numNodes++] = n;
+        if (invalidIndex == n->next) {
+            break;
+        }
+        nodeIndex nextIndex = n->next;
+        n->next = invalidIndex;
+        n = this->addressFromIndex(nextIndex);
+    }
+
+    // usage is high again, restart the idle period
+    const int64 outstanding = (this->numOutstanding += mag->numNodes);
+    if (((outstanding * 4) >= (int64(this->numPuddles) * this->puddleSize)) &&
+        (0 != this->idleCount.load(std::memory_order_relaxed))) {
+        this->idleCount = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+poolAllocator<TYPE>::releaseMagazine(void* owner, poolMagazine* mag) {
+    poolAllocator<TYPE>* self = (poolAllocator<TYPE>*) owner;
+    magazine* typedMag = (magazine*) mag;
+    for (int32 i = 0; i < typedMag->numNodes; i += BatchSize) {
+        const int32 remaining = typedMag->numNodes - i;
+        const int32 num = (remaining < BatchSize) ? remaining : BatchSize;
+        self->pushBatch(&typedMag->nodes[i], num);
+    }
+    typedMag->numNodes = 0;
 }
 
 //------------------------------------------------------------------------------
 template<class TYPE>
 template<typename... ARGS> TYPE*
 poolAllocator<TYPE>::Create(ARGS&&... args) {
-    
-    // pop a new node from the free-stack
-    node* n = this->pop();
-    if (nullptr == n) {
-        // need to allocate a new puddle
-        this->allocPuddle();
-        n = this->pop();
+
+    // pop a new node from the thread-local magazine
+    magazine* mag = this->threadMagazine();
+    if (0 == mag->numNodes) {
+        this->refill(mag);
     }
+    node* n = mag->nodes[--mag->numNodes];
     o_assert(nullptr != n);
-    
+    o_assert(nodeState::free == n->state);
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xBB);
+    #endif
+    n->next = invalidIndex;
+    n->state = nodeState::used;
+
     // construct with placement new
     void* objPtr = (void*) (n + 1);
     TYPE* obj = new(objPtr) TYPE(std::forward<ARGS>(args)...);
@@ -243,13 +560,14 @@ poolAllocator<TYPE>::Create(ARGS&&... args) {
 //------------------------------------------------------------------------------
 template<class TYPE> bool
 poolAllocator<TYPE>::isOwned(TYPE* obj) const {
-    const uint32 num = this->numPuddles;
-    for (uint32 i = 0; i < num; i++) {
-        const uint8* start = this->puddles[i];
-        const uint8* end = this->puddles[i] + NumPuddleElements * this->elmSize;
-        const uint8* ptr = (uint8*) obj;
-        if ((ptr >= start) && (ptr < end)) {
-            return true;
+    for (uint32 i = 0; i < this->numPuddleSlots; i++) {
+        const uint8* start = *this->puddleSlot(i);
+        if (nullptr != start) {
+            const uint8* end = start + this->puddleSize * this->elmSize;
+            const uint8* ptr = (uint8*) obj;
+            if ((ptr >= start) && (ptr < end)) {
+                return true;
+            }
         }
     }
     return false;
@@ -258,18 +576,32 @@ poolAllocator<TYPE>::isOwned(TYPE* obj) const {
 //------------------------------------------------------------------------------
 template<class TYPE> void
 poolAllocator<TYPE>::Destroy(TYPE* obj) {
-    
+
     #if ORYOL_ALLOCATOR_DEBUG
     // make sure this object has been allocated by us
     o_assert(this->isOwned(obj));
     #endif
-    
+
     // call destructor on obj
     obj->~TYPE();
-    
-    // push the pool element back on the free-stack
+
+    // mark the pool element as free
     node* n = ((node*)obj) - 1;
-    push(n);
+    o_assert(nodeState::used == n->state);
+    o_assert(invalidIndex == n->next);
+    #if ORYOL_ALLOCATOR_DEBUG
+    Memory::Fill((void*) (n + 1), sizeof(TYPE), 0xAA);
+    #endif
+    n->state = nodeState::free;
+
+    // put into thread-local magazine, if the magazine is full,
+    // move a batch back to the shared free-list
+    magazine* mag = this->threadMagazine();
+    if (MagazineSize == mag->numNodes) {
+        this->pushBatch(&mag->nodes[MagazineSize - BatchSize], BatchSize);
+        mag->numNodes -= BatchSize;
+    }
+    mag->nodes[mag->numNodes++] = n;
 }
 
 } // namespace Core
@@ -0,0 +1,144 @@
+//------------------------------------------------------------------------------
+//  poolMagazine.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "poolMagazine.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assert.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace Core {
+
+// NOTE: these are all zero-initialized PODs (or have a constexpr
+// constructor) so that they are valid before static allocators
+// are constructed
+#if ORYOL_HAS_THREADS
+static std::mutex liveOwnersLock;
+#endif
+struct liveOwner {
+    uint32 ownerId;
+    void* owner;
+    poolMagazine::idleFunc releaseIdle;
+};
+static uint32 uniqueOwnerId = 0;
+static liveOwner* liveOwners = nullptr;
+static int32 numLiveOwners = 0;
+static int32 maxLiveOwners = 0;
+
+static ORYOL_THREAD_LOCAL poolMagazine* threadMagazines = nullptr;
+
+#if ORYOL_HAS_THREADS
+// returns the thread's magazines when the thread exits, this
+// needs a real C++11 thread_local because it has a destructor
+struct threadExitHook {
+    bool armed = false;
+    ~threadExitHook() {
+        if (this->armed) {
+            poolMagazine::ReleaseThreadMagazines();
+        }
+    };
+};
+static thread_local threadExitHook exitHook;
+#endif
+
+//------------------------------------------------------------------------------
+static bool
+isLiveOwner(uint32 ownerId) {
+    for (int32 i = 0; i < numLiveOwners; i++) {
+        if (ownerId == liveOwners[i].ownerId) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+uint32
+poolMagazine::registerOwner(void* owner, idleFunc releaseIdle) {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(liveOwnersLock);
+    #endif
+    if (numLiveOwners == maxLiveOwners) {
+        maxLiveOwners = (0 == maxLiveOwners) ? 64 : maxLiveOwners * 2;
+        liveOwners = (liveOwner*) Memory::ReAlloc(liveOwners, maxLiveOwners * sizeof(liveOwner));
+    }
+    const uint32 ownerId = ++uniqueOwnerId;
+    liveOwner& entry = liveOwners[numLiveOwners++];
+    entry.ownerId = ownerId;
+    entry.owner = owner;
+    entry.releaseIdle = releaseIdle;
+    return ownerId;
+}
+
+//------------------------------------------------------------------------------
+void
+poolMagazine::unregisterOwner(uint32 ownerId) {
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(liveOwnersLock);
+    #endif
+    for (int32 i = 0; i < numLiveOwners; i++) {
+        if (ownerId == liveOwners[i].ownerId) {
+            liveOwners[i] = liveOwners[--numLiveOwners];
+            return;
+        }
+    }
+    o_error("poolMagazine::unregisterOwner(): owner not registered!\n");
+}
+
+//------------------------------------------------------------------------------
+void
+poolMagazine::attach(poolMagazine* mag) {
+    o_assert(nullptr != mag);
+    o_assert(!mag->attached);
+    mag->nextMagazine = threadMagazines;
+    mag->attached = true;
+    threadMagazines = mag;
+    #if ORYOL_HAS_THREADS
+    exitHook.armed = true;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+poolMagazine::release(poolMagazine* mag) {
+    o_assert(nullptr != mag);
+    if (0 != mag->ownerId) {
+        // hold the lock while handing back the nodes, so that the
+        // owner can't be destroyed under our feet
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> lock(liveOwnersLock);
+        #endif
+        if ((mag->numNodes > 0) && isLiveOwner(mag->ownerId)) {
+            mag->releaser(mag->owner, mag);
+        }
+    }
+    mag->owner = nullptr;
+    mag->ownerId = 0;
+    mag->numNodes = 0;
+}
+
+//------------------------------------------------------------------------------
+void
+poolMagazine::ReleaseThreadMagazines() {
+    for (poolMagazine* mag = threadMagazines; nullptr != mag; mag = mag->nextMagazine) {
+        release(mag);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+poolMagazine::ReleaseIdlePuddles() {
+    // hold the lock so that no allocator can be destroyed meanwhile
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(liveOwnersLock);
+    #endif
+    for (int32 i = 0; i < numLiveOwners; i++) {
+        liveOwners[i].releaseIdle(liveOwners[i].owner);
+    }
+}
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,62 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, don't use!
+
+    Thread-local node cache ("magazine") in front of the shared free-list
+    of a poolAllocator. Each thread owns a few magazines per pooled type
+    which are selected by the allocator's owner id, Create() and Destroy()
+    mostly only touch the thread's magazine, and only exchange whole
+    batches of nodes with the shared free-list.
+
+    A magazine is bound to one allocator instance through a unique
+    owner id. Allocators register themselves on construction and
+    unregister on destruction, so that leftover nodes in magazines of
+    destroyed allocators are never handed back to a dead allocator.
+    All magazines of a thread are kept in a thread-local list,
+    CoreFacade::LeaveThread() returns their content to the owning
+    allocators. Threads which don't call LeaveThread() return them
+    through a thread-exit hook which is armed by the first attach().
+
+    The registry of live allocators is also used to release idle
+    puddles outside of Create()/Destroy(): ReleaseIdlePuddles() is called
+    once per frame by CoreFacade and lets each allocator release its
+    puddles if it has been idle long enough.
+*/
+#include "Core/Types.h"
+#include "Core/Config.h"
+
+namespace Oryol {
+namespace Core {
+
+class poolMagazine {
+public:
+    /// function which releases an owner's idle puddles
+    typedef void (*idleFunc)(void* owner);
+
+    /// register a new allocator, return a unique owner id
+    static uint32 registerOwner(void* owner, idleFunc releaseIdle);
+    /// unregister an allocator
+    static void unregisterOwner(uint32 ownerId);
+    /// add a magazine to the current thread's magazine list
+    static void attach(poolMagazine* mag);
+    /// return a magazine's nodes to its owner (if still alive) and unbind the magazine
+    static void release(poolMagazine* mag);
+    /// release all magazines of the current thread
+    static void ReleaseThreadMagazines();
+    /// release idle puddles of all live allocators
+    static void ReleaseIdlePuddles();
+
+    /// function which returns the magazine's content to its owner
+    typedef void (*releaseFunc)(void* owner, poolMagazine* mag);
+
+    poolMagazine* nextMagazine;     // next magazine in this thread's list
+    void* owner;                    // owning poolAllocator
+    releaseFunc releaser;           // return nodes to owner
+    uint32 ownerId;                 // unique id of owner, 0 if unbound
+    int32 numNodes;                 // current number of cached nodes
+    bool attached;                  // true if in the thread's magazine list
+};
+
+} // namespace Core
+} // namespace Oryol
@@ -102,23 +102,23 @@ public:
     };
     /// operator!=
     template<class U> bool operator!=(const Ptr<U>& rhs) const {
-        return p != rhs.GetUnsafe();
+        return p != rhs.getUnsafe();
     };
     /// operator<
     template<class U> bool operator<(const Ptr<U>& rhs) const {
-        return p < rhs.GetUnsafe();
+        return p < rhs.getUnsafe();
     };
     /// operator>
     template<class U> bool operator>(const Ptr<U>& rhs) const {
-        return p > rhs.GetUnsafe();
+        return p > rhs.getUnsafe();
     };
     /// operator<=
     template<class U> bool operator<=(const Ptr<U>& rhs) const {
-        return p <= rhs.GetUnsafe();
+        return p <= rhs.getUnsafe();
     };
     /// operator>=
     template<class U> bool operator>=(const Ptr<U>& rhs) const {
-        return p >= rhs.GetUnsafe();
+        return p >= rhs.getUnsafe();
     };
     /// test if invalid (contains nullptr)
     bool operator==(std::nullptr_t) const {
@@ -148,6 +148,10 @@ public:
         // fallthrough: either we're not valid, or the dynamic_cast failed
         return Ptr<U>();
     };
+    /// perform unchecked static cast (the caller must know the type, e.g. from a type tag)
+    template<class U> Ptr<U> staticCast() const {
+        return Ptr<U>(static_cast<U*>(this->p));
+    };
     /// operator*
     T& operator*() const {
         o_assert(nullptr != p);
@@ -14,6 +14,7 @@
 #include "Core/Ptr.h"
 #include "Core/Macros.h"
 #include "Core/Memory/poolAllocator.h"
+#include "Core/Memory/objectRecycler.h"
 
 namespace Oryol {
 namespace Core {
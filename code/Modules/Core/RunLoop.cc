@@ -3,6 +3,7 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "RunLoop.h"
+#include "Core/Memory/Memory.h"
 
 namespace Oryol {
 namespace Core {
@@ -10,7 +11,8 @@ namespace Core {
 OryolClassImpl(RunLoop);
 
 //------------------------------------------------------------------------------
-RunLoop::RunLoop()
+RunLoop::RunLoop() :
+frameAllocator(ORYOL_FRAME_ALLOCATOR_SIZE)
 {
     // empty
 }
@@ -31,12 +33,20 @@ RunLoop::Run() {
         }
     }
     this->RemoveCallbacks();
+    o_assert2(Memory::ThreadAllocator() != &this->frameAllocator, "Frame allocator still installed at end of frame!\n");
+    this->frameAllocator.Reset();
+}
+
+//------------------------------------------------------------------------------
+LinearAllocator&
+RunLoop::FrameAllocator() {
+    return this->frameAllocator;
 }
 
 //------------------------------------------------------------------------------
 bool
 RunLoop::HasCallback(const StringAtom& name) const {
-    return this->FindCallback(name);
+    return InvalidIndex != this->FindCallback(name);
 }
 
 //------------------------------------------------------------------------------
@@ -44,7 +54,7 @@ int32
 RunLoop::FindCallback(const StringAtom& name) const {
     const int32 num = this->callbacks.Size();
     for (int32 i = 0; i < num; i++) {
-        if (this->callbacks[i].Name() == name) {
+        if (this->callbacks.ValueAtIndex(i).Name() == name) {
             return i;
         }
     }
@@ -78,7 +88,7 @@ RunLoop::Remove(const StringAtom& name) {
     
     int32 index = this->FindCallback(name);
     o_assert(InvalidIndex != index);
-    this->callbacks[index].SetValid(false);
+    this->callbacks.ValueAtIndex(index).SetValid(false);
     this->toRemove.Insert(name);
 }
 
@@ -99,10 +109,11 @@ RunLoop::RemoveCallbacks() {
     for (const StringAtom& name : this->toRemove) {
         int32 index = this->FindCallback(name);
         if (InvalidIndex != index) {
-            o_assert(!this->callbacks[index].IsValid());
+            o_assert(!this->callbacks.ValueAtIndex(index).IsValid());
             this->callbacks.EraseIndex(index);
         }
     }
+    this->toRemove.Clear();
 }
 
 //------------------------------------------------------------------------------
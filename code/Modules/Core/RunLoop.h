@@ -21,11 +21,21 @@
 
         MyClass myObj;<br>
         Callback("name", pri, std::function<void()>(&MyClass::MyMethod, &myObj));
+
+    Each RunLoop owns a LinearAllocator for per-frame allocations which
+    is reset at the end of Run(). Install it with a
+    ThreadAllocatorScope inside a callback for temporaries which are
+    destroyed before the callback returns, objects created in the scope
+    must not survive the frame or be handed to another thread. Run()
+    asserts that the frame allocator isn't installed anymore when
+    it resets it.
 */
 #include <functional>
 #include "Core/RefCounted.h"
 #include "Core/String/StringAtom.h"
 #include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
+#include "Core/Memory/LinearAllocator.h"
 
 namespace Oryol {
 namespace Core {
@@ -62,8 +72,10 @@ public:
     /// destructor
     virtual ~RunLoop();
     
-    /// run one frame
+    /// run one frame (resets the frame allocator at the end)
     void Run();
+    /// get the frame allocator
+    LinearAllocator& FrameAllocator();
     
     /// add a callback to the run loop, higher priorities run earlier, slow!
     void Add(const Callback& callback);
@@ -85,6 +97,7 @@ private:
     Map<int32, Callback> callbacks;
     Map<StringAtom, Callback> toAdd;
     Set<StringAtom> toRemove;
+    LinearAllocator frameAllocator;
 };
     
 } // namespace Core
@@ -9,12 +9,14 @@
 namespace Oryol {
 namespace Core {
 
-const char* String::emptyString = "";
-
 //------------------------------------------------------------------------------
 String::String(const StringAtom& str) {
-    const char* cstr = str.AsCStr();
-    this->create(cstr, std::strlen(cstr));
+    this->create(str.AsCStr(), str.Length());
+}
+
+//------------------------------------------------------------------------------
+String::String(const StringView& str) {
+    this->create(str.Ptr(), str.Length());
 }
 
 //------------------------------------------------------------------------------
@@ -23,18 +25,10 @@ String::String(const char* str) {
         this->create(str, std::strlen(str));
     }
     else {
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
-//------------------------------------------------------------------------------
-String::String() :
-data(nullptr),
-strPtr(nullptr) {
-    // empty
-}
-
 //------------------------------------------------------------------------------
 /**
  Construct string from substring of other string. If len is 0, this
@@ -80,58 +74,74 @@ String::Assign(const char* ptr, int32 startIndex, int32 endIndex) {
 void
 String::operator=(const StringAtom& str) {
     this->release();
-    const char* cstr = str.AsCStr();
-    this->create(cstr, std::strlen(cstr));
+    this->create(str.AsCStr(), str.Length());
+}
+
+//------------------------------------------------------------------------------
+void
+String::operator=(const StringView& str) {
+    // str may point into our own string data
+    *this = String(str);
 }
 
 //------------------------------------------------------------------------------
 StringAtom
 String::AsStringAtom() const {
-    return StringAtom(this->AsCStr());;
+    return StringAtom(this->AsCStr(), this->Length());
 }
 
 //------------------------------------------------------------------------------
 void
 String::destroy() {
-    o_assert(0 != this->data);
+    o_assert(!this->IsLocal());
     o_assert(0 == this->data->refCount);
+    Allocator* allocator = this->data->allocator;
     this->data->~StringData();
-    Memory::Free(this->data);
-    this->data = 0;
-    this->strPtr = 0;
+    Memory::Free(allocator, this->data);
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
 void
 String::alloc(int32 len) {
-    o_assert(len > 0);
-    this->data = (StringData*) Memory::Alloc(sizeof(StringData) + len + 1);
+    o_assert(len > MaxLocalLength);
+    Allocator* allocator = Memory::ThreadAllocator();
+    this->data = (StringData*) Memory::Alloc(allocator, sizeof(StringData) + len + 1);
+    this->localBuf[LocalBufSize - 1] = (char) HeapTag;
     new(this->data) StringData();
     this->addRef();
     this->data->length = len;
-    this->strPtr = (const char*) &(this->data[1]);
+    this->data->allocator = allocator;
 }
 
 //------------------------------------------------------------------------------
 void
 String::create(const char* ptr, int32 len) {
     o_assert(0 != ptr);
-    if ((ptr[0] != 0) && (len > 0)) {
-        this->alloc(len);
-        Memory::Copy(ptr, (void*)this->strPtr, len);
-        ((char*)this->strPtr)[len] = 0;
+    if ((len > 0) && (ptr[0] != 0)) {
+        char* dst;
+        if (len <= MaxLocalLength) {
+            // short string, store in local buffer
+            dst = this->localBuf;
+            this->localBuf[LocalBufSize - 1] = (char) len;
+        }
+        else {
+            this->alloc(len);
+            dst = (char*) &(this->data[1]);
+        }
+        std::memcpy(dst, ptr, len);
+        dst[len] = 0;
     }
     else {
         // empty string, don't bother to allocate storage for this
-        this->data = nullptr;
-        this->strPtr = nullptr;
+        this->setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
 void
 String::addRef() {
-    o_assert(nullptr != this->data);
+    o_assert(!this->IsLocal());
     #if ORYOL_HAS_ATOMIC
     this->data->refCount.fetch_add(1, std::memory_order_relaxed);
     #else
@@ -142,18 +152,26 @@ String::addRef() {
 //------------------------------------------------------------------------------
 void
 String::release() {
-    if (nullptr != this->data) {
+    if (!this->IsLocal()) {
         #if ORYOL_HAS_ATOMIC
-        if (1 == this->data->refCount.fetch_sub(1, std::memory_order_relaxed)) {
+        // if we're the only owner, no other thread can add a reference,
+        // so the atomic read-modify-write can be skipped
+        bool last = (1 == this->data->refCount.load(std::memory_order_acquire));
+        if (!last) {
+            last = (1 == this->data->refCount.fetch_sub(1, std::memory_order_acq_rel));
+        }
+        else {
+            this->data->refCount.store(0, std::memory_order_relaxed);
+        }
+        if (last) {
         #else
         if (1 == this->data->refCount--) {
         #endif
             // no more owners, destroy the shared string data
             this->destroy();
         }
-        this->data = nullptr;
-        this->strPtr = nullptr;
     }
+    this->setEmpty();
 }
 
 //------------------------------------------------------------------------------
@@ -179,19 +197,21 @@ String::String(const std::string& str) {
 
 //------------------------------------------------------------------------------
 String::String(const String& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    if (nullptr != this->data) {
+    this->copyBytes(rhs);
+    if (!this->IsLocal()) {
         this->addRef();
     }
 }
 
 //------------------------------------------------------------------------------
 String::String(String&& rhs) {
-    this->data = rhs.data;
-    this->strPtr = rhs.strPtr;
-    rhs.data = 0;
-    rhs.strPtr = 0;
+    this->copyBytes(rhs);
+    rhs.setEmpty();
+}
+
+//------------------------------------------------------------------------------
+String::~String() {
+    this->release();
 }
 
 //------------------------------------------------------------------------------
@@ -215,9 +235,8 @@ void
 String::operator=(const String& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        if (nullptr != this->data) {
+        this->copyBytes(rhs);
+        if (!this->IsLocal()) {
             this->addRef();
         }
     }
@@ -228,24 +247,24 @@ void
 String::operator=(String&& rhs) {
     if (this != &rhs) {
         this->release();
-        this->data = rhs.data;
-        this->strPtr = rhs.strPtr;
-        rhs.data = 0;
-        rhs.strPtr = 0;
+        this->copyBytes(rhs);
+        rhs.setEmpty();
     }
 }
 
 //------------------------------------------------------------------------------
 bool
 String::operator==(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (!this->IsLocal() && !rhs.IsLocal() && (this->data == rhs.data)) {
+        // shared string data
         return true;
     }
-    else if ((nullptr == this->data) || (nullptr == rhs.data)) {
+    const int32 len = this->Length();
+    if (len != rhs.Length()) {
         return false;
     }
     else {
-        return std::strcmp(this->AsCStr(), rhs.AsCStr()) == 0;
+        return std::memcmp(this->AsCStr(), rhs.AsCStr(), len) == 0;
     }
 }
 
@@ -258,7 +277,7 @@ String::operator!=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (!this->IsLocal() && !rhs.IsLocal() && (this->data == rhs.data)) {
         return false;
     }
     else {
@@ -269,7 +288,7 @@ String::operator<(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (!this->IsLocal() && !rhs.IsLocal() && (this->data == rhs.data)) {
         return false;
     }
     else {
@@ -280,7 +299,7 @@ String::operator>(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator<=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (!this->IsLocal() && !rhs.IsLocal() && (this->data == rhs.data)) {
         return true;
     }
     else {
@@ -291,7 +310,7 @@ String::operator<=(const String& rhs) const {
 //------------------------------------------------------------------------------
 bool
 String::operator>=(const String& rhs) const {
-    if (this->data == rhs.data) {
+    if (!this->IsLocal() && !rhs.IsLocal() && (this->data == rhs.data)) {
         return true;
     }
     else {
@@ -299,32 +318,10 @@ String::operator>=(const String& rhs) const {
     }
 }
 
-//------------------------------------------------------------------------------
-int32
-String::Length() const {
-    if (nullptr == this->data) {
-        return 0;
-    }
-    else {
-        return this->data->length;
-    }
-}
-
-//------------------------------------------------------------------------------
-const char*
-String::AsCStr() const {
-    if (nullptr == this->strPtr) {
-        return emptyString;
-    }
-    else {
-        return this->strPtr;
-    }
-}
-
 //------------------------------------------------------------------------------
 std::string
 String::AsStdString() const {
-    return std::string(this->AsCStr());
+    return std::string(this->AsCStr(), this->Length());
 }
 
 //------------------------------------------------------------------------------
@@ -348,8 +345,8 @@ String::Clear() {
 //------------------------------------------------------------------------------
 int32
 String::RefCount() const {
-    if (nullptr == this->data) {
-        return 0;
+    if (this->IsLocal()) {
+        return (0 == this->tag()) ? 0 : 1;
     }
     else {
         return this->data->refCount;
@@ -359,8 +356,9 @@ String::RefCount() const {
 //------------------------------------------------------------------------------
 char
 String::Back() const {
-    if (this->strPtr) {
-        return this->strPtr[this->data->length - 1];
+    const int32 len = this->Length();
+    if (len > 0) {
+        return this->AsCStr()[len - 1];
     }
     else {
         return 0;
@@ -370,12 +368,7 @@ String::Back() const {
 //------------------------------------------------------------------------------
 char
 String::Front() const {
-    if (this->strPtr) {
-        return this->strPtr[0];
-    }
-    else {
-        return 0;
-    }
+    return this->AsCStr()[0];
 }
 
 //------------------------------------------------------------------------------
@@ -4,12 +4,15 @@
     @class Oryol::Core::String
     @brief immutable, reference counted, shared strings
     
-    An immutable, shared UTF-8 String class. Memory is only allocated
-    when creating or assigning from non-String objects (const char*,
-    StringAtoms or std::string). When assigning from another string,
-    only a pointer to the original string data is copied, and a 
-    refcount is maintained. The last String pointing to the string
-    data frees the string data.
+    An immutable, shared UTF-8 String class. Short strings (up to 
+    MaxLocalLength bytes) are stored inside the String object and 
+    never touch the heap, copying a short string copies the
+    characters. Longer strings allocate a shared, refcounted
+    string data block when creating or assigning from non-String 
+    objects (const char*, StringAtoms or std::string). When assigning 
+    from another string, only a pointer to the original string data 
+    is copied, and a refcount is maintained. The last String pointing 
+    to the string data frees the string data.
     
     To manipulate string data, use the StringUtil class.
     
@@ -21,12 +24,19 @@
     (but String::NumChars will return the number of UTF-8 character up to
     the first 0-byte). This is intended behaviour, don't change this!
     
+    The string data is allocated through the thread's allocator
+    (see Memory::SetThreadAllocator()), and freed through the same
+    allocator by the last String pointing to it.
+    
     @see StringBuilder, StringAtom
 */
 #include <atomic>
 #include <string>
+#include <cstring>
 #include "Core/Types.h"
 #include "Core/Assert.h"
+#include "Core/Memory/Allocator.h"
+#include "Core/String/StringView.h"
 
 namespace Oryol {
 namespace Core {
@@ -35,6 +45,9 @@ class StringAtom;
 
 class String {
 public:
+    /// max length of strings which are stored inside the String object
+    static const int32 MaxLocalLength = 22;
+
     /// default constructor
     String();
     /// construct from C string (allocates!)
@@ -47,11 +60,15 @@ public:
     String(const std::string& str);
     /// construct from StringAtom (allocates!)
     String(const StringAtom& str);
+    /// construct from StringView (allocates!)
+    String(const StringView& str);
     
     /// copy constructor (does not allocate)
     String(const String& rhs);
     /// move constructor (does not allocate)
     String(String&& rhs);
+    /// destructor
+    ~String();
     
     /// assign from C string (allocates!)
     void operator=(const char* cstr);
@@ -59,6 +76,8 @@ public:
     void operator=(const std::string& str);
     /// assign from StringAtom (allocates!)
     void operator=(const StringAtom& str);
+    /// assign from StringView (allocates!)
+    void operator=(const StringView& str);
     /// copy-assign from other String (does not allocate)
     void operator=(const String& rhs);
     /// move-assign from other String (does not allocate)
@@ -87,6 +106,8 @@ public:
     std::string AsStdString() const;
     /// get as StringAtom (slow)
     StringAtom AsStringAtom() const;
+    /// get a StringView of the content (fast, only valid while this String is alive)
+    StringView AsStringView() const;
     /// get the last character in the string
     char Back() const;
     /// get the first character in the string
@@ -100,8 +121,10 @@ public:
     bool Empty() const;
     /// clear content
     void Clear();
-    /// get the refcount of this string
+    /// get the refcount of this string (1 for non-empty local strings)
     int32 RefCount() const;
+    /// return true if the string is stored inside the String object
+    bool IsLocal() const;
     
 private:
     /// shared string data header, this is followed by the actual string
@@ -112,9 +135,10 @@ private:
         int32 refCount{0};
         #endif
         int32 length;
+        Allocator* allocator;   // allocator of this data block (nullptr: heap)
     };
     
-    /// create new string data block, numBytes does not include the terminating 0
+    /// create local string or new string data block, numBytes does not include the terminating 0
     void create(const char* ptr, int32 len);
     /// private alloc function for len
     void alloc(int32 len);
@@ -124,12 +148,106 @@ private:
     void addRef();
     /// decrement refcount, call destroy if 0
     void release();
+    /// make this an empty local string (does not release)
+    void setEmpty();
+    /// copy the raw String object bytes from rhs (does not addRef)
+    void copyBytes(const String& rhs);
+    /// get the tag byte (local string length, or HeapTag)
+    uint8 tag() const;
     
-    StringData* data;
-    const char* strPtr;     // direct pointer to string data, necessary to see something in the debugger
-    static const char* emptyString;
+    /// size of the local buffer (MaxLocalLength chars + terminating 0 + tag byte)
+    static const int32 LocalBufSize = MaxLocalLength + 2;
+    /// tag byte value for strings stored in a shared StringData block
+    static const uint8 HeapTag = 0xFF;
+    union {
+        StringData* data;               // if tag byte is HeapTag
+        char localBuf[LocalBufSize];    // string data, the last byte is the tag byte
+    };
 };
 
+//------------------------------------------------------------------------------
+inline uint8
+String::tag() const {
+    return (uint8) this->localBuf[LocalBufSize - 1];
+}
+
+//------------------------------------------------------------------------------
+inline bool
+String::IsLocal() const {
+    return HeapTag != this->tag();
+}
+
+//------------------------------------------------------------------------------
+inline void
+String::setEmpty() {
+    this->localBuf[0] = 0;
+    this->localBuf[LocalBufSize - 1] = 0;
+}
+
+//------------------------------------------------------------------------------
+inline void
+String::copyBytes(const String& rhs) {
+    std::memcpy(this->localBuf, rhs.localBuf, LocalBufSize);
+}
+
+//------------------------------------------------------------------------------
+inline
+String::String() {
+    this->setEmpty();
+}
+
+//------------------------------------------------------------------------------
+inline int32
+String::Length() const {
+    if (this->IsLocal()) {
+        return this->tag();
+    }
+    else {
+        return this->data->length;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+String::AsCStr() const {
+    if (this->IsLocal()) {
+        return this->localBuf;
+    }
+    else {
+        return (const char*) &(this->data[1]);
+    }
+}
+
+//------------------------------------------------------------------------------
+inline StringView
+String::AsStringView() const {
+    return StringView(this->AsCStr(), this->Length());
+}
+
+//------------------------------------------------------------------------------
+inline bool
+operator==(const String& s0, const StringView& s1) {
+    return s0.AsStringView() == s1;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+operator!=(const String& s0, const StringView& s1) {
+    return s0.AsStringView() != s1;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+operator==(const StringView& s0, const String& s1) {
+    return s0 == s1.AsStringView();
+}
+
+//------------------------------------------------------------------------------
+inline bool
+operator!=(const StringView& s0, const String& s1) {
+    return s0 != s1.AsStringView();
+}
+
 //------------------------------------------------------------------------------
 bool operator==(const String& s0, const char* s1);
 bool operator!=(const String& s0, const char* s1);
@@ -10,16 +10,28 @@ namespace Oryol {
 namespace Core {
 const char* StringAtom::emptyString = "";
 
+//------------------------------------------------------------------------------
+/**
+ Like a raw string, a String only counts up to its first 0 byte (the
+ length is known, so this doesn't need a strlen()).
+*/
+static int32
+cStringLength(const String& str) {
+    const char* ptr = str.AsCStr();
+    const char* nul = (const char*) std::memchr(ptr, 0, str.Length());
+    return (nullptr != nul) ? int32(nul - ptr) : str.Length();
+}
+
 //------------------------------------------------------------------------------
 StringAtom::StringAtom(const String& rhs) {
-    this->setupFromCString(rhs.AsCStr());
+    this->setup(rhs.AsCStr(), cStringLength(rhs));
 }
 
 //------------------------------------------------------------------------------
 void
 StringAtom::operator=(const String& rhs) {
     this->Clear();
-    this->setupFromCString(rhs.AsCStr());
+    this->setup(rhs.AsCStr(), cStringLength(rhs));
 }
 
 //------------------------------------------------------------------------------
@@ -35,40 +47,32 @@ StringAtom::AsString() const {
 
 //------------------------------------------------------------------------------
 void
-StringAtom::copy(const StringAtom& rhs) {
-    // check if rhs is from our thread, if yes the copy is quick,
-    // if no we need to transfer it into this thread's string atom table
-    if (rhs.data) {
-        if (rhs.data->table == stringAtomTable::Instance()) {
-            this->data = rhs.data;
-        }
-        else {
-            // rhs is from another thread, need to transfer to this thread
-            this->setupFromCString(rhs.data->str);
-        }
+StringAtom::setupFromCString(const char* str) {
+    if (0 != str) {
+        this->setup(str, int32(std::strlen(str)));
     }
     else {
-        // fallthrough: rhs is invalid
         this->data = nullptr;
     }
 }
 
 //------------------------------------------------------------------------------
 void
-StringAtom::setupFromCString(const char* str) {
+StringAtom::setup(const char* str, int32 len) {
 
-    if ((0 != str) && (str[0] != 0)) {
-        // get my thread-local string atom table
+    if ((0 != str) && (len > 0)) {
+        // get the global string atom table
         stringAtomTable* table = stringAtomTable::Instance();
         
         // get hash of string
-        std::size_t hash = stringAtomTable::HashForString(str);
+        const int32 hash = stringAtomTable::HashForString(str, len);
         
-        // check if string already exists in table
-        this->data = table->Find(hash, str);
+        // check if string already exists in table (lock-free)
+        this->data = table->Find(hash, str, len);
         if (0 == this->data) {
-            // string doesn't exist yet in table, add it
-            this->data = table->Add(hash, str);
+            // string doesn't exist yet in table, add it (this returns
+            // the existing entry if another thread added the same string)
+            this->data = table->Add(hash, str, len);
         }
     }
     else {
@@ -77,37 +81,6 @@ StringAtom::setupFromCString(const char* str) {
     }
 }
 
-//------------------------------------------------------------------------------
-bool
-StringAtom::operator==(const StringAtom& rhs) const {
-
-    if (rhs.data == this->data) {
-        // definitely identical
-        return true;
-    }
-    else if (rhs.data && this->data) {
-        // NOTE: we can compare string atoms from different threads for
-        // equality or inequality, but not for less/greater
-        if (rhs.data->table == this->data->table) {
-            // same thread, and not identical
-            return false;
-        }
-        else if (rhs.data->hash != this->data->hash) {
-            // different threads and hashes differ, definitely different
-            return false;
-        }
-        else {
-            // different threads, same hash, must do string compare
-            return 0 == std::strcmp(this->data->str, rhs.data->str);
-        }
-        return false;
-    }
-    else {
-        // one has data, the other not
-        return false;
-    }
-}
-
 //------------------------------------------------------------------------------
 bool
 StringAtom::operator==(const char* rhs) const {
@@ -5,13 +5,15 @@
     @brief immutable, unique strings for fast comparison
     
     A unique string, relatively slow on creation, but fast for comparison.
-    String atoms are stored in thread-local stringAtomTables and comparison
-    is fastest in the creator thread.
+    String atoms are stored in a global stringAtomTable, so comparing and
+    copying string atoms is a simple pointer operation, also if the
+    string atoms have been created in different threads.
     
     @see String
 */
 #include "Core/Types.h"
 #include "Core/String/stringAtomTable.h"
+#include "Core/String/StringView.h"
 
 namespace Oryol {
 namespace Core {
@@ -22,13 +24,17 @@ class StringAtom {
 public:
     /// default constructor
     StringAtom();
-    /// construct from String
+    /// construct from String (up to the first 0 byte, like a raw string)
     StringAtom(const String& str);
     /// construct from raw string (slow)
     StringAtom(const char* str);
     /// construct from raw string (slow)
     StringAtom(const uchar* str);
-    /// copy-constructor (fast if rhs was created in same thread)
+    /// construct from raw string with length, str doesn't need to be 0-terminated (slow)
+    StringAtom(const char* str, int32 len);
+    /// construct from StringView (slow)
+    StringAtom(const StringView& str);
+    /// copy-constructor (fast)
     StringAtom(const StringAtom& rhs);
     /// move-constructor
     StringAtom(StringAtom&& rhs);
@@ -43,8 +49,10 @@ public:
     void operator=(const char* rhs);
     /// assign raw string (slow)
     void operator=(const uchar* rhs);
-    /// assign from String object (slow)
+    /// assign from String object, up to the first 0 byte (slow)
     void operator=(const String& rhs);
+    /// assign from StringView (slow)
+    void operator=(const StringView& rhs);
     
     /// equality operator (FAST)
     bool operator==(const StringAtom& rhs) const;
@@ -74,16 +82,20 @@ public:
     bool Empty() const;
     /// get length
     int32 Length() const;
+    /// get the string's hash value (0 if empty), for use in hashing containers
+    int32 Hash() const;
     /// get contained c-string
     const char* AsCStr() const;
     /// get String (slow because string object must be constructed)
     String AsString() const;
+    /// get StringView (fast, the view remains valid forever)
+    StringView AsStringView() const;
 
 private:
-    /// copy content
-    void copy(const StringAtom& rhs);
     /// setup from C string
     void setupFromCString(const char* str);
+    /// setup from raw string with length
+    void setup(const char* str, int32 len);
     
     const stringAtomBuffer::Header* data;
     static const char* emptyString;
@@ -116,14 +128,27 @@ StringAtom::StringAtom(const uchar* rhs) {
 
 //------------------------------------------------------------------------------
 inline
-StringAtom::StringAtom(const StringAtom& rhs) {
-    this->copy(rhs);
+StringAtom::StringAtom(const char* str, int32 len) {
+    this->setup(str, len);
 }
 
 //------------------------------------------------------------------------------
 inline
-StringAtom::StringAtom(StringAtom&& rhs) {
-    this->copy(rhs);
+StringAtom::StringAtom(const StringView& str) {
+    this->setup(str.Ptr(), str.Length());
+}
+
+//------------------------------------------------------------------------------
+inline
+StringAtom::StringAtom(const StringAtom& rhs) :
+data(rhs.data) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringAtom::StringAtom(StringAtom&& rhs) :
+data(rhs.data) {
     rhs.data = nullptr;
 }
 
@@ -136,18 +161,14 @@ StringAtom::~StringAtom() {
 //------------------------------------------------------------------------------
 inline void
 StringAtom::operator=(const StringAtom& rhs) {
-    if (&rhs != this) {
-        this->Clear();
-        this->copy(rhs);
-    }
+    this->data = rhs.data;
 }
 
 //------------------------------------------------------------------------------
 inline void
 StringAtom::operator=(StringAtom&& rhs) {
     if (&rhs != this) {
-        this->Clear();
-        this->copy(rhs);
+        this->data = rhs.data;
         rhs.data = nullptr;
     }
 }
@@ -166,19 +187,28 @@ StringAtom::operator=(const uchar* rhs) {
     this->setupFromCString((const char*)rhs);
 }
 
+//------------------------------------------------------------------------------
+inline void
+StringAtom::operator=(const StringView& rhs) {
+    this->Clear();
+    this->setup(rhs.Ptr(), rhs.Length());
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringAtom::operator==(const StringAtom& rhs) const {
+    return this->data == rhs.data;
+}
+
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator!=(const StringAtom& rhs) const {
-    return !operator==(rhs);
+    return this->data != rhs.data;
 }
 
 //------------------------------------------------------------------------------
 inline bool
 StringAtom::operator<(const StringAtom& rhs) const {
-    if (rhs.data && this->data) {
-        // it is forbidden to compare string from different threads!
-        o_assert(this->data->table == rhs.data->table);
-    }
     return this->data < rhs.data;
 }
 
@@ -217,6 +247,17 @@ StringAtom::Length() const {
     }
 }
 
+//------------------------------------------------------------------------------
+inline int32
+StringAtom::Hash() const {
+    if (nullptr != this->data) {
+        return this->data->hash;
+    }
+    else {
+        return 0;
+    }
+}
+
 //------------------------------------------------------------------------------
 inline const char*
 StringAtom::AsCStr() const {
@@ -228,5 +269,16 @@ StringAtom::AsCStr() const {
     }
 }
 
+//------------------------------------------------------------------------------
+inline StringView
+StringAtom::AsStringView() const {
+    if (nullptr != this->data) {
+        return StringView(this->data->str, this->data->length);
+    }
+    else {
+        return StringView();
+    }
+}
+
 } // namespace Core
 } // namespace Oryol
@@ -150,6 +150,27 @@ StringBuilder::GetSubString(int32 startIndex, int32 endIndex) const {
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+ Returns a view into the builder's buffer, the view becomes invalid
+ when the builder content is modified or the builder is destroyed.
+*/
+StringView
+StringBuilder::GetSubView(int32 startIndex, int32 endIndex) const {
+    return this->AsStringView().GetSubView(startIndex, endIndex);
+}
+
+//------------------------------------------------------------------------------
+StringView
+StringBuilder::AsStringView() const {
+    if (this->buffer) {
+        return StringView(this->buffer, this->size);
+    }
+    else {
+        return StringView();
+    }
+}
+
 //------------------------------------------------------------------------------
 const char*
 StringBuilder::AsCStr() const {
@@ -240,6 +261,19 @@ StringBuilder::Set(const String& str, int32 startIndex, int32 endIndex) {
     this->Append(str, startIndex, endIndex);
 }
 
+//------------------------------------------------------------------------------
+void
+StringBuilder::Append(const StringView& str) {
+    this->Append(str.Ptr(), 0, str.Length());
+}
+
+//------------------------------------------------------------------------------
+void
+StringBuilder::Set(const StringView& str) {
+    this->Clear();
+    this->Append(str);
+}
+
 //------------------------------------------------------------------------------
 void
 StringBuilder::Append(std::initializer_list<String> list) {
@@ -431,6 +465,18 @@ StringBuilder::FindFirstOf(const char* str, int32 startIndex, int32 endIndex, co
     return findFirstOf(str, strLen, startIndex, endIndex, delims);
 }
 
+//------------------------------------------------------------------------------
+/**
+ Find index of first occurrence of any characters in delim in a string view,
+ between startIndex (including) and endIndex (excluding). If endIndex is 
+ EndOfString, search until end of view. Returns InvalidIndex if not found.
+*/
+int32
+StringBuilder::FindFirstOf(const StringView& str, int32 startIndex, int32 endIndex, const char* delims) {
+    o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
+    return str.FindFirstOf(startIndex, endIndex, delims);
+}
+
 //------------------------------------------------------------------------------
 /**
  Find index of first occurrence of any characters in delim, between startIndex
@@ -474,9 +520,9 @@ int32
 StringBuilder::FindFirstNotOf(const char* str, int32 startIndex, int32 endIndex, const char* delims) {
     o_assert(0 != delims);
     o_assert(str);
-    o_assert((EndOfString != endIndex) || (endIndex >= startIndex));
+    o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
     const int32 strLen = std::strlen(str);
-    return findFirstOf(str, strLen, startIndex, endIndex, delims);
+    return findFirstNotOf(str, strLen, startIndex, endIndex, delims);
 }
 
 //------------------------------------------------------------------------------
@@ -530,6 +576,18 @@ StringBuilder::FindSubString(const char* str, int32 startIndex, int32 endIndex,
     o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
     return findSubString(str, startIndex, endIndex, subStr);
 }
+
+//------------------------------------------------------------------------------
+/**
+ Find first occurrence of subStr in a string view, starting between startIndex 
+ (including) and endIndex (excluding). If endIndex is EndOfString, search until
+ end of view. Returns InvalidIndex if not found.
+*/
+int32
+StringBuilder::FindSubString(const StringView& str, int32 startIndex, int32 endIndex, const StringView& subStr) {
+    o_assert((EndOfString == endIndex) || (endIndex >= startIndex));
+    return str.FindSubString(startIndex, endIndex, subStr);
+}
     
 //------------------------------------------------------------------------------
 /**
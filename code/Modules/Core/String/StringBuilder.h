@@ -46,8 +46,12 @@ public:
     String GetString() const;
     /// get a substring, if endIndex can be EndOfString
     String GetSubString(int32 startIndex, int32 endIndex) const;
+    /// get a view to a substring (doesn't allocate, invalid after the builder is modified), endIndex can be EndOfString
+    StringView GetSubView(int32 startIndex, int32 endIndex) const;
     /// get content as raw C string
     const char* AsCStr() const;
+    /// get content as StringView (doesn't allocate, invalid after the builder is modified)
+    StringView AsStringView() const;
     
     /// printf-style formatting, max string length must be provided, returns false if resulting string is too long
     bool Format(int32 maxLength, const char* fmt, ...) __attribute__((format(printf, 3, 4)));
@@ -60,6 +64,8 @@ public:
     void Set(const String& str);
     /// (re)set to range from string, endIndex can be EndOfString
     void Set(const String& str, int32 startIndex, int32 endIndex);
+    /// (re)set to string view
+    void Set(const StringView& str);
     /// (re)set to a list of strings
     void Set(std::initializer_list<String> list);
     /// (re)set to a list of strings with delimiter
@@ -75,6 +81,8 @@ public:
     void Append(const String& str);
     /// append range from string, if endIndex can be EndOfString
     void Append(const String& str, int32 startIndex, int32 endIndex);
+    /// append string view
+    void Append(const StringView& str);
     /// append a list of strings
     void Append(std::initializer_list<String> list);
     /// append a list of strings with delimiter
@@ -95,6 +103,8 @@ public:
     int32 FindFirstOf(int32 startIndex, int32 endIndex, const char* delims) const;
     /// find byte-index of first occurrence of delim chars, return EndOfString if not found
     static int32 FindFirstOf(const char* str, int32 startIndex, int32 endIndex, const char* delims);
+    /// find byte-index of first occurrence of delim chars in a string view, return EndOfString if not found
+    static int32 FindFirstOf(const StringView& str, int32 startIndex, int32 endIndex, const char* delims);
     /// find byte-index of first occurrence not in delim chars, return EndOfString if not found
     int32 FindFirstNotOf(int32 startIndex, int32 endIndex, const char* delims) const;
     /// find byte-index of first occurrence not in delim chars, return EndOfString if not found
@@ -103,6 +113,8 @@ public:
     int32 FindSubString(int32 startIndex, int32 endIndex, const char* subString) const;
     /// find substring index, endIndex can be EndOfString, return EndOfString if not found
     static int32 FindSubString(const char* str, int32 startIndex, int32 endIndex, const char* subString);
+    /// find substring index in a string view, endIndex can be EndOfString, return EndOfString if not found
+    static int32 FindSubString(const StringView& str, int32 startIndex, int32 endIndex, const StringView& subString);
     /// test if contains a substring
     bool Contains(const char* str);
 
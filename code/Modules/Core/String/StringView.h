@@ -0,0 +1,284 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::StringView
+    @brief non-owning view into a range of string data
+
+    A StringView is a pointer and a length into string data owned by
+    someone else (a String, StringAtom, StringBuilder or a raw character
+    buffer). Creating, copying and inspecting a StringView never
+    allocates, but the view is only valid as long as the viewed
+    string data is alive and unchanged. The viewed data doesn't
+    need to be 0-terminated, so don't pass Ptr() to functions
+    expecting a C string.
+
+    Views into StringAtoms are always valid, since the string atom
+    table is never destroyed.
+
+    @see String, StringAtom, StringBuilder
+*/
+#include <cstring>
+#include "Core/Types.h"
+#include "Core/Assert.h"
+
+namespace Oryol {
+namespace Core {
+
+class StringView {
+public:
+    /// default constructor (empty view)
+    StringView();
+    /// construct from 0-terminated C string (nullptr is allowed)
+    StringView(const char* str);
+    /// construct from pointer and length
+    StringView(const char* ptr, int32 len);
+
+    /// equality operator
+    bool operator==(const StringView& rhs) const;
+    /// inequality operator
+    bool operator!=(const StringView& rhs) const;
+    /// get character at index
+    char operator[](int32 index) const;
+
+    /// get pointer to first character (NOT 0-terminated!)
+    const char* Ptr() const;
+    /// get length in number of bytes
+    int32 Length() const;
+    /// return true if not empty
+    bool IsValid() const;
+    /// return true if empty
+    bool Empty() const;
+    /// get the first character (0 if empty)
+    char Front() const;
+    /// get the last character (0 if empty)
+    char Back() const;
+
+    /// get a view to a range of this view, endIndex can be EndOfString
+    StringView GetSubView(int32 startIndex, int32 endIndex) const;
+    /// get a view with the characters in chars removed from both ends
+    StringView Trim(const char* chars) const;
+    /// find byte-index of first occurrence of delim chars, return EndOfString if not found
+    int32 FindFirstOf(int32 startIndex, int32 endIndex, const char* delims) const;
+    /// find byte-index of first occurrence not in delim chars, return EndOfString if not found
+    int32 FindFirstNotOf(int32 startIndex, int32 endIndex, const char* delims) const;
+    /// find substring index, endIndex can be EndOfString, return EndOfString if not found
+    int32 FindSubString(int32 startIndex, int32 endIndex, const StringView& subString) const;
+    /// test if the view starts with a string
+    bool StartsWith(const StringView& str) const;
+
+private:
+    /// clamp endIndex to the view's length
+    int32 clampEndIndex(int32 endIndex) const;
+
+    const char* ptr;
+    int32 len;
+};
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView() :
+ptr(""),
+len(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const char* str) {
+    if (nullptr != str) {
+        this->ptr = str;
+        this->len = std::strlen(str);
+    }
+    else {
+        this->ptr = "";
+        this->len = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+inline
+StringView::StringView(const char* str, int32 length) :
+ptr(str),
+len(length) {
+    o_assert((nullptr != str) && (length >= 0));
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::operator==(const StringView& rhs) const {
+    return (this->len == rhs.len) && (0 == std::memcmp(this->ptr, rhs.ptr, this->len));
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::operator!=(const StringView& rhs) const {
+    return !this->operator==(rhs);
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::operator[](int32 index) const {
+    o_assert((index >= 0) && (index < this->len));
+    return this->ptr[index];
+}
+
+//------------------------------------------------------------------------------
+inline const char*
+StringView::Ptr() const {
+    return this->ptr;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+StringView::Length() const {
+    return this->len;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::IsValid() const {
+    return this->len > 0;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::Empty() const {
+    return 0 == this->len;
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::Front() const {
+    return (this->len > 0) ? this->ptr[0] : 0;
+}
+
+//------------------------------------------------------------------------------
+inline char
+StringView::Back() const {
+    return (this->len > 0) ? this->ptr[this->len - 1] : 0;
+}
+
+//------------------------------------------------------------------------------
+inline int32
+StringView::clampEndIndex(int32 endIndex) const {
+    return ((EndOfString == endIndex) || (endIndex > this->len)) ? this->len : endIndex;
+}
+
+//------------------------------------------------------------------------------
+inline StringView
+StringView::GetSubView(int32 startIndex, int32 endIndex) const {
+    if (EndOfString == endIndex) {
+        endIndex = this->len;
+    }
+    o_assert((startIndex >= 0) && (startIndex <= endIndex) && (endIndex <= this->len));
+    return StringView(this->ptr + startIndex, endIndex - startIndex);
+}
+
+//------------------------------------------------------------------------------
+inline StringView
+StringView::Trim(const char* chars) const {
+    o_assert(nullptr != chars);
+    int32 startIndex = 0;
+    int32 endIndex = this->len;
+    while ((startIndex < endIndex) && (0 != this->ptr[startIndex]) && std::strchr(chars, this->ptr[startIndex])) {
+        startIndex++;
+    }
+    while ((endIndex > startIndex) && (0 != this->ptr[endIndex - 1]) && std::strchr(chars, this->ptr[endIndex - 1])) {
+        endIndex--;
+    }
+    return StringView(this->ptr + startIndex, endIndex - startIndex);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Find index of first occurrence of any characters in delims, between startIndex
+ (including) and endIndex (excluding). If endIndex is EndOfString, search until
+ end of view. Returns InvalidIndex if not found.
+*/
+inline int32
+StringView::FindFirstOf(int32 startIndex, int32 endIndex, const char* delims) const {
+    o_assert((nullptr != delims) && (startIndex >= 0));
+    endIndex = this->clampEndIndex(endIndex);
+    for (int32 i = startIndex; i < endIndex; i++) {
+        // NOTE: strchr would also match the terminating 0 of delims
+        if ((0 != this->ptr[i]) && std::strchr(delims, this->ptr[i])) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Find index of first occurrence of any characters NOT in delims, between startIndex
+ (including) and endIndex (excluding). If endIndex is EndOfString, search until
+ end of view. Returns InvalidIndex if not found.
+*/
+inline int32
+StringView::FindFirstNotOf(int32 startIndex, int32 endIndex, const char* delims) const {
+    o_assert((nullptr != delims) && (startIndex >= 0));
+    endIndex = this->clampEndIndex(endIndex);
+    for (int32 i = startIndex; i < endIndex; i++) {
+        if ((0 == this->ptr[i]) || !std::strchr(delims, this->ptr[i])) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Find first occurrence of subString starting between startIndex (including)
+ and endIndex (excluding), the subString must be completely inside the view.
+ If endIndex is EndOfString, search until end of view. Returns InvalidIndex
+ if not found.
+*/
+inline int32
+StringView::FindSubString(int32 startIndex, int32 endIndex, const StringView& subString) const {
+    o_assert((startIndex >= 0) && subString.IsValid());
+    endIndex = this->clampEndIndex(endIndex);
+    const int32 lastIndex = this->len - subString.len;
+    if (endIndex > lastIndex + 1) {
+        endIndex = lastIndex + 1;
+    }
+    const char first = subString.ptr[0];
+    for (int32 i = startIndex; i < endIndex; i++) {
+        if ((first == this->ptr[i]) && (0 == std::memcmp(this->ptr + i, subString.ptr, subString.len))) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+StringView::StartsWith(const StringView& str) const {
+    return (this->len >= str.len) && (0 == std::memcmp(this->ptr, str.ptr, str.len));
+}
+
+//------------------------------------------------------------------------------
+inline bool
+operator==(const StringView& s0, const char* s1) {
+    return s0 == StringView(s1);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+operator!=(const StringView& s0, const char* s1) {
+    return s0 != StringView(s1);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+operator==(const char* s0, const StringView& s1) {
+    return StringView(s0) == s1;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+operator!=(const char* s0, const StringView& s1) {
+    return StringView(s0) != s1;
+}
+
+} // namespace Core
+} // namespace Oryol
@@ -30,8 +30,7 @@ stringAtomBuffer::allocChunk() {
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomBuffer::AddString(stringAtomTable* table, int32 hash, const char* str) {
-    o_assert(nullptr != table);
+stringAtomBuffer::AddString(int32 hash, const char* str, int32 strLen) {
     o_assert(nullptr != str);
     
     // no chunks allocated yet?
@@ -40,7 +39,6 @@ stringAtomBuffer::AddString(stringAtomTable* table, int32 hash, const char* str)
     }
     
     // compute length of new entry (header + string len + 0 terminator byte)
-    const int32 strLen = std::strlen(str);
     size_t requiredSize = strLen + sizeof(Header) + 1;
     o_assert(requiredSize < this->chunkSize);
     
@@ -51,11 +49,11 @@ stringAtomBuffer::AddString(stringAtomTable* table, int32 hash, const char* str)
     
     // copy over data
     Header* head = (Header*) this->curPointer;
-    head->table = table;
     head->hash = hash;
     head->length  = strLen;
     head->str  = (char*) this->curPointer + sizeof(Header);
-    std::strcpy((char*)head->str, str);
+    std::memcpy((char*)head->str, str, strLen);
+    ((char*)head->str)[strLen] = 0;
     
     // set curPointer to the next aligned position
     this->curPointer = (int8*) Memory::Align(this->curPointer + requiredSize, sizeof(Header));
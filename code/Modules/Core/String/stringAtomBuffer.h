@@ -4,6 +4,7 @@
     private class, do not use
     
     A growable buffer for raw string data for the StringAtom system.
+    Not thread-safe, the stringAtomTable guards each buffer with a lock.
 */
 #include "Core/Types.h"
 #include "Core/Containers/Array.h"
@@ -11,18 +12,15 @@
 namespace Oryol {
 namespace Core {
 
-class stringAtomTable;
-
 class stringAtomBuffer {
 public:
     // header data for a single entry (string data starts at end of header)
     struct Header {
         // default constructor
-        Header() : table(0), hash(0), length(0), str(0) { };
+        Header() : hash(0), length(0), str(0) { };
         /// constructor
-        Header(const stringAtomTable* t, int32 hsh, int32 len, const char* s) : table(t), hash(hsh), length(len), str(s) { };
+        Header(int32 hsh, int32 len, const char* s) : hash(hsh), length(len), str(s) { };
     
-        const stringAtomTable* table;
         int32 hash;
         int32 length;
         const char* str;
@@ -31,8 +29,8 @@ public:
     /// destructor
     ~stringAtomBuffer();
     
-    /// add a new string to the buffer, return pointer to start of header
-    const Header* AddString(stringAtomTable* table, int32 hash, const char* str);
+    /// add a new string with length to the buffer, return pointer to start of header
+    const Header* AddString(int32 hash, const char* str, int32 len);
     
 private:
     /// allocate a new chunk
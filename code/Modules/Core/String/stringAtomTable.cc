@@ -3,106 +3,189 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include <cstring>
+#include <new>
 #include "stringAtomTable.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Assert.h"
 
 namespace Oryol {
 namespace Core {
 
-OryolLocalSingletonImpl(stringAtomTable);
-
 //------------------------------------------------------------------------------
 stringAtomTable::stringAtomTable() {
-    
-    SingletonEnsureUnique();
+    // empty
+}
+
+//------------------------------------------------------------------------------
+stringAtomTable::~stringAtomTable() {
+    for (stripe& s : this->stripes) {
+        slotArray* array = s.slots.load(std::memory_order_relaxed);
+        while (nullptr != array) {
+            slotArray* prev = array->prev;
+            Memory::Free(array);
+            array = prev;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+stringAtomTable*
+stringAtomTable::Instance() {
+    // created on first use (thread-safe static initialization), never
+    // destroyed; the table must not capture a thread's allocator,
+    // since its memory must outlive any allocator
+    static stringAtomTable* table = [] {
+        Allocator* prevAllocator = Memory::SetThreadAllocator(nullptr);
+        stringAtomTable* t = new stringAtomTable();
+        Memory::SetThreadAllocator(prevAllocator);
+        return t;
+    }();
+    return table;
+}
+
+//------------------------------------------------------------------------------
+int32
+stringAtomTable::stripeIndex(int32 hash) {
+    // the lower bits select the slot, so use the upper bits for the stripe
+    return int32(uint32(hash) >> 27) & (NumStripes - 1);
 }
 
 //------------------------------------------------------------------------------
 const stringAtomBuffer::Header*
-stringAtomTable::Find(int32 hash, const char* str) const {
-    
-    // need to create a temp object for searching in the set
-    stringAtomBuffer::Header dummyHead(this, hash, 0, str);
-    Entry dummyEntry(&dummyHead);
-    auto ptr = this->table.Find(dummyEntry);
-    if (nullptr == ptr) {
-        return nullptr;
+stringAtomTable::findInSlots(const slotArray* array, int32 hash, const char* str, int32 len) {
+    const uint32 mask = array->mask;
+    for (uint32 i = uint32(hash) & mask; ; i = (i + 1) & mask) {
+        const stringAtomBuffer::Header* header = array->slots[i].load(std::memory_order_acquire);
+        if (nullptr == header) {
+            return nullptr;
+        }
+        // only compare the string data if hash and length match
+        if ((header->hash == hash) && (header->length == len) && (0 == std::memcmp(header->str, str, len))) {
+            return header;
+        }
     }
-    else {
-        o_assert(nullptr != ptr->header);
-        return ptr->header;
+}
+
+//------------------------------------------------------------------------------
+void
+stringAtomTable::insertIntoSlots(slotArray* array, const stringAtomBuffer::Header* header) {
+    const uint32 mask = array->mask;
+    for (uint32 i = uint32(header->hash) & mask; ; i = (i + 1) & mask) {
+        if (nullptr == array->slots[i].load(std::memory_order_relaxed)) {
+            array->slots[i].store(header, std::memory_order_release);
+            return;
+        }
     }
 }
 
 //------------------------------------------------------------------------------
-const stringAtomBuffer::Header*
-stringAtomTable::Add(int32 hash, const char* str) {
-    
-    #if ORYOL_DEBUG
-    o_assert(nullptr == this->Find(hash, str));
-    #endif
-    
-    // add new string to the string buffer
-    const stringAtomBuffer::Header* newHeader = this->buffer.AddString(this, hash, str);
-    o_assert(nullptr != newHeader);
-    
-    // add new entry to our lookup table
-    this->table.Insert(Entry(newHeader));
-    return newHeader;
+stringAtomTable::slotArray*
+stringAtomTable::allocSlots(int32 capacity) {
+    o_assert((capacity > 0) && (0 == (capacity & (capacity - 1))));
+    const int32 size = sizeof(slotArray) + (capacity - 1) * sizeof(std::atomic<const stringAtomBuffer::Header*>);
+    slotArray* array = (slotArray*) Memory::Alloc(size);
+    array->prev = nullptr;
+    array->mask = uint32(capacity - 1);
+    for (int32 i = 0; i < capacity; i++) {
+        new(&array->slots[i]) std::atomic<const stringAtomBuffer::Header*>(nullptr);
+    }
+    return array;
 }
 
 //------------------------------------------------------------------------------
-int32
-stringAtomTable::HashForString(const char* str) {
-
-    // see here: http://eternallyconfuzzled.com/tuts/algorithms/jsw_tut_hashing.aspx
-    const char* p = str;
-    int32 h = 0;
-    char c;
-    while (0 != (c = *p++))
-    {
-        h += c;
-        h += (h << 10);
-        h ^= (h >> 6);
+stringAtomTable::slotArray*
+stringAtomTable::grow(stripe& s) {
+    slotArray* oldArray = s.slots.load(std::memory_order_relaxed);
+    const int32 newCapacity = oldArray ? int32(oldArray->mask + 1) * 2 : 256;
+    slotArray* newArray = allocSlots(newCapacity);
+    if (nullptr != oldArray) {
+        for (uint32 i = 0; i <= oldArray->mask; i++) {
+            const stringAtomBuffer::Header* header = oldArray->slots[i].load(std::memory_order_relaxed);
+            if (nullptr != header) {
+                insertIntoSlots(newArray, header);
+            }
+        }
     }
-    h += (h << 3);
-    h ^= (h >> 11);
-    h += (h << 15);
-    return h;
+    newArray->prev = oldArray;
+    s.slots.store(newArray, std::memory_order_release);
+    return newArray;
 }
 
 //------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator==(const Entry& rhs) const {
+const stringAtomBuffer::Header*
+stringAtomTable::Find(int32 hash, const char* str, int32 len) const {
+    o_assert_dbg(nullptr != str);
+    const stripe& s = this->stripes[stripeIndex(hash)];
+    const slotArray* array = s.slots.load(std::memory_order_acquire);
+    if (nullptr == array) {
+        return nullptr;
+    }
+    return findInSlots(array, hash, str, len);
+}
 
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
+//------------------------------------------------------------------------------
+const stringAtomBuffer::Header*
+stringAtomTable::Add(int32 hash, const char* str, int32 len) {
+    o_assert_dbg(nullptr != str);
+    stripe& s = this->stripes[stripeIndex(hash)];
+    #if ORYOL_HAS_THREADS
+    std::lock_guard<std::mutex> lock(s.lock);
     #endif
-    
-    if (this->header->hash != rhs.header->hash) {
-        // if hashes differ, the entries are definitely not equal
-        return false;
+
+    // another thread may have added the string in the meantime
+    slotArray* array = s.slots.load(std::memory_order_relaxed);
+    if (nullptr != array) {
+        const stringAtomBuffer::Header* header = findInSlots(array, hash, str, len);
+        if (nullptr != header) {
+            return header;
+        }
     }
-    else {
-        // if hashes are identical, need to do a strcmp
-        return (0 == std::strcmp(this->header->str, rhs.header->str));
+
+    // keep the load factor below 1/2
+    if ((nullptr == array) || (uint32(s.numEntries + 1) * 2 > (array->mask + 1))) {
+        array = grow(s);
     }
+    
+    // add new string to the string buffer and publish it
+    const stringAtomBuffer::Header* newHeader = s.buffer.AddString(hash, str, len);
+    o_assert(nullptr != newHeader);
+    insertIntoSlots(array, newHeader);
+    s.numEntries++;
+    return newHeader;
 }
 
 //------------------------------------------------------------------------------
-bool
-stringAtomTable::Entry::operator<(const Entry& rhs) const {
-        
-    #if ORYOL_DEBUG
-    o_assert(this->header != 0 && rhs.header != 0);
-    o_assert(this->header->hash != 0 && rhs.header->hash != 0);
-    o_assert(this->header->str != 0 && rhs.header->str != 0);
-    #endif
-    return std::strcmp(this->header->str, rhs.header->str) < 0;
+int32
+stringAtomTable::HashForString(const char* str, int32 len) {
+
+    // word-at-a-time multiply/xorshift hash: consumes 8 bytes per
+    // step, the tail is loaded as a zero-padded partial word, the
+    // final mix is the splitmix64 finalizer, so that both the upper
+    // bits (stripe index) and lower bits (slot index) are well distributed
+    o_assert_dbg((nullptr != str) && (len >= 0));
+    const uint8* p = (const uint8*) str;
+    uint64 h = 0x9E3779B97F4A7C15ULL ^ (uint64(len) * 0xFF51AFD7ED558CCDULL);
+    uint64 word;
+    while (len >= 8) {
+        std::memcpy(&word, p, 8);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+        p += 8;
+        len -= 8;
+    }
+    if (len > 0) {
+        word = 0;
+        std::memcpy(&word, p, len);
+        h = (h ^ word) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 31;
+    }
+    h ^= h >> 30;
+    h *= 0xBF58476D1CE4E5B9ULL;
+    h ^= h >> 27;
+    h *= 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return int32(uint32(h ^ (h >> 32)));
 }
 
 } // namespace Core
 } // namespace Oryol
-
-
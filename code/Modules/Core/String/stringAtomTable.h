@@ -3,54 +3,85 @@
 /*
     private class, do not use
     
-    A thread-local StringAtom table.
+    The global StringAtom table. Each string is interned once per
+    process, so StringAtoms can be compared by pointer, also across
+    threads.
+
+    The table is split into NumStripes stripes selected by the
+    string hash. Each stripe owns a stringAtomBuffer and an
+    open-addressing array of header pointers. Entries are never
+    removed or modified after they are published, so lookups are
+    lock-free. Insertion takes the stripe's lock, looks up again,
+    copies the string into the stripe's buffer and publishes the new
+    header. When a slot array is grown, the new array is published
+    with an atomic pointer swap, the old array is kept alive since
+    other threads may still probe it (a lookup which misses in an
+    old array falls through to the locked insert path, which looks
+    up again in the current array).
+
+    The table is created on first use and never destroyed, so that
+    StringAtom data pointers stay valid until the process ends.
 */
+#include <atomic>
 #include "Core/Types.h"
+#include "Core/Config.h"
 #include "Core/String/stringAtomBuffer.h"
-#include "Core/Macros.h"
-#include "Core/Containers/HashSet.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
 
 namespace Oryol {
 namespace Core {
 
 class stringAtomTable {
-    OryolLocalSingletonDecl(stringAtomTable);
 public:
+    /// number of stripes (must be 2^N)
+    static const int32 NumStripes = 32;
+
+    /// get the global string atom table
+    static stringAtomTable* Instance();
+    /// compute hash value for string with length
+    static int32 HashForString(const char* str, int32 len);
+    /// find a matching buffer header in the table (lock-free)
+    const stringAtomBuffer::Header* Find(int32 hash, const char* str, int32 len) const;
+    /// add a string to the atom table, returns existing header if another thread was faster
+    const stringAtomBuffer::Header* Add(int32 hash, const char* str, int32 len);
+
+private:
     /// constructor
     stringAtomTable();
     /// destructor
     ~stringAtomTable();
-    
-    /// compute hash value for string
-    static int32 HashForString(const char* str);
-    /// find a matching buffer header in the table
-    const stringAtomBuffer::Header* Find(int32 hash, const char* str) const;
-    /// add a string to the atom table
-    const stringAtomBuffer::Header* Add(int32 hash, const char* str);
 
-private:
-    /// a bucket entry
-    struct Entry {
-        /// default constructor
-        Entry() : header(0) { };
-        /// constructor with header ptr
-        Entry(const stringAtomBuffer::Header* h) : header(h) { };
-        /// equality operator
-        bool operator==(const Entry& rhs) const;
-        /// less-then operator
-        bool operator<(const Entry& rhs) const;
-        
-        const stringAtomBuffer::Header* header;
+    /// an open-addressing array of header pointers
+    struct slotArray {
+        slotArray* prev;        // retired arrays are kept alive
+        uint32 mask;
+        std::atomic<const stringAtomBuffer::Header*> slots[1];
     };
-    
-    /// hash function for bucket entry
-    struct Hasher {
-        int32 operator()(const Entry& e) const {
-            return e.header->hash;
-        };
+    /// one stripe of the table
+    struct stripe {
+        stripe() : slots(nullptr), numEntries(0) { };
+        std::atomic<slotArray*> slots;
+        int32 numEntries;
+        #if ORYOL_HAS_THREADS
+        std::mutex lock;
+        #endif
+        stringAtomBuffer buffer;
     };
-    stringAtomBuffer buffer;
-    Core::HashSet<Entry, Hasher, 1024> table;
+
+    /// get stripe index from hash
+    static int32 stripeIndex(int32 hash);
+    /// find header in a slot array
+    static const stringAtomBuffer::Header* findInSlots(const slotArray* array, int32 hash, const char* str, int32 len);
+    /// store header in first free slot (array must not be full)
+    static void insertIntoSlots(slotArray* array, const stringAtomBuffer::Header* header);
+    /// allocate a new slot array with capacity (must be 2^N)
+    static slotArray* allocSlots(int32 capacity);
+    /// grow the slot array of a stripe, must be called with the stripe locked
+    static slotArray* grow(stripe& s);
+
+    stripe stripes[NumStripes];
 };
 
 } // namespace Core
@@ -0,0 +1,83 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::JobCounter
+    @brief counts the unfinished jobs of a group of jobs
+
+    Pass a JobCounter to JobSystem::Run() to track a group of jobs:
+    the counter is incremented when a job is started, and decremented
+    when the job has finished. JobSystem::Wait() waits until the counter
+    reaches 0, and JobSystem::RunAfter() starts a job only after a counter
+    has reached 0, which is how dependencies between jobs are expressed.
+
+    A JobCounter must outlive all jobs which reference it, it
+    is not copyable and not movable.
+
+    @see JobSystem
+*/
+#include <atomic>
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace Core {
+
+struct job;
+
+class JobCounter {
+public:
+    /// constructor
+    JobCounter();
+    /// destructor
+    ~JobCounter();
+
+    /// get the current number of unfinished jobs
+    int32 Get() const;
+    /// return true if all jobs have finished
+    bool IsDone() const;
+
+private:
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    friend class JobSystem;
+    std::atomic<int32> count;
+    #if ORYOL_HAS_THREADS
+    std::mutex waitLock;
+    #endif
+    job* waitingJobs;       // jobs which are started when count reaches 0
+};
+
+//------------------------------------------------------------------------------
+inline
+JobCounter::JobCounter() :
+count(0),
+waitingJobs(nullptr) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+inline
+JobCounter::~JobCounter() {
+    o_assert(0 == this->count.load(std::memory_order_acquire));
+    o_assert(nullptr == this->waitingJobs);
+}
+
+//------------------------------------------------------------------------------
+inline int32
+JobCounter::Get() const {
+    return this->count.load(std::memory_order_acquire);
+}
+
+//------------------------------------------------------------------------------
+inline bool
+JobCounter::IsDone() const {
+    return 0 == this->count.load(std::memory_order_acquire);
+}
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------------
+//  JobSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "JobSystem.h"
+#include "Core/CoreFacade.h"
+
+namespace Oryol {
+namespace Core {
+
+OryolGlobalSingletonImpl(JobSystem);
+
+ORYOL_THREAD_LOCAL int32 JobSystem::threadIndex = InvalidIndex;
+ORYOL_THREAD_LOCAL uint32 JobSystem::stealIndex = 0;
+
+//------------------------------------------------------------------------------
+JobSystem::JobSystem(int32 numWorkers_) :
+numWorkers(numWorkers_)
+#if ORYOL_HAS_THREADS
+,
+numInjected(0),
+numQueuedJobs(0),
+numSleeping(0),
+stopRequested(false)
+#endif
+{
+    this->SingletonEnsureUnique();
+    #if ORYOL_HAS_THREADS
+    // only one JobSystem per creating thread, and not from inside a job
+    o_assert(InvalidIndex == threadIndex);
+    if (this->numWorkers <= 0) {
+        const int32 numHwThreads = std::thread::hardware_concurrency();
+        this->numWorkers = (numHwThreads > 1) ? (numHwThreads - 1) : 1;
+    }
+
+    // one deque for the creating thread, and one per worker
+    this->deques.Reserve(this->numWorkers + 1);
+    for (int32 i = 0; i <= this->numWorkers; i++) {
+        jobDeque<job>* deque = new jobDeque<job>();
+        deque->setup(DequeCapacity);
+        this->deques.AddBack(deque);
+    }
+    threadIndex = 0;
+    this->threads.Reserve(this->numWorkers);
+    for (int32 i = 0; i < this->numWorkers; i++) {
+        this->threads.AddBack(std::thread(&JobSystem::workerLoop, this, i + 1));
+    }
+    #else
+    this->numWorkers = 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+JobSystem::~JobSystem() {
+    #if ORYOL_HAS_THREADS
+    o_assert(0 == threadIndex);
+    {
+        std::lock_guard<std::mutex> lock(this->sleepLock);
+        this->stopRequested = true;
+    }
+    this->wakeup.notify_all();
+    for (std::thread& thread : this->threads) {
+        thread.join();
+    }
+    this->threads.Clear();
+
+    // discard jobs which never ran (RunAfter() jobs are owned by their counter)
+    job* j = nullptr;
+    while (nullptr != (j = this->findJob())) {
+        this->jobPool.Destroy(j);
+    }
+    for (jobDeque<job>* deque : this->deques) {
+        delete deque;
+    }
+    this->deques.Clear();
+    threadIndex = InvalidIndex;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int32
+JobSystem::NumWorkers() const {
+    return this->numWorkers;
+}
+
+//------------------------------------------------------------------------------
+bool
+JobSystem::IsJobThread() {
+    return InvalidIndex != threadIndex;
+}
+
+//------------------------------------------------------------------------------
+job*
+JobSystem::createJob(JobFunc&& func, JobCounter* counter) {
+    job* j = this->jobPool.Create();
+    j->func = std::move(func);
+    j->counter = counter;
+    j->next = nullptr;
+    if (nullptr != counter) {
+        counter->count.fetch_add(1, std::memory_order_relaxed);
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Run(JobFunc func, JobCounter* counter) {
+    this->schedule(this->createJob(std::move(func), counter));
+}
+
+//------------------------------------------------------------------------------
+/**
+ The job is parked in the dependency counter's wait list, the last job
+ finishing on the dependency counter schedules it. The check is done
+ under the counter's lock, so it can't race with finish().
+*/
+void
+JobSystem::RunAfter(JobCounter* dependency, JobFunc func, JobCounter* counter) {
+    o_assert(nullptr != dependency);
+    job* j = this->createJob(std::move(func), counter);
+    {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> lock(dependency->waitLock);
+        #endif
+        if (dependency->count.load(std::memory_order_acquire) > 0) {
+            j->next = dependency->waitingJobs;
+            dependency->waitingJobs = j;
+            return;
+        }
+    }
+    this->schedule(j);
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::schedule(job* j) {
+    #if ORYOL_HAS_THREADS
+    if ((InvalidIndex == threadIndex) || !this->deques[threadIndex]->push(j)) {
+        // not a job thread, or own deque is full
+        std::lock_guard<std::mutex> lock(this->injectLock);
+        this->injectQueue.Enqueue(j);
+        this->numInjected.fetch_add(1, std::memory_order_release);
+    }
+    // NOTE: pairs with the numSleeping/numQueuedJobs sequence in workerLoop(),
+    // either the worker sees the new job, or we see the sleeping worker
+    this->numQueuedJobs.fetch_add(1, std::memory_order_seq_cst);
+    if (this->numSleeping.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(this->sleepLock);
+        this->wakeup.notify_one();
+    }
+    #else
+    this->execute(j);
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::execute(job* j) {
+    j->func();
+    JobCounter* counter = j->counter;
+    // destroy first, so that captured objects are released before Wait() returns
+    this->jobPool.Destroy(j);
+    if (nullptr != counter) {
+        this->finish(counter);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Only the last decrement takes the counter's lock, the counter isn't
+ touched anymore after the lock is released, Wait() takes the lock
+ once before returning, so the counter may be destroyed after Wait().
+*/
+void
+JobSystem::finish(JobCounter* counter) {
+    int32 count = counter->count.load(std::memory_order_relaxed);
+    while (count > 1) {
+        if (counter->count.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+            return;
+        }
+    }
+    job* waiting = nullptr;
+    {
+        #if ORYOL_HAS_THREADS
+        std::lock_guard<std::mutex> lock(counter->waitLock);
+        #endif
+        if (1 == counter->count.fetch_sub(1, std::memory_order_acq_rel)) {
+            waiting = counter->waitingJobs;
+            counter->waitingJobs = nullptr;
+        }
+    }
+    while (nullptr != waiting) {
+        job* next = waiting->next;
+        waiting->next = nullptr;
+        this->schedule(waiting);
+        waiting = next;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::Wait(JobCounter* counter) {
+    o_assert(nullptr != counter);
+    #if ORYOL_HAS_THREADS
+    while (!counter->IsDone()) {
+        job* j = this->findJob();
+        if (nullptr != j) {
+            this->execute(j);
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    // wait for the last finish() to release the counter
+    std::lock_guard<std::mutex> lock(counter->waitLock);
+    #else
+    o_assert(counter->IsDone());
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ Splits [0, num) into ranges of grainSize elements (if grainSize is 0,
+ a grain size is picked which creates about 4 ranges per thread). The
+ last range is run on the calling thread.
+*/
+void
+JobSystem::ParallelFor(int32 num, int32 grainSize, RangeFunc func) {
+    o_assert(grainSize >= 0);
+    if (num <= 0) {
+        return;
+    }
+    if (0 == grainSize) {
+        grainSize = num / (4 * (this->numWorkers + 1));
+        if (grainSize < 1) {
+            grainSize = 1;
+        }
+    }
+    JobCounter counter;
+    int32 begin = 0;
+    for (; (begin + grainSize) < num; begin += grainSize) {
+        const int32 end = begin + grainSize;
+        const RangeFunc* rangeFunc = &func;
+        this->Run([rangeFunc, begin, end]() {
+            (*rangeFunc)(begin, end);
+        }, &counter);
+    }
+    func(begin, num);
+    this->Wait(&counter);
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+/**
+ Try the own deque first (newest job), then the shared queue, then
+ steal the oldest job from another thread's deque.
+*/
+job*
+JobSystem::findJob() {
+    job* j = nullptr;
+    if (InvalidIndex != threadIndex) {
+        j = this->deques[threadIndex]->pop();
+    }
+    if ((nullptr == j) && (this->numInjected.load(std::memory_order_acquire) > 0)) {
+        std::lock_guard<std::mutex> lock(this->injectLock);
+        if (!this->injectQueue.Empty()) {
+            j = this->injectQueue.Dequeue();
+            this->numInjected.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+    if (nullptr == j) {
+        const int32 numDeques = this->deques.Size();
+        const uint32 start = stealIndex++;
+        for (int32 i = 0; i < numDeques; i++) {
+            const int32 victim = (start + i) % numDeques;
+            if (victim != threadIndex) {
+                j = this->deques[victim]->steal();
+                if (nullptr != j) {
+                    break;
+                }
+            }
+        }
+    }
+    if (nullptr != j) {
+        this->numQueuedJobs.fetch_sub(1, std::memory_order_relaxed);
+    }
+    return j;
+}
+
+//------------------------------------------------------------------------------
+void
+JobSystem::workerLoop(int32 index) {
+    CoreFacade::EnterThread();
+    threadIndex = index;
+    stealIndex = index;
+    while (!this->stopRequested.load(std::memory_order_acquire)) {
+        job* j = this->findJob();
+        if (nullptr != j) {
+            this->execute(j);
+        }
+        else if (this->numQueuedJobs.load(std::memory_order_seq_cst) > 0) {
+            // lost a steal race, or a job is just being pushed
+            std::this_thread::yield();
+        }
+        else {
+            std::unique_lock<std::mutex> lock(this->sleepLock);
+            this->numSleeping.fetch_add(1, std::memory_order_seq_cst);
+            this->wakeup.wait(lock, [this] {
+                return this->stopRequested.load(std::memory_order_acquire) ||
+                       (this->numQueuedJobs.load(std::memory_order_seq_cst) > 0);
+            });
+            this->numSleeping.fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+    threadIndex = InvalidIndex;
+    CoreFacade::LeaveThread();
+}
+#endif
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,123 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Core::JobSystem
+    @brief work-stealing thread pool for short-lived jobs
+
+    The JobSystem runs a pool of worker threads (by default one less
+    than the number of hardware threads, since the thread which creates
+    the JobSystem helps out while it waits for jobs). Every worker, and
+    the creating thread, owns a work-stealing deque: jobs started on a
+    worker thread are pushed onto its own deque and popped again in
+    LIFO order, idle workers steal the oldest jobs from other deques.
+    Jobs started from other threads go into a shared queue.
+
+    Completion is tracked with JobCounter objects, Wait() doesn't block
+    but runs other jobs until the counter reaches 0, so it is safe to
+    wait from inside a job. RunAfter() defers a job until a counter has
+    reached 0, this is how dependencies between jobs are expressed.
+    ParallelFor() splits an index range into jobs and waits for them.
+
+    The worker threads call CoreFacade::EnterThread() and
+    CoreFacade::LeaveThread(), so jobs may use thread-local RunLoops,
+    pool allocators and Ptr<> objects like any other Oryol thread.
+
+    Without thread support, jobs are run immediately by Run().
+
+    @see JobCounter
+*/
+#include <atomic>
+#include <functional>
+#include "Core/Config.h"
+#include "Core/Types.h"
+#include "Core/Macros.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Queue.h"
+#include "Core/Memory/poolAllocator.h"
+#include "Core/Threading/JobCounter.h"
+#include "Core/Threading/jobDeque.h"
+#if ORYOL_HAS_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#endif
+
+namespace Oryol {
+namespace Core {
+
+/* private struct, do not use */
+struct job {
+    std::function<void()> func;
+    JobCounter* counter;    // optional counter decremented when job has finished
+    job* next;              // link in a JobCounter's list of waiting jobs
+};
+
+class JobSystem {
+    OryolGlobalSingletonDecl(JobSystem);
+public:
+    /// job function
+    typedef std::function<void()> JobFunc;
+    /// ParallelFor range function, called with [begin, end)
+    typedef std::function<void(int32 begin, int32 end)> RangeFunc;
+
+    /// constructor, 0 workers means hardware concurrency - 1
+    JobSystem(int32 numWorkers=0);
+    /// destructor, waits for the worker threads to finish
+    ~JobSystem();
+
+    /// get number of worker threads
+    int32 NumWorkers() const;
+    /// return true if called from a worker thread or the creating thread
+    static bool IsJobThread();
+
+    /// run a job, counter (optional) is decremented when the job has finished
+    void Run(JobFunc func, JobCounter* counter=nullptr);
+    /// run a job after dependency has reached 0, counter is optional
+    void RunAfter(JobCounter* dependency, JobFunc func, JobCounter* counter=nullptr);
+    /// wait until counter reaches 0, runs other jobs while waiting (must be called before destroying counter)
+    void Wait(JobCounter* counter);
+    /// call func in parallel with sub-ranges of [0, num), returns when done
+    void ParallelFor(int32 num, int32 grainSize, RangeFunc func);
+
+private:
+    /// create a job object
+    job* createJob(JobFunc&& func, JobCounter* counter);
+    /// make a job runnable
+    void schedule(job* j);
+    /// run a job, update its counter and destroy it
+    void execute(job* j);
+    /// decrement a counter, schedule its waiting jobs when it reaches 0
+    void finish(JobCounter* counter);
+    #if ORYOL_HAS_THREADS
+    /// find a runnable job, return nullptr if none found
+    job* findJob();
+    /// the worker thread loop
+    void workerLoop(int32 index);
+    #endif
+
+    /// max number of jobs in a per-thread deque
+    static const int32 DequeCapacity = 4096;
+
+    /// index of the calling thread's deque, InvalidIndex for other threads
+    static ORYOL_THREAD_LOCAL int32 threadIndex;
+    /// per-thread start index for picking steal victims
+    static ORYOL_THREAD_LOCAL uint32 stealIndex;
+
+    poolAllocator<job> jobPool;
+    int32 numWorkers;
+    #if ORYOL_HAS_THREADS
+    Array<jobDeque<job>*> deques;   // [0] is the creating thread's deque
+    Array<std::thread> threads;
+    std::mutex injectLock;
+    Queue<job*> injectQueue;        // jobs started from non-job threads
+    std::atomic<int32> numInjected;
+    std::mutex sleepLock;
+    std::condition_variable wakeup;
+    std::atomic<int32> numQueuedJobs;
+    std::atomic<int32> numSleeping;
+    std::atomic<bool> stopRequested;
+    #endif
+};
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,178 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    Fixed-capacity work-stealing deque (Chase-Lev, with the C11 memory
+    orderings from Le et al., "Correct and Efficient Work-Stealing for
+    Weak Memory Models"). The owner thread pushes and pops at the
+    bottom end (LIFO, cache-warm), any other thread may steal from the
+    top end (FIFO, oldest and usually biggest work item). Only steal()
+    and the pop of the last element need a compare-and-swap.
+
+    push() and pop() must only be called from the owner thread,
+    steal() may be called from any thread. push() returns false
+    if the deque is full, the caller must find another place for
+    the element. The capacity is rounded up to the next power of 2.
+*/
+#include <atomic>
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace Core {
+
+template<class TYPE> class jobDeque {
+public:
+    /// constructor
+    jobDeque();
+    /// destructor
+    ~jobDeque();
+
+    /// allocate the deque, must be called before any other method
+    void setup(int32 capacity);
+    /// discard the deque
+    void discard();
+    /// return true if setup() has been called
+    bool isValid() const;
+    /// approximate number of elements (may be outdated when returned)
+    int32 size() const;
+
+    /// push an element at the bottom (owner thread only), return false if full
+    bool push(TYPE* elm);
+    /// pop an element from the bottom (owner thread only), return nullptr if empty
+    TYPE* pop();
+    /// steal an element from the top (any thread), return nullptr if empty or lost a race
+    TYPE* steal();
+
+private:
+    static const int32 CacheLineSize = 64;
+
+    std::atomic<TYPE*>* slots;
+    int64 mask;
+    std::atomic<int64> top;
+    // keep thieves and owner on separate cache lines
+    uint8 padding[CacheLineSize];
+    std::atomic<int64> bottom;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+jobDeque<TYPE>::jobDeque() :
+slots(nullptr),
+mask(0),
+top(0),
+bottom(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+jobDeque<TYPE>::~jobDeque() {
+    if (this->isValid()) {
+        this->discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+jobDeque<TYPE>::setup(int32 capacity) {
+    o_assert(!this->isValid());
+    o_assert(capacity > 1);
+    int32 num = 2;
+    while (num < capacity) {
+        num <<= 1;
+    }
+    this->slots = (std::atomic<TYPE*>*) Memory::Alloc(num * sizeof(std::atomic<TYPE*>));
+    for (int32 i = 0; i < num; i++) {
+        new(&this->slots[i]) std::atomic<TYPE*>(nullptr);
+    }
+    this->mask = num - 1;
+    this->top.store(0, std::memory_order_relaxed);
+    this->bottom.store(0, std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+jobDeque<TYPE>::discard() {
+    o_assert(this->isValid());
+    Memory::Free(this->slots);
+    this->slots = nullptr;
+    this->mask = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+jobDeque<TYPE>::isValid() const {
+    return nullptr != this->slots;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+jobDeque<TYPE>::size() const {
+    const int64 b = this->bottom.load(std::memory_order_relaxed);
+    const int64 t = this->top.load(std::memory_order_relaxed);
+    return (b > t) ? int32(b - t) : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+jobDeque<TYPE>::push(TYPE* elm) {
+    o_assert_dbg(this->isValid());
+    const int64 b = this->bottom.load(std::memory_order_relaxed);
+    const int64 t = this->top.load(std::memory_order_acquire);
+    if ((b - t) > this->mask) {
+        // full
+        return false;
+    }
+    this->slots[b & this->mask].store(elm, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->bottom.store(b + 1, std::memory_order_relaxed);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+jobDeque<TYPE>::pop() {
+    o_assert_dbg(this->isValid());
+    const int64 b = this->bottom.load(std::memory_order_relaxed) - 1;
+    this->bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64 t = this->top.load(std::memory_order_relaxed);
+    if (t > b) {
+        // was empty, restore bottom
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    TYPE* elm = this->slots[b & this->mask].load(std::memory_order_relaxed);
+    if (t == b) {
+        // last element, race against thieves
+        if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            elm = nullptr;
+        }
+        this->bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return elm;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> TYPE*
+jobDeque<TYPE>::steal() {
+    o_assert_dbg(this->isValid());
+    int64 t = this->top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64 b = this->bottom.load(std::memory_order_acquire);
+    if (t >= b) {
+        return nullptr;
+    }
+    TYPE* elm = this->slots[t & this->mask].load(std::memory_order_relaxed);
+    if (!this->top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        // lost the race against the owner or another thief
+        return nullptr;
+    }
+    return elm;
+}
+
+} // namespace Core
+} // namespace Oryol
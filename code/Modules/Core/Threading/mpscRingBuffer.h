@@ -0,0 +1,208 @@
+#pragma once
+//------------------------------------------------------------------------------
+/*
+    private class, do not use
+
+    Bounded lock-free ring buffer with one consumer thread and
+    one or multiple producer threads. Each slot has a sequence number
+    which tells producers and the consumer whether the slot is free
+    or holds a published element (D. Vyukov's bounded queue), so no
+    locks are needed, and the consumer never writes the producer's
+    cache lines.
+
+    enqueue() may be called from any number of threads concurrently
+    (it claims a slot with a compare-and-swap), enqueueSingle() is
+    the single-producer fast path without CAS, it must never be
+    called concurrently with enqueue() or itself. dequeue() must only
+    be called from the consumer thread. The capacity is rounded up to
+    the next power of 2.
+*/
+#include <atomic>
+#include <utility>
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace Core {
+
+template<class TYPE> class mpscRingBuffer {
+public:
+    /// constructor
+    mpscRingBuffer();
+    /// destructor
+    ~mpscRingBuffer();
+
+    /// allocate the ring buffer, must be called before any other method
+    void setup(int32 capacity);
+    /// discard the ring buffer, destroys remaining elements
+    void discard();
+    /// return true if setup() has been called
+    bool isValid() const;
+    /// get capacity
+    int32 capacity() const;
+
+    /// enqueue an element from any producer thread, return false if full
+    bool enqueue(TYPE&& elm);
+    /// enqueue an element with only one producer thread, return false if full
+    bool enqueueSingle(TYPE&& elm);
+    /// dequeue an element (consumer thread only), return false if empty
+    bool dequeue(TYPE& outElm);
+
+private:
+    struct slot {
+        std::atomic<uintptr> seq;
+        TYPE elm;
+    };
+    /// claim a slot for writing, returns nullptr if full
+    slot* claimMulti(uintptr& outPos);
+
+    static const int32 CacheLineSize = 64;
+
+    slot* slots;
+    uintptr mask;
+    std::atomic<uintptr> enqueuePos;
+    // keep producer and consumer position on separate cache lines
+    uint8 padding[CacheLineSize];
+    uintptr dequeuePos;
+};
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+mpscRingBuffer<TYPE>::mpscRingBuffer() :
+slots(nullptr),
+mask(0),
+enqueuePos(0),
+dequeuePos(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE>
+mpscRingBuffer<TYPE>::~mpscRingBuffer() {
+    if (this->isValid()) {
+        this->discard();
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+mpscRingBuffer<TYPE>::setup(int32 capacity) {
+    o_assert(!this->isValid());
+    o_assert(capacity > 1);
+    int32 num = 2;
+    while (num < capacity) {
+        num <<= 1;
+    }
+    this->slots = (slot*) Memory::Alloc(num * sizeof(slot));
+    for (int32 i = 0; i < num; i++) {
+        new(&this->slots[i]) slot();
+        this->slots[i].seq.store(i, std::memory_order_relaxed);
+    }
+    this->mask = num - 1;
+    this->enqueuePos.store(0, std::memory_order_relaxed);
+    this->dequeuePos = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> void
+mpscRingBuffer<TYPE>::discard() {
+    o_assert(this->isValid());
+    const int32 num = this->capacity();
+    for (int32 i = 0; i < num; i++) {
+        this->slots[i].~slot();
+    }
+    Memory::Free(this->slots);
+    this->slots = nullptr;
+    this->mask = 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpscRingBuffer<TYPE>::isValid() const {
+    return nullptr != this->slots;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> int32
+mpscRingBuffer<TYPE>::capacity() const {
+    return this->isValid() ? int32(this->mask + 1) : 0;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> typename mpscRingBuffer<TYPE>::slot*
+mpscRingBuffer<TYPE>::claimMulti(uintptr& outPos) {
+    uintptr pos = this->enqueuePos.load(std::memory_order_relaxed);
+    for (;;) {
+        slot* s = &this->slots[pos & this->mask];
+        const uintptr seq = s->seq.load(std::memory_order_acquire);
+        const intptr diff = intptr(seq) - intptr(pos);
+        if (0 == diff) {
+            // slot is free, try to claim it
+            if (this->enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                outPos = pos;
+                return s;
+            }
+        }
+        else if (diff < 0) {
+            // slot still occupied by the previous lap: full
+            return nullptr;
+        }
+        else {
+            // another producer was faster
+            pos = this->enqueuePos.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpscRingBuffer<TYPE>::enqueue(TYPE&& elm) {
+    o_assert_dbg(this->isValid());
+    uintptr pos = 0;
+    slot* s = this->claimMulti(pos);
+    if (nullptr != s) {
+        s->elm = std::move(elm);
+        s->seq.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+    else {
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpscRingBuffer<TYPE>::enqueueSingle(TYPE&& elm) {
+    o_assert_dbg(this->isValid());
+    const uintptr pos = this->enqueuePos.load(std::memory_order_relaxed);
+    slot* s = &this->slots[pos & this->mask];
+    if (s->seq.load(std::memory_order_acquire) != pos) {
+        // consumer hasn't freed the slot yet: full
+        return false;
+    }
+    this->enqueuePos.store(pos + 1, std::memory_order_relaxed);
+    s->elm = std::move(elm);
+    s->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template<class TYPE> bool
+mpscRingBuffer<TYPE>::dequeue(TYPE& outElm) {
+    o_assert_dbg(this->isValid());
+    const uintptr pos = this->dequeuePos;
+    slot* s = &this->slots[pos & this->mask];
+    if (s->seq.load(std::memory_order_acquire) != (pos + 1)) {
+        // empty, or the producer hasn't finished writing this slot
+        return false;
+    }
+    outElm = std::move(s->elm);
+    this->dequeuePos = pos + 1;
+    // hand the slot to the producers for the next lap
+    s->seq.store(pos + this->mask + 1, std::memory_order_release);
+    return true;
+}
+
+} // namespace Core
+} // namespace Oryol
@@ -0,0 +1,169 @@
+//------------------------------------------------------------------------------
+//  AllocatorTest.cc
+//  Test pluggable allocators.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Memory/LinearAllocator.h"
+#include "Core/Memory/ArenaAllocator.h"
+#include "Core/Memory/TrackingAllocator.h"
+#include "Core/Containers/Array.h"
+#include "Core/String/String.h"
+#include "Core/RunLoop.h"
+#include <cstring>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+
+//------------------------------------------------------------------------------
+TEST(LinearAllocator) {
+
+    LinearAllocator alloc(1024);
+    CHECK(alloc.Capacity() == 1024);
+    CHECK(alloc.Size() == 0);
+
+    uint8* p0 = (uint8*) alloc.Alloc(10);
+    uint8* p1 = (uint8*) alloc.Alloc(20);
+    CHECK(nullptr != p0);
+    CHECK(nullptr != p1);
+    CHECK(p1 > p0);
+    CHECK(((intptr)p0 & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK(((intptr)p1 & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    CHECK(alloc.Size() == 80);
+
+    // most recent allocation grows in place
+    Memory::Fill(p1, 20, 0x12);
+    uint8* p2 = (uint8*) alloc.ReAlloc(p1, 40);
+    CHECK(p2 == p1);
+    CHECK(p2[19] == 0x12);
+    CHECK(alloc.Size() == 80 + 16);
+
+    // freeing doesn't roll back, and a freed allocation isn't grown in place
+    alloc.Free(p2);
+    CHECK(alloc.Size() == 80 + 16);
+
+    // allocations which don't fit go to the heap
+    void* p3 = alloc.Alloc(2048);
+    CHECK(nullptr != p3);
+    CHECK(alloc.NumOverflowAllocs() == 1);
+    alloc.Free(p3);
+
+    alloc.Reset();
+    CHECK(alloc.Size() == 0);
+    CHECK(alloc.Alloc(10) == p0);
+    CHECK(alloc.Size() == 32);
+    // a stale free of p0 from before Reset() doesn't release the new allocation
+    alloc.Free(p0);
+    CHECK(alloc.Size() == 32);
+}
+
+//------------------------------------------------------------------------------
+TEST(ArenaAllocator) {
+
+    ArenaAllocator arena;
+    CHECK(arena.NumPages() == 0);
+    void* p0 = arena.Alloc(24);
+    void* p1 = arena.Alloc(30);
+    CHECK(arena.NumPages() == 1);
+    CHECK(((intptr)p0 & (ORYOL_MAX_PLATFORM_ALIGN - 1)) == 0);
+    arena.Free(p0);
+    // same size class re-uses the freed block
+    void* p2 = arena.Alloc(17);
+    CHECK(p2 == p0);
+    // a different size class needs a new page
+    void* p3 = arena.Alloc(100);
+    CHECK(arena.NumPages() == 2);
+
+    // re-alloc within size class stays in place, otherwise copies
+    Memory::Fill(p1, 30, 0x34);
+    CHECK(arena.ReAlloc(p1, 32) == p1);
+    uint8* p4 = (uint8*) arena.ReAlloc(p1, 500);
+    CHECK(p4 != p1);
+    CHECK(p4[29] == 0x34);
+
+    // large allocations go to the heap
+    void* p5 = arena.Alloc(100000);
+    CHECK(arena.NumPages() == 3);
+    arena.Free(p5);
+    arena.Free(p2);
+    arena.Free(p3);
+    arena.Free(p4);
+}
+
+//------------------------------------------------------------------------------
+TEST(TrackingAllocator) {
+
+    TrackingAllocator tracker("test");
+    CHECK(0 == std::strcmp(tracker.Tag(), "test"));
+    void* p0 = tracker.Alloc(100);
+    void* p1 = tracker.Alloc(200);
+    CHECK(tracker.NumBytes() == 300);
+    CHECK(tracker.NumAllocs() == 2);
+    p0 = tracker.ReAlloc(p0, 50);
+    CHECK(tracker.NumBytes() == 250);
+    CHECK(tracker.PeakBytes() == 300);
+    tracker.Free(p0);
+    tracker.Free(p1);
+    CHECK(tracker.NumBytes() == 0);
+    CHECK(tracker.NumAllocs() == 0);
+    CHECK(tracker.TotalAllocs() == 2);
+    CHECK(tracker.PeakBytes() == 300);
+
+    // decorate an arena
+    ArenaAllocator arena;
+    TrackingAllocator arenaTracker("arena", &arena);
+    void* p2 = arenaTracker.Alloc(64);
+    CHECK(arena.NumPages() == 1);
+    CHECK(arenaTracker.NumBytes() == 64);
+    arenaTracker.Free(p2);
+}
+
+//------------------------------------------------------------------------------
+TEST(ThreadAllocator) {
+
+    CHECK(nullptr == Memory::ThreadAllocator());
+    TrackingAllocator tracker("thread");
+    {
+        Allocator* prev = Memory::SetThreadAllocator(&tracker);
+        CHECK(nullptr == prev);
+        Array<int32> array;
+        String str("Hello World, this is a long string");
+        Memory::SetThreadAllocator(prev);
+
+        // the container and string keep using their allocator
+        for (int32 i = 0; i < 100; i++) {
+            array.AddBack(i);
+        }
+        CHECK(tracker.NumAllocs() >= 2);
+        CHECK(tracker.NumBytes() >= int64(100 * sizeof(int32)));
+
+        // ...but a copy uses the current thread allocator
+        const int32 numAllocs = tracker.NumAllocs();
+        Array<int32> copy(array);
+        CHECK(copy.Size() == 100);
+        CHECK(tracker.NumAllocs() == numAllocs);
+        CHECK(str == "Hello World, this is a long string");
+    }
+    CHECK(tracker.NumAllocs() == 0);
+    CHECK(tracker.NumBytes() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(FrameAllocator) {
+
+    auto runLoop = RunLoop::Create();
+    LinearAllocator& frameAlloc = runLoop->FrameAllocator();
+    {
+        ThreadAllocatorScope scope(&frameAlloc);
+        CHECK(Memory::ThreadAllocator() == &frameAlloc);
+        Array<int32> array;
+        array.Reserve(64);
+        CHECK(frameAlloc.Size() > 0);
+    }
+    CHECK(nullptr == Memory::ThreadAllocator());
+    frameAlloc.Alloc(100);
+    CHECK(frameAlloc.Size() > 0);
+    runLoop->Run();
+    CHECK(frameAlloc.Size() == 0);
+}
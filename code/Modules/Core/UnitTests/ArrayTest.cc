@@ -295,5 +295,17 @@ TEST(ArrayTest) {
     CHECK(array4[1] == "Blub");
     CHECK(array4[2] == "Blob");
     CHECK(array4[3] == "Blubber");
+
+    // add a range of elements
+    const int32 podRange[3] = { 4, 5, 6 };
+    Array<int32> array5({ 1, 2, 3 });
+    array5.AddBack(podRange, 3);
+    CHECK(array5.Size() == 6);
+    CHECK((array5[2] == 3) && (array5[3] == 4) && (array5[5] == 6));
+    const String strRange[2] = { "Bla", "Blub" };
+    array4.AddBack(strRange, 2);
+    CHECK(array4.Size() == 6);
+    CHECK(array4[4] == "Bla");
+    CHECK(array4[5] == "Blub");
 }
 
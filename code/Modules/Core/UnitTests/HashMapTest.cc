@@ -0,0 +1,269 @@
+//------------------------------------------------------------------------------
+//  HashMapTest.cc
+//  Test HashMap functionality, and compare against Map and Set.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/HashSet.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/Set.h"
+#include "Core/String/StringAtom.h"
+#include "Core/Log.h"
+#include <chrono>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace std;
+
+struct Int32Hasher {
+    uint32 operator()(int32 val) const {
+        return val;
+    };
+};
+
+struct AtomHasher {
+    uint32 operator()(const StringAtom& atom) const {
+        return atom.Hash();
+    };
+};
+
+//------------------------------------------------------------------------------
+TEST(HashMapTest) {
+
+    HashMap<int32, int32, Int32Hasher> map;
+    CHECK(map.GetMinGrow() == ORYOL_CONTAINER_DEFAULT_MIN_GROW);
+    CHECK(map.GetMaxGrow() == ORYOL_CONTAINER_DEFAULT_MAX_GROW);
+    CHECK(map.Size() == 0);
+    CHECK(map.Empty());
+    CHECK(map.Capacity() == 0);
+    CHECK(!map.Contains(1));
+    CHECK(nullptr == map.Find(1));
+    for (int32 i = 0; i < 1000; i++) {
+        map.Insert(i * 7, i);
+    }
+    CHECK(map.Size() == 1000);
+    CHECK(map.Capacity() >= 1000);
+    for (int32 i = 0; i < 1000; i++) {
+        CHECK(map.Contains(i * 7));
+        CHECK(map[i * 7] == i);
+        CHECK(!map.Contains(i * 7 + 1));
+    }
+    CHECK(!map.InsertUnique(7, 100));
+    CHECK(map[7] == 1);
+    CHECK(map.InsertUnique(1, 100));
+    CHECK(map[1] == 100);
+    *map.Find(1) = 200;
+    CHECK(map[1] == 200);
+    map.Erase(1);
+    map.Erase(1);
+    CHECK(map.Size() == 1000);
+
+    // iteration visits every element once
+    int64 sum = 0;
+    int32 num = 0;
+    for (const auto& kvp : map) {
+        CHECK(kvp.Key() == kvp.Value() * 7);
+        sum += kvp.Value();
+        num++;
+    }
+    CHECK(num == 1000);
+    CHECK(sum == (999 * 1000) / 2);
+
+    // erase every second element, the others must remain reachable
+    for (int32 i = 0; i < 1000; i += 2) {
+        map.Erase(i * 7);
+    }
+    CHECK(map.Size() == 500);
+    for (int32 i = 0; i < 1000; i++) {
+        CHECK(map.Contains(i * 7) == (1 == (i & 1)));
+    }
+
+    // copy and move
+    HashMap<int32, int32, Int32Hasher> map1(map);
+    CHECK(map1.Size() == 500);
+    CHECK(map1[7] == 1);
+    HashMap<int32, int32, Int32Hasher> map2(std::move(map1));
+    CHECK(map1.Empty());
+    CHECK(map2.Size() == 500);
+    CHECK(map2[7 * 999] == 999);
+    map1 = map2;
+    CHECK(map1.Size() == 500);
+    map2 = std::move(map1);
+    CHECK(map1.Empty());
+    CHECK(map2.Size() == 500);
+
+    // clear keeps capacity
+    const int32 capacity = map2.Capacity();
+    map2.Clear();
+    CHECK(map2.Empty());
+    CHECK(map2.Capacity() == capacity);
+    CHECK(!map2.Contains(7));
+    map2.Insert(7, 7);
+    CHECK(map2[7] == 7);
+
+    // reserve
+    HashMap<int32, int32, Int32Hasher> map3;
+    map3.Reserve(100);
+    const int32 reserved = map3.Capacity();
+    CHECK(reserved >= 100);
+    for (int32 i = 0; i < 100; i++) {
+        map3.Insert(i, i);
+    }
+    CHECK(map3.Capacity() == reserved);
+
+    // hash collisions (all keys in the same group)
+    struct BadHasher {
+        uint32 operator()(int32 val) const {
+            return 0;
+        };
+    };
+    HashMap<int32, int32, BadHasher> badMap;
+    for (int32 i = 0; i < 100; i++) {
+        badMap.Insert(i, i);
+    }
+    for (int32 i = 0; i < 100; i += 3) {
+        badMap.Erase(i);
+    }
+    for (int32 i = 0; i < 100; i++) {
+        CHECK(badMap.Contains(i) == (0 != (i % 3)));
+    }
+
+    // growth is clamped to maxGrow
+    HashMap<int32, int32, Int32Hasher> map4;
+    map4.SetAllocStrategy(16, 64);
+    int32 prevCapacity = 0;
+    for (int32 i = 0; i < 1000; i++) {
+        map4.Insert(i, i);
+        if (map4.Capacity() != prevCapacity) {
+            CHECK((0 == prevCapacity) || ((map4.Capacity() - prevCapacity) <= (64 + 14)));
+            prevCapacity = map4.Capacity();
+        }
+    }
+    for (int32 i = 0; i < 1000; i++) {
+        CHECK(map4[i] == i);
+    }
+
+    // insert/erase churn doesn't grow the table
+    HashMap<int32, int32, Int32Hasher> map5;
+    for (int32 i = 0; i < 500; i++) {
+        map5.Insert(i, i);
+    }
+    const int32 churnCapacity = map5.Capacity();
+    for (int32 i = 500; i < 100000; i++) {
+        map5.Erase(i - 500);
+        map5.Insert(i, i);
+    }
+    CHECK(map5.Size() == 500);
+    CHECK(map5.Capacity() == churnCapacity);
+    for (int32 i = 99500; i < 100000; i++) {
+        CHECK(map5[i] == i);
+    }
+    for (int32 i = 0; i < 99500; i += 97) {
+        CHECK(!map5.Contains(i));
+    }
+
+    // non-POD keys and values
+    HashMap<StringAtom, StringAtom, AtomHasher> atomMap;
+    atomMap.Insert(StringAtom("Bla"), StringAtom("Blub"));
+    atomMap.Insert(StringAtom("Blob"), StringAtom("Blib"));
+    CHECK(atomMap[StringAtom("Bla")] == "Blub");
+    CHECK(atomMap[StringAtom("Blob")] == "Blib");
+    atomMap.Erase(StringAtom("Bla"));
+    CHECK(!atomMap.Contains(StringAtom("Bla")));
+    CHECK(atomMap.Contains(StringAtom("Blob")));
+}
+
+//------------------------------------------------------------------------------
+TEST(HashMapBenchmark) {
+
+    const int32 numElements = 20000;
+    const int32 numLookups = 1000000;
+    chrono::time_point<chrono::system_clock> start, end;
+    chrono::duration<double> dur;
+
+    // Map: insert and lookup
+    Map<int32, int32> map;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numElements; i++) {
+        map.Insert((i * 7919) % numElements, i);
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Map: %d inserts: %f sec\n", numElements, dur.count());
+    int32 found = 0;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numLookups; i++) {
+        if (InvalidIndex != map.FindIndex(i % (numElements * 2))) {
+            found++;
+        }
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Map: %d lookups: %f sec\n", numLookups, dur.count());
+    CHECK(found == numLookups / 2);
+
+    // HashMap: insert and lookup
+    HashMap<int32, int32, Int32Hasher> hashMap;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numElements; i++) {
+        hashMap.Insert((i * 7919) % numElements, i);
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("HashMap: %d inserts: %f sec\n", numElements, dur.count());
+    found = 0;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numLookups; i++) {
+        if (nullptr != hashMap.Find(i % (numElements * 2))) {
+            found++;
+        }
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("HashMap: %d lookups: %f sec\n", numLookups, dur.count());
+    CHECK(found == numLookups / 2);
+
+    // HashMap: erase
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numElements; i++) {
+        hashMap.Erase(i);
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("HashMap: %d erases: %f sec\n", numElements, dur.count());
+    CHECK(hashMap.Empty());
+
+    // Set vs HashSet
+    Set<int32> set;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numElements; i++) {
+        set.Insert((i * 7919) % numElements);
+    }
+    found = 0;
+    for (int32 i = 0; i < numLookups; i++) {
+        if (set.Contains(i % (numElements * 2))) {
+            found++;
+        }
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("Set: %d inserts, %d lookups: %f sec\n", numElements, numLookups, dur.count());
+    CHECK(found == numLookups / 2);
+
+    HashSet<int32, Int32Hasher, 1024> hashSet;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numElements; i++) {
+        hashSet.Insert((i * 7919) % numElements);
+    }
+    found = 0;
+    for (int32 i = 0; i < numLookups; i++) {
+        if (hashSet.Contains(i % (numElements * 2))) {
+            found++;
+        }
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("HashSet: %d inserts, %d lookups: %f sec\n", numElements, numLookups, dur.count());
+    CHECK(found == numLookups / 2);
+}
@@ -0,0 +1,199 @@
+//------------------------------------------------------------------------------
+//  JobSystemTest.cc
+//  Test JobSystem jobs, counters, dependencies and ParallelFor.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/Threading/JobSystem.h"
+#include "Core/CoreFacade.h"
+#include "Core/Log.h"
+#include <atomic>
+#include <chrono>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace std;
+
+//------------------------------------------------------------------------------
+TEST(JobSystemTest) {
+
+    JobSystem* jobSystem = JobSystem::CreateSingle(4);
+    CHECK(JobSystem::HasInstance());
+    CHECK(jobSystem->NumWorkers() == 4);
+    CHECK(JobSystem::IsJobThread());
+
+    // simple jobs with a counter
+    std::atomic<int32> numRun(0);
+    JobCounter counter;
+    CHECK(counter.IsDone());
+    for (int32 i = 0; i < 1000; i++) {
+        jobSystem->Run([&numRun]() {
+            numRun++;
+        }, &counter);
+    }
+    jobSystem->Wait(&counter);
+    CHECK(counter.IsDone());
+    CHECK(numRun == 1000);
+
+    // worker threads have entered the Oryol thread context
+    std::atomic<int32> numJobThreads(0);
+    for (int32 i = 0; i < 100; i++) {
+        jobSystem->Run([&numJobThreads]() {
+            if (JobSystem::IsJobThread()) {
+                numJobThreads++;
+            }
+            // allocates from the thread's pool magazine
+            Ptr<RunLoop> runLoop = RunLoop::Create();
+        }, &counter);
+    }
+    jobSystem->Wait(&counter);
+    CHECK(numJobThreads == 100);
+
+    // dependencies: stage 2 may only start after all of stage 1 is done
+    std::atomic<int32> stage1(0);
+    std::atomic<int32> stage2Errors(0);
+    JobCounter stage1Counter;
+    JobCounter stage2Counter;
+    for (int32 i = 0; i < 100; i++) {
+        jobSystem->Run([&stage1]() {
+            stage1++;
+        }, &stage1Counter);
+    }
+    for (int32 i = 0; i < 100; i++) {
+        jobSystem->RunAfter(&stage1Counter, [&stage1, &stage2Errors]() {
+            if (stage1 != 100) {
+                stage2Errors++;
+            }
+        }, &stage2Counter);
+    }
+    jobSystem->Wait(&stage2Counter);
+    CHECK(stage1Counter.IsDone());
+    CHECK(stage2Errors == 0);
+
+    // a dependency which is already done starts immediately
+    numRun = 0;
+    jobSystem->RunAfter(&stage1Counter, [&numRun]() {
+        numRun++;
+    }, &counter);
+    jobSystem->Wait(&counter);
+    CHECK(numRun == 1);
+
+    // jobs starting jobs, and waiting inside a job
+    numRun = 0;
+    for (int32 i = 0; i < 10; i++) {
+        jobSystem->Run([jobSystem, &numRun]() {
+            JobCounter innerCounter;
+            for (int32 j = 0; j < 10; j++) {
+                jobSystem->Run([&numRun]() {
+                    numRun++;
+                }, &innerCounter);
+            }
+            jobSystem->Wait(&innerCounter);
+        }, &counter);
+    }
+    jobSystem->Wait(&counter);
+    CHECK(numRun == 100);
+
+    // ParallelFor covers each index exactly once
+    const int32 num = 100000;
+    Array<int32> values;
+    values.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        values.AddBack(0);
+    }
+    jobSystem->ParallelFor(num, 1000, [&values](int32 begin, int32 end) {
+        for (int32 i = begin; i < end; i++) {
+            values[i] += i;
+        }
+    });
+    int32 numWrong = 0;
+    for (int32 i = 0; i < num; i++) {
+        if (values[i] != i) {
+            numWrong++;
+        }
+    }
+    CHECK(numWrong == 0);
+    std::atomic<int32> numCalls(0);
+    jobSystem->ParallelFor(7, 0, [&numCalls](int32 begin, int32 end) {
+        numCalls += end - begin;
+    });
+    CHECK(numCalls == 7);
+    jobSystem->ParallelFor(0, 0, [&numCalls](int32 begin, int32 end) {
+        numCalls++;
+    });
+    CHECK(numCalls == 7);
+
+    // jobs started from a non-job thread
+    #if ORYOL_HAS_THREADS
+    numRun = 0;
+    std::thread thread([jobSystem, &numRun, &counter]() {
+        CoreFacade::EnterThread();
+        CHECK(!JobSystem::IsJobThread());
+        for (int32 i = 0; i < 100; i++) {
+            jobSystem->Run([&numRun]() {
+                numRun++;
+            }, &counter);
+        }
+        CoreFacade::LeaveThread();
+    });
+    thread.join();
+    jobSystem->Wait(&counter);
+    CHECK(numRun == 100);
+    #endif
+
+    JobSystem::DestroySingle();
+    CHECK(!JobSystem::HasInstance());
+    CHECK(!JobSystem::IsJobThread());
+}
+
+//------------------------------------------------------------------------------
+TEST(JobSystemBenchmark) {
+
+    const int32 num = 1 << 22;
+    Array<float32> values;
+    values.Reserve(num);
+    for (int32 i = 0; i < num; i++) {
+        values.AddBack(float32(i & 255));
+    }
+    auto work = [&values](int32 begin, int32 end) {
+        for (int32 i = begin; i < end; i++) {
+            float32 v = values[i];
+            for (int32 j = 0; j < 8; j++) {
+                v = v * 0.5f + 1.0f;
+            }
+            values[i] = v;
+        }
+    };
+
+    chrono::time_point<chrono::system_clock> start, end;
+    chrono::duration<double> dur;
+    start = chrono::system_clock::now();
+    work(0, num);
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("JobSystem: serial loop over %d elements: %f sec\n", num, dur.count());
+
+    JobSystem* jobSystem = JobSystem::CreateSingle();
+    start = chrono::system_clock::now();
+    jobSystem->ParallelFor(num, 0, work);
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("JobSystem: ParallelFor over %d elements with %d workers: %f sec\n", num, jobSystem->NumWorkers(), dur.count());
+
+    // many tiny jobs (job overhead)
+    const int32 numJobs = 100000;
+    std::atomic<int32> numRun(0);
+    JobCounter counter;
+    start = chrono::system_clock::now();
+    for (int32 i = 0; i < numJobs; i++) {
+        jobSystem->Run([&numRun]() {
+            numRun++;
+        }, &counter);
+    }
+    jobSystem->Wait(&counter);
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("JobSystem: %d empty jobs: %f sec\n", numJobs, dur.count());
+    CHECK(numRun == numJobs);
+    JobSystem::DestroySingle();
+}
@@ -5,6 +5,7 @@
 #include "Pre.h"
 #include "UnitTest++/src/UnitTest++.h"
 #include "Core/Containers/Map.h"
+#include "Core/String/String.h"
 
 using namespace Oryol;
 using namespace Oryol::Core;
@@ -148,4 +149,15 @@ TEST(MapTest) {
     CHECK(map4[32] == 32);
     int32 index = map4.FindIndex(32);
     CHECK(InvalidIndex == map4.FindDuplicate(index));
+    
+    // erasing the front element moves the spare room to the front,
+    // inserting into the empty map must still work
+    Map<String, int32> map5;
+    for (int i = 0; i < 64; i++) {
+        map5.Insert("bla", i);
+        CHECK(map5.Size() == 1);
+        CHECK(map5["bla"] == i);
+        map5.EraseIndex(0);
+        CHECK(map5.Empty());
+    }
 }
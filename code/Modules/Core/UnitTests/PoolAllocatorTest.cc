@@ -9,7 +9,13 @@
 #include "Core/RefCounted.h"
 #include "Core/Ptr.h"
 #include "Core/Memory/poolAllocator.h"
+#include "Core/CoreFacade.h"
 
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Oryol;
 using namespace Oryol::Core;
 
 TEST(PoolAllocator) {
@@ -26,4 +32,157 @@ TEST(PoolAllocator) {
     CHECK(0 != obj1);
     CHECK(obj == obj1);
     allocatorOne.Destroy(obj1);
+
+    // a second allocator of the same type gets its own magazine,
+    // so alternating between them doesn't flush the first one
+    poolAllocator<RefCounted> allocatorTwo;
+    RefCounted* obj2 = allocatorTwo.Create();
+    allocatorTwo.Destroy(obj2);
+    RefCounted* obj3 = allocatorOne.Create();
+    CHECK(obj3 == obj);
+    allocatorOne.Destroy(obj3);
+}
+
+class PuddleTestClass {
+public:
+    PuddleTestClass(int32 v) : val(v) { };
+    int32 val;
+};
+
+TEST(PoolAllocatorCapacity) {
+
+    // more elements than 256 puddles with 256 elements
+    const int32 numObjs = 300000;
+    poolAllocator<PuddleTestClass> allocator;
+    std::vector<PuddleTestClass*> objs;
+    objs.reserve(numObjs);
+    for (int32 i = 0; i < numObjs; i++) {
+        objs.push_back(allocator.Create(i));
+    }
+    CHECK(allocator.NumPuddles() > 256);
+    bool allValid = true;
+    for (int32 i = 0; i < numObjs; i++) {
+        allValid &= (objs[i]->val == i);
+        allocator.Destroy(objs[i]);
+    }
+    CHECK(allValid);
+}
+
+TEST(PoolAllocatorReleaseIdlePuddles) {
+
+    poolAllocator<PuddleTestClass> allocator(1024);
+    CHECK(allocator.NumPuddles() == 0);
+
+    const int32 numObjs = 5000;
+    std::vector<PuddleTestClass*> objs;
+    for (int32 i = 0; i < numObjs; i++) {
+        objs.push_back(allocator.Create(i));
+    }
+    CHECK(allocator.NumPuddles() == 5);
+    for (auto obj : objs) {
+        allocator.Destroy(obj);
+    }
+    objs.clear();
+
+    // low usage for a while doesn't release puddles in Destroy()...
+    CHECK(allocator.NumPuddles() == 5);
+    for (int32 i = 0; i < 2000; i++) {
+        for (int32 j = 0; j < 100; j++) {
+            objs.push_back(allocator.Create(j));
+        }
+        for (auto obj : objs) {
+            allocator.Destroy(obj);
+        }
+        objs.clear();
+    }
+    CHECK(allocator.NumPuddles() == 5);
+
+    // ...but through ReleaseIdlePuddlesIfIdle(), only the nodes
+    // cached in this thread's magazine keep puddles alive
+    allocator.ReleaseIdlePuddlesIfIdle();
+    CHECK(allocator.NumPuddles() <= 2);
+
+    // allocate again, released puddle slots are re-used
+    for (int32 i = 0; i < numObjs; i++) {
+        objs.push_back(allocator.Create(i));
+    }
+    CHECK(allocator.NumPuddles() <= 6);
+    bool allValid = true;
+    for (int32 i = 0; i < numObjs; i++) {
+        allValid &= (objs[i]->val == i);
+        allocator.Destroy(objs[i]);
+    }
+    CHECK(allValid);
+}
+
+#if ORYOL_HAS_THREADS
+class ContentionTestClass {
+public:
+    ContentionTestClass(int32 v) : val(v) { };
+    int32 val;
+    int32 padding[7];
+};
+static poolAllocator<ContentionTestClass> contentionAllocator;
+
+const int32 numContentionLive = 32;
+const int32 numContentionOps = 1 << 18;
+
+static void heapContentionThreadFunc(int32 seed) {
+    ContentionTestClass* objs[numContentionLive] = { 0 };
+    for (int32 i = 0; i < numContentionOps; i++) {
+        const int32 slot = i & (numContentionLive - 1);
+        if (nullptr != objs[slot]) {
+            o_assert(objs[slot]->val == (seed + i - numContentionLive));
+            delete objs[slot];
+        }
+        objs[slot] = new ContentionTestClass(seed + i);
+    }
+    for (int32 i = 0; i < numContentionLive; i++) {
+        delete objs[i];
+    }
+}
+
+static void contentionThreadFunc(int32 seed) {
+    CoreFacade::EnterThread();
+    ContentionTestClass* objs[numContentionLive] = { 0 };
+    for (int32 i = 0; i < numContentionOps; i++) {
+        const int32 slot = i & (numContentionLive - 1);
+        if (nullptr != objs[slot]) {
+            o_assert(objs[slot]->val == (seed + i - numContentionLive));
+            contentionAllocator.Destroy(objs[slot]);
+        }
+        objs[slot] = contentionAllocator.Create(seed + i);
+    }
+    for (int32 i = 0; i < numContentionLive; i++) {
+        contentionAllocator.Destroy(objs[i]);
+    }
+    CoreFacade::LeaveThread();
+}
+
+TEST(PoolAllocatorContention) {
+
+    // same workload with poolAllocator and with new/delete as baseline
+    const int32 threadCounts[] = { 1, 4, 16, 64 };
+    for (int32 numThreads : threadCounts) {
+        for (int32 useHeap = 0; useHeap < 2; useHeap++) {
+            chrono::time_point<chrono::system_clock> start, end;
+            start = chrono::system_clock::now();
+
+            std::vector<std::thread> threads;
+            for (int32 i = 0; i < numThreads; i++) {
+                threads.emplace_back(useHeap ? heapContentionThreadFunc : contentionThreadFunc, i * numContentionOps);
+            }
+            for (auto& t : threads) {
+                t.join();
+            }
+
+            end = chrono::system_clock::now();
+            chrono::duration<double> dur = end - start;
+            const double numOps = double(numThreads) * numContentionOps;
+            Log::Info("%s: %d threads: %d Create/Destroy pairs: %f sec (%f Mops/sec)\n",
+                useHeap ? "new/delete" : "poolAllocator",
+                numThreads, numThreads * numContentionOps, dur.count(), (numOps / dur.count()) / 1000000.0);
+        }
+    }
 }
+#endif
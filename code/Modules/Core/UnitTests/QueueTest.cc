@@ -55,6 +55,10 @@ TEST(QueueTest) {
     CHECK(queue0.Size() == 4);
     CHECK(queue0.SpareDequeue() == 0);
     
+    // peek at elements
+    CHECK(queue0[0] == "Element0");
+    CHECK(queue0[3] == "Element3");
+
     // dequeue elements
     StringAtom r0(queue0.Dequeue());
     CHECK(r0 == w0);
@@ -71,4 +71,10 @@ TEST(SetTest) {
     CHECK(set.begin() == &set.ValueAtIndex(0));
     CHECK(set.end() == &set.ValueAtIndex(7) + 1);
     
+    // test clear
+    set.Clear();
+    CHECK(set.Empty());
+    CHECK(!set.Contains(1));
+    set.Insert(1);
+    CHECK(set.Contains(1));
 }
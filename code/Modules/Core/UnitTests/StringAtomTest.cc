@@ -11,6 +11,8 @@
 #include <cstring>
 #include <thread>
 #include <array>
+#include <vector>
+#include <cstdio>
 
 using namespace std;
 using namespace Oryol;
@@ -56,18 +58,55 @@ TEST(StringAtomSingleThreaded) {
     CHECK(!atom0.IsValid());
 }
 
+TEST(StringAtomWithLength) {
+
+    // construct from strings which are not 0-terminated
+    const char* src = "HelloWorldHello";
+    StringAtom atom0(src, 5);
+    StringAtom atom1(src + 10, 5);
+    StringAtom atom2("Hello");
+    CHECK(atom0.Length() == 5);
+    CHECK(atom0 == "Hello");
+    CHECK(atom0 == atom1);
+    CHECK(atom0 == atom2);
+    CHECK(atom0.Hash() == atom2.Hash());
+    StringAtom atom3(src, 10);
+    CHECK(atom3 == "HelloWorld");
+    CHECK(atom3 != atom0);
+    StringAtom atom4(src, 0);
+    CHECK(!atom4.IsValid());
+
+    // strings which share a prefix, or differ only in length
+    StringAtom atom5(src, 15);
+    StringAtom atom6(src, 14);
+    CHECK(atom5 != atom6);
+    CHECK(atom5.Length() == 15);
+    CHECK(atom6.Length() == 14);
+    CHECK(atom6 == "HelloWorldHell");
+
+    // a String with an embedded 0 byte is only used up to the 0 byte
+    const char embedded[] = "Hello\0World";
+    String str(embedded, 0, 11);
+    StringAtom atom7(str);
+    CHECK(atom7 == atom2);
+    CHECK(atom7.Length() == 5);
+    atom7 = String(embedded + 6, 0, 5);
+    CHECK(atom7 == "World");
+    atom7 = str;
+    CHECK(atom7 == atom2);
+}
+
 #if ORYOL_HAS_THREADS
-// must use reference, the copy would fail since there is no thread-local
-// string-atom table yet
 static void threadFunc(const StringAtom& a0) {
     
     Oryol::Core::CoreFacade::EnterThread();
     
-    // transfer into a thread-local string atom
+    // copy and re-create in another thread, all must share the same data
     StringAtom a1(a0);
-    StringAtom a2(a0);
+    StringAtom a2("BLOB");
     CHECK(a0 == a1);
     CHECK(a1 == a2);
+    CHECK(a0.AsCStr() == a2.AsCStr());
     CHECK(a1.AsString() == "BLOB");
     CHECK(a0.AsString() == "BLOB");
     CHECK(a2.AsString() == "BLOB");
@@ -110,4 +149,52 @@ TEST(StringAtomPerformance) {
         chrono::duration<double> dur = end - start;
         Log::Info("run %d: %dx StringAtoms created: %f sec\n", i, numStringAtoms, dur.count());
     }
-}
\ No newline at end of file
+}
+#if ORYOL_HAS_THREADS
+// intern the same strings from several threads at the same time
+static const int32 numInternStrings = 100000;
+static char internStrings[numInternStrings][24];
+
+static void internThreadFunc(Array<StringAtom>* outAtoms) {
+    outAtoms->Reserve(numInternStrings);
+    for (int32 i = 0; i < numInternStrings; i++) {
+        outAtoms->EmplaceBack(internStrings[i]);
+    }
+}
+
+TEST(StringAtomConcurrentIntern) {
+
+    const int32 threadCounts[] = { 1, 2, 4, 8 };
+    for (int32 numThreads : threadCounts) {
+        // use new strings for each run, so that the threads race on insertion
+        for (int32 i = 0; i < numInternStrings; i++) {
+            std::snprintf(internStrings[i], sizeof(internStrings[i]), "intern_%d_%d", numThreads, i);
+        }
+        std::vector<Array<StringAtom>> atoms(numThreads);
+        
+        chrono::time_point<chrono::system_clock> start, end;
+        start = chrono::system_clock::now();
+        std::vector<std::thread> threads;
+        for (int32 i = 0; i < numThreads; i++) {
+            threads.emplace_back(internThreadFunc, &atoms[i]);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        end = chrono::system_clock::now();
+        chrono::duration<double> dur = end - start;
+        Log::Info("%d threads: %dx StringAtoms interned per thread: %f sec\n", numThreads, numInternStrings, dur.count());
+
+        // all threads must have received the same string data
+        for (int32 i = 1; i < numThreads; i++) {
+            CHECK(atoms[i].Size() == numInternStrings);
+            bool identical = true;
+            for (int32 j = 0; j < numInternStrings; j++) {
+                identical &= (atoms[0][j].AsCStr() == atoms[i][j].AsCStr());
+            }
+            CHECK(identical);
+        }
+        CHECK(atoms[0][123] == StringAtom(internStrings[123]));
+    }
+}
+#endif
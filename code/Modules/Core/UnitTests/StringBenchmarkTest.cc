@@ -0,0 +1,92 @@
+//------------------------------------------------------------------------------
+//  StringBenchmarkTest.cc
+//  Measure String construct/copy/compare throughput for local (short)
+//  and shared (long) strings, compared to std::string.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/String/String.h"
+#include "Core/Containers/Array.h"
+#include "Core/Log.h"
+#include <chrono>
+#include <string>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace std;
+
+static const int32 NumStrings = 1000;
+static const int32 NumIterations = 200;
+
+//------------------------------------------------------------------------------
+template<class STRING> void
+benchmark(const char* name, const Array<std::string>& src) {
+    chrono::time_point<chrono::system_clock> start, end;
+    chrono::duration<double> dur;
+    const int32 num = NumStrings * NumIterations;
+
+    // construct from raw C strings
+    Array<STRING> strings;
+    strings.Reserve(NumStrings);
+    start = chrono::system_clock::now();
+    for (int32 iter = 0; iter < NumIterations; iter++) {
+        strings.Clear();
+        for (int32 i = 0; i < NumStrings; i++) {
+            strings.AddBack(STRING(src[i].c_str()));
+        }
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("%s: %d constructs: %f sec\n", name, num, dur.count());
+
+    // copy-construct
+    Array<STRING> copies;
+    copies.Reserve(NumStrings);
+    start = chrono::system_clock::now();
+    for (int32 iter = 0; iter < NumIterations; iter++) {
+        copies.Clear();
+        for (int32 i = 0; i < NumStrings; i++) {
+            copies.AddBack(strings[i]);
+        }
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("%s: %d copies: %f sec\n", name, num, dur.count());
+
+    // compare against neighbour and against copy
+    int32 numEqual = 0;
+    start = chrono::system_clock::now();
+    for (int32 iter = 0; iter < NumIterations; iter++) {
+        for (int32 i = 0; i < NumStrings; i++) {
+            if (strings[i] == copies[i]) {
+                numEqual++;
+            }
+            if (strings[i] == strings[(i + 1) % NumStrings]) {
+                numEqual++;
+            }
+        }
+    }
+    end = chrono::system_clock::now();
+    dur = end - start;
+    Log::Info("%s: %d compares: %f sec\n", name, num * 2, dur.count());
+    CHECK(numEqual == num);
+}
+
+//------------------------------------------------------------------------------
+TEST(StringBenchmark) {
+
+    Array<std::string> shortSrc;
+    Array<std::string> longSrc;
+    for (int32 i = 0; i < NumStrings; i++) {
+        std::string s = "str_" + std::to_string(i);
+        shortSrc.AddBack(s);
+        longSrc.AddBack("a_much_longer_string_" + s + "_with_a_suffix");
+    }
+    CHECK(int32(shortSrc[NumStrings - 1].length()) <= String::MaxLocalLength);
+    CHECK(int32(longSrc[0].length()) > String::MaxLocalLength);
+
+    benchmark<String>("String (short)", shortSrc);
+    benchmark<String>("String (long)", longSrc);
+    benchmark<std::string>("std::string (short)", shortSrc);
+    benchmark<std::string>("std::string (long)", longSrc);
+}
@@ -68,20 +68,68 @@ TEST(StringTest) {
     CHECK(str4 == blob);
     CHECK(str4 == "Blob");
     
-    // copy-assignment
+    // copy-assignment of short strings copies the characters
+    CHECK(str2.IsLocal());
     str0 = str2;
     CHECK(str0 == "Bla");
     CHECK(str0 == str2);
-    CHECK(str0.RefCount() == 2);
-    CHECK(str2.RefCount() == 2);
-    CHECK(str0.AsCStr() == str2.AsCStr());  // tests for identical pointers!
+    CHECK(str0.IsLocal());
+    CHECK(str0.RefCount() == 1);
+    CHECK(str2.RefCount() == 1);
+    CHECK(str0.AsCStr() != str2.AsCStr());
     str2.Clear();
     CHECK(str0 == "Bla");
     CHECK(str2.Empty());
-    CHECK(str0.RefCount() == 1);
     CHECK(str2.RefCount() == 0);
     str0.Clear();
     CHECK(str0.Empty());
+
+    // copy-assignment of long strings shares the string data
+    const char* longBla = "Bla Bla Bla Bla Bla Bla Bla";
+    String longStr(longBla);
+    CHECK(!longStr.IsLocal());
+    CHECK(longStr.Length() == 27);
+    CHECK(longStr.RefCount() == 1);
+    str0 = longStr;
+    CHECK(str0 == longBla);
+    CHECK(str0 == longStr);
+    CHECK(str0.RefCount() == 2);
+    CHECK(longStr.RefCount() == 2);
+    CHECK(str0.AsCStr() == longStr.AsCStr());  // tests for identical pointers!
+    longStr.Clear();
+    CHECK(str0 == longBla);
+    CHECK(longStr.Empty());
+    CHECK(longStr.IsLocal());
+    CHECK(str0.RefCount() == 1);
+    CHECK(longStr.RefCount() == 0);
+    str0.Clear();
+    CHECK(str0.Empty());
+
+    // boundary between local and shared strings
+    String maxLocal("0123456789012345678901");
+    CHECK(maxLocal.Length() == String::MaxLocalLength);
+    CHECK(maxLocal.IsLocal());
+    CHECK(maxLocal == "0123456789012345678901");
+    CHECK(maxLocal.Back() == '1');
+    String minShared("01234567890123456789012");
+    CHECK(minShared.Length() == String::MaxLocalLength + 1);
+    CHECK(!minShared.IsLocal());
+    CHECK(maxLocal != minShared);
+    CHECK(maxLocal < minShared);
+    String movedStr(std::move(minShared));
+    CHECK(!movedStr.IsLocal());
+    CHECK(movedStr.RefCount() == 1);
+    CHECK(minShared.Empty());
+    movedStr = std::move(maxLocal);
+    CHECK(movedStr.IsLocal());
+    CHECK(movedStr == "0123456789012345678901");
+    CHECK(maxLocal.Empty());
+
+    // embedded 0-bytes are preserved in local strings
+    String rawStr("ab\0cd", 0, 5);
+    CHECK(rawStr.Length() == 5);
+    CHECK(rawStr.IsLocal());
+    CHECK(rawStr.AsCStr()[3] == 'c');
     
     // move-assignment
     str2 = std::move(str3);
@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+//  StringViewTest.cc
+//  Test StringView class.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/String/StringView.h"
+#include "Core/String/String.h"
+#include "Core/String/StringAtom.h"
+#include "Core/String/StringBuilder.h"
+
+using namespace Oryol;
+using namespace Oryol::Core;
+
+TEST(StringViewTest) {
+
+    // construction
+    StringView view0;
+    CHECK(view0.Empty());
+    CHECK(!view0.IsValid());
+    CHECK(view0.Length() == 0);
+    CHECK(view0.Front() == 0);
+    CHECK(view0.Back() == 0);
+    CHECK(view0 == "");
+    const char* nullPointer = nullptr;
+    StringView view1(nullPointer);
+    CHECK(view1.Empty());
+    CHECK(view0 == view1);
+
+    const char* hello = "Hello World!";
+    StringView view2(hello);
+    CHECK(view2.IsValid());
+    CHECK(view2.Length() == 12);
+    CHECK(view2.Ptr() == hello);
+    CHECK(view2.Front() == 'H');
+    CHECK(view2.Back() == '!');
+    CHECK(view2[6] == 'W');
+    CHECK(view2 == "Hello World!");
+    CHECK("Hello World!" == view2);
+    CHECK(view2 != "Hello World");
+    CHECK(view2 != view0);
+
+    // view doesn't need to be 0-terminated
+    StringView view3(hello, 5);
+    CHECK(view3.Length() == 5);
+    CHECK(view3 == "Hello");
+    CHECK(view3 != "Hello World!");
+    CHECK(view2.StartsWith(view3));
+    CHECK(!view3.StartsWith(view2));
+
+    // sub-views
+    CHECK(view2.GetSubView(6, EndOfString) == "World!");
+    CHECK(view2.GetSubView(0, 5) == view3);
+    CHECK(view2.GetSubView(5, 5).Empty());
+    CHECK(view2.GetSubView(6, 11).Ptr() == hello + 6);
+    CHECK(StringView("  \tbla \r\n").Trim(" \t\r\n") == "bla");
+    CHECK(StringView(" \r\n").Trim(" \t\r\n").Empty());
+    CHECK(StringView("bla").Trim(" ") == "bla");
+
+    // find functions stay inside the view
+    CHECK(view2.FindFirstOf(0, EndOfString, "o") == 4);
+    CHECK(view2.FindFirstOf(5, EndOfString, "o") == 7);
+    CHECK(view2.FindFirstOf(0, 4, "o") == InvalidIndex);
+    CHECK(view3.FindFirstOf(0, EndOfString, "W") == InvalidIndex);
+    CHECK(view2.FindFirstOf(0, EndOfString, "!") == 11);
+    CHECK(view2.FindFirstNotOf(0, EndOfString, "Hel") == 4);
+    CHECK(view3.FindFirstNotOf(0, EndOfString, "Helo") == InvalidIndex);
+    CHECK(view2.FindSubString(0, EndOfString, "World") == 6);
+    CHECK(view2.FindSubString(0, 6, "World") == InvalidIndex);
+    CHECK(view2.FindSubString(0, EndOfString, "World!!") == InvalidIndex);
+    CHECK(view3.FindSubString(0, EndOfString, "lo W") == InvalidIndex);
+    CHECK(StringView("http://bla").FindSubString(0, 8, "://") == 4);
+    CHECK(StringView("ab").FindSubString(0, 8, "://") == InvalidIndex);
+
+    // String and StringAtom
+    String str(view3);
+    CHECK(str == "Hello");
+    CHECK(str == view3);
+    CHECK(view3 == str);
+    CHECK(str.AsStringView() == "Hello");
+    CHECK(str.AsStringView().Ptr() == str.AsCStr());
+    str = view2.GetSubView(6, EndOfString);
+    CHECK(str == "World!");
+    str = str.AsStringView().GetSubView(1, 3);
+    CHECK(str == "or");
+    StringAtom atom(view3);
+    CHECK(atom == "Hello");
+    CHECK(atom.AsStringView() == "Hello");
+    CHECK(atom.AsStringView().Ptr() == atom.AsCStr());
+    CHECK(StringAtom().AsStringView().Empty());
+    atom = view2;
+    CHECK(atom == "Hello World!");
+
+    // StringBuilder
+    StringBuilder builder;
+    CHECK(builder.AsStringView().Empty());
+    builder.Set(view3);
+    builder.Append(view2.GetSubView(5, EndOfString));
+    CHECK(builder.AsStringView() == "Hello World!");
+    CHECK(builder.GetSubView(6, EndOfString) == "World!");
+    CHECK(builder.GetSubView(6, EndOfString).Ptr() == builder.AsCStr() + 6);
+    CHECK(StringBuilder::FindFirstOf(view3, 0, EndOfString, "l") == 2);
+    CHECK(StringBuilder::FindSubString(view2, 0, EndOfString, "World") == 6);
+}
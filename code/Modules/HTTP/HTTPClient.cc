@@ -25,10 +25,8 @@ HTTPClient::~HTTPClient() {
 //------------------------------------------------------------------------------
 bool
 HTTPClient::Put(const Ptr<Message>& msg) {
-    o_assert(msg->IsMemberOf(HTTPProtocol::GetProtocolId()));
-    Ptr<HTTPProtocol::HTTPRequest> req = msg.dynamicCast<HTTPProtocol::HTTPRequest>();
-    o_assert(req.isValid());
-    this->loader.putRequest(req);
+    o_assert(msg->IsA<HTTPProtocol::HTTPRequest>());
+    this->loader.putRequest(msg.staticCast<HTTPProtocol::HTTPRequest>());
     return true;
 }
 
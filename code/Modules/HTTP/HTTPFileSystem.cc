@@ -3,6 +3,12 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "HTTPFileSystem.h"
+#include "IO/SubStream.h"
+#include "Core/Log.h"
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
 
 namespace Oryol {
 namespace HTTP {
@@ -11,9 +17,13 @@ OryolClassImpl(HTTPFileSystem);
 
 using namespace Core;
 using namespace IO;
+using namespace Time;
 
 //------------------------------------------------------------------------------
-HTTPFileSystem::HTTPFileSystem() {
+HTTPFileSystem::HTTPFileSystem() :
+etagString("ETag"),
+lastModifiedString("Last-Modified"),
+jitterState(uint32(uintptr_t(this)) | 1) {
     this->httpClient = HTTPClient::Create();
 }
 
@@ -25,18 +35,7 @@ HTTPFileSystem::~HTTPFileSystem() {
 //------------------------------------------------------------------------------
 void
 HTTPFileSystem::onGet(const Ptr<IOProtocol::Get>& msg) {
-
-    // convert the IO request into a HTTP request and push to HTTPClient
-    Ptr<HTTPProtocol::HTTPRequest> httpReq = HTTPProtocol::HTTPRequest::Create();
-    httpReq->SetMethod(HTTPMethod::Get);
-    httpReq->SetURL(msg->GetURL());
-    this->httpClient->Put(httpReq);
-    
-    // add to pending requests
-    pendingRequest pending;
-    pending.ioRequest = msg;
-    pending.httpRequest = httpReq;
-    this->pendingRequests.AddBack(pending);
+    this->addRequest(msg, Map<String,String>());
 }
 
 //------------------------------------------------------------------------------
@@ -47,45 +46,390 @@ HTTPFileSystem::onGetRange(const Ptr<IOProtocol::GetRange>& msg) {
     this->stringBuilder.Format(64, "bytes=%d-%d", msg->GetStartOffset(), msg->GetEndOffset());
     Map<String,String> requestHeaders;
     requestHeaders.Insert("Range", this->stringBuilder.GetString());
-    
+    this->addRequest(msg, requestHeaders);
+}
+
+//------------------------------------------------------------------------------
+void
+HTTPFileSystem::onGetRanges(const Ptr<IOProtocol::GetRanges>& msg) {
+    o_assert(!msg->GetPipe().isValid());
+    const Array<int32>& startOffsets = msg->GetStartOffsets();
+    const Array<int32>& endOffsets = msg->GetEndOffsets();
+    o_assert(startOffsets.Size() == endOffsets.Size());
+    if (startOffsets.Empty()) {
+        msg->SetStatus(IOStatus::BadRequest);
+        msg->SetErrorDesc(IOStatus::ToString(IOStatus::BadRequest));
+        msg->SetHandled();
+        return;
+    }
+
+    // all ranges go into a single Range header
+    this->stringBuilder.Set("bytes=");
+    for (int32 i = 0; i < startOffsets.Size(); i++) {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "%s%d-%d", (i > 0) ? "," : "", startOffsets[i], endOffsets[i]);
+        this->stringBuilder.Append(buf);
+    }
+    Map<String,String> requestHeaders;
+    requestHeaders.Insert("Range", this->stringBuilder.GetString());
+    this->addRequest(msg, requestHeaders);
+}
+
+//------------------------------------------------------------------------------
+void
+HTTPFileSystem::addRequest(const Ptr<IOProtocol::Get>& msg, const Map<String,String>& requestHeaders) {
+    pendingRequest pending;
+    pending.ioRequest = msg;
+    pending.requestHeaders = requestHeaders;
+
+    // revalidate a cached copy with a conditional request, an ETag
+    // is always quoted (optionally with a W/ prefix), otherwise
+    // the validator is a Last-Modified date
+    const String& cachedValidator = msg->GetCachedValidator();
+    if (!cachedValidator.Empty()) {
+        const char* validatorStr = cachedValidator.AsCStr();
+        const bool isETag = ('"' == validatorStr[0]) || (0 == std::strncmp(validatorStr, "W/", 2));
+        pending.requestHeaders.Insert(isETag ? "If-None-Match" : "If-Modified-Since", cachedValidator);
+    }
+    pending.startTime = Clock::Now();
+    pending.numRetries = 0;
+    pending.retryTime = 0;
+    if (this->sendRequest(pending)) {
+        this->pendingRequests.AddBack(pending);
+    }
+    else {
+        this->failRequest(pending, IOStatus::RequestTimeout);
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+HTTPFileSystem::sendRequest(pendingRequest& pending) {
+    const Ptr<IOProtocol::Get>& msg = pending.ioRequest;
+
+    // the HTTP request gets the time which is left of the IO request's timeout
+    int32 timeout = 0;
+    if (msg->GetTimeout() > 0) {
+        timeout = msg->GetTimeout() - int32(Clock::Since(pending.startTime).AsMilliSeconds());
+        if (timeout <= 0) {
+            return false;
+        }
+    }
+
     // convert the IO request into a HTTP request and push to HTTPClient
     Ptr<HTTPProtocol::HTTPRequest> httpReq = HTTPProtocol::HTTPRequest::Create();
     httpReq->SetMethod(HTTPMethod::Get);
     httpReq->SetURL(msg->GetURL());
-    httpReq->SetRequestHeaders(requestHeaders);
+    httpReq->SetRequestHeaders(pending.requestHeaders);
+    httpReq->SetResponsePipe(msg->GetPipe());
+    httpReq->SetTimeout(timeout);
     this->httpClient->Put(httpReq);
-    
-    // add to pending requests
-    pendingRequest pending;
-    pending.ioRequest = msg;
     pending.httpRequest = httpReq;
-    this->pendingRequests.AddBack(pending);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+HTTPFileSystem::isTransientError(IOStatus::Code status) {
+    return (IOStatus::DownloadError == status) ||
+           (IOStatus::RequestTimeout == status) ||
+           (IOStatus::BadGateway == status) ||
+           (IOStatus::ServiceUnavailable == status) ||
+           (IOStatus::GatewayTimeout == status);
+}
+
+//------------------------------------------------------------------------------
+/**
+ The retry delay doubles with each retry, and is randomized to the
+ range [delay/2, delay], so that many clients which failed at the
+ same time don't hammer the server at the same time again.
+*/
+bool
+HTTPFileSystem::scheduleRetry(pendingRequest& pending) {
+    const Ptr<IOProtocol::Get>& msg = pending.ioRequest;
+    if (msg->Cancelled() || msg->GetPipe().isValid() ||
+        (pending.numRetries >= msg->GetMaxRetries()) ||
+        !isTransientError(pending.httpRequest->GetResponse()->GetStatus())) {
+        return false;
+    }
+    int32 delay = ORYOL_IO_RETRY_BASE_DELAY << pending.numRetries;
+    if ((delay > ORYOL_IO_RETRY_MAX_DELAY) || (delay <= 0)) {
+        delay = ORYOL_IO_RETRY_MAX_DELAY;
+    }
+    this->jitterState ^= this->jitterState << 13;
+    this->jitterState ^= this->jitterState >> 17;
+    this->jitterState ^= this->jitterState << 5;
+    delay = (delay / 2) + int32(this->jitterState % uint32((delay / 2) + 1));
+
+    // don't bother if the request would be out of time
+    const int32 now = int32(Clock::Since(pending.startTime).AsMilliSeconds());
+    if ((msg->GetTimeout() > 0) && ((now + delay) >= msg->GetTimeout())) {
+        return false;
+    }
+    Log::Info("HTTPFileSystem: retrying '%s' in %d ms (%s)\n",
+        msg->GetURL().AsCStr(), delay, IOStatus::ToString(pending.httpRequest->GetResponse()->GetStatus()));
+    pending.numRetries++;
+    pending.retryTime = now + delay;
+    pending.httpRequest = 0;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+HTTPFileSystem::failRequest(const pendingRequest& pending, IOStatus::Code status) {
+    const Ptr<IOProtocol::Get>& msg = pending.ioRequest;
+    if (msg->GetPipe().isValid()) {
+        msg->GetPipe()->CloseWrite();
+    }
+    msg->SetStatus(status);
+    this->stringBuilder.Format(256, "%s: %s", msg->GetURL().AsCStr(), IOStatus::ToString(status));
+    msg->SetErrorDesc(this->stringBuilder.GetString());
+    msg->SetHandled();
+}
+
+//------------------------------------------------------------------------------
+bool
+HTTPFileSystem::HasPendingRequests() const {
+    return !this->pendingRequests.Empty();
+}
+
+//------------------------------------------------------------------------------
+/**
+ Requests waiting for a retry, and streaming requests whose pipe is
+ full (the transfer is paused until the reader drains it) don't
+ need the fast IO lane tick.
+*/
+bool
+HTTPFileSystem::IsTransferring() const {
+    for (const pendingRequest& cur : this->pendingRequests) {
+        if (cur.httpRequest.isValid()) {
+            const Ptr<ChunkPipe>& pipe = cur.ioRequest->GetPipe();
+            if (!pipe.isValid() || !pipe->IsFull() || cur.ioRequest->Cancelled()) {
+                return true;
+            }
+        }
+    }
+    return false;
 }
 
 //------------------------------------------------------------------------------
 void
 HTTPFileSystem::DoWork() {
     
+    // forward cancellation, cancelled HTTP requests are aborted by the HTTPClient
+    for (const pendingRequest& cur : this->pendingRequests) {
+        if (cur.ioRequest->Cancelled() && cur.httpRequest.isValid() && !cur.httpRequest->Cancelled()) {
+            cur.httpRequest->SetCancelled();
+        }
+    }
+
     // trigger our http client
     this->httpClient->DoWork();
     
     // process pending requests
     for (int i = this->pendingRequests.Size() - 1; i >= 0; i--) {
-        if (this->pendingRequests[i].httpRequest->Handled()) {
+        pendingRequest& cur = this->pendingRequests[i];
+        if (!cur.httpRequest.isValid()) {
+            // waiting for a retry
+            if (cur.ioRequest->Cancelled()) {
+                this->failRequest(cur, IOStatus::Cancelled);
+                this->pendingRequests.Erase(i);
+            }
+            else if (Clock::Since(cur.startTime).AsMilliSeconds() >= cur.retryTime) {
+                if (!this->sendRequest(cur)) {
+                    this->failRequest(cur, IOStatus::RequestTimeout);
+                    this->pendingRequests.Erase(i);
+                }
+            }
+        }
+        else if (cur.httpRequest->Handled() && !this->scheduleRetry(cur)) {
             // ok this request is done, transfer the interesting
             // stuff over to the ioRequest
-            const pendingRequest& cur = this->pendingRequests[i];
-            const Ptr<HTTPProtocol::HTTPResponse>& httpResponse = cur.httpRequest->GetResponse();
-            cur.ioRequest->SetStatus(httpResponse->GetStatus());
-            cur.ioRequest->SetStream(httpResponse->GetBody());
-            cur.ioRequest->SetErrorDesc(httpResponse->GetErrorDesc());
-            cur.ioRequest->SetHandled();
+            this->finishRequest(cur);
             
             // of this request is done, remove from pending array
             this->pendingRequests.Erase(i);
         }
     }
 }
+
+//------------------------------------------------------------------------------
+void
+HTTPFileSystem::finishRequest(const pendingRequest& cur) {
+    const Ptr<HTTPProtocol::HTTPResponse>& httpResponse = cur.httpRequest->GetResponse();
+    cur.ioRequest->SetStatus(httpResponse->GetStatus());
+    cur.ioRequest->SetStream(httpResponse->GetBody());
+    const Map<String,String>& responseHeaders = httpResponse->GetResponseHeaders();
+    if (responseHeaders.Contains(this->etagString)) {
+        cur.ioRequest->SetValidator(responseHeaders[this->etagString]);
+    }
+    else if (responseHeaders.Contains(this->lastModifiedString)) {
+        cur.ioRequest->SetValidator(responseHeaders[this->lastModifiedString]);
+    }
+    cur.ioRequest->SetErrorDesc(httpResponse->GetErrorDesc());
+    if (cur.ioRequest->IsA<IOProtocol::GetRanges>() &&
+        !this->splitRanges(cur.ioRequest.staticCast<IOProtocol::GetRanges>(), httpResponse)) {
+        this->stringBuilder.Format(256, "%s: response doesn't match the requested ranges", cur.ioRequest->GetURL().AsCStr());
+        cur.ioRequest->SetStatus(IOStatus::BadGateway);
+        cur.ioRequest->SetErrorDesc(this->stringBuilder.GetString());
+    }
+    cur.ioRequest->SetHandled();
+}
+
+//------------------------------------------------------------------------------
+/**
+ The RangeStreams are SubStreams into the response body, the body
+ remains the request's Stream. Error responses are left alone.
+*/
+bool
+HTTPFileSystem::splitRanges(const Ptr<IOProtocol::GetRanges>& msg, const Ptr<HTTPProtocol::HTTPResponse>& httpResponse) {
+    const IOStatus::Code status = httpResponse->GetStatus();
+    if ((IOStatus::OK != status) && (IOStatus::PartialContent != status)) {
+        return true;
+    }
+    const Ptr<Stream>& body = httpResponse->GetBody();
+    if (!body.isValid()) {
+        return false;
+    }
+    StringView bodyView;
+    if (body->Size() > 0) {
+        body->Open(OpenMode::ReadOnly);
+        bodyView = StringView((const char*) body->MapRead(nullptr), body->Size());
+        body->UnmapRead();
+        body->Close();
+    }
+
+    // find the byte ranges contained in the response body
+    Array<bodyPart> parts;
+    if (IOStatus::OK == status) {
+        // the server ignored the Range header, the body is the whole file
+        if (body->Size() > 0) {
+            parts.AddBack(bodyPart{ 0, body->Size() - 1, 0 });
+        }
+    }
+    else {
+        const Map<String,String>& responseHeaders = httpResponse->GetResponseHeaders();
+        StringView contentType;
+        if (responseHeaders.Contains("Content-Type")) {
+            contentType = StringView(responseHeaders["Content-Type"].AsCStr());
+        }
+        if (contentType.StartsWith("multipart/byteranges")) {
+            const int32 boundaryIndex = contentType.FindSubString(0, EndOfString, "boundary=");
+            if (InvalidIndex == boundaryIndex) {
+                return false;
+            }
+            StringBuilder delim("\r\n--");
+            delim.Append(contentType.GetSubView(boundaryIndex + 9, EndOfString).Trim("\" \t"));
+            const StringView delimView(delim.AsCStr(), delim.Length());
+
+            // the first delimiter may be at the start of the body without a leading CRLF
+            int32 pos = bodyView.StartsWith(delimView.GetSubView(2, EndOfString)) ?
+                        -2 : bodyView.FindSubString(0, EndOfString, delimView);
+            while (InvalidIndex != pos) {
+                const int32 lineStart = pos + delimView.Length();
+                if (bodyView.GetSubView(lineStart, EndOfString).StartsWith("--")) {
+                    // closing delimiter
+                    break;
+                }
+                const int32 headEnd = bodyView.FindSubString(lineStart, EndOfString, "\r\n\r\n");
+                if (InvalidIndex == headEnd) {
+                    return false;
+                }
+                const int32 dataStart = headEnd + 4;
+                const int32 dataEnd = bodyView.FindSubString(dataStart, EndOfString, delimView);
+                bodyPart part;
+                const StringView head = bodyView.GetSubView(lineStart, headEnd);
+                if ((InvalidIndex == dataEnd) ||
+                    !parseContentRange(findPartHeader(head, "Content-Range"), part.first, part.last) ||
+                    ((part.last - part.first + 1) != (dataEnd - dataStart))) {
+                    return false;
+                }
+                part.bodyOffset = dataStart;
+                parts.AddBack(part);
+                pos = dataEnd;
+            }
+        }
+        else if (responseHeaders.Contains("Content-Range")) {
+            bodyPart part;
+            const String& contentRange = responseHeaders["Content-Range"];
+            if (!parseContentRange(StringView(contentRange.AsCStr()), part.first, part.last) ||
+                ((part.last - part.first + 1) != body->Size())) {
+                return false;
+            }
+            part.bodyOffset = 0;
+            parts.AddBack(part);
+        }
+    }
+
+    // each requested range must start in one of the parts
+    const Array<int32>& startOffsets = msg->GetStartOffsets();
+    const Array<int32>& endOffsets = msg->GetEndOffsets();
+    Array<Ptr<Stream>> rangeStreams;
+    rangeStreams.Reserve(startOffsets.Size());
+    for (int32 i = 0; i < startOffsets.Size(); i++) {
+        const int32 start = startOffsets[i];
+        int32 partIndex = InvalidIndex;
+        for (int32 j = 0; j < parts.Size(); j++) {
+            if ((start >= parts[j].first) && (start <= parts[j].last)) {
+                partIndex = j;
+                break;
+            }
+        }
+        if (InvalidIndex == partIndex) {
+            return false;
+        }
+        const bodyPart& part = parts[partIndex];
+        const int32 end = (endOffsets[i] < part.last) ? endOffsets[i] : part.last;
+        rangeStreams.AddBack(SubStream::Create(body, part.bodyOffset + (start - part.first), (end - start) + 1));
+    }
+    msg->SetStatus(IOStatus::PartialContent);
+    msg->SetRangeStreams(rangeStreams);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+StringView
+HTTPFileSystem::findPartHeader(const StringView& head, const char* name) {
+    const int32 nameLen = int32(std::strlen(name));
+    int32 lineStart = 0;
+    while (lineStart < head.Length()) {
+        int32 lineEnd = head.FindSubString(lineStart, EndOfString, "\r\n");
+        if (InvalidIndex == lineEnd) {
+            lineEnd = head.Length();
+        }
+        const StringView line = head.GetSubView(lineStart, lineEnd);
+        if ((line.Length() > nameLen) && (line[nameLen] == ':')) {
+            bool match = true;
+            for (int32 i = 0; match && (i < nameLen); i++) {
+                match = std::tolower(line[i]) == std::tolower(name[i]);
+            }
+            if (match) {
+                return line.GetSubView(nameLen + 1, EndOfString).Trim(" \t");
+            }
+        }
+        lineStart = lineEnd + 2;
+    }
+    return StringView();
+}
+
+//------------------------------------------------------------------------------
+bool
+HTTPFileSystem::parseContentRange(const StringView& value, int32& outFirst, int32& outLast) {
+    if (!value.StartsWith("bytes ")) {
+        return false;
+    }
+    const int32 dash = value.FindFirstOf(6, EndOfString, "-");
+    if (InvalidIndex == dash) {
+        return false;
+    }
+    int32 slash = value.FindFirstOf(dash, EndOfString, "/");
+    if (InvalidIndex == slash) {
+        slash = value.Length();
+    }
+    outFirst = std::atoi(String(value.GetSubView(6, dash)).AsCStr());
+    outLast = std::atoi(String(value.GetSubView(dash + 1, slash)).AsCStr());
+    return (outFirst >= 0) && (outLast >= outFirst);
+}
     
 } // namespace HTTP
 } // namespace Oryol
\ No newline at end of file
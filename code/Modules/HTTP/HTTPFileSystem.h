@@ -6,11 +6,30 @@
     @see HTTPClient, FileSystem
     
     @todo: HTTPFileSystem description
+
+    A GetRanges request is sent as a single HTTP request with a
+    multi-range Range header ("bytes=0-99,500-599"). The response is
+    split into the request's RangeStreams without copying: a
+    multipart/byteranges response by its parts, a single-part 206
+    response (the server may merge overlapping or adjacent ranges) by
+    its Content-Range, and a 200 response (the server ignored the Range
+    header) by the requested offsets. A response which doesn't cover
+    all requested ranges fails the request with BadGateway.
+
+    Requests which fail with a transient error (no response, 408, 502,
+    503 or 504) are sent again up to MaxRetries times, after a jittered
+    exponential backoff (ORYOL_IO_RETRY_BASE_DELAY doubling up to
+    ORYOL_IO_RETRY_MAX_DELAY). Requests with a Pipe are not retried,
+    because the consumer may already have read data. The Timeout of a
+    request covers all attempts, a request which runs out of time fails
+    with RequestTimeout. Cancelling a request aborts its HTTP transfer.
 */
 #include "IO/FileSystem.h"
 #include "HTTP/HTTPProtocol.h"
 #include "HTTP/HTTPClient.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/String/StringView.h"
+#include "Time/Clock.h"
 
 namespace Oryol {
 namespace HTTP {
@@ -25,19 +44,58 @@ public:
     
     /// per-frame update
     virtual void DoWork();
+    /// return true if HTTP requests are in flight
+    virtual bool HasPendingRequests() const override;
+    /// return true if a HTTP request is sent and not paused by a full pipe
+    virtual bool IsTransferring() const override;
     /// called when the IOProtocol::Get message is received
     virtual void onGet(const Core::Ptr<IO::IOProtocol::Get>& msg);
     /// called when the IOProtocol::GetRange message is received
     virtual void onGetRange(const Core::Ptr<IO::IOProtocol::GetRange>& msg);
+    /// called when the IOProtocol::GetRanges message is received
+    virtual void onGetRanges(const Core::Ptr<IO::IOProtocol::GetRanges>& msg) override;
 
 private:
-    Core::StringBuilder stringBuilder;
-    Core::Ptr<HTTPClient> httpClient;
+    /// an IO request and its current HTTP request
     struct pendingRequest {
         Core::Ptr<IO::IOProtocol::Get> ioRequest;
         Core::Ptr<HTTPProtocol::HTTPRequest> httpRequest;
+        Core::Map<Core::String,Core::String> requestHeaders;
+        Time::TimePoint startTime;
+        int32 numRetries;
+        int32 retryTime;    // in millisecs since startTime
     };
+    /// add an IO request to the pending requests, and send it
+    void addRequest(const Core::Ptr<IO::IOProtocol::Get>& msg, const Core::Map<Core::String,Core::String>& requestHeaders);
+    /// convert an IO request into a HTTP request and push to HTTPClient, return false if out of time
+    bool sendRequest(pendingRequest& pending);
+    /// decide if a failed request is tried again, and when
+    bool scheduleRetry(pendingRequest& pending);
+    /// complete a pending IO request from its HTTP response
+    void finishRequest(const pendingRequest& pending);
+    /// complete a pending IO request with an error status
+    void failRequest(const pendingRequest& pending, IO::IOStatus::Code status);
+    /// return true if a failed request may succeed when tried again
+    static bool isTransientError(IO::IOStatus::Code status);
+    /// split the response of a GetRanges request into its RangeStreams, return false if malformed
+    bool splitRanges(const Core::Ptr<IO::IOProtocol::GetRanges>& msg, const Core::Ptr<HTTPProtocol::HTTPResponse>& httpResponse);
+    /// find a header value in a multipart part head, returns empty view if not found
+    static Core::StringView findPartHeader(const Core::StringView& head, const char* name);
+    /// parse a "bytes FIRST-LAST/TOTAL" Content-Range value
+    static bool parseContentRange(const Core::StringView& value, int32& outFirst, int32& outLast);
+
+    /// a byte range of the response body
+    struct bodyPart {
+        int32 first;
+        int32 last;
+        int32 bodyOffset;
+    };
+    const Core::String etagString;
+    const Core::String lastModifiedString;
+    Core::StringBuilder stringBuilder;
+    Core::Ptr<HTTPClient> httpClient;
     Core::Array<pendingRequest> pendingRequests;
+    uint32 jitterState;
 };
     
 } // namespace HTTP
@@ -1,13 +1,13 @@
 //-----------------------------------------------------------------------------
-// #version:2# machine generated, do not edit!
+// #version:7# machine generated, do not edit!
 //-----------------------------------------------------------------------------
 #include "Pre.h"
 #include "HTTPProtocol.h"
 
 namespace Oryol {
 namespace HTTP {
-OryolClassPoolAllocImpl(HTTPProtocol::HTTPResponse);
-OryolClassPoolAllocImpl(HTTPProtocol::HTTPRequest);
+OryolClassRecycleImpl(HTTPProtocol::HTTPResponse);
+OryolClassRecycleImpl(HTTPProtocol::HTTPRequest);
 HTTPProtocol::CreateCallback HTTPProtocol::jumpTable[HTTPProtocol::MessageId::NumMessageIds] = { 
     &HTTPProtocol::HTTPResponse::FactoryCreate,
     &HTTPProtocol::HTTPRequest::FactoryCreate,
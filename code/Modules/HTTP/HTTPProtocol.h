@@ -1,6 +1,6 @@
 #pragma once
 //-----------------------------------------------------------------------------
-/* #version:2#
+/* #version:7#
     machine generated, do not edit!
 */
 #include <cstring>
@@ -12,6 +12,7 @@
 #include "Core/Containers/Map.h"
 #include "Core/String/String.h"
 #include "IO/Stream.h"
+#include "IO/ChunkPipe.h"
 #include "IO/IOStatus.h"
 
 namespace Oryol {
@@ -21,6 +22,12 @@ public:
     static Messaging::ProtocolIdType GetProtocolId() {
         return 'HTPR';
     };
+    static Messaging::ProtocolIdType GetBaseProtocolId() {
+        return 'HTPR';
+    };
+    static uint64 GetMessageIdBits() {
+        return (uint64(1) << MessageId::HTTPResponseId) | (uint64(1) << MessageId::HTTPRequestId);
+    };
     class MessageId {
     public:
         enum {
@@ -41,6 +48,7 @@ public:
             return Messaging::InvalidMessageId;
         };
     };
+    static_assert(MessageId::NumMessageIds <= Messaging::MaxNumMessageIds, "too many message ids in protocol hierarchy");
     typedef Core::Ptr<Messaging::Message> (*CreateCallback)();
     static CreateCallback jumpTable[HTTPProtocol::MessageId::NumMessageIds];
     class Factory {
@@ -48,11 +56,20 @@ public:
         static Core::Ptr<Messaging::Message> Create(Messaging::MessageIdType id);
     };
     class HTTPResponse : public Messaging::Message {
-        OryolClassPoolAllocDecl(HTTPResponse);
+        OryolClassRecycleDecl(HTTPResponse);
     public:
         HTTPResponse() {
             this->msgId = MessageId::HTTPResponseId;
+            this->baseProtId = HTTPProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+            this->status = IO::IOStatus::InvalidIOStatus;
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
             this->status = IO::IOStatus::InvalidIOStatus;
+            this->responseheaders.Clear();
+            this->body = Core::Ptr<IO::Stream>();
+            this->errordesc = Core::String();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -60,9 +77,17 @@ public:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::HTTPResponseId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'HTPR') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return HTTPProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::HTTPResponseId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'HTPR';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
         void SetStatus(const IO::IOStatus::Code& val) {
             this->status = val;
@@ -95,11 +120,24 @@ private:
         Core::String errordesc;
     };
     class HTTPRequest : public Messaging::Message {
-        OryolClassPoolAllocDecl(HTTPRequest);
+        OryolClassRecycleDecl(HTTPRequest);
     public:
         HTTPRequest() {
             this->msgId = MessageId::HTTPRequestId;
+            this->baseProtId = HTTPProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
             this->method = HTTP::HTTPMethod::Get;
+            this->timeout = 0;
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
+            this->method = HTTP::HTTPMethod::Get;
+            this->url = IO::URL();
+            this->requestheaders.Clear();
+            this->body = Core::Ptr<IO::Stream>();
+            this->responsepipe = Core::Ptr<IO::ChunkPipe>();
+            this->timeout = 0;
+            this->response = Core::Ptr<HTTPProtocol::HTTPResponse>();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -107,9 +145,17 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::HTTPRequestId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'HTPR') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return HTTPProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::HTTPRequestId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'HTPR';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
         void SetMethod(const HTTP::HTTPMethod::Code& val) {
             this->method = val;
@@ -135,6 +181,18 @@ private:
         const Core::Ptr<IO::Stream>& GetBody() const {
             return this->body;
         };
+        void SetResponsePipe(const Core::Ptr<IO::ChunkPipe>& val) {
+            this->responsepipe = val;
+        };
+        const Core::Ptr<IO::ChunkPipe>& GetResponsePipe() const {
+            return this->responsepipe;
+        };
+        void SetTimeout(int32 val) {
+            this->timeout = val;
+        };
+        int32 GetTimeout() const {
+            return this->timeout;
+        };
         void SetResponse(const Core::Ptr<HTTPProtocol::HTTPResponse>& val) {
             this->response = val;
         };
@@ -146,6 +204,8 @@ private:
         IO::URL url;
         Core::Map<Core::String,Core::String> requestheaders;
         Core::Ptr<IO::Stream> body;
+        Core::Ptr<IO::ChunkPipe> responsepipe;
+        int32 timeout;
         Core::Ptr<HTTPProtocol::HTTPResponse> response;
     };
 };
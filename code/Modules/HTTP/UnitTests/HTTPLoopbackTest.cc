@@ -0,0 +1,581 @@
+//------------------------------------------------------------------------------
+//  HTTPLoopbackTest.cc
+//  Test concurrent requests, connection reuse and out-of-order
+//  completion against a local TestHTTPServer.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "HTTP/HTTPClient.h"
+#include "HTTP/HTTPFileSystem.h"
+#include "Core/String/StringBuilder.h"
+#include "IO/MemoryStream.h"
+#include "IO/IOFacade.h"
+#include "IO/DiskCache.h"
+#include "Core/CoreFacade.h"
+#include "Time/Clock.h"
+#include "TestHTTPServer.h"
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::IO;
+using namespace Oryol::HTTP;
+using namespace Oryol::Time;
+
+#if ORYOL_LINUX || ORYOL_MACOS
+//------------------------------------------------------------------------------
+static Ptr<HTTPProtocol::HTTPRequest>
+makeRequest(const TestHTTPServer& server, const char* path) {
+    Ptr<HTTPProtocol::HTTPRequest> req = HTTPProtocol::HTTPRequest::Create();
+    req->SetURL(server.MakeURL(path));
+    return req;
+}
+
+//------------------------------------------------------------------------------
+static bool
+checkData(const Ptr<Stream>& body, int32 offset, int32 size) {
+    if (!body.isValid() || (body->Size() != size)) {
+        return false;
+    }
+    body->Open(OpenMode::ReadOnly);
+    const uint8* end = nullptr;
+    const uint8* ptr = body->MapRead(&end);
+    bool ok = true;
+    for (int32 i = 0; i < size; i++) {
+        if (ptr[i] != TestHTTPServer::DataByte(offset + i)) {
+            ok = false;
+            break;
+        }
+    }
+    body->UnmapRead();
+    body->Close();
+    return ok;
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackConcurrentTest) {
+    TestHTTPServer server;
+    server.Start();
+    Ptr<HTTPClient> httpClient = HTTPClient::Create();
+
+    // many requests of different sizes, all in flight at the same time
+    const int32 numRequests = 64;
+    Array<Ptr<HTTPProtocol::HTTPRequest>> requests;
+    StringBuilder strBuilder;
+    for (int32 i = 0; i < numRequests; i++) {
+        strBuilder.Format(64, "/data/%d", (i + 1) * 1000);
+        requests.AddBack(makeRequest(server, strBuilder.AsCStr()));
+        httpClient->Put(requests.Back());
+    }
+    bool allHandled = false;
+    while (!allHandled) {
+        httpClient->DoWork();
+        allHandled = true;
+        for (const auto& req : requests) {
+            allHandled &= req->Handled();
+        }
+    }
+    for (int32 i = 0; i < numRequests; i++) {
+        const Ptr<HTTPProtocol::HTTPResponse>& response = requests[i]->GetResponse();
+        CHECK(response.isValid());
+        CHECK(response->GetStatus() == IOStatus::OK);
+        CHECK(response->GetBody()->GetContentType().TypeAndSubType() == "application/octet-stream");
+        CHECK(checkData(response->GetBody(), 0, (i + 1) * 1000));
+    }
+    CHECK(server.NumRequests() == numRequests);
+    CHECK(server.MaxConcurrentRequests() > 1);
+
+    // idle connections must be reused instead of opening new ones
+    CHECK(server.NumConnections() < numRequests);
+    #if ORYOL_LINUX
+    CHECK(server.NumConnections() <= curlURLLoader::MaxConnectionsPerHost);
+    #endif
+    const int32 numConnections = server.NumConnections();
+    Ptr<HTTPProtocol::HTTPRequest> again = makeRequest(server, "/data/100");
+    httpClient->Put(again);
+    while (!again->Handled()) {
+        httpClient->DoWork();
+    }
+    CHECK(again->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(server.NumConnections() == numConnections);
+
+    server.Stop();
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackOutOfOrderTest) {
+    TestHTTPServer server;
+    server.Start();
+    Ptr<HTTPClient> httpClient = HTTPClient::Create();
+
+    // a slow request must not hold back the requests behind it
+    Ptr<HTTPProtocol::HTTPRequest> slow = makeRequest(server, "/delay/1000/data/16");
+    httpClient->Put(slow);
+    Array<Ptr<HTTPProtocol::HTTPRequest>> fast;
+    for (int32 i = 0; i < 4; i++) {
+        fast.AddBack(makeRequest(server, "/data/16"));
+        httpClient->Put(fast.Back());
+    }
+    bool fastHandled = false;
+    while (!fastHandled) {
+        httpClient->DoWork();
+        fastHandled = true;
+        for (const auto& req : fast) {
+            fastHandled &= req->Handled();
+        }
+    }
+    CHECK(!slow->Handled());
+    while (!slow->Handled()) {
+        httpClient->DoWork();
+    }
+    CHECK(slow->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(checkData(slow->GetResponse()->GetBody(), 0, 16));
+
+    server.Stop();
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackStatusTest) {
+    TestHTTPServer server;
+    server.Start();
+    Ptr<HTTPClient> httpClient = HTTPClient::Create();
+
+    // error status codes, a range request and a POST
+    Ptr<HTTPProtocol::HTTPRequest> req404 = makeRequest(server, "/status/404");
+    Ptr<HTTPProtocol::HTTPRequest> req500 = makeRequest(server, "/status/500");
+    Ptr<HTTPProtocol::HTTPRequest> reqRange = makeRequest(server, "/data/1000");
+    Map<String,String> rangeHeaders;
+    rangeHeaders.Insert("Range", "bytes=100-199");
+    reqRange->SetRequestHeaders(rangeHeaders);
+    Ptr<HTTPProtocol::HTTPRequest> reqPost = makeRequest(server, "/echo");
+    reqPost->SetMethod(HTTPMethod::Post);
+    Ptr<MemoryStream> postBody = MemoryStream::Create();
+    postBody->SetContentType("text/plain");
+    postBody->Open(OpenMode::WriteOnly);
+    postBody->Write("Hello World!", 12);
+    postBody->Close();
+    reqPost->SetBody(postBody);
+    httpClient->Put(req404);
+    httpClient->Put(req500);
+    httpClient->Put(reqRange);
+    httpClient->Put(reqPost);
+    while (!(req404->Handled() && req500->Handled() && reqRange->Handled() && reqPost->Handled())) {
+        httpClient->DoWork();
+    }
+    CHECK(req404->GetResponse()->GetStatus() == IOStatus::NotFound);
+    CHECK(req500->GetResponse()->GetStatus() == IOStatus::InternalServerError);
+    CHECK(reqRange->GetResponse()->GetStatus() == IOStatus::PartialContent);
+    CHECK(checkData(reqRange->GetResponse()->GetBody(), 100, 100));
+    const Ptr<Stream>& echo = reqPost->GetResponse()->GetBody();
+    CHECK(reqPost->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(echo->GetContentType().TypeAndSubType() == "text/plain");
+    CHECK(echo->Size() == 12);
+    if (echo->Size() == 12) {
+        echo->Open(OpenMode::ReadOnly);
+        char buf[12];
+        echo->Read(buf, 12);
+        echo->Close();
+        CHECK(0 == std::memcmp(buf, "Hello World!", 12));
+    }
+
+    server.Stop();
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackStreamingTest) {
+    TestHTTPServer server;
+    server.Start();
+    Ptr<HTTPClient> httpClient = HTTPClient::Create();
+
+    // without a pipe, the response body is allocated once from the Content-Length
+    Ptr<HTTPProtocol::HTTPRequest> req = makeRequest(server, "/data/1000000");
+    httpClient->Put(req);
+    while (!req->Handled()) {
+        httpClient->DoWork();
+    }
+    Ptr<MemoryStream> body = req->GetResponse()->GetBody().dynamicCast<MemoryStream>();
+    CHECK(body.isValid());
+    CHECK(body->Size() == 1000000);
+    CHECK(body->Capacity() == 1000000);
+    CHECK(checkData(body, 0, 1000000));
+
+    // stream a big response through a small pipe which is drained slowly,
+    // the transfer must be paused instead of buffering the whole body
+    const int32 size = 8 * 1024 * 1024;
+    const int32 pipeCapacity = 256 * 1024;
+    Ptr<ChunkPipe> pipe = ChunkPipe::Create(pipeCapacity);
+    req = makeRequest(server, "/data/8388608");
+    req->SetResponsePipe(pipe);
+    httpClient->Put(req);
+    int32 numRead = 0;
+    bool allValid = true;
+    uint8 buf[64 * 1024];
+    while (!(req->Handled() && pipe->IsEmpty())) {
+        httpClient->DoWork();
+        const int32 num = pipe->Read(buf, sizeof(buf));
+        for (int32 i = 0; i < num; i++) {
+            allValid &= (buf[i] == TestHTTPServer::DataByte(numRead + i));
+        }
+        numRead += num;
+    }
+    CHECK(req->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(pipe->IsEndOfStream());
+    CHECK(pipe->GetContentLength() == size);
+    CHECK(pipe->GetContentType().TypeAndSubType() == "application/octet-stream");
+    CHECK(numRead == size);
+    CHECK(allValid);
+    CHECK(pipe->MaxBuffered() < 2 * pipeCapacity);
+    CHECK(req->GetResponse()->GetBody()->Size() == 0);
+
+    // an error response isn't streamed
+    pipe = ChunkPipe::Create();
+    req = makeRequest(server, "/status/404");
+    req->SetResponsePipe(pipe);
+    httpClient->Put(req);
+    while (!req->Handled()) {
+        httpClient->DoWork();
+    }
+    CHECK(req->GetResponse()->GetStatus() == IOStatus::NotFound);
+    CHECK(pipe->IsEndOfStream());
+    CHECK(pipe->NumBytesRead() == 0);
+
+    // stream a range through the HTTPFileSystem
+    Ptr<HTTPFileSystem> fs = HTTPFileSystem::Create();
+    Ptr<IOProtocol::GetRange> ioReq = IOProtocol::GetRange::Create();
+    ioReq->SetURL(server.MakeURL("/data/100000"));
+    ioReq->SetStartOffset(1000);
+    ioReq->SetEndOffset(50999);
+    ioReq->SetPipe(ChunkPipe::Create(4096));
+    fs->onGetRange(ioReq);
+    CHECK(fs->HasPendingRequests());
+    numRead = 0;
+    allValid = true;
+    while (!(ioReq->Handled() && ioReq->GetPipe()->IsEmpty())) {
+        fs->DoWork();
+        const int32 num = ioReq->GetPipe()->Read(buf, 1024);
+        for (int32 i = 0; i < num; i++) {
+            allValid &= (buf[i] == TestHTTPServer::DataByte(1000 + numRead + i));
+        }
+        numRead += num;
+    }
+    CHECK(!fs->HasPendingRequests());
+    CHECK(ioReq->GetStatus() == IOStatus::PartialContent);
+    CHECK(numRead == 50000);
+    CHECK(allValid);
+
+    server.Stop();
+}
+
+//------------------------------------------------------------------------------
+static Ptr<IOProtocol::GetRanges>
+getRanges(const Ptr<HTTPFileSystem>& fs, const String& url) {
+    Ptr<IOProtocol::GetRanges> ioReq = IOProtocol::GetRanges::Create();
+    ioReq->SetURL(url);
+    ioReq->SetStartOffsets(Array<int32>({ 100, 5000, 200 }));
+    ioReq->SetEndOffsets(Array<int32>({ 199, 5049, 299 }));
+    fs->onGetRanges(ioReq);
+    while (!ioReq->Handled()) {
+        fs->DoWork();
+    }
+    return ioReq;
+}
+
+//------------------------------------------------------------------------------
+static bool
+checkRanges(const Ptr<IOProtocol::GetRanges>& ioReq) {
+    const Array<Ptr<Stream>>& streams = ioReq->GetRangeStreams();
+    return (ioReq->GetStatus() == IOStatus::PartialContent) &&
+           (streams.Size() == 3) &&
+           checkData(streams[0], 100, 100) &&
+           checkData(streams[1], 5000, 50) &&
+           checkData(streams[2], 200, 100);
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackRangesTest) {
+    TestHTTPServer server;
+    server.Start();
+    Ptr<HTTPFileSystem> fs = HTTPFileSystem::Create();
+
+    // several ranges in one multipart/byteranges response
+    Ptr<IOProtocol::GetRanges> ioReq = getRanges(fs, server.MakeURL("/data/10000"));
+    CHECK(checkRanges(ioReq));
+    CHECK(ioReq->GetStream()->Size() > 250);
+    CHECK(server.NumRequests() == 1);
+
+    // the server merged the ranges into a single range
+    ioReq = getRanges(fs, server.MakeURL("/merge/10000"));
+    CHECK(checkRanges(ioReq));
+    CHECK(ioReq->GetStream()->Size() == 4950);
+
+    // the server ignored the Range header
+    ioReq = getRanges(fs, server.MakeURL("/plain/10000"));
+    CHECK(checkRanges(ioReq));
+    CHECK(ioReq->GetStream()->Size() == 10000);
+
+    // a range behind the end of the data
+    ioReq = getRanges(fs, server.MakeURL("/plain/1000"));
+    CHECK(ioReq->GetStatus() == IOStatus::BadGateway);
+    CHECK(ioReq->GetRangeStreams().Empty());
+    ioReq = getRanges(fs, server.MakeURL("/data/4000"));
+    CHECK(ioReq->GetStatus() == IOStatus::RequestedRangeNotSatisfiable);
+    CHECK(ioReq->GetRangeStreams().Empty());
+    CHECK(server.NumRequests() == 5);
+
+    server.Stop();
+}
+
+//------------------------------------------------------------------------------
+static Ptr<IOProtocol::Get>
+getFile(const Ptr<HTTPFileSystem>& fs, const String& url, int32 maxRetries, int32 timeout) {
+    Ptr<IOProtocol::Get> ioReq = IOProtocol::Get::Create();
+    ioReq->SetURL(url);
+    ioReq->SetMaxRetries(maxRetries);
+    ioReq->SetTimeout(timeout);
+    fs->onGet(ioReq);
+    while (!ioReq->Handled()) {
+        fs->DoWork();
+    }
+    return ioReq;
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackDeadlineTest) {
+    TestHTTPServer server;
+    server.Start();
+    Ptr<HTTPClient> httpClient = HTTPClient::Create();
+
+    // a hung server doesn't block the client beyond the timeout
+    TimePoint start = Clock::Now();
+    Ptr<HTTPProtocol::HTTPRequest> req = makeRequest(server, "/delay/2000/data/100");
+    req->SetTimeout(100);
+    httpClient->Put(req);
+    while (!req->Handled()) {
+        httpClient->DoWork();
+    }
+    CHECK(req->GetResponse()->GetStatus() == IOStatus::RequestTimeout);
+    CHECK(Clock::Since(start).AsMilliSeconds() < 1000.0);
+
+    // cancel a streaming transfer which is paused because nobody reads the pipe
+    Ptr<ChunkPipe> pipe = ChunkPipe::Create(64 * 1024);
+    req = makeRequest(server, "/data/8388608");
+    req->SetResponsePipe(pipe);
+    httpClient->Put(req);
+    while (!pipe->IsFull()) {
+        httpClient->DoWork();
+    }
+    for (int32 i = 0; i < 10; i++) {
+        httpClient->DoWork();
+    }
+    CHECK(!req->Handled());
+    req->SetCancelled();
+    httpClient->DoWork();
+    CHECK(req->Handled());
+    CHECK(req->GetResponse()->GetStatus() == IOStatus::Cancelled);
+    CHECK(pipe->NumBuffered() < 2 * pipe->Capacity());
+    uint8 buf[64 * 1024];
+    while (!pipe->IsEndOfStream()) {
+        pipe->Read(buf, sizeof(buf));
+    }
+
+    // the HTTPClient is still usable
+    req = makeRequest(server, "/data/100");
+    httpClient->Put(req);
+    while (!req->Handled()) {
+        httpClient->DoWork();
+    }
+    CHECK(checkData(req->GetResponse()->GetBody(), 0, 100));
+
+    // cancelling an IO request aborts its HTTP transfer
+    Ptr<HTTPFileSystem> fs = HTTPFileSystem::Create();
+    Ptr<IOProtocol::Get> ioReq = IOProtocol::Get::Create();
+    ioReq->SetURL(server.MakeURL("/delay/2000/data/100"));
+    fs->onGet(ioReq);
+    fs->DoWork();
+    ioReq->SetCancelled();
+    start = Clock::Now();
+    while (!ioReq->Handled()) {
+        fs->DoWork();
+    }
+    CHECK(ioReq->GetStatus() == IOStatus::Cancelled);
+    CHECK(Clock::Since(start).AsMilliSeconds() < 1000.0);
+    CHECK(!fs->HasPendingRequests());
+
+    server.Stop();
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackRetryTest) {
+    TestHTTPServer server;
+    server.Start();
+    Ptr<HTTPFileSystem> fs = HTTPFileSystem::Create();
+
+    // transient failures are retried
+    Ptr<IOProtocol::Get> ioReq = getFile(fs, server.MakeURL("/fail/2/data/100"), 2, 0);
+    CHECK(ioReq->GetStatus() == IOStatus::OK);
+    CHECK(checkData(ioReq->GetStream(), 0, 100));
+    CHECK(server.NumRequests() == 3);
+
+    // ...but not more often than MaxRetries
+    ioReq = getFile(fs, server.MakeURL("/fail/2/data/200"), 1, 0);
+    CHECK(ioReq->GetStatus() == IOStatus::ServiceUnavailable);
+    CHECK(server.NumRequests() == 5);
+
+    // permanent failures are not retried
+    ioReq = getFile(fs, server.MakeURL("/status/404"), 2, 0);
+    CHECK(ioReq->GetStatus() == IOStatus::NotFound);
+    CHECK(server.NumRequests() == 6);
+
+    // the timeout covers all attempts
+    TimePoint start = Clock::Now();
+    ioReq = getFile(fs, server.MakeURL("/fail/100/data/100"), 100, 300);
+    CHECK(ioReq->GetStatus() == IOStatus::ServiceUnavailable);
+    CHECK(Clock::Since(start).AsMilliSeconds() < 300.0);
+    ioReq = getFile(fs, server.MakeURL("/delay/2000/data/100"), 2, 100);
+    CHECK(ioReq->GetStatus() == IOStatus::RequestTimeout);
+
+    // cancel while waiting for a retry
+    ioReq = IOProtocol::Get::Create();
+    ioReq->SetURL(server.MakeURL("/fail/100/data/300"));
+    ioReq->SetMaxRetries(100);
+    fs->onGet(ioReq);
+    while (server.NumRequests() < 10) {
+        fs->DoWork();
+    }
+    ioReq->SetCancelled();
+    while (!ioReq->Handled()) {
+        fs->DoWork();
+    }
+    CHECK(ioReq->GetStatus() == IOStatus::Cancelled);
+    CHECK(!fs->HasPendingRequests());
+
+    server.Stop();
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackCompressionTest) {
+    TestHTTPServer server;
+    server.Start();
+    Ptr<HTTPClient> httpClient = HTTPClient::Create();
+
+    // gzip and deflate bodies are inflated while they arrive
+    Ptr<HTTPProtocol::HTTPRequest> reqGzip = makeRequest(server, "/gzip/100000");
+    Ptr<HTTPProtocol::HTTPRequest> reqDeflate = makeRequest(server, "/deflate/100000");
+    Ptr<HTTPProtocol::HTTPRequest> reqBad = makeRequest(server, "/badgzip/100000");
+    Ptr<HTTPProtocol::HTTPRequest> reqLower = makeRequest(server, "/lcgzip/100000");
+    httpClient->Put(reqGzip);
+    httpClient->Put(reqDeflate);
+    httpClient->Put(reqBad);
+    httpClient->Put(reqLower);
+    while (!(reqGzip->Handled() && reqDeflate->Handled() && reqBad->Handled() && reqLower->Handled())) {
+        httpClient->DoWork();
+    }
+    CHECK(reqGzip->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(reqGzip->GetResponse()->GetResponseHeaders()["Content-Encoding"] == "gzip");
+    CHECK(std::atoi(reqGzip->GetResponse()->GetResponseHeaders()["Content-Length"].AsCStr()) < 100000);
+    CHECK(checkData(reqGzip->GetResponse()->GetBody(), 0, 100000));
+    CHECK(reqDeflate->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(reqDeflate->GetResponse()->GetResponseHeaders()["Content-Encoding"] == "deflate");
+    CHECK(checkData(reqDeflate->GetResponse()->GetBody(), 0, 100000));
+    CHECK(reqBad->GetResponse()->GetStatus() == IOStatus::DownloadError);
+    // header names and content codings are case-insensitive
+    CHECK(reqLower->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(checkData(reqLower->GetResponse()->GetBody(), 0, 100000));
+
+    // a compressed body is inflated into the pipe, the content length is unknown
+    const int32 size = 4 * 1024 * 1024;
+    Ptr<ChunkPipe> pipe = ChunkPipe::Create(64 * 1024);
+    Ptr<HTTPProtocol::HTTPRequest> req = makeRequest(server, "/gzip/4194304");
+    req->SetResponsePipe(pipe);
+    httpClient->Put(req);
+    int32 numRead = 0;
+    bool allValid = true;
+    uint8 buf[16 * 1024];
+    while (!(req->Handled() && pipe->IsEmpty())) {
+        httpClient->DoWork();
+        const int32 num = pipe->Read(buf, sizeof(buf));
+        for (int32 i = 0; i < num; i++) {
+            allValid &= (buf[i] == TestHTTPServer::DataByte(numRead + i));
+        }
+        numRead += num;
+    }
+    CHECK(req->GetResponse()->GetStatus() == IOStatus::OK);
+    CHECK(pipe->GetContentLength() == EndOfStream);
+    CHECK(numRead == size);
+    CHECK(allValid);
+    // ...and inflating stops while the pipe is full
+    CHECK(pipe->MaxBuffered() <= (pipe->Capacity() + Inflater::ChunkSize));
+
+    // the HTTPFileSystem gets the inflated data
+    Ptr<HTTPFileSystem> fs = HTTPFileSystem::Create();
+    Ptr<IOProtocol::Get> ioReq = getFile(fs, server.MakeURL("/gzip/5000"), 0, 0);
+    CHECK(ioReq->GetStatus() == IOStatus::OK);
+    CHECK(checkData(ioReq->GetStream(), 0, 5000));
+
+    server.Stop();
+}
+
+//------------------------------------------------------------------------------
+static Ptr<IOProtocol::Get>
+waitHandled(const Ptr<IOProtocol::Get>& req) {
+    while (!req->Handled()) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    return req;
+}
+
+//------------------------------------------------------------------------------
+TEST(HTTPLoopbackDiskCacheTest) {
+    TestHTTPServer server;
+    server.Start();
+    std::remove("/tmp/oryol_http_cache/pack.bin");
+    std::remove("/tmp/oryol_http_cache/index.bin");
+    if (IOFacade::HasInstance()) {
+        // left over by a test which crashed (e.g. HTTPFileSystemTest when offline)
+        IOFacade::DestroySingle();
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    IOFacade* ioFacade = IOFacade::CreateSingle();
+    ioFacade->RegisterFileSystem("http", Creator<HTTPFileSystem,FileSystem>());
+    ioFacade->SetupDiskCache("/tmp/oryol_http_cache", 1024 * 1024);
+    const String url = server.MakeURL("/etag/data/1000");
+
+    // the first load stores the result with its ETag
+    Ptr<IOProtocol::Get> req = waitHandled(ioFacade->LoadCachedFile(url));
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkData(req->GetStream(), 0, 1000));
+    CHECK(req->GetValidator() == "\"v1\"");
+    CHECK(DiskCache::Instance()->GetValidator(url) == "\"v1\"");
+    CHECK(DiskCache::Instance()->NumMisses() == 1);
+
+    // the second load is revalidated, the 304 is served from the cache
+    const int32 numRequests = server.NumRequests();
+    req = waitHandled(ioFacade->LoadCachedFile(url));
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkData(req->GetStream(), 0, 1000));
+    CHECK(server.NumRequests() == numRequests + 1);
+    CHECK(DiskCache::Instance()->NumHits() == 1);
+
+    // a changed ETag replaces the cached entry
+    server.SetETagVersion(2);
+    req = waitHandled(ioFacade->LoadCachedFile(url));
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(checkData(req->GetStream(), 0, 1000));
+    CHECK(req->GetValidator() == "\"v2\"");
+    CHECK(DiskCache::Instance()->GetValidator(url) == "\"v2\"");
+
+    // responses without a validator are not stored
+    const String plainURL = server.MakeURL("/data/100");
+    req = waitHandled(ioFacade->LoadCachedFile(plainURL));
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(!DiskCache::Instance()->Contains(plainURL));
+
+    req = 0;
+    IOFacade::DestroySingle();
+    std::remove("/tmp/oryol_http_cache/pack.bin");
+    std::remove("/tmp/oryol_http_cache/index.bin");
+    server.Stop();
+}
+#endif
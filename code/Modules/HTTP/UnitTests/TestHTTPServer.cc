@@ -0,0 +1,449 @@
+//------------------------------------------------------------------------------
+//  TestHTTPServer.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "TestHTTPServer.h"
+#if ORYOL_LINUX || ORYOL_MACOS
+#include "Core/Assert.h"
+#include "Core/String/StringBuilder.h"
+#include "zlib/zlib.h"
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+
+const char* TestHTTPServer::MultipartBoundary = "ORYOL_TEST_BOUNDARY";
+
+//------------------------------------------------------------------------------
+TestHTTPServer::TestHTTPServer() :
+listenFd(-1),
+port(0),
+stopRequested(false),
+numConnections(0),
+numRequests(0),
+numActiveRequests(0),
+maxActiveRequests(0),
+etagVersion(1) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+TestHTTPServer::~TestHTTPServer() {
+    if (-1 != this->listenFd) {
+        this->Stop();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TestHTTPServer::Start() {
+    o_assert(-1 == this->listenFd);
+    this->listenFd = socket(AF_INET, SOCK_STREAM, 0);
+    o_assert(this->listenFd >= 0);
+    int one = 1;
+    setsockopt(this->listenFd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    int res = bind(this->listenFd, (sockaddr*) &addr, sizeof(addr));
+    o_assert(0 == res);
+    res = listen(this->listenFd, 64);
+    o_assert(0 == res);
+    socklen_t addrLen = sizeof(addr);
+    getsockname(this->listenFd, (sockaddr*) &addr, &addrLen);
+    this->port = ntohs(addr.sin_port);
+    this->stopRequested = false;
+    this->acceptThread = std::thread(&TestHTTPServer::acceptLoop, this);
+}
+
+//------------------------------------------------------------------------------
+void
+TestHTTPServer::Stop() {
+    o_assert(-1 != this->listenFd);
+    this->stopRequested = true;
+    shutdown(this->listenFd, SHUT_RDWR);
+    this->acceptThread.join();
+    close(this->listenFd);
+    this->listenFd = -1;
+    {
+        std::lock_guard<std::mutex> lock(this->connectionLock);
+        for (int fd : this->connectionFds) {
+            shutdown(fd, SHUT_RDWR);
+        }
+    }
+    for (std::thread& thread : this->connectionThreads) {
+        thread.join();
+    }
+    this->connectionThreads.Clear();
+    this->connectionFds.Clear();
+}
+
+//------------------------------------------------------------------------------
+int32
+TestHTTPServer::Port() const {
+    return this->port;
+}
+
+//------------------------------------------------------------------------------
+String
+TestHTTPServer::MakeURL(const char* path) const {
+    StringBuilder builder;
+    builder.Format(1024, "http://127.0.0.1:%d%s", this->port, path);
+    return builder.GetString();
+}
+
+//------------------------------------------------------------------------------
+int32
+TestHTTPServer::NumConnections() const {
+    return this->numConnections;
+}
+
+//------------------------------------------------------------------------------
+int32
+TestHTTPServer::NumRequests() const {
+    return this->numRequests;
+}
+
+//------------------------------------------------------------------------------
+int32
+TestHTTPServer::MaxConcurrentRequests() const {
+    return this->maxActiveRequests;
+}
+
+//------------------------------------------------------------------------------
+void
+TestHTTPServer::SetETagVersion(int32 version) {
+    this->etagVersion = version;
+}
+
+//------------------------------------------------------------------------------
+uint8
+TestHTTPServer::DataByte(int32 offset) {
+    return uint8((offset * 7) ^ (offset >> 8));
+}
+
+//------------------------------------------------------------------------------
+void
+TestHTTPServer::appendData(Array<uint8>& body, int32 start, int32 end) {
+    for (int32 i = start; i <= end; i++) {
+        body.AddBack(DataByte(i));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TestHTTPServer::compress(Array<uint8>& body, int windowBits) {
+    z_stream strm;
+    std::memset(&strm, 0, sizeof(strm));
+    int res = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+    o_assert(Z_OK == res);
+    Array<uint8> compressed;
+    compressed.Reserve(int32(deflateBound(&strm, uLong(body.Size()))));
+    for (int32 i = 0; i < compressed.Capacity(); i++) {
+        compressed.AddBack(0);
+    }
+    strm.next_in = body.begin();
+    strm.avail_in = uInt(body.Size());
+    strm.next_out = compressed.begin();
+    strm.avail_out = uInt(compressed.Size());
+    res = deflate(&strm, Z_FINISH);
+    o_assert(Z_STREAM_END == res);
+    const int32 size = int32(strm.total_out);
+    deflateEnd(&strm);
+    body.Clear();
+    for (int32 i = 0; i < size; i++) {
+        body.AddBack(compressed[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TestHTTPServer::appendString(Array<uint8>& body, const char* str) {
+    for (const char* p = str; 0 != *p; p++) {
+        body.AddBack(uint8(*p));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TestHTTPServer::acceptLoop() {
+    while (!this->stopRequested) {
+        int fd = accept(this->listenFd, nullptr, nullptr);
+        if (fd < 0) {
+            // listen socket has been shut down
+            break;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        this->numConnections++;
+        std::lock_guard<std::mutex> lock(this->connectionLock);
+        this->connectionFds.AddBack(fd);
+        this->connectionThreads.AddBack(std::thread(&TestHTTPServer::connectionLoop, this, fd));
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+TestHTTPServer::connectionLoop(int fd) {
+    Array<char> buf;
+    static const int32 chunkSize = 16 * 1024;
+    char chunk[chunkSize];
+    bool keepAlive = true;
+    while (keepAlive && !this->stopRequested) {
+        // receive until the request head, and the request body are complete
+        const StringView delim("\r\n\r\n");
+        int32 headEnd = InvalidIndex;
+        int32 bodySize = 0;
+        while (true) {
+            if ((InvalidIndex == headEnd) && (buf.Size() > 0)) {
+                headEnd = StringView(buf.begin(), buf.Size()).FindSubString(0, EndOfString, delim);
+                if (InvalidIndex != headEnd) {
+                    const StringView head(buf.begin(), headEnd);
+                    const StringView contentLength = findHeader(head, "Content-Length");
+                    if (contentLength.IsValid()) {
+                        bodySize = std::atoi(String(contentLength).AsCStr());
+                    }
+                }
+            }
+            if ((InvalidIndex != headEnd) && (buf.Size() >= (headEnd + 4 + bodySize))) {
+                break;
+            }
+            const int res = int(recv(fd, chunk, chunkSize, 0));
+            if (res <= 0) {
+                keepAlive = false;
+                break;
+            }
+            for (int i = 0; i < res; i++) {
+                buf.AddBack(chunk[i]);
+            }
+        }
+        if (!keepAlive) {
+            break;
+        }
+        const StringView head(buf.begin(), headEnd);
+        const StringView body(buf.begin() + headEnd + 4, bodySize);
+        this->numRequests++;
+        const int32 numActive = ++this->numActiveRequests;
+        int32 maxActive = this->maxActiveRequests;
+        while ((numActive > maxActive) && !this->maxActiveRequests.compare_exchange_weak(maxActive, numActive));
+        keepAlive = this->handleRequest(fd, head, body);
+        this->numActiveRequests--;
+
+        // remove the request from the receive buffer
+        const int32 requestSize = headEnd + 4 + bodySize;
+        for (int32 i = 0; i < requestSize; i++) {
+            buf.Erase(0);
+        }
+    }
+    std::lock_guard<std::mutex> lock(this->connectionLock);
+    this->connectionFds.EraseSwap(this->connectionFds.FindIndexLinear(fd));
+    close(fd);
+}
+
+//------------------------------------------------------------------------------
+StringView
+TestHTTPServer::findHeader(const StringView& head, const char* name) {
+    const int32 nameLen = int32(std::strlen(name));
+    int32 lineStart = head.FindSubString(0, EndOfString, "\r\n");
+    while (InvalidIndex != lineStart) {
+        lineStart += 2;
+        int32 lineEnd = head.FindSubString(lineStart, EndOfString, "\r\n");
+        if (InvalidIndex == lineEnd) {
+            lineEnd = head.Length();
+        }
+        const StringView line = head.GetSubView(lineStart, lineEnd);
+        if ((line.Length() > nameLen) && (line[nameLen] == ':') && (0 == strncasecmp(line.Ptr(), name, nameLen))) {
+            return line.GetSubView(nameLen + 1, EndOfString).Trim(" \t");
+        }
+        lineStart = (lineEnd < head.Length()) ? lineEnd : InvalidIndex;
+    }
+    return StringView();
+}
+
+//------------------------------------------------------------------------------
+bool
+TestHTTPServer::sendResponse(int fd, int code, const char* extraHeaders, const uint8* body, int32 bodySize) {
+    StringBuilder builder;
+    builder.Format(1024, "HTTP/1.1 %d Test\r\nContent-Length: %d\r\n%s\r\n", code, bodySize, extraHeaders);
+    Array<uint8> response;
+    response.Reserve(builder.Length() + bodySize);
+    for (int32 i = 0; i < builder.Length(); i++) {
+        response.AddBack(uint8(builder.AsCStr()[i]));
+    }
+    for (int32 i = 0; i < bodySize; i++) {
+        response.AddBack(body[i]);
+    }
+    int32 sent = 0;
+    while (sent < response.Size()) {
+        const int res = int(send(fd, response.begin() + sent, response.Size() - sent, MSG_NOSIGNAL));
+        if (res <= 0) {
+            return false;
+        }
+        sent += res;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+bool
+TestHTTPServer::handleRequest(int fd, const StringView& head, const StringView& body) {
+    // request line: METHOD PATH HTTP/1.1
+    const int32 pathStart = head.FindFirstOf(0, EndOfString, " ") + 1;
+    const int32 pathEnd = head.FindFirstOf(pathStart, EndOfString, " ");
+    StringView path = head.GetSubView(pathStart, pathEnd);
+    const bool keepAlive = findHeader(head, "Connection") != "close";
+
+    // optional delay
+    if (path.StartsWith("/delay/")) {
+        const int32 msEnd = path.FindFirstOf(7, EndOfString, "/");
+        const int32 ms = std::atoi(String(path.GetSubView(7, msEnd)).AsCStr());
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+        path = path.GetSubView(msEnd, EndOfString);
+    }
+
+    // optional failures
+    if (path.StartsWith("/fail/")) {
+        const int32 numEnd = path.FindFirstOf(6, EndOfString, "/");
+        const int32 numFails = std::atoi(String(path.GetSubView(6, numEnd)).AsCStr());
+        int32 count = 0;
+        {
+            std::lock_guard<std::mutex> lock(this->failLock);
+            const String key(path);
+            if (!this->failCounts.Contains(key)) {
+                this->failCounts.Insert(key, 0);
+            }
+            count = ++this->failCounts[key];
+        }
+        if (count <= numFails) {
+            return sendResponse(fd, 503, "", nullptr, 0) && keepAlive;
+        }
+        path = path.GetSubView(numEnd, EndOfString);
+    }
+
+    // optional ETag validation
+    StringBuilder etagHeader;
+    if (path.StartsWith("/etag/")) {
+        StringBuilder etag;
+        etag.Format(32, "\"v%d\"", int32(this->etagVersion));
+        etagHeader.Format(64, "ETag: %s\r\n", etag.AsCStr());
+        if (findHeader(head, "If-None-Match") == etag.AsCStr()) {
+            return sendResponse(fd, 304, etagHeader.AsCStr(), nullptr, 0) && keepAlive;
+        }
+        path = path.GetSubView(5, EndOfString);
+    }
+
+    if (path.StartsWith("/data/") || path.StartsWith("/merge/") || path.StartsWith("/plain/") ||
+        path.StartsWith("/gzip/") || path.StartsWith("/deflate/") || path.StartsWith("/badgzip/") || path.StartsWith("/lcgzip/")) {
+        const int32 sizeStart = path.FindFirstOf(1, EndOfString, "/") + 1;
+        const int32 size = std::atoi(String(path.GetSubView(sizeStart, EndOfString)).AsCStr());
+        StringBuilder extraHeaders;
+        Array<uint8> data;
+        StringView range = findHeader(head, "Range");
+        if (!(path.StartsWith("/data/") || path.StartsWith("/merge/")) || !range.StartsWith("bytes=")) {
+            extraHeaders.Set(etagHeader.AsCStr());
+            extraHeaders.Append("Content-Type: application/octet-stream\r\n");
+            appendData(data, 0, size - 1);
+            const bool lowerCase = path.StartsWith("/lcgzip/");
+            const bool gzip = path.StartsWith("/gzip/") || path.StartsWith("/badgzip/") || lowerCase;
+            const bool deflate = path.StartsWith("/deflate/");
+            const StringView acceptEncoding = findHeader(head, "Accept-Encoding");
+            if ((gzip || deflate) && (InvalidIndex != acceptEncoding.FindSubString(0, EndOfString, gzip ? "gzip" : "deflate"))) {
+                compress(data, gzip ? 31 : 15);
+                if (lowerCase) {
+                    extraHeaders.Append("content-encoding: GZIP\r\n");
+                }
+                else {
+                    extraHeaders.Append(gzip ? "Content-Encoding: gzip\r\n" : "Content-Encoding: deflate\r\n");
+                }
+                if (path.StartsWith("/badgzip/")) {
+                    data.Erase(data.Size() - 1);
+                    data[data.Size() / 2] ^= 0xFF;
+                }
+            }
+            return sendResponse(fd, 200, extraHeaders.AsCStr(), data.begin(), data.Size()) && keepAlive;
+        }
+
+        // parse the comma-separated ranges
+        Array<int32> starts;
+        Array<int32> ends;
+        range = range.GetSubView(6, EndOfString);
+        while (range.IsValid()) {
+            int32 comma = range.FindFirstOf(0, EndOfString, ",");
+            if (InvalidIndex == comma) {
+                comma = range.Length();
+            }
+            const int32 dash = range.FindFirstOf(0, comma, "-");
+            const int32 start = std::atoi(String(range.GetSubView(0, dash)).AsCStr());
+            int32 end = std::atoi(String(range.GetSubView(dash + 1, comma)).AsCStr());
+            if (end >= size) {
+                end = size - 1;
+            }
+            if (start > end) {
+                return sendResponse(fd, 416, "", nullptr, 0) && keepAlive;
+            }
+            starts.AddBack(start);
+            ends.AddBack(end);
+            range = range.GetSubView((comma < range.Length()) ? comma + 1 : comma, EndOfString);
+        }
+        if (path.StartsWith("/merge/")) {
+            int32 start = starts[0];
+            int32 end = ends[0];
+            for (int32 i = 1; i < starts.Size(); i++) {
+                start = (starts[i] < start) ? starts[i] : start;
+                end = (ends[i] > end) ? ends[i] : end;
+            }
+            starts.Clear();
+            ends.Clear();
+            starts.AddBack(start);
+            ends.AddBack(end);
+        }
+
+        StringBuilder builder;
+        if (1 == starts.Size()) {
+            builder.Format(256, "%sContent-Type: application/octet-stream\r\nContent-Range: bytes %d-%d/%d\r\n",
+                etagHeader.AsCStr(), starts[0], ends[0], size);
+            appendData(data, starts[0], ends[0]);
+        }
+        else {
+            builder.Format(256, "%sContent-Type: multipart/byteranges; boundary=%s\r\n", etagHeader.AsCStr(), MultipartBoundary);
+            for (int32 i = 0; i < starts.Size(); i++) {
+                StringBuilder partHead;
+                partHead.Format(256, "\r\n--%s\r\nContent-Type: application/octet-stream\r\nContent-Range: bytes %d-%d/%d\r\n\r\n",
+                    MultipartBoundary, starts[i], ends[i], size);
+                appendString(data, partHead.AsCStr());
+                appendData(data, starts[i], ends[i]);
+            }
+            StringBuilder tail;
+            tail.Format(256, "\r\n--%s--\r\n", MultipartBoundary);
+            appendString(data, tail.AsCStr());
+        }
+        return sendResponse(fd, 206, builder.AsCStr(), data.begin(), data.Size()) && keepAlive;
+    }
+    else if (path.StartsWith("/status/")) {
+        const int code = std::atoi(String(path.GetSubView(8, EndOfString)).AsCStr());
+        return sendResponse(fd, code, "", nullptr, 0) && keepAlive;
+    }
+    else if (path == "/echo") {
+        StringBuilder extraHeaders;
+        const StringView contentType = findHeader(head, "Content-Type");
+        if (contentType.IsValid()) {
+            extraHeaders.Set("Content-Type: ");
+            extraHeaders.Append(contentType);
+            extraHeaders.Append("\r\n");
+        }
+        return sendResponse(fd, 200, extraHeaders.AsCStr(), (const uint8*) body.Ptr(), body.Length()) && keepAlive;
+    }
+    else {
+        return sendResponse(fd, 404, "", nullptr, 0) && keepAlive;
+    }
+}
+#endif
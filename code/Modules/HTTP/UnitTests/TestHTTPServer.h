@@ -0,0 +1,99 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class TestHTTPServer
+    @brief minimal HTTP/1.1 server on the loopback interface for unit tests
+
+    Listens on a free port on 127.0.0.1, and serves each connection
+    in its own thread (with keep-alive). Understood paths:
+
+    - /data/N: N bytes of test data, see DataByte(), honours a
+      "Range: bytes=a-b" request header, several comma-separated
+      ranges are answered with a multipart/byteranges response
+      (with boundary MultipartBoundary)
+    - /merge/N: like /data/N, but several ranges are merged into a
+      single range from the lowest start to the highest end
+    - /plain/N: like /data/N, but ignores the Range header
+    - /gzip/N, /deflate/N: like /plain/N, but the data is sent gzip or
+      zlib compressed if the Accept-Encoding request header allows it
+    - /badgzip/N: like /gzip/N, but the compressed data is truncated
+    - /lcgzip/N: like /gzip/N, but with a lower-case "content-encoding: GZIP" header
+    - /delay/MS/...: wait MS milliseconds, then serve the rest of the path
+    - /fail/N/...: the first N requests of the whole path get an empty 503
+      response, the following requests serve the rest of the path
+    - /etag/...: serve the rest of the path with an ETag "vN" header (N is
+      set with SetETagVersion()), or an empty 304 response if the
+      If-None-Match request header matches the current ETag
+    - /status/CODE: an empty response with the HTTP status CODE
+    - /echo: responds with the request body (for POST)
+*/
+#include "Core/Types.h"
+#include "Core/String/String.h"
+#include "Core/String/StringView.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+class TestHTTPServer {
+public:
+    /// constructor
+    TestHTTPServer();
+    /// destructor, stops the server
+    ~TestHTTPServer();
+
+    /// start listening and serving
+    void Start();
+    /// close all connections and stop the server
+    void Stop();
+    /// get the port the server listens on
+    Oryol::int32 Port() const;
+    /// build an http://127.0.0.1:port URL string for a path (path starts with '/')
+    Oryol::Core::String MakeURL(const char* path) const;
+    /// get the number of accepted connections
+    Oryol::int32 NumConnections() const;
+    /// get the number of served requests
+    Oryol::int32 NumRequests() const;
+    /// get the max number of requests which were served at the same time
+    Oryol::int32 MaxConcurrentRequests() const;
+    /// set the version number of the ETag of /etag/ paths
+    void SetETagVersion(Oryol::int32 version);
+    /// the test data byte at an offset
+    static Oryol::uint8 DataByte(Oryol::int32 offset);
+    /// the boundary of multipart/byteranges responses
+    static const char* MultipartBoundary;
+
+private:
+    /// the accept thread function
+    void acceptLoop();
+    /// the per-connection thread function
+    void connectionLoop(int fd);
+    /// handle one request, return false if the connection should be closed
+    bool handleRequest(int fd, const Oryol::Core::StringView& head, const Oryol::Core::StringView& body);
+    /// find a request header value, returns empty view if not found
+    static Oryol::Core::StringView findHeader(const Oryol::Core::StringView& head, const char* name);
+    /// append test data in the range [start, end] to a response body
+    static void appendData(Oryol::Core::Array<Oryol::uint8>& body, Oryol::int32 start, Oryol::int32 end);
+    /// compress a response body with zlib (windowBits 15) or gzip (windowBits 31)
+    static void compress(Oryol::Core::Array<Oryol::uint8>& body, int windowBits);
+    /// append a string to a response body
+    static void appendString(Oryol::Core::Array<Oryol::uint8>& body, const char* str);
+    /// send a complete response
+    static bool sendResponse(int fd, int code, const char* extraHeaders, const Oryol::uint8* body, Oryol::int32 bodySize);
+
+    int listenFd;
+    Oryol::int32 port;
+    std::thread acceptThread;
+    std::mutex connectionLock;
+    Oryol::Core::Array<std::thread> connectionThreads;
+    Oryol::Core::Array<int> connectionFds;
+    std::atomic<bool> stopRequested;
+    std::atomic<Oryol::int32> numConnections;
+    std::atomic<Oryol::int32> numRequests;
+    std::atomic<Oryol::int32> numActiveRequests;
+    std::atomic<Oryol::int32> maxActiveRequests;
+    std::atomic<Oryol::int32> etagVersion;
+    std::mutex failLock;
+    Oryol::Core::Map<Oryol::Core::String, Oryol::int32> failCounts;
+};
@@ -3,8 +3,9 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "curlURLLoader.h"
-#include "IO/MemoryStream.h"
 #include "curl/curl.h"
+#include <cstdlib>
+#include <cctype>
 
 #if LIBCURL_VERSION_NUM != 0x072400
 #error "Not using the right curl version, header search path fuckup?"
@@ -15,6 +16,7 @@ namespace HTTP {
 
 using namespace Core;
 using namespace IO;
+using namespace Time;
 
 bool curlURLLoader::curlInitCalled = false;
 std::mutex curlURLLoader::curlInitMutex;
@@ -22,8 +24,7 @@ std::mutex curlURLLoader::curlInitMutex;
 //------------------------------------------------------------------------------
 curlURLLoader::curlURLLoader() :
 contentTypeString("Content-Type"),
-curlSession(0),
-curlError(0) {
+curlMulti(0) {
 
     // we need to do some one-time curl initialization here,
     // thread-protected because curl_global_init() is not thread-safe
@@ -35,62 +36,148 @@ curlError(0) {
     }
     curlInitMutex.unlock();
 
-    // setup a new curl session
-    this->setupCurlSession();
+    // setup the multi handle, this also owns the connection cache
+    this->curlMulti = curl_multi_init();
+    o_assert(0 != this->curlMulti);
+    curl_multi_setopt(this->curlMulti, CURLMOPT_MAX_HOST_CONNECTIONS, long(MaxConnectionsPerHost));
+    curl_multi_setopt(this->curlMulti, CURLMOPT_MAXCONNECTS, long(MaxTransfers));
 }
 
 //------------------------------------------------------------------------------
 curlURLLoader::~curlURLLoader() {
-    this->discardCurlSession();
+    // abort requests which are still in flight
+    for (transfer* t : this->transfers) {
+        curl_multi_remove_handle(this->curlMulti, t->curlEasy);
+        Ptr<HTTPProtocol::HTTPResponse> httpResponse = HTTPProtocol::HTTPResponse::Create();
+        httpResponse->SetStatus(IOStatus::Cancelled);
+        t->req->SetResponse(httpResponse);
+        t->req->SetHandled();
+        if (t->responseBody->IsOpen()) {
+            t->responseBody->Close();
+        }
+        if (t->pipe.isValid()) {
+            t->pipe->CloseWrite();
+        }
+        if (0 != t->requestHeaders) {
+            curl_slist_free_all((struct curl_slist*) t->requestHeaders);
+        }
+        curl_easy_cleanup(t->curlEasy);
+        Memory::Free(t->curlError);
+        delete t;
+    }
+    this->transfers.Clear();
+    for (void* curlEasy : this->idleEasyHandles) {
+        curl_easy_cleanup(curlEasy);
+    }
+    this->idleEasyHandles.Clear();
+    curl_multi_cleanup(this->curlMulti);
+    this->curlMulti = 0;
 }
 
 //------------------------------------------------------------------------------
-void
-curlURLLoader::setupCurlSession() {
-    o_assert(0 == this->curlError);
-    o_assert(0 == this->curlSession);
-
-    // setup the error buffer
-    const int32 curlErrorBufferSize = CURL_ERROR_SIZE * 4;
-    this->curlError = (char*) Memory::Alloc(curlErrorBufferSize);
-    Memory::Clear(this->curlError, curlErrorBufferSize);
+int32
+curlURLLoader::numTransfers() const {
+    return this->transfers.Size();
+}
 
-    // setup the curl session
-    this->curlSession = curl_easy_init();
-    o_assert(0 != this->curlSession);
+//------------------------------------------------------------------------------
+void*
+curlURLLoader::obtainEasyHandle() {
+    void* curlEasy = 0;
+    if (!this->idleEasyHandles.Empty()) {
+        // reuse an easy handle, this keeps its DNS cache
+        curlEasy = this->idleEasyHandles.Back();
+        this->idleEasyHandles.Erase(this->idleEasyHandles.Size() - 1);
+        curl_easy_reset(curlEasy);
+    }
+    else {
+        curlEasy = curl_easy_init();
+        o_assert(0 != curlEasy);
+    }
 
     // set session options
-    curl_easy_setopt(this->curlSession, CURLOPT_NOSIGNAL, 1L);
-    curl_easy_setopt(this->curlSession, CURLOPT_NOPROGRESS, 1L);
-    curl_easy_setopt(this->curlSession, CURLOPT_ERRORBUFFER, this->curlError);
-    curl_easy_setopt(this->curlSession, CURLOPT_WRITEFUNCTION, curlWriteDataCallback);
-    curl_easy_setopt(this->curlSession, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
-    curl_easy_setopt(this->curlSession, CURLOPT_WRITEHEADER, this);
-    curl_easy_setopt(this->curlSession, CURLOPT_TCP_KEEPALIVE, 1L);
-    curl_easy_setopt(this->curlSession, CURLOPT_TCP_KEEPIDLE, 10L);
-    curl_easy_setopt(this->curlSession, CURLOPT_TCP_KEEPINTVL, 10L);
+    curl_easy_setopt(curlEasy, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curlEasy, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curlEasy, CURLOPT_XFERINFOFUNCTION, curlProgressCallback);
+    curl_easy_setopt(curlEasy, CURLOPT_CONNECTTIMEOUT_MS, long(ConnectTimeout));
+    curl_easy_setopt(curlEasy, CURLOPT_WRITEFUNCTION, curlWriteDataCallback);
+    curl_easy_setopt(curlEasy, CURLOPT_HEADERFUNCTION, curlHeaderCallback);
+    curl_easy_setopt(curlEasy, CURLOPT_TCP_KEEPALIVE, 1L);
+    curl_easy_setopt(curlEasy, CURLOPT_TCP_KEEPIDLE, 10L);
+    curl_easy_setopt(curlEasy, CURLOPT_TCP_KEEPINTVL, 10L);
+    return curlEasy;
 }
 
 //------------------------------------------------------------------------------
 void
-curlURLLoader::discardCurlSession() {
-    o_assert(0 != this->curlError);
-    o_assert(0 != this->curlSession);
+curlURLLoader::beginBody(transfer* t) {
+    t->bodyStarted = true;
 
-    curl_easy_cleanup(this->curlSession);
-    this->curlSession = 0;
-    Memory::Free(this->curlError);
-    this->curlError = 0;
+    // only successful responses are streamed, error bodies
+    // go into the response body stream as usual
+    long curlHttpCode = 0;
+    curl_easy_getinfo(t->curlEasy, CURLINFO_RESPONSE_CODE, &curlHttpCode);
+    t->streaming = t->pipe.isValid() && (curlHttpCode >= 200) && (curlHttpCode < 300);
+    if (t->compressed) {
+        t->inflater.Begin();
+    }
+    if (t->streaming) {
+        if (t->responseHeaders.Contains("Content-Type")) {
+            t->pipe->SetContentType(t->responseHeaders["Content-Type"]);
+        }
+        // the Content-Length of a compressed body is the compressed size
+        t->pipe->SetContentLength(t->compressed ? EndOfStream : t->contentLength);
+    }
+    else if (t->contentLength > 0) {
+        // allocate the whole body at once instead of growing it chunk by chunk,
+        // but don't trust the server with more than MaxBodyReserve bytes
+        t->responseBody->Reserve(t->contentLength < MaxBodyReserve ? t->contentLength : MaxBodyReserve);
+    }
 }
 
 //------------------------------------------------------------------------------
 size_t
 curlURLLoader::curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
-    // userData is expected to point to a Stream object, open for writing
+    // userData is expected to point to the transfer
+    transfer* t = (transfer*) userData;
     int32 bytesToWrite = (int32) (size * nmemb);
     if (bytesToWrite > 0) {
-        Stream* stream = (Stream*) userData;
-        stream->Write(ptr, bytesToWrite);
+        if (!t->bodyStarted) {
+            beginBody(t);
+        }
+        if (t->streaming) {
+            if (t->pipe->IsFull()) {
+                // curl keeps the data until the transfer is resumed
+                t->paused = true;
+                return CURL_WRITEFUNC_PAUSE;
+            }
+            if (!t->compressed) {
+                t->pipe->Write(ptr, bytesToWrite);
+            }
+            else {
+                // curl passes the data of a paused call again after resuming,
+                // skip the part which had been inflated before pausing
+                const int32 skip = (t->numInflated < bytesToWrite) ? t->numInflated : bytesToWrite;
+                int32 numConsumed = 0;
+                if (!t->inflater.InflateToPipe(ptr + skip, bytesToWrite - skip, t->pipe, &numConsumed)) {
+                    // corrupt data, aborts the transfer
+                    return 0;
+                }
+                if (((skip + numConsumed) < bytesToWrite) || t->inflater.HasPendingOutput()) {
+                    // the pipe filled up while inflating
+                    t->numInflated += numConsumed;
+                    t->paused = true;
+                    return CURL_WRITEFUNC_PAUSE;
+                }
+                t->numInflated -= skip;
+            }
+        }
+        else if (!t->compressed) {
+            t->responseBody->Write(ptr, bytesToWrite);
+        }
+        else if (!t->inflater.Inflate(ptr, bytesToWrite, t->responseBody)) {
+            return 0;
+        }
         return bytesToWrite;
     }
     else {
@@ -101,17 +188,30 @@ curlURLLoader::curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void*
 //------------------------------------------------------------------------------
 size_t
 curlURLLoader::curlHeaderCallback(char* ptr, size_t size, size_t nmemb, void* userData) {
-    // userData is expected to point to the curlURLLoader object
-    curlURLLoader* self = (curlURLLoader*) userData;
+    // userData is expected to point to the transfer
+    transfer* t = (transfer*) userData;
     int32 receivedBytes = (int32) (size * nmemb);
     if (receivedBytes > 0) {
-        self->stringBuilder.Set(ptr, 0, receivedBytes);
-        int32 colonIndex = self->stringBuilder.FindFirstOf(0, receivedBytes, ":");
+        // parse the header line in place, the key and value Strings
+        // only allocate if they don't fit into a local String
+        const StringView line(ptr, receivedBytes);
+        int32 colonIndex = line.FindFirstOf(0, EndOfString, ":");
         if (InvalidIndex != colonIndex) {
-            String key = self->stringBuilder.GetSubString(0, colonIndex);
-            int32 endOfValueIndex = self->stringBuilder.FindFirstOf(colonIndex, EndOfString, "\r\n");
-            String value = self->stringBuilder.GetSubString(colonIndex + 2, endOfValueIndex);
-            self->responseHeaders.Insert(key, value);
+            const StringView key = line.GetSubView(0, colonIndex);
+            const StringView value = line.GetSubView(colonIndex + 1, EndOfString).Trim(" \t\r\n");
+            // header names and content codings are case-insensitive
+            if (equalsNoCase(key, "Content-Length")) {
+                t->contentLength = std::atoi(String(value).AsCStr());
+            }
+            else if (equalsNoCase(key, "Content-Encoding")) {
+                t->compressed = equalsNoCase(value, "gzip") || equalsNoCase(value, "x-gzip") || equalsNoCase(value, "deflate");
+            }
+            t->responseHeaders.Insert(String(key), String(value));
+        }
+        else if (line.StartsWith("HTTP/")) {
+            // status line of a new response (e.g. after a redirect)
+            t->contentLength = EndOfStream;
+            t->compressed = false;
         }
         return receivedBytes;
     }
@@ -121,33 +221,136 @@ curlURLLoader::curlHeaderCallback(char* ptr, size_t size, size_t nmemb, void* us
 }
 
 //------------------------------------------------------------------------------
+bool
+curlURLLoader::equalsNoCase(const StringView& str, const char* lit) {
+    const int32 len = str.Length();
+    for (int32 i = 0; i < len; i++) {
+        if ((0 == lit[i]) || (std::tolower((unsigned char)str[i]) != std::tolower((unsigned char)lit[i]))) {
+            return false;
+        }
+    }
+    return 0 == lit[len];
+}
+
+//------------------------------------------------------------------------------
+int
+curlURLLoader::curlProgressCallback(void* userData, int64 dlTotal, int64 dlNow, int64 ulTotal, int64 ulNow) {
+    // userData is expected to point to the transfer, a non-0 return value aborts
+    const transfer* t = (const transfer*) userData;
+    return t->req->Cancelled() ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Starts new transfers, lets curl do all work which is possible without
+ blocking, and completes finished transfers. If transfers are still in
+ flight, waits up to PollTimeout milliseconds for network activity
+ and repeats once.
+*/
 void
 curlURLLoader::doWork() {
-    while (!this->requestQueue.Empty()) {
-        Ptr<HTTPProtocol::HTTPRequest> req = this->requestQueue.Dequeue();
-        this->doOneRequest(req);
-        req->SetHandled();
+    this->startTransfers();
+    if (!this->transfers.Empty()) {
+        this->abortTransfers();
+        this->resumeTransfers();
+        int numRunning = 0;
+        curl_multi_perform(this->curlMulti, &numRunning);
+        this->finishTransfers();
+        if (numRunning > 0) {
+            int numFds = 0;
+            curl_multi_wait(this->curlMulti, nullptr, 0, PollTimeout, &numFds);
+            curl_multi_perform(this->curlMulti, &numRunning);
+            this->finishTransfers();
+        }
+        // fill up the slots of finished transfers
+        this->startTransfers();
     }
 }
 
 //------------------------------------------------------------------------------
 void
-curlURLLoader::doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req) {
-    o_assert(0 != this->curlSession);
-    o_assert(0 != this->curlError);
-    this->stringBuilder.Clear();
-    this->responseHeaders.Clear();
+curlURLLoader::resumeTransfers() {
+    for (int32 i = 0; i < this->transfers.Size(); i++) {
+        transfer* t = this->transfers[i];
+        if (t->paused && t->pipe->CanResume()) {
+            // this may call the write callback right away, which may pause again
+            t->paused = false;
+            curl_easy_pause(t->curlEasy, CURLPAUSE_CONT);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Cancelled and expired transfers are removed from the multi handle
+ directly, because curl doesn't call the callbacks of paused transfers,
+ and a consumer which cancels a streaming request doesn't drain the
+ pipe anymore.
+*/
+void
+curlURLLoader::abortTransfers() {
+    for (int32 i = this->transfers.Size() - 1; i >= 0; i--) {
+        transfer* t = this->transfers[i];
+        const int32 timeout = t->req->GetTimeout();
+        if (t->req->Cancelled()) {
+            this->finishTransfer(t, CURLE_ABORTED_BY_CALLBACK);
+        }
+        else if ((timeout > 0) && (Clock::Since(t->startTime).AsMilliSeconds() > timeout)) {
+            this->finishTransfer(t, CURLE_OPERATION_TIMEDOUT);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+curlURLLoader::startTransfers() {
+    while ((this->transfers.Size() < MaxTransfers) && !this->requestQueue.Empty()) {
+        this->startTransfer(this->requestQueue.Dequeue());
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+curlURLLoader::startTransfer(const Ptr<HTTPProtocol::HTTPRequest>& req) {
+    transfer* t = new transfer();
+    t->req = req;
+    t->pipe = req->GetResponsePipe();
+    t->startTime = Clock::Now();
+    t->contentLength = EndOfStream;
+    t->compressed = false;
+    t->bodyStarted = false;
+    t->streaming = false;
+    t->paused = false;
+    t->numInflated = 0;
+    t->curlEasy = this->obtainEasyHandle();
+    t->requestHeaders = 0;
+    t->curlError = (char*) Memory::Alloc(CURL_ERROR_SIZE);
+    Memory::Clear(t->curlError, CURL_ERROR_SIZE);
+    void* curlEasy = t->curlEasy;
+    curl_easy_setopt(curlEasy, CURLOPT_ERRORBUFFER, t->curlError);
+    curl_easy_setopt(curlEasy, CURLOPT_WRITEHEADER, t);
+    curl_easy_setopt(curlEasy, CURLOPT_PRIVATE, t);
+    curl_easy_setopt(curlEasy, CURLOPT_XFERINFODATA, t);
+
+    // deadlines, a paused streaming transfer receives no data on purpose
+    if (req->GetTimeout() > 0) {
+        curl_easy_setopt(curlEasy, CURLOPT_TIMEOUT_MS, long(req->GetTimeout()));
+    }
+    if (!t->pipe.isValid()) {
+        curl_easy_setopt(curlEasy, CURLOPT_LOW_SPEED_LIMIT, 1L);
+        curl_easy_setopt(curlEasy, CURLOPT_LOW_SPEED_TIME, long(StallTimeout));
+    }
 
     // set URL in curl
     const URL& url = req->GetURL();
     o_assert(url.Scheme() == "http");
-    curl_easy_setopt(this->curlSession, CURLOPT_URL, url.AsCStr());
+    curl_easy_setopt(curlEasy, CURLOPT_URL, url.AsCStr());
 
     // set the HTTP method
     /// @todo: only HTTP GET and POST supported for now
     switch (req->GetMethod()) {
-        case HTTPMethod::Get:  curl_easy_setopt(this->curlSession, CURLOPT_HTTPGET, 1); break;
-        case HTTPMethod::Post: curl_easy_setopt(this->curlSession, CURLOPT_POST, 1); break;
+        case HTTPMethod::Get:  curl_easy_setopt(curlEasy, CURLOPT_HTTPGET, 1); break;
+        case HTTPMethod::Post: curl_easy_setopt(curlEasy, CURLOPT_POST, 1); break;
         default: o_error("curlURLLoader: unsupported HTTP method '%s'\n", HTTPMethod::ToString(req->GetMethod())); break;
     }
 
@@ -160,7 +363,13 @@ curlURLLoader::doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req) {
         requestHeaders = curl_slist_append(requestHeaders, this->stringBuilder.AsCStr());
     }
 
-    // if this is a POST, set the data to post
+    // ask for a compressed body, except for ranges (which would be ranges of the compressed body)
+    if (!(req->GetRequestHeaders().Contains("Range") || req->GetRequestHeaders().Contains("Accept-Encoding"))) {
+        requestHeaders = curl_slist_append(requestHeaders, "Accept-Encoding: gzip, deflate");
+    }
+
+    // if this is a POST, set the data to post (the post-stream stays
+    // open and mapped until the transfer has finished)
     const Ptr<Stream>& postStream = req->GetBody();
     if (req->GetMethod() == HTTPMethod::Post) {
         o_assert(postStream.isValid());
@@ -169,8 +378,8 @@ curlURLLoader::doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req) {
         const uint8* postData = postStream->MapRead(&endPtr);
         const int32 postDataSize = postStream->Size();
         o_assert((endPtr - postData) == postDataSize);
-        curl_easy_setopt(this->curlSession, CURLOPT_POSTFIELDS, postData);
-        curl_easy_setopt(this->curlSession, CURLOPT_POSTFIELDSIZE, postDataSize);
+        curl_easy_setopt(curlEasy, CURLOPT_POSTFIELDS, postData);
+        curl_easy_setopt(curlEasy, CURLOPT_POSTFIELDSIZE, postDataSize);
 
         // add a Content-Type request header if the post-stream has a content-type set
         if (postStream->GetContentType().IsValid()) {
@@ -182,58 +391,119 @@ curlURLLoader::doOneRequest(const Ptr<HTTPProtocol::HTTPRequest>& req) {
 
     // set the http request headers
     if (0 != requestHeaders) {
-        curl_easy_setopt(this->curlSession, CURLOPT_HTTPHEADER, requestHeaders);
+        curl_easy_setopt(curlEasy, CURLOPT_HTTPHEADER, requestHeaders);
+        t->requestHeaders = requestHeaders;
     }
 
-    // prepare the HTTPResponse and the response-body stream
-    Ptr<HTTPProtocol::HTTPResponse> httpResponse = HTTPProtocol::HTTPResponse::Create();
-    Ptr<MemoryStream> responseBodyStream = MemoryStream::Create();
-    responseBodyStream->Open(OpenMode::WriteOnly);
-    curl_easy_setopt(this->curlSession, CURLOPT_WRITEDATA, responseBodyStream.get());
+    // prepare the response-body stream
+    t->responseBody = MemoryStream::Create();
+    t->responseBody->Open(OpenMode::WriteOnly);
+    curl_easy_setopt(curlEasy, CURLOPT_WRITEDATA, t);
+
+    this->transfers.AddBack(t);
+    curl_multi_add_handle(this->curlMulti, curlEasy);
+}
+
+//------------------------------------------------------------------------------
+void
+curlURLLoader::finishTransfers() {
+    int numMsgs = 0;
+    CURLMsg* msg = nullptr;
+    while (nullptr != (msg = curl_multi_info_read(this->curlMulti, &numMsgs))) {
+        if (CURLMSG_DONE == msg->msg) {
+            transfer* t = nullptr;
+            curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, (char**) &t);
+            o_assert(nullptr != t);
+            this->finishTransfer(t, msg->data.result);
+        }
+    }
+}
 
-    // perform the request
-    CURLcode performResult = curl_easy_perform(this->curlSession);
+//------------------------------------------------------------------------------
+void
+curlURLLoader::finishTransfer(transfer* t, int curlResult) {
+    const Ptr<HTTPProtocol::HTTPRequest>& req = t->req;
+    void* curlEasy = t->curlEasy;
+    Ptr<HTTPProtocol::HTTPResponse> httpResponse = HTTPProtocol::HTTPResponse::Create();
 
     // query the http code
     long curlHttpCode = 0;
-    curl_easy_getinfo(this->curlSession, CURLINFO_RESPONSE_CODE, &curlHttpCode);
+    curl_easy_getinfo(curlEasy, CURLINFO_RESPONSE_CODE, &curlHttpCode);
     httpResponse->SetStatus((IOStatus::Code) curlHttpCode);
 
     // check for error codes
-    if (CURLE_PARTIAL_FILE == performResult) {
+    bool inflateFailed = false;
+    if (t->inflater.IsActive()) {
+        inflateFailed = t->inflater.HasError() || ((CURLE_OK == curlResult) && !t->inflater.IsFinished());
+        t->inflater.End();
+    }
+    if (CURLE_ABORTED_BY_CALLBACK == curlResult) {
+        httpResponse->SetStatus(IOStatus::Cancelled);
+    }
+    else if (CURLE_OPERATION_TIMEDOUT == curlResult) {
+        Log::Warn("curlURLLoader: transfer timed out for '%s'\n", req->GetURL().AsCStr());
+        httpResponse->SetStatus(IOStatus::RequestTimeout);
+        httpResponse->SetErrorDesc(IOStatus::ToString(IOStatus::RequestTimeout));
+    }
+    else if (CURLE_PARTIAL_FILE == curlResult) {
         // this seems to happen quite often even though all data has been received,
         // not sure what to do about this, but don't treat it as an error
         Log::Warn("curlURLLoader: CURLE_PARTIAL_FILE received for '%s', httpStatus='%ld'\n", req->GetURL().AsCStr(), curlHttpCode);
-        httpResponse->SetErrorDesc(this->curlError);
+        httpResponse->SetErrorDesc(t->curlError);
     }
-    else if (0 != performResult) {
+    else if (0 != curlResult) {
         // some other curl error
-        Log::Warn("curlURLLoader: curl_easy_peform failed with '%s' for '%s', httpStatus='%ld'\n",
-            req->GetURL().AsCStr(), this->curlError, curlHttpCode);
-        httpResponse->SetErrorDesc(this->curlError);
+        Log::Warn("curlURLLoader: transfer failed with '%s' for '%s', httpStatus='%ld'\n",
+            t->curlError, req->GetURL().AsCStr(), curlHttpCode);
+        httpResponse->SetErrorDesc(t->curlError);
+        if (0 == curlHttpCode) {
+            // no response at all (e.g. connection failed)
+            httpResponse->SetStatus(IOStatus::DownloadError);
+        }
+    }
+
+    if (inflateFailed) {
+        Log::Warn("curlURLLoader: invalid compressed response body for '%s'\n", req->GetURL().AsCStr());
+        httpResponse->SetStatus(IOStatus::DownloadError);
+        httpResponse->SetErrorDesc("invalid compressed response body");
     }
 
     // check if the responseHeaders contained a Content-Type, if yes, set it on the responseBodyStream
-    if (this->responseHeaders.Contains(this->contentTypeString)) {
-        responseBodyStream->SetContentType(this->responseHeaders[this->contentTypeString]);
+    if (t->responseHeaders.Contains(this->contentTypeString)) {
+        t->responseBody->SetContentType(t->responseHeaders[this->contentTypeString]);
     }
 
-    // close the responseBodyStream, and set the result
-    responseBodyStream->Close();
-    httpResponse->SetResponseHeaders(this->responseHeaders);
-    httpResponse->SetBody(responseBodyStream);
+    // close the responseBodyStream and the optional pipe, and set the result
+    t->responseBody->Close();
+    if (t->pipe.isValid()) {
+        t->pipe->CloseWrite();
+    }
+    httpResponse->SetResponseHeaders(t->responseHeaders);
+    httpResponse->SetBody(t->responseBody);
     req->SetResponse(httpResponse);
 
     // close the optional body stream
+    const Ptr<Stream>& postStream = req->GetBody();
     if (postStream.isValid() && postStream->IsOpen()) {
         postStream->Close();
     }
+    req->SetHandled();
 
-    // free the previously allocated request headers
-    if (0 != requestHeaders) {
-        curl_slist_free_all(requestHeaders);
-        requestHeaders = 0;
+    // free the request headers, and keep the easy handle for the next transfer
+    // (unless the transfer failed, the handle may be paused or mid-transfer)
+    curl_multi_remove_handle(this->curlMulti, curlEasy);
+    if (0 != t->requestHeaders) {
+        curl_slist_free_all((struct curl_slist*) t->requestHeaders);
+    }
+    if (CURLE_OK == curlResult) {
+        this->idleEasyHandles.AddBack(curlEasy);
+    }
+    else {
+        curl_easy_cleanup(curlEasy);
     }
+    Memory::Free(t->curlError);
+    this->transfers.EraseSwap(this->transfers.FindIndexLinear(t));
+    delete t;
 }
 
 } // namespace HTTP
@@ -3,11 +3,49 @@
 /**
     @class Oryol::HTTP::curlURLLoader
     @brief urlLoader implementation on top of curl
+
+    The curlURLLoader drives all requests through one curl multi handle,
+    up to MaxTransfers requests are in flight at the same time, and
+    requests are completed in the order they finish (not in the order
+    they were put). Idle connections are kept in the multi handle's
+    connection cache and are reused for the next request to the same host.
+    doWork() never blocks longer than PollTimeout milliseconds.
+
+    If the request has a ResponsePipe, a successful (2xx) response body
+    is written into the pipe as it arrives instead of being collected
+    in a MemoryStream. While the pipe is full the transfer is paused,
+    and it is resumed in doWork() once the reader has drained the pipe.
+    A compressed chunk is only inflated until the pipe is full, so a
+    small chunk which inflates to many megabytes doesn't overrun it.
+    Otherwise the response body stream is pre-sized from the
+    Content-Length header (up to MaxBodyReserve bytes, the stream grows
+    as needed beyond that).
+
+    Requests without a Range header are sent with "Accept-Encoding: gzip,
+    deflate", and compressed response bodies are inflated on the fly
+    while they arrive, so the response body (or pipe) always receives the
+    decompressed data. The response headers are passed through unchanged.
+
+    Connections are given up after ConnectTimeout milliseconds, and
+    non-streaming transfers which receive no data for StallTimeout
+    seconds fail, so a dead server never blocks an IO lane. A request
+    with a Timeout is aborted after that many milliseconds (with status
+    RequestTimeout), and a cancelled request is aborted right away (with
+    status Cancelled). This also works for paused streaming transfers,
+    which curl doesn't call back while paused. Transport errors without
+    a HTTP response have the status DownloadError.
+
     @see urlLoader
 */
 #include "HTTP/base/baseURLLoader.h"
 #include "Core/String/StringBuilder.h"
+#include "Core/String/StringView.h"
+#include "Core/Containers/Array.h"
 #include "Core/Containers/Map.h"
+#include "IO/MemoryStream.h"
+#include "IO/ChunkPipe.h"
+#include "IO/Inflater.h"
+#include "Time/Clock.h"
 #include <mutex>
 
 namespace Oryol {
@@ -21,26 +59,74 @@ public:
     ~curlURLLoader();
     /// process enqueued requests
     void doWork();
+    /// get number of requests currently in flight
+    int32 numTransfers() const;
+
+    /// max number of requests in flight
+    static const int32 MaxTransfers = 16;
+    /// max number of open connections per host
+    static const int32 MaxConnectionsPerHost = 6;
+    /// max time doWork() waits for network activity, in milliseconds
+    static const int32 PollTimeout = 10;
+    /// max time to establish a connection, in milliseconds
+    static const int32 ConnectTimeout = 10000;
+    /// max time a non-streaming transfer may receive no data, in seconds
+    static const int32 StallTimeout = 30;
+    /// max number of bytes reserved up-front for a non-streaming response body
+    static const int32 MaxBodyReserve = 16 * 1024 * 1024;
 
 private:
-    /// setup curl session
-    void setupCurlSession();
-    /// discard the curl session
-    void discardCurlSession();
-    /// synchronously handle a single request
-    void doOneRequest(const Core::Ptr<HTTPProtocol::HTTPRequest>& req);
+    /// state of an in-flight request
+    struct transfer {
+        Core::Ptr<HTTPProtocol::HTTPRequest> req;
+        Core::Ptr<IO::MemoryStream> responseBody;
+        Core::Map<Core::String,Core::String> responseHeaders;
+        Core::Ptr<IO::ChunkPipe> pipe;
+        Time::TimePoint startTime;
+        IO::Inflater inflater;
+        int32 contentLength;
+        int32 numInflated;
+        bool compressed;
+        bool bodyStarted;
+        bool streaming;
+        bool paused;
+        void* curlEasy;
+        void* requestHeaders;
+        char* curlError;
+    };
+
+    /// start requests from the request queue until MaxTransfers are in flight
+    void startTransfers();
+    /// setup a transfer and add it to the multi handle
+    void startTransfer(const Core::Ptr<HTTPProtocol::HTTPRequest>& req);
+    /// complete finished transfers
+    void finishTransfers();
+    /// complete a transfer, set the response on the request and mark it handled
+    void finishTransfer(transfer* t, int curlResult);
+    /// resume paused streaming transfers if their pipe has been drained
+    void resumeTransfers();
+    /// abort cancelled and expired transfers
+    void abortTransfers();
+    /// called with the first chunk of the response body
+    static void beginBody(transfer* t);
+    /// get an idle curl easy handle, or create a new one
+    void* obtainEasyHandle();
     /// curl write-data callback
     static size_t curlWriteDataCallback(char* ptr, size_t size, size_t nmemb, void* userData);
     /// curl header-data callback
     static size_t curlHeaderCallback(char* ptr, size_t size, size_t nmenb, void* userData);
+    /// compare a header name or token with a literal, ignoring case
+    static bool equalsNoCase(const Core::StringView& str, const char* lit);
+    /// curl progress callback, aborts cancelled transfers
+    static int curlProgressCallback(void* userData, int64 dlTotal, int64 dlNow, int64 ulTotal, int64 ulNow);
 
     static bool curlInitCalled;
     static std::mutex curlInitMutex;
     const Core::String contentTypeString;
-    void* curlSession;
-    char* curlError;
+    void* curlMulti;
+    Core::Array<void*> idleEasyHandles;
+    Core::Array<transfer*> transfers;
     Core::StringBuilder stringBuilder;
-    Core::Map<Core::String,Core::String> responseHeaders;
 };
 
 } // namespace HTTP
@@ -0,0 +1,195 @@
+//------------------------------------------------------------------------------
+//  ChunkPipe.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ChunkPipe.h"
+#include "Core/Memory/Memory.h"
+
+#if ORYOL_HAS_THREADS
+#define SCOPED_LOCK std::lock_guard<std::mutex> scopedLock(this->lock)
+#else
+#define SCOPED_LOCK
+#endif
+
+namespace Oryol {
+namespace IO {
+
+OryolClassImpl(ChunkPipe);
+
+using namespace Core;
+
+//------------------------------------------------------------------------------
+ChunkPipe::ChunkPipe(int32 capacity_) :
+capacity(capacity_),
+contentLength(EndOfStream),
+buffer(nullptr),
+bufferSize(0),
+readPos(0),
+writePos(0),
+numBytesRead(0),
+maxBuffered(0),
+writeClosed(false) {
+    o_assert(capacity_ > 0);
+}
+
+//------------------------------------------------------------------------------
+ChunkPipe::~ChunkPipe() {
+    if (nullptr != this->buffer) {
+        Memory::Free(this->buffer);
+        this->buffer = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkPipe::Capacity() const {
+    return this->capacity;
+}
+
+//------------------------------------------------------------------------------
+void
+ChunkPipe::SetContentLength(int32 numBytes) {
+    SCOPED_LOCK;
+    this->contentLength = numBytes;
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkPipe::GetContentLength() const {
+    SCOPED_LOCK;
+    return this->contentLength;
+}
+
+//------------------------------------------------------------------------------
+void
+ChunkPipe::SetContentType(const ContentType& contentType_) {
+    SCOPED_LOCK;
+    this->contentType = contentType_;
+}
+
+//------------------------------------------------------------------------------
+ContentType
+ChunkPipe::GetContentType() const {
+    SCOPED_LOCK;
+    return this->contentType;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Appends the chunk behind the unread data. The unread data is moved to
+ the front of the buffer before the buffer is grown, so that the buffer
+ only grows beyond the capacity if the writer ignores IsFull().
+*/
+void
+ChunkPipe::Write(const void* ptr, int32 numBytes) {
+    o_assert(nullptr != ptr);
+    if (numBytes <= 0) {
+        return;
+    }
+    SCOPED_LOCK;
+    o_assert(!this->writeClosed);
+    const int32 numUnread = this->writePos - this->readPos;
+    if ((this->writePos + numBytes) > this->bufferSize) {
+        if ((numUnread > 0) && (this->readPos > 0)) {
+            Memory::Move(this->buffer + this->readPos, this->buffer, numUnread);
+        }
+        this->readPos = 0;
+        this->writePos = numUnread;
+        if ((numUnread + numBytes) > this->bufferSize) {
+            int32 newSize = this->capacity + numBytes;
+            if (newSize < (numUnread + numBytes)) {
+                newSize = numUnread + numBytes;
+            }
+            this->buffer = (uint8*) Memory::ReAlloc(this->buffer, newSize);
+            this->bufferSize = newSize;
+        }
+    }
+    Memory::Copy(ptr, this->buffer + this->writePos, numBytes);
+    this->writePos += numBytes;
+    if ((numUnread + numBytes) > this->maxBuffered) {
+        this->maxBuffered = numUnread + numBytes;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ChunkPipe::CloseWrite() {
+    SCOPED_LOCK;
+    this->writeClosed = true;
+}
+
+//------------------------------------------------------------------------------
+bool
+ChunkPipe::IsFull() const {
+    SCOPED_LOCK;
+    return (this->writePos - this->readPos) >= this->capacity;
+}
+
+//------------------------------------------------------------------------------
+bool
+ChunkPipe::CanResume() const {
+    SCOPED_LOCK;
+    return (this->writePos - this->readPos) <= (this->capacity >> 1);
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkPipe::Read(void* ptr, int32 maxBytes) {
+    o_assert(nullptr != ptr);
+    SCOPED_LOCK;
+    int32 numBytes = this->writePos - this->readPos;
+    if (numBytes > maxBytes) {
+        numBytes = maxBytes;
+    }
+    if (numBytes > 0) {
+        Memory::Copy(this->buffer + this->readPos, ptr, numBytes);
+        this->readPos += numBytes;
+        this->numBytesRead += numBytes;
+        if (this->readPos == this->writePos) {
+            this->readPos = 0;
+            this->writePos = 0;
+        }
+    }
+    else {
+        numBytes = 0;
+    }
+    return numBytes;
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkPipe::NumBuffered() const {
+    SCOPED_LOCK;
+    return this->writePos - this->readPos;
+}
+
+//------------------------------------------------------------------------------
+bool
+ChunkPipe::IsEmpty() const {
+    SCOPED_LOCK;
+    return this->writePos == this->readPos;
+}
+
+//------------------------------------------------------------------------------
+bool
+ChunkPipe::IsEndOfStream() const {
+    SCOPED_LOCK;
+    return this->writeClosed && (this->writePos == this->readPos);
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkPipe::NumBytesRead() const {
+    SCOPED_LOCK;
+    return this->numBytesRead;
+}
+
+//------------------------------------------------------------------------------
+int32
+ChunkPipe::MaxBuffered() const {
+    SCOPED_LOCK;
+    return this->maxBuffered;
+}
+
+} // namespace IO
+} // namespace Oryol
@@ -0,0 +1,97 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IO::ChunkPipe
+    @brief thread-safe byte pipe for streaming IO requests
+
+    A ChunkPipe transports the data of a streaming IOProtocol::Get
+    request from the IO lane thread to the consumer while the data
+    is still arriving. The FileSystem writes chunks into the pipe,
+    and the consumer reads them out at its own pace:
+
+    @code
+    Ptr<IOProtocol::Get> req = ioFacade->StreamFile("http://host/big.bin");
+    while (!(req->Handled() && req->GetPipe()->IsEmpty())) {
+        int32 numBytes = req->GetPipe()->Read(buf, sizeof(buf));
+        ...
+    }
+    @endcode
+
+    The capacity is a back-pressure limit, not a hard size: Write()
+    always accepts the data, but a writer must stop writing while
+    IsFull() is true, and resume only once CanResume() is true (the pipe
+    has drained to half its capacity). Memory usage is thus bounded by
+    the capacity plus one chunk, no matter how big the file is.
+
+    The content length and content type are set by the writer before
+    the first chunk (the content length is EndOfStream if unknown).
+*/
+#include "Core/RefCounted.h"
+#include "IO/Config.h"
+#include "IO/ContentType.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+
+namespace Oryol {
+namespace IO {
+
+class ChunkPipe : public Core::RefCounted {
+    OryolClassDecl(ChunkPipe);
+public:
+    /// constructor
+    ChunkPipe(int32 capacity=ORYOL_CHUNKPIPE_DEFAULT_CAPACITY);
+    /// destructor
+    virtual ~ChunkPipe();
+
+    /// get the back-pressure limit
+    int32 Capacity() const;
+    /// set the expected total number of bytes (writer)
+    void SetContentLength(int32 numBytes);
+    /// get the expected total number of bytes, EndOfStream if unknown
+    int32 GetContentLength() const;
+    /// set the content type (writer)
+    void SetContentType(const ContentType& contentType);
+    /// get the content type
+    ContentType GetContentType() const;
+
+    /// write a chunk (writer), always writes all bytes
+    void Write(const void* ptr, int32 numBytes);
+    /// signal that no more data will be written (writer)
+    void CloseWrite();
+    /// return true if the writer should stop writing
+    bool IsFull() const;
+    /// return true if a stopped writer may resume
+    bool CanResume() const;
+
+    /// read up to maxBytes into ptr (reader), returns number of bytes read
+    int32 Read(void* ptr, int32 maxBytes);
+    /// get number of bytes which can be read right now
+    int32 NumBuffered() const;
+    /// return true if no bytes can be read right now
+    bool IsEmpty() const;
+    /// return true if the writer is done, and all bytes have been read
+    bool IsEndOfStream() const;
+    /// get the total number of bytes read so far
+    int32 NumBytesRead() const;
+    /// get the max number of buffered bytes at any time (for tests and profiling)
+    int32 MaxBuffered() const;
+
+private:
+    const int32 capacity;
+    int32 contentLength;
+    ContentType contentType;
+    uint8* buffer;
+    int32 bufferSize;
+    int32 readPos;
+    int32 writePos;
+    int32 numBytesRead;
+    int32 maxBuffered;
+    bool writeClosed;
+    #if ORYOL_HAS_THREADS
+    mutable std::mutex lock;
+    #endif
+};
+
+} // namespace IO
+} // namespace Oryol
@@ -10,3 +10,15 @@
 #define ORYOL_STREAM_DEFAULT_MIN_GROW (256)
 /// maximum grow size for streams (in bytes)
 #define ORYOL_STREAM_DEFAULT_MAX_GROW (1<<18)   // 256 kByte
+/// default back-pressure limit of a ChunkPipe (in bytes)
+#define ORYOL_CHUNKPIPE_DEFAULT_CAPACITY (1<<18)   // 256 kByte
+/// max number of requests the ioRequestRouter puts into one IO lane at a time
+#define ORYOL_IO_MAX_LANE_REQUESTS (8)
+/// max number of hosts the ioRequestRouter remembers a lane for
+#define ORYOL_IO_MAX_HOST_LANES (64)
+/// default number of times a filesystem retries a request after a transient failure
+#define ORYOL_IO_DEFAULT_MAX_RETRIES (2)
+/// delay before the first retry of a failed request (in milliseconds), doubles with each retry
+#define ORYOL_IO_RETRY_BASE_DELAY (100)
+/// max delay between retries of a failed request (in milliseconds)
+#define ORYOL_IO_RETRY_MAX_DELAY (5000)
@@ -0,0 +1,694 @@
+//------------------------------------------------------------------------------
+//  DiskCache.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "DiskCache.h"
+#include "IO/MappedFileStream.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include "Core/String/StringBuilder.h"
+#include <algorithm>
+#if ORYOL_POSIX
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if ORYOL_HAS_THREADS
+#define SCOPED_LOCK std::lock_guard<std::mutex> scopedLock(this->lock)
+#define SCOPED_COMPACT_LOCK std::lock_guard<std::mutex> scopedCompactLock(this->compactLock)
+#else
+#define SCOPED_LOCK
+#define SCOPED_COMPACT_LOCK
+#endif
+
+namespace Oryol {
+namespace IO {
+
+OryolGlobalSingletonImpl(DiskCache);
+
+using namespace Core;
+
+// each body in the pack is preceded by its key and size, this
+// is checked when the index is loaded to detect a stale index
+static const int32 packHeaderSize = sizeof(uint64) + sizeof(int32);
+static const uint32 indexMagic = 'ODC1';
+static const uint8 putRecord = 'P';
+static const uint8 removeRecord = 'R';
+
+//------------------------------------------------------------------------------
+static void
+writeString(std::FILE* fp, const String& str) {
+    const int32 len = str.Length();
+    std::fwrite(&len, sizeof(len), 1, fp);
+    if (len > 0) {
+        std::fwrite(str.AsCStr(), 1, len, fp);
+    }
+}
+
+//------------------------------------------------------------------------------
+static bool
+readString(std::FILE* fp, String& outStr) {
+    int32 len = 0;
+    if ((1 != std::fread(&len, sizeof(len), 1, fp)) || (len < 0) || (len > (1<<16))) {
+        return false;
+    }
+    if (len > 0) {
+        char* buf = (char*) Memory::Alloc(len);
+        const bool valid = (len == int32(std::fread(buf, 1, len, fp)));
+        if (valid) {
+            outStr.Assign(buf, 0, len);
+        }
+        Memory::Free(buf);
+        return valid;
+    }
+    else {
+        outStr.Clear();
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Cuts a partially written body off the end of the pack file, returns
+ the resulting pack size.
+*/
+static int32
+truncatePack(const String& path, int32 size) {
+    #if ORYOL_POSIX
+    if (0 == truncate(path.AsCStr(), size)) {
+        return size;
+    }
+    #endif
+    // couldn't truncate, the garbage at the end counts as dead bytes
+    std::FILE* fp = std::fopen(path.AsCStr(), "rb");
+    if (nullptr != fp) {
+        std::fseek(fp, 0, SEEK_END);
+        size = int32(std::ftell(fp));
+        std::fclose(fp);
+    }
+    return size;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Copies bytes from the current position of src to dst in chunks of
+ at most copyChunkSize bytes, returns false on a short read or write.
+*/
+static const int32 copyChunkSize = 64 * 1024;
+static bool
+copyBytes(std::FILE* src, std::FILE* dst, int32 numBytes, uint8* buf) {
+    while (numBytes > 0) {
+        const int32 num = (numBytes < copyChunkSize) ? numBytes : copyChunkSize;
+        if ((num != int32(std::fread(buf, 1, num, src))) ||
+            (num != int32(std::fwrite(buf, 1, num, dst)))) {
+            return false;
+        }
+        numBytes -= num;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+DiskCache::DiskCache(const String& dir, int32 byteBudget_) :
+byteBudget(byteBudget_),
+numBytes(0),
+packSize(0),
+numHits(0),
+numMisses(0),
+useCounter(0),
+compactIndex(0),
+compactEnd(0),
+compactSize(0),
+compactFile(nullptr) {
+    this->SingletonEnsureUnique();
+    o_assert(dir.IsValid() && (byteBudget_ > 0));
+    #if ORYOL_POSIX
+    mkdir(dir.AsCStr(), 0755);
+    #endif
+    this->packPath = StringBuilder({ dir, "/pack.bin" }).GetString();
+    this->indexPath = StringBuilder({ dir, "/index.bin" }).GetString();
+    this->compactPath = StringBuilder({ dir, "/pack.bin.tmp" }).GetString();
+    this->load();
+}
+
+//------------------------------------------------------------------------------
+DiskCache::~DiskCache() {
+    SCOPED_COMPACT_LOCK;
+    SCOPED_LOCK;
+    this->abortCompact();
+    this->flush();
+}
+
+//------------------------------------------------------------------------------
+bool
+DiskCache::lruOrder(const lruItem& a, const lruItem& b) {
+    return a.lastUse > b.lastUse;
+}
+
+//------------------------------------------------------------------------------
+uint64
+DiskCache::hashKey(const String& url, const String& validator) {
+    uint64 hash = 14695981039346656037ULL;
+    for (const char* c = url.AsCStr(); *c; c++) {
+        hash = (hash ^ uint8(*c)) * 1099511628211ULL;
+    }
+    if (validator.IsValid()) {
+        hash = (hash ^ 0) * 1099511628211ULL;
+        for (const char* c = validator.AsCStr(); *c; c++) {
+            hash = (hash ^ uint8(*c)) * 1099511628211ULL;
+        }
+    }
+    return hash;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Replays the index journal, and drops entries whose pack header
+ doesn't match (e.g. after a crash during compaction), afterwards
+ the journal is rewritten compactly.
+*/
+void
+DiskCache::load() {
+    SCOPED_LOCK;
+    std::FILE* packFile = std::fopen(this->packPath.AsCStr(), "rb");
+    if (nullptr != packFile) {
+        std::fseek(packFile, 0, SEEK_END);
+        this->packSize = int32(std::ftell(packFile));
+    }
+    std::FILE* fp = std::fopen(this->indexPath.AsCStr(), "rb");
+    if (nullptr != fp) {
+        uint32 magic = 0;
+        if ((1 == std::fread(&magic, sizeof(magic), 1, fp)) && (indexMagic == magic)) {
+            uint8 type = 0;
+            while (1 == std::fread(&type, sizeof(type), 1, fp)) {
+                entry e;
+                if (putRecord == type) {
+                    String contentType;
+                    if ((1 != std::fread(&e.key, sizeof(e.key), 1, fp)) ||
+                        (1 != std::fread(&e.offset, sizeof(e.offset), 1, fp)) ||
+                        (1 != std::fread(&e.size, sizeof(e.size), 1, fp)) ||
+                        (1 != std::fread(&e.lastUse, sizeof(e.lastUse), 1, fp)) ||
+                        !readString(fp, e.url) || !readString(fp, e.validator) || !readString(fp, contentType)) {
+                        break;
+                    }
+                    e.contentType = contentType;
+                    this->remove(e.url);
+                    this->entries.Insert(e.url, e);
+                    this->numBytes += e.size;
+                    if (e.lastUse > this->useCounter) {
+                        this->useCounter = e.lastUse;
+                    }
+                }
+                else if (removeRecord == type) {
+                    if (!readString(fp, e.url)) {
+                        break;
+                    }
+                    this->remove(e.url);
+                }
+                else {
+                    break;
+                }
+            }
+        }
+        std::fclose(fp);
+    }
+
+    // validate entries against the pack file
+    Array<String> invalid;
+    for (const auto& kvp : this->entries) {
+        const entry& e = kvp.Value();
+        bool valid = false;
+        if ((nullptr != packFile) && (e.offset >= packHeaderSize) && ((e.offset + e.size) <= this->packSize)) {
+            uint64 key = 0;
+            int32 size = 0;
+            std::fseek(packFile, e.offset - packHeaderSize, SEEK_SET);
+            valid = (1 == std::fread(&key, sizeof(key), 1, packFile)) &&
+                    (1 == std::fread(&size, sizeof(size), 1, packFile)) &&
+                    (key == e.key) && (size == e.size);
+        }
+        if (!valid) {
+            invalid.AddBack(e.url);
+        }
+    }
+    for (const String& url : invalid) {
+        Log::Warn("DiskCache: dropping invalid entry for '%s'\n", url.AsCStr());
+        this->remove(url);
+    }
+    if (nullptr != packFile) {
+        std::fclose(packFile);
+    }
+    this->rebuildLRU();
+    this->flush();
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::writePutRecord(std::FILE* fp, const entry& e) {
+    std::fwrite(&putRecord, sizeof(putRecord), 1, fp);
+    std::fwrite(&e.key, sizeof(e.key), 1, fp);
+    std::fwrite(&e.offset, sizeof(e.offset), 1, fp);
+    std::fwrite(&e.size, sizeof(e.size), 1, fp);
+    std::fwrite(&e.lastUse, sizeof(e.lastUse), 1, fp);
+    writeString(fp, e.url);
+    writeString(fp, e.validator);
+    writeString(fp, e.contentType.AsCStr());
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::writeRemoveRecord(std::FILE* fp, const String& url) {
+    std::fwrite(&removeRecord, sizeof(removeRecord), 1, fp);
+    writeString(fp, url);
+}
+
+//------------------------------------------------------------------------------
+Ptr<Stream>
+DiskCache::Lookup(const URL& url, int32 offset, int32 numBytes_, String* outValidator) {
+    const String urlString(url.AsCStr());
+    SCOPED_LOCK;
+    entry* e = this->entries.Find(urlString);
+    if ((nullptr == e) || (offset < 0) || (offset >= e->size)) {
+        this->numMisses++;
+        return Ptr<Stream>();
+    }
+    if ((EndOfStream == numBytes_) || ((offset + numBytes_) > e->size)) {
+        numBytes_ = e->size - offset;
+    }
+    Ptr<MappedFileStream> stream = MappedFileStream::Create();
+    if (IOStatus::OK != stream->MapFile(this->packPath.AsCStr(), e->offset + offset, numBytes_)) {
+        this->numMisses++;
+        return Ptr<Stream>();
+    }
+    stream->SetURL(url);
+    stream->SetContentType(e->contentType);
+    if (nullptr != outValidator) {
+        *outValidator = e->validator;
+    }
+    this->touch(*e);
+    this->numHits++;
+    return stream;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Appends the body to the pack file, and a put-record to the index
+ journal. Bodies which are bigger than the byte budget, empty bodies,
+ and bodies without a validator (which could never be revalidated)
+ are not cached. The body stream must not be open. Afterwards, a step
+ of a pending compaction is done.
+*/
+bool
+DiskCache::Store(const URL& url, const String& validator, const Ptr<Stream>& body) {
+    o_assert(body.isValid() && !body->IsOpen());
+    const int32 size = body->Size();
+    if ((0 == size) || (size > this->byteBudget) || validator.Empty()) {
+        return false;
+    }
+    const String urlString(url.AsCStr());
+    {
+        SCOPED_LOCK;
+        const uint64 key = hashKey(urlString, validator);
+        entry* existing = this->entries.Find(urlString);
+        if ((nullptr != existing) && (existing->key == key) && (existing->size == size)) {
+            // same content is already cached
+            this->touch(*existing);
+            return true;
+        }
+        if (nullptr != existing) {
+            this->remove(urlString);
+        }
+        this->evict(size);
+
+        // append the body to the pack, the offset comes from the file
+        // itself, and a partial write is cut off again
+        std::FILE* packFile = std::fopen(this->packPath.AsCStr(), "ab");
+        if (nullptr == packFile) {
+            Log::Warn("DiskCache: failed to open '%s' for writing\n", this->packPath.AsCStr());
+            return false;
+        }
+        std::fseek(packFile, 0, SEEK_END);
+        const int32 packOffset = int32(std::ftell(packFile));
+        body->Open(OpenMode::ReadOnly);
+        const uint8* data = body->MapRead(nullptr);
+        bool written = (1 == std::fwrite(&key, sizeof(key), 1, packFile)) &&
+                       (1 == std::fwrite(&size, sizeof(size), 1, packFile)) &&
+                       (size == int32(std::fwrite(data, 1, size, packFile)));
+        body->Close();
+        written &= (0 == std::fclose(packFile));
+        if (!written) {
+            Log::Warn("DiskCache: failed to write '%s'\n", this->packPath.AsCStr());
+            this->packSize = truncatePack(this->packPath, packOffset);
+            return false;
+        }
+        entry e;
+        e.url = urlString;
+        e.validator = validator;
+        e.contentType = body->GetContentType();
+        e.key = key;
+        e.offset = packOffset + packHeaderSize;
+        e.size = size;
+        e.lastUse = 0;
+        this->packSize = e.offset + size;
+        this->numBytes += size;
+        this->entries.Insert(e.url, e);
+        entry& inserted = *this->entries.Find(urlString);
+        this->touch(inserted);
+
+        // append to the index journal
+        std::FILE* fp = std::fopen(this->indexPath.AsCStr(), "ab");
+        if (nullptr != fp) {
+            this->writePutRecord(fp, inserted);
+            std::fclose(fp);
+        }
+    }
+    // drop the dead bytes of evicted and replaced entries
+    this->compactStep(CompactStepBytes);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::Remove(const URL& url) {
+    const String urlString(url.AsCStr());
+    SCOPED_LOCK;
+    if (this->entries.Contains(urlString)) {
+        this->remove(urlString);
+        std::FILE* fp = std::fopen(this->indexPath.AsCStr(), "ab");
+        if (nullptr != fp) {
+            this->writeRemoveRecord(fp, urlString);
+            std::fclose(fp);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::remove(const String& url) {
+    const entry* e = this->entries.Find(url);
+    if (nullptr != e) {
+        this->numBytes -= e->size;
+        this->entries.Erase(url);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Every use pushes a new item onto the LRU heap, the item of the
+ previous use becomes stale and is skipped when it reaches the top.
+*/
+void
+DiskCache::touch(entry& e) {
+    e.lastUse = ++this->useCounter;
+    this->lru.AddBack(lruItem{ e.lastUse, e.url });
+    std::push_heap(this->lru.begin(), this->lru.end(), lruOrder);
+    if (this->lru.Size() > (2 * this->entries.Size() + 64)) {
+        // too many stale items
+        this->rebuildLRU();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::rebuildLRU() {
+    this->lru.Clear();
+    this->lru.Reserve(this->entries.Size());
+    for (const auto& kvp : this->entries) {
+        this->lru.AddBack(lruItem{ kvp.Value().lastUse, kvp.Value().url });
+    }
+    std::make_heap(this->lru.begin(), this->lru.end(), lruOrder);
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::evict(int32 size) {
+    std::FILE* fp = nullptr;
+    while (((this->numBytes + size) > this->byteBudget) && !this->lru.Empty()) {
+        std::pop_heap(this->lru.begin(), this->lru.end(), lruOrder);
+        const lruItem item = this->lru.Back();
+        this->lru.Erase(this->lru.Size() - 1);
+        const entry* e = this->entries.Find(item.url);
+        if ((nullptr != e) && (e->lastUse == item.lastUse)) {
+            this->remove(item.url);
+            if (nullptr == fp) {
+                fp = std::fopen(this->indexPath.AsCStr(), "ab");
+            }
+            if (nullptr != fp) {
+                this->writeRemoveRecord(fp, item.url);
+            }
+        }
+    }
+    if (nullptr != fp) {
+        std::fclose(fp);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::Compact() {
+    {
+        SCOPED_COMPACT_LOCK;
+        SCOPED_LOCK;
+        if (nullptr == this->compactFile) {
+            this->beginCompact();
+        }
+    }
+    while (this->compactStep(CompactStepBytes)) {
+        // continue
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Snapshots the live entries in pack order, they are copied into a
+ new pack file by compactStep().
+*/
+void
+DiskCache::beginCompact() {
+    o_assert(nullptr == this->compactFile);
+    this->compactFile = std::fopen(this->compactPath.AsCStr(), "wb");
+    if (nullptr == this->compactFile) {
+        Log::Warn("DiskCache: failed to open '%s' for writing\n", this->compactPath.AsCStr());
+        return;
+    }
+    this->compactItems.Clear();
+    this->compactItems.Reserve(this->entries.Size());
+    for (const auto& kvp : this->entries) {
+        const entry& e = kvp.Value();
+        this->compactItems.AddBack(compactItem{ e.url, e.key, e.offset, 0, e.size });
+    }
+    std::sort(this->compactItems.begin(), this->compactItems.end(), [](const compactItem& a, const compactItem& b) {
+        return a.srcOffset < b.srcOffset;
+    });
+    this->compactIndex = 0;
+    this->compactEnd = this->packSize;
+    this->compactSize = 0;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Starts a compaction if the pack holds more dead than live bytes, and
+ copies the next live entries of a pending compaction. The copying
+ happens outside of the state lock: the bytes below compactEnd are
+ never written again, and the compaction state is only touched while
+ holding the compact lock. Returns true if the compaction is still
+ pending afterwards.
+*/
+bool
+DiskCache::compactStep(int32 maxBytes) {
+    SCOPED_COMPACT_LOCK;
+    int32 endIndex = 0;
+    {
+        SCOPED_LOCK;
+        if (nullptr == this->compactFile) {
+            const int32 deadBytes = this->packSize - this->numBytes - this->entries.Size() * packHeaderSize;
+            if (deadBytes <= this->numBytes) {
+                return false;
+            }
+            this->beginCompact();
+            if (nullptr == this->compactFile) {
+                return false;
+            }
+        }
+        endIndex = this->compactIndex;
+        int32 bytes = 0;
+        while ((endIndex < this->compactItems.Size()) && (bytes < maxBytes)) {
+            bytes += packHeaderSize + this->compactItems[endIndex].size;
+            endIndex++;
+        }
+    }
+
+    std::FILE* src = std::fopen(this->packPath.AsCStr(), "rb");
+    bool valid = (nullptr != src);
+    if (valid) {
+        uint8* buf = (uint8*) Memory::Alloc(copyChunkSize);
+        for (int32 i = this->compactIndex; valid && (i < endIndex); i++) {
+            compactItem& item = this->compactItems[i];
+            const int32 numBytes = packHeaderSize + item.size;
+            std::fseek(src, item.srcOffset - packHeaderSize, SEEK_SET);
+            valid = copyBytes(src, this->compactFile, numBytes, buf);
+            item.dstOffset = this->compactSize + packHeaderSize;
+            this->compactSize += numBytes;
+        }
+        Memory::Free(buf);
+        std::fclose(src);
+    }
+
+    SCOPED_LOCK;
+    if (!valid) {
+        Log::Warn("DiskCache: failed to compact '%s'\n", this->packPath.AsCStr());
+        this->abortCompact();
+        return false;
+    }
+    this->compactIndex = endIndex;
+    if (this->compactIndex == this->compactItems.Size()) {
+        this->finishCompact();
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Copies the bodies which were stored since the compaction started
+ (this is the only copy under the state lock), moves the entries to
+ their new offsets and replaces the pack file. Streams which are still
+ mapped from the old pack stay valid, since the old file is only
+ unlinked. Entries which were removed or replaced during the
+ compaction leave dead bytes in the new pack.
+*/
+void
+DiskCache::finishCompact() {
+    const int32 tailSize = this->packSize - this->compactEnd;
+    bool valid = true;
+    if (tailSize > 0) {
+        std::FILE* src = std::fopen(this->packPath.AsCStr(), "rb");
+        valid = (nullptr != src);
+        if (valid) {
+            uint8* buf = (uint8*) Memory::Alloc(copyChunkSize);
+            std::fseek(src, this->compactEnd, SEEK_SET);
+            valid = copyBytes(src, this->compactFile, tailSize, buf);
+            Memory::Free(buf);
+            std::fclose(src);
+        }
+    }
+    valid &= (0 == std::fclose(this->compactFile));
+    this->compactFile = nullptr;
+    if (!valid) {
+        Log::Warn("DiskCache: failed to compact '%s'\n", this->packPath.AsCStr());
+        std::remove(this->compactPath.AsCStr());
+        this->compactItems.Clear();
+        return;
+    }
+    for (const compactItem& item : this->compactItems) {
+        entry* e = this->entries.Find(item.url);
+        if ((nullptr != e) && (e->key == item.key) && (e->offset == item.srcOffset)) {
+            e->offset = item.dstOffset;
+        }
+    }
+    const int32 shift = this->compactSize - this->compactEnd;
+    for (auto& kvp : this->entries) {
+        if (kvp.Value().offset > this->compactEnd) {
+            kvp.Value().offset += shift;
+        }
+    }
+    this->compactItems.Clear();
+    std::rename(this->compactPath.AsCStr(), this->packPath.AsCStr());
+    this->packSize = this->compactSize + tailSize;
+    this->flush();
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::abortCompact() {
+    if (nullptr != this->compactFile) {
+        std::fclose(this->compactFile);
+        this->compactFile = nullptr;
+        std::remove(this->compactPath.AsCStr());
+        this->compactItems.Clear();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::Flush() {
+    SCOPED_LOCK;
+    this->flush();
+}
+
+//------------------------------------------------------------------------------
+void
+DiskCache::flush() {
+    StringBuilder strBuilder({ this->indexPath, ".tmp" });
+    const String tmpPath = strBuilder.GetString();
+    std::FILE* fp = std::fopen(tmpPath.AsCStr(), "wb");
+    if (nullptr == fp) {
+        Log::Warn("DiskCache: failed to write '%s'\n", tmpPath.AsCStr());
+        return;
+    }
+    std::fwrite(&indexMagic, sizeof(indexMagic), 1, fp);
+    for (const auto& kvp : this->entries) {
+        this->writePutRecord(fp, kvp.Value());
+    }
+    std::fclose(fp);
+    std::rename(tmpPath.AsCStr(), this->indexPath.AsCStr());
+}
+
+//------------------------------------------------------------------------------
+bool
+DiskCache::Contains(const URL& url) const {
+    const String urlString(url.AsCStr());
+    SCOPED_LOCK;
+    return this->entries.Contains(urlString);
+}
+
+//------------------------------------------------------------------------------
+String
+DiskCache::GetValidator(const URL& url) const {
+    const String urlString(url.AsCStr());
+    SCOPED_LOCK;
+    return this->entries.Contains(urlString) ? this->entries[urlString].validator : String();
+}
+
+//------------------------------------------------------------------------------
+int32
+DiskCache::ByteBudget() const {
+    return this->byteBudget;
+}
+
+//------------------------------------------------------------------------------
+int32
+DiskCache::NumEntries() const {
+    SCOPED_LOCK;
+    return this->entries.Size();
+}
+
+//------------------------------------------------------------------------------
+int32
+DiskCache::NumBytes() const {
+    SCOPED_LOCK;
+    return this->numBytes;
+}
+
+//------------------------------------------------------------------------------
+int32
+DiskCache::PackSize() const {
+    SCOPED_LOCK;
+    return this->packSize;
+}
+
+//------------------------------------------------------------------------------
+int32
+DiskCache::NumHits() const {
+    SCOPED_LOCK;
+    return this->numHits;
+}
+
+//------------------------------------------------------------------------------
+int32
+DiskCache::NumMisses() const {
+    SCOPED_LOCK;
+    return this->numMisses;
+}
+
+} // namespace IO
+} // namespace Oryol
@@ -0,0 +1,175 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IO::DiskCache
+    @brief persistent local cache for IO request results
+
+    The DiskCache keeps the bodies of loaded files in a local directory,
+    so that they don't need to be downloaded again, also after a restart.
+    Caching is opt-in per request: requests with CacheWriteEnabled store
+    their result in the cache, requests with CacheReadEnabled revalidate
+    a cached copy with a conditional request (the filesystem gets the
+    stored validator as CachedValidator), and are served from the cache
+    if the origin answers with NotModified. The IO lanes access the cache,
+    setup is done through IOFacade:
+
+    @code
+    ioFacade->SetupDiskCache("/tmp/mygame_cache", 64 * 1024 * 1024);
+    Ptr<IOProtocol::Get> req = ioFacade->LoadCachedFile("http://host/file.bin");
+    @endcode
+
+    Entries are keyed by URL plus validator (the ETag or Last-Modified
+    header of a HTTP response): storing the same URL and validator again
+    doesn't write anything, a new validator replaces the old entry.
+    Results without a validator can't be revalidated and are not cached.
+
+    All bodies are appended to a single pack file ("pack.bin"), and
+    cache hits are memory-mapped directly from the pack. Changes to the
+    index are appended to an index journal ("index.bin"), which is
+    replayed when the cache is opened. When the cached bytes exceed the
+    byte budget, the least recently used entries are evicted (through a
+    min-heap of last-use stamps), and the pack is compacted once it holds
+    more dead than live bytes. Compaction is incremental: each Store()
+    copies at most CompactStepBytes of live entries into the new pack,
+    without blocking lookups and stores on other threads while copying.
+
+    The DiskCache is thread-safe.
+*/
+#include "Core/Macros.h"
+#include "Core/String/String.h"
+#include "Core/Containers/HashMap.h"
+#include "Core/Containers/Array.h"
+#include "IO/URL.h"
+#include "IO/Stream.h"
+#include "IO/ContentType.h"
+#if ORYOL_HAS_THREADS
+#include <mutex>
+#endif
+#include <cstdio>
+
+namespace Oryol {
+namespace IO {
+
+class DiskCache {
+    OryolGlobalSingletonDecl(DiskCache);
+public:
+    /// constructor, opens or creates the cache in a local directory
+    DiskCache(const Core::String& dir, int32 byteBudget);
+    /// destructor, writes the index
+    ~DiskCache();
+
+    /// look up a cached body (or a range of it) and its validator, returns invalid ptr if not cached
+    Core::Ptr<Stream> Lookup(const URL& url, int32 offset=0, int32 numBytes=EndOfStream, Core::String* outValidator=nullptr);
+    /// store a body in the cache, returns false if not cached (also if the validator is empty)
+    bool Store(const URL& url, const Core::String& validator, const Core::Ptr<Stream>& body);
+    /// remove an entry
+    void Remove(const URL& url);
+    /// test if an entry exists for the URL
+    bool Contains(const URL& url) const;
+    /// get the validator of a cached entry
+    Core::String GetValidator(const URL& url) const;
+    /// rewrite the pack file without the bytes of removed entries (also finishes a pending compaction)
+    void Compact();
+    /// write a compact index journal
+    void Flush();
+
+    /// get the byte budget
+    int32 ByteBudget() const;
+    /// get number of cached entries
+    int32 NumEntries() const;
+    /// get the number of bytes in live entries
+    int32 NumBytes() const;
+    /// get the size of the pack file (including dead bytes)
+    int32 PackSize() const;
+    /// get number of Lookup() hits
+    int32 NumHits() const;
+    /// get number of Lookup() misses
+    int32 NumMisses() const;
+
+    /// max number of bytes copied by a compaction step in Store()
+    static const int32 CompactStepBytes = 1024 * 1024;
+
+private:
+    /// a cache entry
+    struct entry {
+        Core::String url;
+        Core::String validator;
+        ContentType contentType;
+        uint64 key;
+        int32 offset;
+        int32 size;
+        uint64 lastUse;
+    };
+    /// an item of the LRU heap, stale if the entry has been used since
+    struct lruItem {
+        uint64 lastUse;
+        Core::String url;
+    };
+    /// a live entry which is copied by the pending compaction
+    struct compactItem {
+        Core::String url;
+        uint64 key;
+        int32 srcOffset;
+        int32 dstOffset;
+        int32 size;
+    };
+    /// hash function for URL strings
+    struct urlHasher {
+        uint32 operator()(const Core::String& url) const {
+            return uint32(hashKey(url, Core::String()));
+        };
+    };
+    /// heap order of the LRU heap, the least recently used item on top
+    static bool lruOrder(const lruItem& a, const lruItem& b);
+    /// compute the content key from URL and validator (64-bit FNV-1a)
+    static uint64 hashKey(const Core::String& url, const Core::String& validator);
+    /// read the index journal
+    void load();
+    /// append a put-record to the index journal
+    void writePutRecord(std::FILE* fp, const entry& e);
+    /// append a remove-record to the index journal
+    void writeRemoveRecord(std::FILE* fp, const Core::String& url);
+    /// remove an entry (no locking)
+    void remove(const Core::String& url);
+    /// update the last-use stamp of an entry (no locking)
+    void touch(entry& e);
+    /// rebuild the LRU heap from the entries (no locking)
+    void rebuildLRU();
+    /// evict least recently used entries until numBytes fit into the budget (no locking)
+    void evict(int32 numBytes);
+    /// start a compaction (no locking)
+    void beginCompact();
+    /// copy up to maxBytes of the pending compaction, returns false if nothing is pending (locks)
+    bool compactStep(int32 maxBytes);
+    /// copy the tail of the pack and replace the pack file (no locking)
+    void finishCompact();
+    /// drop a pending compaction (no locking)
+    void abortCompact();
+    /// write a compact index (no locking)
+    void flush();
+
+    Core::String packPath;
+    Core::String indexPath;
+    Core::String compactPath;
+    int32 byteBudget;
+    int32 numBytes;
+    int32 packSize;
+    int32 numHits;
+    int32 numMisses;
+    uint64 useCounter;
+    Core::HashMap<Core::String, entry, urlHasher> entries;
+    Core::Array<lruItem> lru;
+    Core::Array<compactItem> compactItems;
+    int32 compactIndex;
+    int32 compactEnd;
+    int32 compactSize;
+    std::FILE* compactFile;
+    #if ORYOL_HAS_THREADS
+    mutable std::mutex lock;
+    /// serializes compaction steps, always taken before lock
+    std::mutex compactLock;
+    #endif
+};
+
+} // namespace IO
+} // namespace Oryol
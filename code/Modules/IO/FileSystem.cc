@@ -36,11 +36,32 @@ FileSystem::onGetRange(const Ptr<IOProtocol::GetRange>& msg) {
     Log::Warn("FileSystem::onGetRange(): message not handled by FileSystem!\n");
 }
 
+//------------------------------------------------------------------------------
+void
+FileSystem::onGetRanges(const Ptr<IOProtocol::GetRanges>& msg) {
+    // implement in subclass!
+    Log::Warn("FileSystem::onGetRanges(): message not handled by FileSystem!\n");
+}
+
 //------------------------------------------------------------------------------
 void
 FileSystem::DoWork() {
     // implement in subclass!
 }
 
+//------------------------------------------------------------------------------
+bool
+FileSystem::HasPendingRequests() const {
+    // implement in subclass if requests are completed in DoWork()
+    return false;
+}
+
+//------------------------------------------------------------------------------
+bool
+FileSystem::IsTransferring() const {
+    // override in subclass if pending requests can be paused
+    return this->HasPendingRequests();
+}
+
 } // namespace IO
 } // namespace Oryol
\ No newline at end of file
@@ -25,10 +25,16 @@ public:
     
     /// per-frame update
     virtual void DoWork();
+    /// return true if requests are in flight
+    virtual bool HasPendingRequests() const;
+    /// return true if pending requests are moving data (the IO lane ticks faster)
+    virtual bool IsTransferring() const;
     /// called when the IOProtocol::Get message is received
     virtual void onGet(const Core::Ptr<IOProtocol::Get>& msg);
     /// called when the IOProtocol::GetRange message is received
     virtual void onGetRange(const Core::Ptr<IOProtocol::GetRange>& msg);
+    /// called when the IOProtocol::GetRanges message is received
+    virtual void onGetRanges(const Core::Ptr<IOProtocol::GetRanges>& msg);
 };
     
 } // namespace IO
@@ -4,6 +4,8 @@
 #include "Pre.h"
 #include "IOFacade.h"
 #include "IO/assignRegistry.h"
+#include "IO/DiskCache.h"
+#include "IO/SubStream.h"
 #include "Core/CoreFacade.h"
 
 namespace Oryol {
@@ -17,7 +19,10 @@ OryolGlobalSingletonImpl(IOFacade);
 const int32 IOFacade::numIOLanes = 4;
 
 //------------------------------------------------------------------------------
-IOFacade::IOFacade() {
+IOFacade::IOFacade() :
+numPreloadFilesDone(0),
+numPreloadFilesFailed(0),
+numPreloadBytesDone(0) {
     this->SingletonEnsureUnique();
     this->mainThreadId = std::this_thread::get_id();
     assignRegistry::CreateSingle();
@@ -30,7 +35,11 @@ IOFacade::IOFacade() {
 IOFacade::~IOFacade() {
     o_assert(this->isMainThread());
     CoreFacade::Instance()->RunLoop()->Remove("IO::IOFacade");
+    this->DiscardPreloadedFiles();
     this->requestRouter = 0;
+    if (DiskCache::HasInstance()) {
+        DiskCache::DestroySingle();
+    }
     schemeRegistry::DestroySingle();
     assignRegistry::DestroySingle();
 }
@@ -42,6 +51,7 @@ IOFacade::doWork() {
     if (this->requestRouter.isValid()) {
         this->requestRouter->DoWork();
     }
+    this->updatePreloading();
 }
 
 //------------------------------------------------------------------------------
@@ -108,37 +118,250 @@ IOFacade::IsFileSystemRegistered(const StringAtom& scheme) const {
 
 //------------------------------------------------------------------------------
 Ptr<IOProtocol::Get>
-IOFacade::LoadFile(const URL& url, int32 ioLane) {
+IOFacade::createGet(const URL& url, int32 ioLane, IOPriority::Code priority) {
     Ptr<IOProtocol::Get> ioReq = IOProtocol::Get::Create();
     ioReq->SetURL(url);
     ioReq->SetLane(ioLane);
+    ioReq->SetPriority(priority);
+    return ioReq;
+}
+
+//------------------------------------------------------------------------------
+/**
+ If the file has been preloaded, the returned request is already handled
+ and gets a SubStream on the preloaded stream. If the file is still being preloaded,
+ the returned request is handled when the preload request is done.
+*/
+Ptr<IOProtocol::Get>
+IOFacade::LoadFile(const URL& url, int32 ioLane, IOPriority::Code priority) {
+    o_assert(this->isMainThread());
+    Ptr<IOProtocol::Get> ioReq = this->createGet(url, ioLane, priority);
+    if (!this->preloadFiles.Empty()) {
+        const String urlString(url.AsCStr());
+        if (this->preloadFiles.Contains(urlString)) {
+            const Ptr<IOProtocol::Get>& preload = this->preloadFiles[urlString];
+            if (!preload->Handled()) {
+                this->preloadWaiters.AddBack(preloadWaiter{ ioReq, preload });
+                return ioReq;
+            }
+            else if (IOStatus::OK == preload->GetStatus()) {
+                ioReq->SetStatus(IOStatus::OK);
+                // each request gets its own view with its own open state and read position
+                const Ptr<Stream>& stream = preload->GetStream();
+                if (stream.isValid()) {
+                    ioReq->SetStream(SubStream::Create(stream, 0, stream->Size()));
+                }
+                ioReq->SetHandled();
+                return ioReq;
+            }
+        }
+    }
+    this->requestRouter->Put(ioReq);
+    return ioReq;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Like LoadFile(), but a cached copy is revalidated with a conditional
+ request and served from the DiskCache if it is still valid, otherwise
+ the result is stored in the DiskCache. Requires SetupDiskCache().
+*/
+Ptr<IOProtocol::Get>
+IOFacade::LoadCachedFile(const URL& url, int32 ioLane, IOPriority::Code priority) {
+    o_assert(this->isMainThread());
+    o_assert(DiskCache::HasInstance());
+    Ptr<IOProtocol::Get> ioReq = this->createGet(url, ioLane, priority);
+    ioReq->SetCacheReadEnabled(true);
+    ioReq->SetCacheWriteEnabled(true);
     this->requestRouter->Put(ioReq);
     return ioReq;
 }
 
 //------------------------------------------------------------------------------
 Ptr<IOProtocol::GetRange>
-IOFacade::LoadFileRange(const URL& url, int32 startOffset, int32 endOffset, int32 ioLane) {
+IOFacade::LoadFileRange(const URL& url, int32 startOffset, int32 endOffset, int32 ioLane, IOPriority::Code priority) {
     Ptr<IOProtocol::GetRange> ioReq = IOProtocol::GetRange::Create();
     ioReq->SetURL(url);
     ioReq->SetLane(ioLane);
+    ioReq->SetPriority(priority);
     ioReq->SetStartOffset(startOffset);
     ioReq->SetEndOffset(endOffset);
     this->requestRouter->Put(ioReq);
     return ioReq;
 }
 
+//------------------------------------------------------------------------------
+/**
+ Fetches all ranges with a single filesystem request (one mapping of a
+ local file, or one HTTP request with a multi-range Range header). The
+ request's RangeStreams receive one read-only stream per range, in
+ the same order as the offsets.
+*/
+Ptr<IOProtocol::GetRanges>
+IOFacade::LoadFileRanges(const URL& url, const Array<int32>& startOffsets, const Array<int32>& endOffsets, int32 ioLane, IOPriority::Code priority) {
+    o_assert(startOffsets.Size() == endOffsets.Size());
+    Ptr<IOProtocol::GetRanges> ioReq = IOProtocol::GetRanges::Create();
+    ioReq->SetURL(url);
+    ioReq->SetLane(ioLane);
+    ioReq->SetPriority(priority);
+    ioReq->SetStartOffsets(startOffsets);
+    ioReq->SetEndOffsets(endOffsets);
+    this->requestRouter->Put(ioReq);
+    return ioReq;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Returns a Get request with a ChunkPipe: the file content arrives in the
+ pipe while the request is in flight, and the request is handled after
+ all data has been written into the pipe. The request's Stream doesn't
+ receive the data (but may hold the body of a HTTP error response).
+*/
+Ptr<IOProtocol::Get>
+IOFacade::StreamFile(const URL& url, int32 pipeCapacity, int32 ioLane, IOPriority::Code priority) {
+    Ptr<IOProtocol::Get> ioReq = IOProtocol::Get::Create();
+    ioReq->SetURL(url);
+    ioReq->SetLane(ioLane);
+    ioReq->SetPriority(priority);
+    ioReq->SetPipe(ChunkPipe::Create(pipeCapacity));
+    this->requestRouter->Put(ioReq);
+    return ioReq;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Caching is opt-in per request: after the DiskCache has been setup,
+ LoadCachedFile() requests are revalidated against the cache, and their
+ results are stored in the cache. Use Put() with CacheReadEnabled and
+ CacheWriteEnabled to control caching of other requests (GetRange
+ requests can only read from the cache).
+*/
+void
+IOFacade::SetupDiskCache(const String& dir, int32 byteBudget) {
+    o_assert(this->isMainThread());
+    o_assert(!DiskCache::HasInstance());
+    DiskCache::CreateSingle(dir, byteBudget);
+}
+
 //------------------------------------------------------------------------------
 void
+IOFacade::Put(const Ptr<IOProtocol::Request>& req) {
+    this->requestRouter->Put(req);
+}
+
+//------------------------------------------------------------------------------
+const Ptr<ioRequestRouter>&
+IOFacade::RequestRouter() const {
+    return this->requestRouter;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Preload requests are scheduled with high priority on any lane (unless
+ an explicit lane is given), so they are loaded concurrently across all
+ lanes. Adding the same URL again does nothing.
+*/
+void
 IOFacade::AddPreloadFile(const URL& url, int32 ioLane) {
-    /// @todo: implement AddPreloadFile()
+    o_assert(this->isMainThread());
+    const String urlString(url.AsCStr());
+    if (!this->preloadFiles.Contains(urlString)) {
+        Ptr<IOProtocol::Get> ioReq = this->createGet(url, ioLane, IOPriority::High);
+        this->preloadFiles.Insert(urlString, ioReq);
+        this->pendingPreloads.AddBack(ioReq);
+        this->requestRouter->Put(ioReq);
+    }
 }
 
 //------------------------------------------------------------------------------
 bool
 IOFacade::IsPreloadingFinished() const {
-    /// @todo: implement IsPreloadingFinished()
-    return false;
+    for (const auto& preload : this->pendingPreloads) {
+        if (!preload->Handled()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+IOFacade::updatePreloading() {
+    for (int32 i = this->pendingPreloads.Size() - 1; i >= 0; i--) {
+        const Ptr<IOProtocol::Get>& preload = this->pendingPreloads[i];
+        if (preload->Handled()) {
+            this->numPreloadFilesDone++;
+            if ((IOStatus::OK == preload->GetStatus()) && preload->GetStream().isValid()) {
+                this->numPreloadBytesDone += preload->GetStream()->Size();
+            }
+            else {
+                this->numPreloadFilesFailed++;
+            }
+            this->pendingPreloads.EraseSwap(i);
+        }
+    }
+    for (int32 i = this->preloadWaiters.Size() - 1; i >= 0; i--) {
+        const preloadWaiter& waiter = this->preloadWaiters[i];
+        if (waiter.preload->Handled()) {
+            if (IOStatus::OK == waiter.preload->GetStatus()) {
+                waiter.msg->SetStatus(IOStatus::OK);
+                const Ptr<Stream>& stream = waiter.preload->GetStream();
+                if (stream.isValid()) {
+                    waiter.msg->SetStream(SubStream::Create(stream, 0, stream->Size()));
+                }
+                waiter.msg->SetHandled();
+            }
+            else {
+                // failed preload, try again
+                this->requestRouter->Put(waiter.msg);
+            }
+            this->preloadWaiters.EraseSwap(i);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+int32
+IOFacade::NumPreloadFiles() const {
+    return this->preloadFiles.Size();
+}
+
+//------------------------------------------------------------------------------
+int32
+IOFacade::NumPreloadFilesDone() const {
+    return this->numPreloadFilesDone;
+}
+
+//------------------------------------------------------------------------------
+int32
+IOFacade::NumPreloadFilesFailed() const {
+    return this->numPreloadFilesFailed;
+}
+
+//------------------------------------------------------------------------------
+int32
+IOFacade::NumPreloadBytesDone() const {
+    return this->numPreloadBytesDone;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Call this after preloading, once the preloaded files have been used,
+ afterwards LoadFile() goes through the IO lanes again. Preload requests
+ which are still in flight are dropped.
+*/
+void
+IOFacade::DiscardPreloadedFiles() {
+    o_assert(this->isMainThread());
+    this->preloadFiles.Clear();
+    this->pendingPreloads.Clear();
+    for (const auto& waiter : this->preloadWaiters) {
+        this->requestRouter->Put(waiter.msg);
+    }
+    this->preloadWaiters.Clear();
+    this->numPreloadFilesDone = 0;
+    this->numPreloadFilesFailed = 0;
+    this->numPreloadBytesDone = 0;
 }
     
 } // namespace IO
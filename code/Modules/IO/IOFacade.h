@@ -43,22 +43,60 @@ public:
     bool IsFileSystemRegistered(const Core::StringAtom& scheme) const;
     
     /// asynchronously load a file, returns IORequest object
-    Core::Ptr<IOProtocol::Get> LoadFile(const IO::URL& url, int32 ioLane = 0);
+    Core::Ptr<IOProtocol::Get> LoadFile(const IO::URL& url, int32 ioLane = AnyLane, IOPriority::Code priority = IOPriority::Normal);
+    /// asynchronously load a file through the DiskCache (revalidated with a conditional request)
+    Core::Ptr<IOProtocol::Get> LoadCachedFile(const IO::URL& url, int32 ioLane = AnyLane, IOPriority::Code priority = IOPriority::Normal);
     /// asynchronously load a file, return IORequest object
-    Core::Ptr<IOProtocol::GetRange> LoadFileRange(const IO::URL& url, int32 startOffset, int32 endOffset, int32 ioLane = 0);
-    /// add a preload file
-    void AddPreloadFile(const IO::URL& url, int32 ioLane = 0);
+    Core::Ptr<IOProtocol::GetRange> LoadFileRange(const IO::URL& url, int32 startOffset, int32 endOffset, int32 ioLane = AnyLane, IOPriority::Code priority = IOPriority::Normal);
+    /// asynchronously load several ranges of a file in one request (end offsets are inclusive)
+    Core::Ptr<IOProtocol::GetRanges> LoadFileRanges(const IO::URL& url, const Core::Array<int32>& startOffsets, const Core::Array<int32>& endOffsets, int32 ioLane = AnyLane, IOPriority::Code priority = IOPriority::Normal);
+    /// asynchronously stream a file through a ChunkPipe, returns IORequest object
+    Core::Ptr<IOProtocol::Get> StreamFile(const IO::URL& url, int32 pipeCapacity = ORYOL_CHUNKPIPE_DEFAULT_CAPACITY, int32 ioLane = AnyLane, IOPriority::Code priority = IOPriority::Normal);
+    /// setup a persistent DiskCache in a local directory, call before the first request
+    void SetupDiskCache(const Core::String& dir, int32 byteBudget);
+    /// put a custom IO request (e.g. with CacheReadEnabled/CacheWriteEnabled)
+    void Put(const Core::Ptr<IOProtocol::Request>& req);
+    /// add a preload file, loaded files are kept in memory for LoadFile() (each request gets its own SubStream)
+    void AddPreloadFile(const IO::URL& url, int32 ioLane = AnyLane);
     /// return true if preloading is finished
     bool IsPreloadingFinished() const;
+    /// get number of preload files
+    int32 NumPreloadFiles() const;
+    /// get number of finished preload files (including failed)
+    int32 NumPreloadFilesDone() const;
+    /// get number of failed preload files
+    int32 NumPreloadFilesFailed() const;
+    /// get number of bytes in finished preload files
+    int32 NumPreloadBytesDone() const;
+    /// free the memory of preloaded files
+    void DiscardPreloadedFiles();
+    /// get the IO request router (for tests and profiling)
+    const Core::Ptr<ioRequestRouter>& RequestRouter() const;
     
 private:
     /// test if we are on the main thread
     bool isMainThread();
     /// the per-frame update method (attached to the main-thread runloop)
     void doWork();
+    /// update preload progress, and handle requests waiting for a preload
+    void updatePreloading();
+    /// create a Get request
+    Core::Ptr<IOProtocol::Get> createGet(const IO::URL& url, int32 ioLane, IOPriority::Code priority);
 
     std::thread::id mainThreadId;
     Core::Ptr<ioRequestRouter> requestRouter;
+
+    /// a LoadFile() request waiting for a preload request
+    struct preloadWaiter {
+        Core::Ptr<IOProtocol::Get> msg;
+        Core::Ptr<IOProtocol::Get> preload;
+    };
+    Core::Map<Core::String, Core::Ptr<IOProtocol::Get>> preloadFiles;
+    Core::Array<Core::Ptr<IOProtocol::Get>> pendingPreloads;
+    Core::Array<preloadWaiter> preloadWaiters;
+    int32 numPreloadFilesDone;
+    int32 numPreloadFilesFailed;
+    int32 numPreloadBytesDone;
     static const int32 numIOLanes;
 };
 
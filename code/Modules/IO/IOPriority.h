@@ -0,0 +1,39 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IO::IOPriority
+    @brief IO request priorities
+
+    The ioRequestRouter only puts a limited number of requests into each
+    IO lane (see ORYOL_IO_MAX_LANE_REQUESTS), the other requests wait in
+    the router, and higher-priority requests are dispatched first. Use
+    High for data the current frame is waiting on, and Low for background
+    prefetching.
+
+    NOTE: the priority only has an effect while all lanes are full,
+    a request which is dispatched into a lane right away is handled
+    in put-order with the other requests of that lane. Requests with
+    an explicit lane index bypass the priorities completely.
+*/
+#include "Core/Types.h"
+
+namespace Oryol {
+namespace IO {
+
+class IOPriority {
+public:
+    /// priority enum
+    enum Code {
+        Low = 0,
+        Normal,
+        High,
+
+        NumPriorities,
+    };
+};
+
+/// IO lane index which lets the ioRequestRouter pick the lane
+static const int32 AnyLane = -1;
+
+} // namespace IO
+} // namespace Oryol
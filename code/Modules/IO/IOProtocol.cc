@@ -1,5 +1,5 @@
 //-----------------------------------------------------------------------------
-// #version:2# machine generated, do not edit!
+// #version:7# machine generated, do not edit!
 //-----------------------------------------------------------------------------
 #include "Pre.h"
 #include "IOProtocol.h"
@@ -7,8 +7,9 @@
 namespace Oryol {
 namespace IO {
 OryolClassPoolAllocImpl(IOProtocol::Request);
-OryolClassPoolAllocImpl(IOProtocol::Get);
+OryolClassRecycleImpl(IOProtocol::Get);
 OryolClassPoolAllocImpl(IOProtocol::GetRange);
+OryolClassPoolAllocImpl(IOProtocol::GetRanges);
 OryolClassPoolAllocImpl(IOProtocol::notifyLanes);
 OryolClassPoolAllocImpl(IOProtocol::notifyFileSystemRemoved);
 OryolClassPoolAllocImpl(IOProtocol::notifyFileSystemReplaced);
@@ -17,6 +18,7 @@ IOProtocol::CreateCallback IOProtocol::jumpTable[IOProtocol::MessageId::NumMessa
     &IOProtocol::Request::FactoryCreate,
     &IOProtocol::Get::FactoryCreate,
     &IOProtocol::GetRange::FactoryCreate,
+    &IOProtocol::GetRanges::FactoryCreate,
     &IOProtocol::notifyLanes::FactoryCreate,
     &IOProtocol::notifyFileSystemRemoved::FactoryCreate,
     &IOProtocol::notifyFileSystemReplaced::FactoryCreate,
@@ -1,6 +1,6 @@
 #pragma once
 //-----------------------------------------------------------------------------
-/* #version:2#
+/* #version:7#
     machine generated, do not edit!
 */
 #include <cstring>
@@ -8,9 +8,14 @@
 #include "Messaging/Serializer.h"
 #include "Messaging/Protocol.h"
 #include "Core/Ptr.h"
+#include "Core/Containers/Array.h"
+#include "IO/Config.h"
 #include "IO/URL.h"
 #include "IO/IOStatus.h"
+#include "IO/IOPriority.h"
+#include "IO/Stream.h"
 #include "IO/MemoryStream.h"
+#include "IO/ChunkPipe.h"
 
 namespace Oryol {
 namespace IO {
@@ -19,12 +24,19 @@ public:
     static Messaging::ProtocolIdType GetProtocolId() {
         return 'IOPT';
     };
+    static Messaging::ProtocolIdType GetBaseProtocolId() {
+        return 'IOPT';
+    };
+    static uint64 GetMessageIdBits() {
+        return (uint64(1) << MessageId::RequestId) | (uint64(1) << MessageId::GetId) | (uint64(1) << MessageId::GetRangeId) | (uint64(1) << MessageId::GetRangesId) | (uint64(1) << MessageId::notifyLanesId) | (uint64(1) << MessageId::notifyFileSystemRemovedId) | (uint64(1) << MessageId::notifyFileSystemReplacedId) | (uint64(1) << MessageId::notifyFileSystemAddedId);
+    };
     class MessageId {
     public:
         enum {
             RequestId = Messaging::Protocol::MessageId::NumMessageIds, 
             GetId,
             GetRangeId,
+            GetRangesId,
             notifyLanesId,
             notifyFileSystemRemovedId,
             notifyFileSystemReplacedId,
@@ -36,6 +48,7 @@ public:
                 case RequestId: return "RequestId";
                 case GetId: return "GetId";
                 case GetRangeId: return "GetRangeId";
+                case GetRangesId: return "GetRangesId";
                 case notifyLanesId: return "notifyLanesId";
                 case notifyFileSystemRemovedId: return "notifyFileSystemRemovedId";
                 case notifyFileSystemReplacedId: return "notifyFileSystemReplacedId";
@@ -47,6 +60,7 @@ public:
             if (std::strcmp("RequestId", str) == 0) return RequestId;
             if (std::strcmp("GetId", str) == 0) return GetId;
             if (std::strcmp("GetRangeId", str) == 0) return GetRangeId;
+            if (std::strcmp("GetRangesId", str) == 0) return GetRangesId;
             if (std::strcmp("notifyLanesId", str) == 0) return notifyLanesId;
             if (std::strcmp("notifyFileSystemRemovedId", str) == 0) return notifyFileSystemRemovedId;
             if (std::strcmp("notifyFileSystemReplacedId", str) == 0) return notifyFileSystemReplacedId;
@@ -54,6 +68,7 @@ public:
             return Messaging::InvalidMessageId;
         };
     };
+    static_assert(MessageId::NumMessageIds <= Messaging::MaxNumMessageIds, "too many message ids in protocol hierarchy");
     typedef Core::Ptr<Messaging::Message> (*CreateCallback)();
     static CreateCallback jumpTable[IOProtocol::MessageId::NumMessageIds];
     class Factory {
@@ -65,20 +80,45 @@ public:
     public:
         Request() {
             this->msgId = MessageId::RequestId;
-            this->lane = 0;
+            this->baseProtId = IOProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+            this->lane = IO::AnyLane;
+            this->priority = IO::IOPriority::Normal;
             this->cachereadenabled = false;
             this->cachewriteenabled = false;
+            this->timeout = 0;
+            this->maxretries = ORYOL_IO_DEFAULT_MAX_RETRIES;
             this->status = IOStatus::InvalidIOStatus;
         };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
+            this->url = IO::URL();
+            this->lane = IO::AnyLane;
+            this->priority = IO::IOPriority::Normal;
+            this->cachereadenabled = false;
+            this->cachewriteenabled = false;
+            this->timeout = 0;
+            this->maxretries = ORYOL_IO_DEFAULT_MAX_RETRIES;
+            this->status = IOStatus::InvalidIOStatus;
+            this->errordesc = Core::String();
+        };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
         };
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::RequestId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'IOPT') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return IOProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::RequestId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'IOPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
         void SetURL(const IO::URL& val) {
             this->url = val;
@@ -92,6 +132,12 @@ public:
         int32 GetLane() const {
             return this->lane;
         };
+        void SetPriority(const IO::IOPriority::Code& val) {
+            this->priority = val;
+        };
+        const IO::IOPriority::Code& GetPriority() const {
+            return this->priority;
+        };
         void SetCacheReadEnabled(bool val) {
             this->cachereadenabled = val;
         };
@@ -104,6 +150,18 @@ public:
         bool GetCacheWriteEnabled() const {
             return this->cachewriteenabled;
         };
+        void SetTimeout(int32 val) {
+            this->timeout = val;
+        };
+        int32 GetTimeout() const {
+            return this->timeout;
+        };
+        void SetMaxRetries(int32 val) {
+            this->maxretries = val;
+        };
+        int32 GetMaxRetries() const {
+            return this->maxretries;
+        };
         void SetStatus(const IOStatus::Code& val) {
             this->status = val;
         };
@@ -119,16 +177,28 @@ public:
 private:
         IO::URL url;
         int32 lane;
+        IO::IOPriority::Code priority;
         bool cachereadenabled;
         bool cachewriteenabled;
+        int32 timeout;
+        int32 maxretries;
         IOStatus::Code status;
         Core::String errordesc;
     };
     class Get : public Request {
-        OryolClassPoolAllocDecl(Get);
+        OryolClassRecycleDecl(Get);
     public:
         Get() {
             this->msgId = MessageId::GetId;
+            this->baseProtId = IOProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            Request::Reset();
+            this->pipe = Core::Ptr<IO::ChunkPipe>();
+            this->stream = Core::Ptr<IO::Stream>();
+            this->validator = Core::String();
+            this->cachedvalidator = Core::String();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -136,24 +206,60 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::GetId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'IOPT') return true;
-            else return Request::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return IOProtocol::GetBaseProtocolId();
         };
-        void SetStream(const Core::Ptr<IO::MemoryStream>& val) {
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::GetId) | Request::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'IOPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
+        };
+        void SetPipe(const Core::Ptr<IO::ChunkPipe>& val) {
+            this->pipe = val;
+        };
+        const Core::Ptr<IO::ChunkPipe>& GetPipe() const {
+            return this->pipe;
+        };
+        void SetStream(const Core::Ptr<IO::Stream>& val) {
             this->stream = val;
         };
-        const Core::Ptr<IO::MemoryStream>& GetStream() const {
+        const Core::Ptr<IO::Stream>& GetStream() const {
             return this->stream;
         };
+        void SetValidator(const Core::String& val) {
+            this->validator = val;
+        };
+        const Core::String& GetValidator() const {
+            return this->validator;
+        };
+        void SetCachedValidator(const Core::String& val) {
+            this->cachedvalidator = val;
+        };
+        const Core::String& GetCachedValidator() const {
+            return this->cachedvalidator;
+        };
 private:
-        Core::Ptr<IO::MemoryStream> stream;
+        Core::Ptr<IO::ChunkPipe> pipe;
+        Core::Ptr<IO::Stream> stream;
+        Core::String validator;
+        Core::String cachedvalidator;
     };
     class GetRange : public Get {
         OryolClassPoolAllocDecl(GetRange);
     public:
         GetRange() {
             this->msgId = MessageId::GetRangeId;
+            this->baseProtId = IOProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+            this->startoffset = 0;
+            this->endoffset = 0;
+        };
+        virtual void Reset() override {
+            Get::Reset();
             this->startoffset = 0;
             this->endoffset = 0;
         };
@@ -163,9 +269,17 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::GetRangeId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'IOPT') return true;
-            else return Get::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return IOProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::GetRangeId) | Get::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'IOPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
         void SetStartOffset(int32 val) {
             this->startoffset = val;
@@ -183,11 +297,71 @@ private:
         int32 startoffset;
         int32 endoffset;
     };
+    class GetRanges : public Get {
+        OryolClassPoolAllocDecl(GetRanges);
+    public:
+        GetRanges() {
+            this->msgId = MessageId::GetRangesId;
+            this->baseProtId = IOProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            Get::Reset();
+            this->startoffsets.Clear();
+            this->endoffsets.Clear();
+            this->rangestreams.Clear();
+        };
+        static Core::Ptr<Messaging::Message> FactoryCreate() {
+            return Create();
+        };
+        static Messaging::MessageIdType ClassMessageId() {
+            return MessageId::GetRangesId;
+        };
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return IOProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::GetRangesId) | Get::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'IOPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
+        };
+        void SetStartOffsets(const Core::Array<int32>& val) {
+            this->startoffsets = val;
+        };
+        const Core::Array<int32>& GetStartOffsets() const {
+            return this->startoffsets;
+        };
+        void SetEndOffsets(const Core::Array<int32>& val) {
+            this->endoffsets = val;
+        };
+        const Core::Array<int32>& GetEndOffsets() const {
+            return this->endoffsets;
+        };
+        void SetRangeStreams(const Core::Array<Core::Ptr<IO::Stream>>& val) {
+            this->rangestreams = val;
+        };
+        const Core::Array<Core::Ptr<IO::Stream>>& GetRangeStreams() const {
+            return this->rangestreams;
+        };
+private:
+        Core::Array<int32> startoffsets;
+        Core::Array<int32> endoffsets;
+        Core::Array<Core::Ptr<IO::Stream>> rangestreams;
+    };
     class notifyLanes : public Messaging::Message {
         OryolClassPoolAllocDecl(notifyLanes);
     public:
         notifyLanes() {
             this->msgId = MessageId::notifyLanesId;
+            this->baseProtId = IOProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -195,9 +369,17 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::notifyLanesId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'IOPT') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return IOProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::notifyLanesId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'IOPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
 private:
     };
@@ -206,6 +388,12 @@ private:
     public:
         notifyFileSystemRemoved() {
             this->msgId = MessageId::notifyFileSystemRemovedId;
+            this->baseProtId = IOProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            notifyLanes::Reset();
+            this->scheme = Core::StringAtom();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -213,9 +401,17 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::notifyFileSystemRemovedId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'IOPT') return true;
-            else return notifyLanes::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return IOProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::notifyFileSystemRemovedId) | notifyLanes::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'IOPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
         void SetScheme(const Core::StringAtom& val) {
             this->scheme = val;
@@ -231,6 +427,12 @@ private:
     public:
         notifyFileSystemReplaced() {
             this->msgId = MessageId::notifyFileSystemReplacedId;
+            this->baseProtId = IOProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            notifyLanes::Reset();
+            this->scheme = Core::StringAtom();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -238,9 +440,17 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::notifyFileSystemReplacedId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'IOPT') return true;
-            else return notifyLanes::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return IOProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::notifyFileSystemReplacedId) | notifyLanes::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'IOPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
         void SetScheme(const Core::StringAtom& val) {
             this->scheme = val;
@@ -256,6 +466,12 @@ private:
     public:
         notifyFileSystemAdded() {
             this->msgId = MessageId::notifyFileSystemAddedId;
+            this->baseProtId = IOProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            notifyLanes::Reset();
+            this->scheme = Core::StringAtom();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -263,9 +479,17 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::notifyFileSystemAddedId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'IOPT') return true;
-            else return notifyLanes::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return IOProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::notifyFileSystemAddedId) | notifyLanes::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'IOPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
         void SetScheme(const Core::StringAtom& val) {
             this->scheme = val;
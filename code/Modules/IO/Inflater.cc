@@ -0,0 +1,250 @@
+//------------------------------------------------------------------------------
+//  Inflater.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "Inflater.h"
+#include "Core/Memory/Memory.h"
+#include "zlib/zlib.h"
+
+namespace Oryol {
+namespace IO {
+
+using namespace Core;
+
+//------------------------------------------------------------------------------
+Inflater::Inflater() :
+zStream(nullptr),
+outBuffer(nullptr),
+numHeaderBytes(0),
+numBytesOut(0),
+outBegin(0),
+outEnd(EndOfStream),
+active(false),
+initialized(false),
+finished(false),
+pendingOutput(false),
+error(false) {
+    this->header[0] = this->header[1] = 0;
+}
+
+//------------------------------------------------------------------------------
+Inflater::~Inflater() {
+    if (this->active) {
+        this->End();
+    }
+    if (nullptr != this->zStream) {
+        Memory::Free(this->zStream);
+        this->zStream = nullptr;
+    }
+    if (nullptr != this->outBuffer) {
+        Memory::Free(this->outBuffer);
+        this->outBuffer = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+Inflater::Begin(int32 outOffset, int32 outNumBytes) {
+    o_assert(!this->active);
+    o_assert((outOffset >= 0) && ((EndOfStream == outNumBytes) || (outNumBytes >= 0)));
+    if (nullptr == this->zStream) {
+        this->zStream = Memory::Alloc(sizeof(z_stream));
+        this->outBuffer = (uint8*) Memory::Alloc(ChunkSize);
+    }
+    Memory::Clear(this->zStream, sizeof(z_stream));
+    this->numHeaderBytes = 0;
+    this->numBytesOut = 0;
+    this->outBegin = outOffset;
+    this->outEnd = (EndOfStream == outNumBytes) ? EndOfStream : outOffset + outNumBytes;
+    this->active = true;
+    this->initialized = false;
+    this->finished = (0 == outNumBytes);
+    this->pendingOutput = false;
+    this->error = false;
+}
+
+//------------------------------------------------------------------------------
+void
+Inflater::End() {
+    o_assert(this->active);
+    if (this->initialized) {
+        inflateEnd((z_stream*) this->zStream);
+        this->initialized = false;
+    }
+    this->active = false;
+}
+
+//------------------------------------------------------------------------------
+bool
+Inflater::IsActive() const {
+    return this->active;
+}
+
+//------------------------------------------------------------------------------
+bool
+Inflater::IsFinished() const {
+    return this->finished;
+}
+
+//------------------------------------------------------------------------------
+bool
+Inflater::HasPendingOutput() const {
+    return this->pendingOutput;
+}
+
+//------------------------------------------------------------------------------
+bool
+Inflater::HasError() const {
+    return this->error;
+}
+
+//------------------------------------------------------------------------------
+int32
+Inflater::NumBytesOut() const {
+    return this->numBytesOut;
+}
+
+//------------------------------------------------------------------------------
+bool
+Inflater::Inflate(const void* ptr, int32 numBytes, const Ptr<Stream>& dst) {
+    o_assert(dst.isValid() && dst->IsWritable());
+    return this->inflateChunk(ptr, numBytes, dst.get(), nullptr, nullptr);
+}
+
+//------------------------------------------------------------------------------
+bool
+Inflater::InflateToPipe(const void* ptr, int32 numBytes, const Ptr<ChunkPipe>& dst, int32* outNumConsumed) {
+    o_assert(dst.isValid() && (nullptr != outNumConsumed));
+    return this->inflateChunk(ptr, numBytes, nullptr, dst.get(), outNumConsumed);
+}
+
+//------------------------------------------------------------------------------
+/**
+ The format can only be detected from the first 2 bytes, so a first
+ chunk with a single byte is held back until the next chunk (the
+ header bytes count as consumed).
+*/
+bool
+Inflater::inflateChunk(const void* ptr, int32 numBytes, Stream* stream, ChunkPipe* pipe, int32* outNumConsumed) {
+    o_assert(this->active && (nullptr != ptr));
+    if (this->error) {
+        return false;
+    }
+    const uint8* src = (const uint8*) ptr;
+    int32 numConsumed = 0;
+    if (!this->initialized) {
+        while ((this->numHeaderBytes < 2) && (numBytes > 0)) {
+            this->header[this->numHeaderBytes++] = *src++;
+            numBytes--;
+            numConsumed++;
+        }
+        if ((this->numHeaderBytes < 2) || this->finished) {
+            if (nullptr != outNumConsumed) {
+                *outNumConsumed = numConsumed + numBytes;
+            }
+            return true;
+        }
+        if (!this->setup() || (InvalidIndex == this->inflate(this->header, 2, stream, pipe))) {
+            return false;
+        }
+    }
+    const int32 num = this->inflate(src, numBytes, stream, pipe);
+    if (InvalidIndex == num) {
+        return false;
+    }
+    if (nullptr != outNumConsumed) {
+        *outNumConsumed = numConsumed + num;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ gzip data starts with the magic bytes 1F 8B, zlib data with a
+ compression method byte and a check byte so that the first 16 bits are
+ a multiple of 31, everything else is treated as raw deflate data (some
+ servers send raw deflate for Content-Encoding: deflate).
+*/
+bool
+Inflater::setup() {
+    int windowBits = -MAX_WBITS;
+    if ((0x1F == this->header[0]) && (0x8B == this->header[1])) {
+        windowBits = MAX_WBITS + 16;
+    }
+    else if ((8 == (this->header[0] & 0x0F)) && (0 == (((this->header[0] << 8) | this->header[1]) % 31))) {
+        windowBits = MAX_WBITS;
+    }
+    z_stream* strm = (z_stream*) this->zStream;
+    if (Z_OK != inflateInit2(strm, windowBits)) {
+        this->error = true;
+        return false;
+    }
+    this->initialized = true;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Stops early if the pipe is full. zlib may hold back output if the
+ output buffer was filled up, this is remembered as pending output,
+ which is flushed by the next call, even if it has no input.
+*/
+int32
+Inflater::inflate(const uint8* ptr, int32 numBytes, Stream* stream, ChunkPipe* pipe) {
+    if (this->finished) {
+        // data behind the end of the compressed stream (or the range) is ignored
+        return numBytes;
+    }
+    if ((numBytes <= 0) && !this->pendingOutput) {
+        return 0;
+    }
+    z_stream* strm = (z_stream*) this->zStream;
+    strm->next_in = (Bytef*) ptr;
+    strm->avail_in = uInt(numBytes);
+    do {
+        strm->next_out = this->outBuffer;
+        strm->avail_out = uInt(ChunkSize);
+        const int res = ::inflate(strm, Z_NO_FLUSH);
+        if (Z_BUF_ERROR == res) {
+            // no progress possible, needs more input
+            break;
+        }
+        else if ((Z_OK != res) && (Z_STREAM_END != res)) {
+            this->error = true;
+            return InvalidIndex;
+        }
+        this->write(ChunkSize - int32(strm->avail_out), stream, pipe);
+        this->finished |= (Z_STREAM_END == res);
+    } while (!this->finished && ((strm->avail_in > 0) || (0 == strm->avail_out)) &&
+             ((nullptr == pipe) || !pipe->IsFull()));
+    this->pendingOutput = !this->finished && (0 == strm->avail_out);
+    return this->finished ? numBytes : numBytes - int32(strm->avail_in);
+}
+
+//------------------------------------------------------------------------------
+void
+Inflater::write(int32 numOut, Stream* stream, ChunkPipe* pipe) {
+    const int32 chunkBegin = this->numBytesOut;
+    const int32 chunkEnd = chunkBegin + numOut;
+    this->numBytesOut = chunkEnd;
+    const int32 begin = (chunkBegin > this->outBegin) ? chunkBegin : this->outBegin;
+    int32 end = chunkEnd;
+    if (EndOfStream != this->outEnd) {
+        if (end >= this->outEnd) {
+            end = this->outEnd;
+            this->finished = true;
+        }
+    }
+    if (end > begin) {
+        const uint8* ptr = this->outBuffer + (begin - chunkBegin);
+        if (nullptr != stream) {
+            stream->Write(ptr, end - begin);
+        }
+        else {
+            pipe->Write(ptr, end - begin);
+        }
+    }
+}
+
+} // namespace IO
+} // namespace Oryol
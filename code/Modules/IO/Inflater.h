@@ -0,0 +1,101 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IO::Inflater
+    @brief streaming zlib decompressor
+
+    An Inflater decompresses gzip, zlib or raw deflate data chunk by
+    chunk, as the compressed data arrives, and writes the decompressed
+    data into a Stream or a ChunkPipe. The format is detected from the
+    first bytes of the compressed data:
+
+    @code
+    Inflater inflater;
+    inflater.Begin();
+    while (...) {
+        if (!inflater.Inflate(chunk, chunkSize, stream)) {
+            // corrupt data
+        }
+    }
+    bool complete = inflater.IsFinished();
+    inflater.End();
+    @endcode
+
+    Begin() optionally takes a range of the decompressed data, only
+    the bytes in that range are written, and the Inflater is finished
+    once the end of the range has been reached.
+
+    InflateToPipe() stops as soon as the pipe is full, and returns
+    the number of consumed compressed bytes, the remaining bytes must
+    be passed again once the pipe can take more data. If all bytes have
+    been consumed but HasPendingOutput() is true, zlib still holds
+    decompressed data, which is written by the next call (which may
+    pass 0 bytes).
+
+    The Inflater is used by the HTTP loaders for Content-Encoding gzip
+    and deflate, and by the LocalFileSystem for .gz files.
+*/
+#include "Core/Types.h"
+#include "Core/Ptr.h"
+#include "IO/Stream.h"
+#include "IO/ChunkPipe.h"
+
+namespace Oryol {
+namespace IO {
+
+class Inflater {
+public:
+    /// constructor
+    Inflater();
+    /// destructor
+    ~Inflater();
+
+    /// begin decompressing a new compressed stream, optionally only a range of the decompressed data
+    void Begin(int32 outOffset=0, int32 outNumBytes=EndOfStream);
+    /// inflate a chunk of compressed data into a stream (must be open for writing), return false on error
+    bool Inflate(const void* ptr, int32 numBytes, const Core::Ptr<Stream>& dst);
+    /// inflate a chunk of compressed data into a pipe until it is full, return false on error
+    bool InflateToPipe(const void* ptr, int32 numBytes, const Core::Ptr<ChunkPipe>& dst, int32* outNumConsumed);
+    /// end decompressing, releases the zlib state
+    void End();
+
+    /// return true between Begin() and End()
+    bool IsActive() const;
+    /// return true if the end of the compressed stream (or of the Begin() range) has been reached
+    bool IsFinished() const;
+    /// return true if zlib holds back decompressed data because the pipe was full
+    bool HasPendingOutput() const;
+    /// return true if the compressed data was corrupt
+    bool HasError() const;
+    /// get number of decompressed bytes since Begin() (including bytes outside the Begin() range)
+    int32 NumBytesOut() const;
+
+    /// size of the decompression buffer
+    static const int32 ChunkSize = 32 * 1024;
+
+private:
+    /// detect the format and setup zlib
+    bool setup();
+    /// feed compressed bytes to zlib, write the output to stream or pipe, return number of consumed bytes or InvalidIndex
+    int32 inflate(const uint8* ptr, int32 numBytes, Stream* stream, ChunkPipe* pipe);
+    /// write the part of a decompressed chunk which is inside the output range
+    void write(int32 numOut, Stream* stream, ChunkPipe* pipe);
+    /// common code of Inflate() and InflateToPipe()
+    bool inflateChunk(const void* ptr, int32 numBytes, Stream* stream, ChunkPipe* pipe, int32* outNumConsumed);
+
+    void* zStream;
+    uint8* outBuffer;
+    uint8 header[2];
+    int32 numHeaderBytes;
+    int32 numBytesOut;
+    int32 outBegin;
+    int32 outEnd;
+    bool active;
+    bool initialized;
+    bool finished;
+    bool pendingOutput;
+    bool error;
+};
+
+} // namespace IO
+} // namespace Oryol
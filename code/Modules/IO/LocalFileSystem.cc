@@ -0,0 +1,271 @@
+//------------------------------------------------------------------------------
+//  LocalFileSystem.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "LocalFileSystem.h"
+#include "Core/Log.h"
+
+namespace Oryol {
+namespace IO {
+
+OryolClassImpl(LocalFileSystem);
+
+using namespace Core;
+
+//------------------------------------------------------------------------------
+LocalFileSystem::LocalFileSystem() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+LocalFileSystem::~LocalFileSystem() {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+bool
+LocalFileSystem::buildLocalPath(const URL& url) {
+    if (url.HasHost() && (url.Host() != "localhost")) {
+        return false;
+    }
+    this->stringBuilder.Set("/");
+    this->stringBuilder.Append(url.Path());
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::onGet(const Ptr<IOProtocol::Get>& msg) {
+    this->load(msg, 0, EndOfStream, IOStatus::OK);
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::onGetRange(const Ptr<IOProtocol::GetRange>& msg) {
+    const int32 startOffset = msg->GetStartOffset();
+    const int32 endOffset = msg->GetEndOffset();
+    if ((startOffset < 0) || (endOffset < startOffset)) {
+        msg->SetStatus(IOStatus::RequestedRangeNotSatisfiable);
+        msg->SetErrorDesc(IOStatus::ToString(IOStatus::RequestedRangeNotSatisfiable));
+        msg->SetHandled();
+    }
+    else {
+        this->load(msg, startOffset, (endOffset - startOffset) + 1, IOStatus::PartialContent);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::onGetRanges(const Ptr<IOProtocol::GetRanges>& msg) {
+    o_assert(!msg->GetPipe().isValid());
+    const Array<int32>& startOffsets = msg->GetStartOffsets();
+    const Array<int32>& endOffsets = msg->GetEndOffsets();
+    o_assert(startOffsets.Size() == endOffsets.Size());
+    if (startOffsets.Empty()) {
+        this->finish(msg, IOStatus::BadRequest);
+        return;
+    }
+
+    // find the span which covers all ranges
+    int32 spanStart = startOffsets[0];
+    int32 spanEnd = endOffsets[0];
+    for (int32 i = 0; i < startOffsets.Size(); i++) {
+        if ((startOffsets[i] < 0) || (endOffsets[i] < startOffsets[i])) {
+            this->finish(msg, IOStatus::RequestedRangeNotSatisfiable);
+            return;
+        }
+        if (startOffsets[i] < spanStart) {
+            spanStart = startOffsets[i];
+        }
+        if (endOffsets[i] > spanEnd) {
+            spanEnd = endOffsets[i];
+        }
+    }
+    if (!this->buildLocalPath(msg->GetURL())) {
+        this->finish(msg, IOStatus::BadRequest);
+        return;
+    }
+
+    // map the span once, the ranges are views into the mapping
+    Ptr<Stream> stream;
+    Ptr<MappedFileStream> mappedStream = MappedFileStream::Create();
+    IOStatus::Code status = mappedStream->MapFile(this->stringBuilder.AsCStr(), spanStart, (spanEnd - spanStart) + 1);
+    if (IOStatus::NotFound == status) {
+        // ...or the ranges are views into the decompressed span
+        status = this->inflateFile(spanStart, (spanEnd - spanStart) + 1, stream);
+    }
+    else {
+        stream = mappedStream;
+    }
+    if (IOStatus::OK == status) {
+        stream->SetURL(msg->GetURL());
+        Array<Ptr<Stream>> rangeStreams;
+        rangeStreams.Reserve(startOffsets.Size());
+        for (int32 i = 0; i < startOffsets.Size(); i++) {
+            const int32 offset = startOffsets[i] - spanStart;
+            if (offset >= stream->Size()) {
+                status = IOStatus::RequestedRangeNotSatisfiable;
+                break;
+            }
+            rangeStreams.AddBack(SubStream::Create(stream, offset, (endOffsets[i] - startOffsets[i]) + 1));
+        }
+        if (IOStatus::OK == status) {
+            status = IOStatus::PartialContent;
+            msg->SetStream(stream);
+            msg->SetRangeStreams(rangeStreams);
+        }
+    }
+    this->finish(msg, status);
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::load(const Ptr<IOProtocol::Get>& msg, int32 offset, int32 numBytes, IOStatus::Code okStatus) {
+    IOStatus::Code status = IOStatus::BadRequest;
+    if (this->buildLocalPath(msg->GetURL())) {
+        Ptr<Stream> stream;
+        Ptr<MappedFileStream> mappedStream = MappedFileStream::Create();
+        status = mappedStream->MapFile(this->stringBuilder.AsCStr(), offset, numBytes);
+        if (IOStatus::NotFound == status) {
+            status = this->inflateFile(offset, numBytes, stream);
+        }
+        else {
+            stream = mappedStream;
+        }
+        if (IOStatus::OK == status) {
+            stream->SetURL(msg->GetURL());
+        }
+        if ((IOStatus::OK == status) && msg->GetPipe().isValid()) {
+            // hand the data out chunk by chunk from DoWork()
+            msg->GetPipe()->SetContentLength(stream->Size());
+            streamingRequest streamReq;
+            streamReq.msg = msg;
+            streamReq.stream = stream;
+            stream->Open(OpenMode::ReadOnly);
+            streamReq.ptr = stream->MapRead(&streamReq.end);
+            streamReq.okStatus = okStatus;
+            this->streamingRequests.AddBack(streamReq);
+            return;
+        }
+        if (IOStatus::OK == status) {
+            status = okStatus;
+            msg->SetStream(stream);
+        }
+    }
+    this->finish(msg, status);
+}
+
+//------------------------------------------------------------------------------
+/**
+ Looks for a compressed version of the file in stringBuilder (with a
+ .gz suffix), and decompresses the requested range into a memory
+ stream, decompression stops at the end of the range. The gzip trailer
+ holds the decompressed size, which is used to allocate the stream
+ once, but it can't be trusted: the reservation is clamped to the
+ range, to the max deflate ratio and to MaxInflateReserve (the stream
+ grows as needed beyond that).
+*/
+IOStatus::Code
+LocalFileSystem::inflateFile(int32 offset, int32 numBytes, Ptr<Stream>& outStream) {
+    this->stringBuilder.Append(".gz");
+    Ptr<MappedFileStream> gzStream = MappedFileStream::Create();
+    IOStatus::Code status = gzStream->MapFile(this->stringBuilder.AsCStr(), 0, EndOfStream);
+    this->stringBuilder.Truncate(this->stringBuilder.Length() - 3);
+    if (IOStatus::OK != status) {
+        return status;
+    }
+    gzStream->Open(OpenMode::ReadOnly);
+    const int32 gzSize = gzStream->Size();
+    const uint8* gzData = gzStream->MapRead(nullptr);
+    Ptr<MemoryStream> stream = MemoryStream::Create();
+    stream->Open(OpenMode::WriteOnly);
+    if ((gzSize >= 18) && (0x1F == gzData[0]) && (0x8B == gzData[1])) {
+        const uint8* sizePtr = gzData + gzSize - 4;
+        int64 reserve = int64(sizePtr[0] | (sizePtr[1] << 8) | (sizePtr[2] << 16) | (uint32(sizePtr[3]) << 24)) - offset;
+        if ((EndOfStream != numBytes) && (reserve > numBytes)) {
+            reserve = numBytes;
+        }
+        if (reserve > (int64(gzSize) * MaxDeflateRatio)) {
+            reserve = int64(gzSize) * MaxDeflateRatio;
+        }
+        if (reserve > MaxInflateReserve) {
+            reserve = MaxInflateReserve;
+        }
+        if (reserve > 0) {
+            stream->Reserve(int32(reserve));
+        }
+    }
+    this->inflater.Begin(offset, numBytes);
+    const bool valid = (gzSize > 0) && this->inflater.Inflate(gzData, gzSize, stream) && this->inflater.IsFinished();
+    const int32 size = this->inflater.NumBytesOut();
+    this->inflater.End();
+    stream->Close();
+    gzStream->UnmapRead();
+    gzStream->Close();
+    if (!valid) {
+        Log::Warn("LocalFileSystem: invalid compressed file '%s.gz'\n", this->stringBuilder.AsCStr());
+        return IOStatus::DownloadError;
+    }
+
+    // like MapFile(), a range starting behind the end fails
+    if (offset > size) {
+        return IOStatus::RequestedRangeNotSatisfiable;
+    }
+    outStream = stream;
+    return IOStatus::OK;
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::finish(const Ptr<IOProtocol::Get>& msg, IOStatus::Code status) {
+    msg->SetStatus(status);
+    if ((IOStatus::OK != status) && (IOStatus::PartialContent != status)) {
+        this->stringBuilder.Format(256, "%s: %s", msg->GetURL().AsCStr(), IOStatus::ToString(status));
+        msg->SetErrorDesc(this->stringBuilder.GetString());
+    }
+    msg->SetHandled();
+}
+
+//------------------------------------------------------------------------------
+void
+LocalFileSystem::DoWork() {
+    for (int32 i = this->streamingRequests.Size() - 1; i >= 0; i--) {
+        streamingRequest& streamReq = this->streamingRequests[i];
+        const Ptr<ChunkPipe>& pipe = streamReq.msg->GetPipe();
+        while ((streamReq.ptr < streamReq.end) && !pipe->IsFull()) {
+            int32 numBytes = int32(streamReq.end - streamReq.ptr);
+            if (numBytes > StreamChunkSize) {
+                numBytes = StreamChunkSize;
+            }
+            pipe->Write(streamReq.ptr, numBytes);
+            streamReq.ptr += numBytes;
+        }
+        if ((streamReq.ptr == streamReq.end) || streamReq.msg->Cancelled()) {
+            pipe->CloseWrite();
+            streamReq.stream->Close();
+            streamReq.msg->SetStatus(streamReq.msg->Cancelled() ? IOStatus::Cancelled : streamReq.okStatus);
+            streamReq.msg->SetHandled();
+            this->streamingRequests.Erase(i);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+LocalFileSystem::HasPendingRequests() const {
+    return !this->streamingRequests.Empty();
+}
+
+//------------------------------------------------------------------------------
+bool
+LocalFileSystem::IsTransferring() const {
+    for (const streamingRequest& streamReq : this->streamingRequests) {
+        if (!streamReq.msg->GetPipe()->IsFull() || streamReq.msg->Cancelled()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace IO
+} // namespace Oryol
@@ -0,0 +1,101 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IO::LocalFileSystem
+    @brief filesystem for local files (file:// URLs)
+
+    The LocalFileSystem handles file:// URLs by memory-mapping the
+    requested file (or file range) into a MappedFileStream, the
+    loaded data is never copied. Register it for the "file" scheme:
+
+    @code
+    ioFacade->RegisterFileSystem("file", Creator<LocalFileSystem,FileSystem>());
+    Ptr<IOProtocol::Get> req = ioFacade->LoadFile("file:///data/bla.dds");
+    @endcode
+
+    The URL host must be empty or "localhost", the URL path is an
+    absolute path. Like a HTTP Range header, the EndOffset of a GetRange
+    request is inclusive, and the range is clamped to the file size.
+
+    A GetRanges request maps the span from the first to the last
+    requested byte once, and each range becomes a SubStream into that
+    mapping. If any range starts behind the end of the file, the whole
+    request fails with RequestedRangeNotSatisfiable.
+
+    If a file doesn't exist, but a gzip-compressed version with a .gz
+    suffix does (e.g. "mesh.bin.gz" for "mesh.bin"), the compressed file
+    is mapped and decompressed into a MemoryStream, so assets can be
+    stored compressed on disk and loaded under their original name.
+    Ranges are applied to the decompressed data, and only the data up
+    to the end of the requested range is decompressed.
+
+    If the request has a Pipe, the mapped data is written into the pipe
+    in StreamChunkSize chunks from DoWork(), as fast as the reader
+    drains the pipe, and the request is handled after the last chunk.
+
+    @see MappedFileStream, FileSystem
+*/
+#include "IO/FileSystem.h"
+#include "IO/MappedFileStream.h"
+#include "IO/SubStream.h"
+#include "IO/MemoryStream.h"
+#include "IO/Inflater.h"
+#include "Core/String/StringBuilder.h"
+#include "Core/Containers/Array.h"
+
+namespace Oryol {
+namespace IO {
+
+class LocalFileSystem : public FileSystem {
+    OryolClassDecl(LocalFileSystem);
+public:
+    /// default constructor
+    LocalFileSystem();
+    /// destructor
+    virtual ~LocalFileSystem();
+
+    /// called when the IOProtocol::Get message is received
+    virtual void onGet(const Core::Ptr<IOProtocol::Get>& msg) override;
+    /// called when the IOProtocol::GetRange message is received
+    virtual void onGetRange(const Core::Ptr<IOProtocol::GetRange>& msg) override;
+    /// called when the IOProtocol::GetRanges message is received
+    virtual void onGetRanges(const Core::Ptr<IOProtocol::GetRanges>& msg) override;
+    /// feed streaming requests
+    virtual void DoWork() override;
+    /// return true if streaming requests are in flight
+    virtual bool HasPendingRequests() const override;
+    /// return true if a streaming request's pipe can take more data
+    virtual bool IsTransferring() const override;
+
+    /// size of the chunks written into a request's pipe
+    static const int32 StreamChunkSize = 64 * 1024;
+    /// max number of bytes reserved up-front for decompressing a .gz file
+    static const int32 MaxInflateReserve = 16 * 1024 * 1024;
+    /// max decompression ratio of deflate data
+    static const int32 MaxDeflateRatio = 1032;
+
+private:
+    /// convert a file URL to a local path in stringBuilder, return false if not a local URL
+    bool buildLocalPath(const URL& url);
+    /// map a file range and complete the request
+    void load(const Core::Ptr<IOProtocol::Get>& msg, int32 offset, int32 numBytes, IOStatus::Code okStatus);
+    /// decompress the .gz version of the file in stringBuilder, and apply a range
+    IOStatus::Code inflateFile(int32 offset, int32 numBytes, Core::Ptr<Stream>& outStream);
+    /// set the status of a request and complete it
+    void finish(const Core::Ptr<IOProtocol::Get>& msg, IOStatus::Code status);
+
+    /// a request which is streamed through its pipe
+    struct streamingRequest {
+        Core::Ptr<IOProtocol::Get> msg;
+        Core::Ptr<Stream> stream;
+        const uint8* ptr;
+        const uint8* end;
+        IOStatus::Code okStatus;
+    };
+    Core::StringBuilder stringBuilder;
+    Core::Array<streamingRequest> streamingRequests;
+    Inflater inflater;
+};
+
+} // namespace IO
+} // namespace Oryol
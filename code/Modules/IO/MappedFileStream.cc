@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+//  MappedFileStream.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "MappedFileStream.h"
+#include "Core/Memory/Memory.h"
+#include <cerrno>
+#if ORYOL_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#else
+#include <cstdio>
+#endif
+
+namespace Oryol {
+namespace IO {
+
+OryolClassImpl(MappedFileStream);
+
+using namespace Core;
+
+//------------------------------------------------------------------------------
+MappedFileStream::MappedFileStream() :
+mapping(nullptr),
+mappingSize(0),
+data(nullptr),
+fileSize(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+MappedFileStream::~MappedFileStream() {
+    if (this->IsOpen()) {
+        this->Close();
+    }
+    this->DiscardContent();
+}
+
+//------------------------------------------------------------------------------
+static IOStatus::Code
+statusFromErrno(int err) {
+    switch (err) {
+        case ENOENT:
+        case ENOTDIR:
+            return IOStatus::NotFound;
+        case EACCES:
+        case EPERM:
+        case EISDIR:
+            return IOStatus::Forbidden;
+        default:
+            return IOStatus::InternalServerError;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Returns IOStatus::OK on success, otherwise NotFound, Forbidden,
+ RequestedRangeNotSatisfiable (offset is behind the end of the file),
+ RequestEntityTooLarge (the range doesn't fit into an int32 sized stream)
+ or InternalServerError. The range is clamped to the end of the file.
+*/
+IOStatus::Code
+MappedFileStream::MapFile(const char* path, int32 offset, int32 numBytes) {
+    o_assert(nullptr != path);
+    o_assert(!this->isOpen);
+    o_assert(nullptr == this->mapping);
+    o_assert((offset >= 0) && ((numBytes >= 0) || (EndOfStream == numBytes)));
+
+    #if ORYOL_POSIX
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return statusFromErrno(errno);
+    }
+    struct stat st;
+    if (0 != fstat(fd, &st)) {
+        const int err = errno;
+        close(fd);
+        return statusFromErrno(err);
+    }
+    if (!S_ISREG(st.st_mode)) {
+        close(fd);
+        return IOStatus::Forbidden;
+    }
+    this->fileSize = st.st_size;
+    #else
+    std::FILE* fp = std::fopen(path, "rb");
+    if (nullptr == fp) {
+        return statusFromErrno(errno);
+    }
+    std::fseek(fp, 0, SEEK_END);
+    this->fileSize = std::ftell(fp);
+    #endif
+
+    // clamp the range to the end of the file
+    IOStatus::Code status = IOStatus::OK;
+    int64 len = this->fileSize - offset;
+    if (len < 0) {
+        status = IOStatus::RequestedRangeNotSatisfiable;
+    }
+    else {
+        if ((EndOfStream != numBytes) && (numBytes < len)) {
+            len = numBytes;
+        }
+        if (len > 0x7FFFFFFF) {
+            status = IOStatus::RequestEntityTooLarge;
+        }
+    }
+    if ((IOStatus::OK == status) && (len > 0)) {
+        #if ORYOL_POSIX
+        // mmap offsets must be page-aligned
+        const int64 pageSize = sysconf(_SC_PAGESIZE);
+        const int64 mapOffset = offset & ~(pageSize - 1);
+        const int64 mapSize = len + (offset - mapOffset);
+        void* ptr = mmap(nullptr, mapSize, PROT_READ, MAP_PRIVATE, fd, mapOffset);
+        if (MAP_FAILED == ptr) {
+            status = statusFromErrno(errno);
+        }
+        else {
+            // start reading ahead big mappings in the background (for small
+            // mappings the extra syscall costs more than the kernel's readahead)
+            if (mapSize >= (1<<20)) {
+                madvise(ptr, mapSize, MADV_WILLNEED);
+            }
+            this->mapping = ptr;
+            this->mappingSize = mapSize;
+            this->data = ((const uint8*)ptr) + (offset - mapOffset);
+        }
+        #else
+        uint8* ptr = (uint8*) Memory::Alloc(int32(len));
+        std::fseek(fp, offset, SEEK_SET);
+        if (len != int64(std::fread(ptr, 1, len, fp))) {
+            Memory::Free(ptr);
+            status = IOStatus::InternalServerError;
+        }
+        else {
+            this->mapping = ptr;
+            this->mappingSize = len;
+            this->data = ptr;
+        }
+        #endif
+    }
+    if (IOStatus::OK == status) {
+        this->size = int32(len);
+    }
+    #if ORYOL_POSIX
+    // the mapping stays valid after the file is closed
+    close(fd);
+    #else
+    std::fclose(fp);
+    #endif
+    return status;
+}
+
+//------------------------------------------------------------------------------
+int64
+MappedFileStream::FileSize() const {
+    return this->fileSize;
+}
+
+//------------------------------------------------------------------------------
+bool
+MappedFileStream::Open(OpenMode::Enum mode) {
+    o_assert(OpenMode::ReadOnly == mode);
+    return Stream::Open(mode);
+}
+
+//------------------------------------------------------------------------------
+void
+MappedFileStream::DiscardContent() {
+    o_assert(!this->isOpen);
+    if (nullptr != this->mapping) {
+        #if ORYOL_POSIX
+        munmap(this->mapping, this->mappingSize);
+        #else
+        Memory::Free(this->mapping);
+        #endif
+        this->mapping = nullptr;
+    }
+    this->mappingSize = 0;
+    this->data = nullptr;
+    this->size = 0;
+    this->readPosition = 0;
+}
+
+//------------------------------------------------------------------------------
+int32
+MappedFileStream::Read(void* ptr, int32 numBytes) {
+    o_assert(this->isOpen);
+    o_assert((this->readPosition >= 0) && (this->readPosition <= this->size));
+
+    // cap numBytes if EndOfStream or trying to read past stream
+    if ((EndOfStream == numBytes) || ((this->readPosition + numBytes) > this->size)) {
+        numBytes = this->size - this->readPosition;
+    }
+    if (numBytes > 0) {
+        Memory::Copy(this->data + this->readPosition, ptr, numBytes);
+        this->readPosition += numBytes;
+    }
+    return numBytes;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Returns a pointer directly into the mapped file pages, see
+ Stream::MapRead() for details.
+*/
+const uint8*
+MappedFileStream::MapRead(const uint8** outMaxValidPtr) {
+    o_assert(this->isOpen);
+    o_assert(!this->isReadMapped);
+    o_assert((this->readPosition >= 0) && (this->readPosition <= this->size));
+
+    this->isReadMapped = true;
+    if (this->readPosition == this->size) {
+        if (nullptr != outMaxValidPtr) {
+            *outMaxValidPtr = nullptr;
+        }
+        return nullptr;
+    }
+    else {
+        if (nullptr != outMaxValidPtr) {
+            *outMaxValidPtr = this->data + this->size;
+        }
+        return this->data + this->readPosition;
+    }
+}
+
+} // namespace IO
+} // namespace Oryol
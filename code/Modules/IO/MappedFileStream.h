@@ -0,0 +1,55 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IO::MappedFileStream
+    @brief read-only Stream on a memory-mapped file range
+
+    A MappedFileStream maps a range of a local file into memory (with mmap
+    on POSIX platforms), MapRead() returns a pointer directly into the
+    mapped pages, so the file content is never copied into a
+    MemoryStream. Pages are faulted in by the OS when they are first
+    accessed. The mapping is released when the stream is destroyed or
+    DiscardContent() is called.
+
+    The stream can only be opened in OpenMode::ReadOnly. On platforms
+    without mmap the file range is read into a heap buffer instead.
+
+    @see LocalFileSystem
+*/
+#include "IO/Stream.h"
+#include "IO/IOStatus.h"
+
+namespace Oryol {
+namespace IO {
+
+class MappedFileStream : public Stream {
+    OryolClassDecl(MappedFileStream);
+public:
+    /// constructor
+    MappedFileStream();
+    /// destructor
+    virtual ~MappedFileStream();
+
+    /// map numBytes at offset of a local file (numBytes can be EndOfStream), stream must be empty
+    IOStatus::Code MapFile(const char* path, int32 offset, int32 numBytes);
+    /// get the size of the whole file (valid after MapFile())
+    int64 FileSize() const;
+
+    /// open the stream, only OpenMode::ReadOnly is allowed
+    virtual bool Open(OpenMode::Enum mode) override;
+    /// release the mapping
+    virtual void DiscardContent() override;
+    /// read a number of bytes from the stream (returns bytes read), numBytes can be EndOfStream
+    virtual int32 Read(void* ptr, int32 numBytes) override;
+    /// map a memory area at the current read-position, DOES NOT ADVANCE READ-POS!
+    virtual const uint8* MapRead(const uint8** outMaxValidPtr) override;
+
+private:
+    void* mapping;          // start of the mapping (page-aligned)
+    int64 mappingSize;      // size of the mapping in bytes
+    const uint8* data;      // start of the requested range inside the mapping
+    int64 fileSize;
+};
+
+} // namespace IO
+} // namespace Oryol
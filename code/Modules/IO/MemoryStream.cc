@@ -16,7 +16,8 @@ MemoryStream::MemoryStream() :
 minGrow(ORYOL_STREAM_DEFAULT_MIN_GROW),
 maxGrow(ORYOL_STREAM_DEFAULT_MAX_GROW),
 capacity(0),
-buffer(nullptr) {
+buffer(nullptr),
+allocator(Memory::ThreadAllocator()) {
     // empty
 }
 
@@ -25,7 +26,8 @@ MemoryStream::MemoryStream(int32 capacity_, int32 minGrow_, int32 maxGrow_) :
 minGrow(minGrow_),
 maxGrow(maxGrow_),
 capacity(0),
-buffer(0) {
+buffer(0),
+allocator(Memory::ThreadAllocator()) {
     this->alloc(capacity_);
 }
 
@@ -57,7 +59,7 @@ MemoryStream::alloc(int32 newCapacity) {
     
     // allocate new buffer
     const int32 newBufSize = newCapacity;
-    uchar* newBuffer = (uchar*) Memory::Alloc(newBufSize);
+    uchar* newBuffer = (uchar*) Memory::Alloc(this->allocator, newBufSize);
     
     // need to move content?
     if (this->size > 0) {
@@ -67,7 +69,7 @@ MemoryStream::alloc(int32 newCapacity) {
     
     // need to free old buffer?
     if (this->buffer) {
-        Memory::Free(this->buffer);
+        Memory::Free(this->allocator, this->buffer);
         this->buffer = nullptr;
     }
     
@@ -97,6 +99,19 @@ MemoryStream::makeRoom(int32 numBytes) {
     this->alloc(newCapacity);
 }
 
+//------------------------------------------------------------------------------
+void
+MemoryStream::SetAllocator(Allocator* allocator_) {
+    o_assert(nullptr == this->buffer);
+    this->allocator = allocator_;
+}
+
+//------------------------------------------------------------------------------
+Allocator*
+MemoryStream::GetAllocator() const {
+    return this->allocator;
+}
+
 //------------------------------------------------------------------------------
 void
 MemoryStream::SetAllocStrategy(int32 minGrow_, int32 maxGrow_) {
@@ -122,12 +137,34 @@ MemoryStream::Capacity() const {
     return this->capacity;
 }
 
+//------------------------------------------------------------------------------
+/**
+ Makes room for numBytes more bytes at the current write position with a
+ single allocation, use this to pre-size the stream when the final size
+ is known upfront (e.g. from a HTTP Content-Length header).
+*/
+void
+MemoryStream::Reserve(int32 numBytes) {
+    o_assert(numBytes >= 0);
+    if ((numBytes > 0) && !this->hasRoom(numBytes)) {
+        this->alloc(this->writePosition + numBytes);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+MemoryStream::Trim() {
+    if ((this->size > 0) && (this->size < this->capacity)) {
+        this->alloc(this->size);
+    }
+}
+
 //------------------------------------------------------------------------------
 void
 MemoryStream::DiscardContent() {
     o_assert(!this->isOpen);
     if (nullptr != this->buffer) {
-        Memory::Free(this->buffer);
+        Memory::Free(this->allocator, this->buffer);
         this->buffer = 0;
     }
     this->size = 0;
@@ -7,9 +7,14 @@
     A MemoryStream implements a Stream interface to a dynamic (growable)
     memory buffer. The MemoryStream object will keep its contents until
     destroyed or the DiscardContent method is called. 
+    
+    The buffer is allocated through the thread's allocator at the time
+    the MemoryStream was created (see Core::Memory::SetThreadAllocator()),
+    or through an allocator set with SetAllocator().
 */
 #include "IO/Config.h"
 #include "IO/Stream.h"
+#include "Core/Memory/Allocator.h"
 
 namespace Oryol {
 namespace IO {
@@ -24,6 +29,10 @@ public:
     /// destructor
     virtual ~MemoryStream();
     
+    /// set allocator for buffer memory (nullptr: heap), stream must be empty
+    void SetAllocator(Core::Allocator* allocator);
+    /// get allocator for buffer memory
+    Core::Allocator* GetAllocator() const;
     /// set allocation strategy
     void SetAllocStrategy(int32 minGrow, int32 maxGrow=ORYOL_STREAM_DEFAULT_MAX_GROW);
     /// get min-grow value
@@ -66,6 +75,7 @@ private:
     int32 maxGrow;
     int32 capacity;
     uchar* buffer;
+    Core::Allocator* allocator;
 };
     
 } // namespace IO
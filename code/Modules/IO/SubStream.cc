@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------------
+//  SubStream.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "SubStream.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace IO {
+
+OryolClassImpl(SubStream);
+
+using namespace Core;
+
+//------------------------------------------------------------------------------
+/**
+ The range is clamped to the size of the parent stream.
+*/
+SubStream::SubStream(const Ptr<Stream>& parent_, int32 offset_, int32 numBytes) :
+parent(parent_),
+offset(offset_),
+data(nullptr) {
+    o_assert(parent_.isValid() && !parent_->IsOpen());
+    o_assert((offset_ >= 0) && (offset_ <= parent_->Size()) && (numBytes >= 0));
+    if ((offset_ + numBytes) > parent_->Size()) {
+        numBytes = parent_->Size() - offset_;
+    }
+    if (numBytes > 0) {
+        // the parent's memory stays valid while the parent isn't modified
+        parent_->Open(OpenMode::ReadOnly);
+        this->data = parent_->MapRead(nullptr) + offset_;
+        parent_->UnmapRead();
+        parent_->Close();
+    }
+    this->size = numBytes;
+    this->SetURL(parent_->GetURL());
+    this->SetContentType(parent_->GetContentType());
+}
+
+//------------------------------------------------------------------------------
+SubStream::~SubStream() {
+    if (this->IsOpen()) {
+        this->Close();
+    }
+}
+
+//------------------------------------------------------------------------------
+const Ptr<Stream>&
+SubStream::Parent() const {
+    return this->parent;
+}
+
+//------------------------------------------------------------------------------
+int32
+SubStream::Offset() const {
+    return this->offset;
+}
+
+//------------------------------------------------------------------------------
+bool
+SubStream::Open(OpenMode::Enum mode) {
+    o_assert(OpenMode::ReadOnly == mode);
+    return Stream::Open(mode);
+}
+
+//------------------------------------------------------------------------------
+void
+SubStream::DiscardContent() {
+    o_assert(!this->isOpen);
+    this->parent = 0;
+    this->data = nullptr;
+    this->size = 0;
+    this->readPosition = 0;
+}
+
+//------------------------------------------------------------------------------
+int32
+SubStream::Read(void* ptr, int32 numBytes) {
+    o_assert(this->isOpen);
+    o_assert((this->readPosition >= 0) && (this->readPosition <= this->size));
+
+    // cap numBytes if EndOfStream or trying to read past stream
+    if ((EndOfStream == numBytes) || ((this->readPosition + numBytes) > this->size)) {
+        numBytes = this->size - this->readPosition;
+    }
+    if (numBytes > 0) {
+        Memory::Copy(this->data + this->readPosition, ptr, numBytes);
+        this->readPosition += numBytes;
+    }
+    return numBytes;
+}
+
+//------------------------------------------------------------------------------
+const uint8*
+SubStream::MapRead(const uint8** outMaxValidPtr) {
+    o_assert(this->isOpen);
+    o_assert(!this->isReadMapped);
+    o_assert((this->readPosition >= 0) && (this->readPosition <= this->size));
+
+    this->isReadMapped = true;
+    if (this->readPosition == this->size) {
+        if (nullptr != outMaxValidPtr) {
+            *outMaxValidPtr = nullptr;
+        }
+        return nullptr;
+    }
+    else {
+        if (nullptr != outMaxValidPtr) {
+            *outMaxValidPtr = this->data + this->size;
+        }
+        return this->data + this->readPosition;
+    }
+}
+
+} // namespace IO
+} // namespace Oryol
@@ -0,0 +1,51 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::IO::SubStream
+    @brief read-only Stream on a byte range of another stream
+
+    A SubStream gives access to a byte range of a parent stream without
+    copying the data, MapRead() returns a pointer into the parent's
+    memory. The SubStream keeps the parent stream alive, the parent's
+    content must not be changed while SubStreams exist.
+
+    The IO filesystems use SubStreams to deliver the per-range results
+    of IOProtocol::GetRanges requests.
+
+    @see IOProtocol::GetRanges
+*/
+#include "IO/Stream.h"
+
+namespace Oryol {
+namespace IO {
+
+class SubStream : public Stream {
+    OryolClassDecl(SubStream);
+public:
+    /// constructor, parent stream must not be open
+    SubStream(const Core::Ptr<Stream>& parent, int32 offset, int32 numBytes);
+    /// destructor
+    virtual ~SubStream();
+
+    /// get the parent stream
+    const Core::Ptr<Stream>& Parent() const;
+    /// get the byte offset in the parent stream
+    int32 Offset() const;
+
+    /// open the stream, only OpenMode::ReadOnly is allowed
+    virtual bool Open(OpenMode::Enum mode) override;
+    /// release the parent stream
+    virtual void DiscardContent() override;
+    /// read a number of bytes from the stream (returns bytes read)
+    virtual int32 Read(void* ptr, int32 numBytes) override;
+    /// map a memory area at the current read-position, DOES NOT ADVANCE READ-POS!
+    virtual const uint8* MapRead(const uint8** outMaxValidPtr) override;
+
+private:
+    Core::Ptr<Stream> parent;
+    int32 offset;
+    const uint8* data;
+};
+
+} // namespace IO
+} // namespace Oryol
@@ -3,7 +3,6 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "URL.h"
-#include "Core/String/StringBuilder.h"
 #include "Core/Log.h"
 #include "IO/assignRegistry.h"
 
@@ -59,12 +58,11 @@ valid(false) {
 //------------------------------------------------------------------------------
 URL::URL(const Core::StringAtom& rhs) :
 valid(false) {
-    this->crack(rhs.AsString());
+    this->crack(rhs);
 }
     
 //------------------------------------------------------------------------------
 URL::URL(const Core::String& rhs) :
-content(rhs),
 valid(false) {
     this->crack(rhs);
 }
@@ -95,21 +93,18 @@ URL::operator=(URL&& rhs) {
 //------------------------------------------------------------------------------
 void
 URL::operator=(const char* rhs) {
-    this->content = rhs;
     this->crack(rhs);
 }
     
 //------------------------------------------------------------------------------
 void
 URL::operator=(const Core::StringAtom& rhs) {
-    this->content = rhs;
-    this->crack(rhs.AsString());
+    this->crack(rhs);
 }
     
 //------------------------------------------------------------------------------
 void
 URL::operator=(const Core::String& rhs) {
-    this->content = rhs;
     this->crack(rhs);
 }
     
@@ -151,24 +146,31 @@ URL::Empty() const {
 
 //------------------------------------------------------------------------------
 void
-URL::crack(String urlString) {
+/**
+ NOTE: cracking the URL doesn't allocate (unless assigns must be resolved,
+ or the URL string is new to the StringAtom table), the string indices 
+ are found by scanning a StringView of the URL StringAtom.
+*/
+URL::crack(StringAtom urlString) {
 
     this->content.Clear();
     this->clearIndices();
     this->valid = false;
     
     if (assignRegistry::HasInstance()) {
-        urlString = assignRegistry::Instance()->ResolveAssigns(urlString);
+        String resolved;
+        if (assignRegistry::Instance()->ResolveAssigns(urlString.AsStringView(), resolved)) {
+            urlString = resolved;
+        }
     }
     if (urlString.IsValid()) {
     
-        StringBuilder builder;
-        builder.Set(urlString);
         this->content = urlString;
+        const StringView str = urlString.AsStringView();
         
         // extract scheme
         this->indices[schemeStart] = 0;
-        this->indices[schemeEnd] = builder.FindSubString(0, 8, "://");
+        this->indices[schemeEnd] = str.FindSubString(0, 8, "://");
         if (EndOfString == this->indices[schemeEnd]) {
             Log::Warn("URL::crack(): '%s' is not a valid URL!\n", this->content.AsCStr());
             this->clearIndices();
@@ -177,16 +179,16 @@ URL::crack(String urlString) {
         
         // extract host fields
         int32 leftStartIndex = this->indices[schemeEnd] + 3;
-        int32 leftEndIndex = builder.FindFirstOf(leftStartIndex, EndOfString, "/");
+        int32 leftEndIndex = str.FindFirstOf(leftStartIndex, EndOfString, "/");
         if (EndOfString == leftEndIndex) {
-            leftEndIndex = builder.Length();
+            leftEndIndex = str.Length();
         }
         if (leftStartIndex != leftEndIndex) {
             // extract user and password
-            int32 userAndPwdEndIndex = builder.FindFirstOf(leftStartIndex, leftEndIndex, "@");
+            int32 userAndPwdEndIndex = str.FindFirstOf(leftStartIndex, leftEndIndex, "@");
             if (EndOfString != userAndPwdEndIndex) {
                 // only user, or user:pwd?
-                int32 userEndIndex = builder.FindFirstOf(leftStartIndex, userAndPwdEndIndex, ":");
+                int32 userEndIndex = str.FindFirstOf(leftStartIndex, userAndPwdEndIndex, ":");
                 if (EndOfString != userEndIndex) {
                     // user and password
                     this->indices[userStart] = leftStartIndex;
@@ -203,7 +205,7 @@ URL::crack(String urlString) {
             }
             
             // extract host and port
-            int32 hostEndIndex = builder.FindFirstOf(leftStartIndex, leftEndIndex, ":");
+            int32 hostEndIndex = str.FindFirstOf(leftStartIndex, leftEndIndex, ":");
             if (EndOfString != hostEndIndex) {
                 // host and port
                 this->indices[hostStart] = leftStartIndex;
@@ -219,13 +221,13 @@ URL::crack(String urlString) {
         }
         
         // is there any path component?
-        if (leftEndIndex != builder.Length()) {
+        if (leftEndIndex != str.Length()) {
             // extract right-hand-side (path, fragment, query)
             int32 rightStartIndex = leftEndIndex + 1;
-            int32 rightEndIndex = builder.Length();
+            int32 rightEndIndex = str.Length();
             
             int32 pathStartIndex = rightStartIndex;
-            int32 pathEndIndex = builder.FindFirstOf(rightStartIndex, rightEndIndex, "#?");
+            int32 pathEndIndex = str.FindFirstOf(rightStartIndex, rightEndIndex, "#?");
             if (EndOfString == pathEndIndex) {
                 pathEndIndex = rightEndIndex;
             }
@@ -235,9 +237,9 @@ URL::crack(String urlString) {
             }
 
             // extract query
-            if ((pathEndIndex != rightEndIndex) && (builder.At(pathEndIndex) == '?')) {
+            if ((pathEndIndex != rightEndIndex) && (str[pathEndIndex] == '?')) {
                 int32 queryStartIndex = pathEndIndex + 1;
-                int32 queryEndIndex = builder.FindFirstOf(queryStartIndex, rightEndIndex, "#");
+                int32 queryEndIndex = str.FindFirstOf(queryStartIndex, rightEndIndex, "#");
                 if (EndOfString == queryEndIndex) {
                     queryEndIndex = rightEndIndex;
                 }
@@ -249,9 +251,9 @@ URL::crack(String urlString) {
             }
             
             // extract fragment
-            if ((pathEndIndex != rightEndIndex) && (builder.At(pathEndIndex) == '#')) {
+            if ((pathEndIndex != rightEndIndex) && (str[pathEndIndex] == '#')) {
                 int32 fragStartIndex = pathEndIndex + 1;
-                int32 fragEndIndex = builder.FindFirstOf(fragStartIndex, rightEndIndex, "?");
+                int32 fragEndIndex = str.FindFirstOf(fragStartIndex, rightEndIndex, "?");
                 if (EndOfString == fragEndIndex) {
                     fragEndIndex = rightEndIndex;
                 }
@@ -273,13 +275,13 @@ URL::HasScheme() const {
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::Scheme() const {
     if (this->HasScheme()) {
-        return String(this->content.AsCStr(), this->indices[schemeStart], this->indices[schemeEnd]);
+        return this->content.AsStringView().GetSubView(this->indices[schemeStart], this->indices[schemeEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -290,13 +292,13 @@ URL::HasUser() const {
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::User() const {
     if (this->HasUser()) {
-        return String(this->content.AsCStr(), this->indices[userStart], this->indices[userEnd]);
+        return this->content.AsStringView().GetSubView(this->indices[userStart], this->indices[userEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -307,13 +309,13 @@ URL::HasPassword() const {
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::Password() const {
     if (this->HasPassword()) {
-        return String(this->content.AsCStr(), this->indices[pwdStart], this->indices[pwdEnd]);
+        return this->content.AsStringView().GetSubView(this->indices[pwdStart], this->indices[pwdEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -324,13 +326,13 @@ URL::HasHost() const {
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::Host() const {
     if (this->HasHost()) {
-        return String(this->content.AsCStr(), this->indices[hostStart], this->indices[hostEnd]);
+        return this->content.AsStringView().GetSubView(this->indices[hostStart], this->indices[hostEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -341,32 +343,32 @@ URL::HasPort() const {
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::Port() const {
     if (this->HasPort()) {
-        return String(this->content.AsCStr(), this->indices[portStart], this->indices[portEnd]);
+        return this->content.AsStringView().GetSubView(this->indices[portStart], this->indices[portEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::HostAndPort() const  {
     if (this->HasHost()) {
         if (this->HasPort()) {
             // URL has host and port definition
-            return String(this->content.AsCStr(), this->indices[hostStart], this->indices[portEnd]);
+            return this->content.AsStringView().GetSubView(this->indices[hostStart], this->indices[portEnd]);
         }
         else {
             // URL only has host
-            return String(this->content.AsCStr(), this->indices[hostStart], this->indices[hostEnd]);
+            return this->content.AsStringView().GetSubView(this->indices[hostStart], this->indices[hostEnd]);
         }
     }
     else {
         // no host in URL
-        return String();
+        return StringView();
     }
 }
 
@@ -377,13 +379,13 @@ URL::HasPath() const {
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::Path() const {
     if (this->HasPath()) {
-        return String(this->content.AsCStr(), this->indices[pathStart], this->indices[pathEnd]);
+        return this->content.AsStringView().GetSubView(this->indices[pathStart], this->indices[pathEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -394,24 +396,24 @@ URL::HasFragment() const {
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::Fragment() const {
     if (this->HasFragment()) {
-        return String(this->content.AsCStr(), this->indices[fragStart], this->indices[fragEnd]);
+        return this->content.AsStringView().GetSubView(this->indices[fragStart], this->indices[fragEnd]);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
 //------------------------------------------------------------------------------
-String
+StringView
 URL::PathToEnd() const {
     if (this->HasPath()) {
-        return String(this->content.AsCStr(), this->indices[pathStart], EndOfString);
+        return this->content.AsStringView().GetSubView(this->indices[pathStart], EndOfString);
     }
     else {
-        return String();
+        return StringView();
     }
 }
 
@@ -426,22 +428,21 @@ Map<String, String>
 URL::Query() const {
     if (this->HasQuery()) {
         Map<String, String> query;
-        StringBuilder builder;
-        builder.Set(this->content.AsCStr(), this->indices[queryStart], this->indices[queryEnd]);
+        const StringView str = this->content.AsStringView().GetSubView(this->indices[queryStart], this->indices[queryEnd]);
         int32 kvpStartIndex = 0;
         int32 kvpEndIndex = 0;
         do {
-            kvpEndIndex = builder.FindFirstOf(kvpStartIndex, EndOfString, "&");
-            int32 keyEndIndex = builder.FindFirstOf(kvpStartIndex, kvpEndIndex, "=");
+            kvpEndIndex = str.FindFirstOf(kvpStartIndex, EndOfString, "&");
+            int32 keyEndIndex = str.FindFirstOf(kvpStartIndex, kvpEndIndex, "=");
             if (EndOfString != keyEndIndex) {
                 // key and value
-                String key(builder.GetSubString(kvpStartIndex, keyEndIndex));
-                String value(builder.GetSubString(keyEndIndex + 1, kvpEndIndex));
+                String key(str.GetSubView(kvpStartIndex, keyEndIndex));
+                String value(str.GetSubView(keyEndIndex + 1, kvpEndIndex));
                 query.Insert(key, value);
             }
             else {
                 // only key
-                String key(builder.GetSubString(kvpStartIndex, kvpEndIndex));
+                String key(str.GetSubView(kvpStartIndex, kvpEndIndex));
                 query.Insert(key, String());
             }
             kvpStartIndex = kvpEndIndex + 1;
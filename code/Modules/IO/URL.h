@@ -7,9 +7,10 @@
     All resource paths in Oryol are expressed as URLs. 
     On creation and assignment, the URL will be
     parsed and indices to its parts will be stored internally, this
-    is quite fast. The actual URL string will be stored as a StringAtom.
-    Expensive String construction only happens when actually getting
-    the URL parts. 
+    is quite fast and doesn't allocate. The actual URL string will be 
+    stored as a StringAtom. The URL part getters return StringViews
+    into the StringAtom, which remain valid even after the URL object 
+    is destroyed. 
     
     @see URLBuilder
 */
@@ -17,6 +18,7 @@
 #include "Core/String/StringAtom.h"
 #include "Core/Containers/Map.h"
 #include "Core/String/String.h"
+#include "Core/String/StringView.h"
 
 namespace Oryol {
 namespace IO {
@@ -65,43 +67,43 @@ public:
     /// test if the URL has a scheme
     bool HasScheme() const;
     /// get the scheme string
-    Core::String Scheme() const;
+    Core::StringView Scheme() const;
     /// test if the URL has a user string
     bool HasUser() const;
     /// get the user string
-    Core::String User() const;
+    Core::StringView User() const;
     /// test if the URL has a password
     bool HasPassword() const;
     /// get the password string
-    Core::String Password() const;
+    Core::StringView Password() const;
     /// test if the URL has a host string
     bool HasHost() const;
     /// get the host string
-    Core::String Host() const;
+    Core::StringView Host() const;
     /// test if the URL has a port string
     bool HasPort() const;
     /// get the port string
-    Core::String Port() const;
+    Core::StringView Port() const;
     /// get host and port (only host if no port was in URL)
-    Core::String HostAndPort() const;
+    Core::StringView HostAndPort() const;
     /// test if the URL has a path string
     bool HasPath() const;
     /// get the path string
-    Core::String Path() const;
+    Core::StringView Path() const;
     /// test if the URL has a fragment
     bool HasFragment() const;
     /// get the fragment string
-    Core::String Fragment() const;
+    Core::StringView Fragment() const;
     /// test if the URL has a query
     bool HasQuery() const;
     /// get the query component
     Core::Map<Core::String, Core::String> Query() const;
     /// get everything right of the server
-    Core::String PathToEnd() const;
+    Core::StringView PathToEnd() const;
     
 private:
     /// crack URL, populates string indices
-    void crack(Core::String urlString);
+    void crack(Core::StringAtom urlString);
     /// clear string indices
     void clearIndices();
     /// copy string indices
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------------
+//  ChunkPipeTest.cc
+//  Test IO::ChunkPipe.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/ChunkPipe.h"
+#include <cstring>
+#if ORYOL_HAS_THREADS
+#include <thread>
+#endif
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::IO;
+
+//------------------------------------------------------------------------------
+TEST(ChunkPipeTest) {
+    Ptr<ChunkPipe> pipe = ChunkPipe::Create(16);
+    CHECK(pipe->Capacity() == 16);
+    CHECK(pipe->GetContentLength() == EndOfStream);
+    CHECK(pipe->IsEmpty());
+    CHECK(!pipe->IsFull());
+    CHECK(pipe->CanResume());
+    CHECK(!pipe->IsEndOfStream());
+
+    pipe->SetContentLength(26);
+    pipe->SetContentType("text/plain");
+    CHECK(pipe->GetContentLength() == 26);
+    CHECK(pipe->GetContentType().TypeAndSubType() == "text/plain");
+
+    // write past the capacity, the pipe is full and the writer must stop
+    pipe->Write("ABCDEFGHIJ", 10);
+    CHECK(!pipe->IsFull());
+    pipe->Write("KLMNOPQRST", 10);
+    CHECK(pipe->IsFull());
+    CHECK(!pipe->CanResume());
+    CHECK(pipe->NumBuffered() == 20);
+    CHECK(pipe->MaxBuffered() == 20);
+
+    // read some, the writer may resume at half capacity
+    char buf[32];
+    CHECK(pipe->Read(buf, 8) == 8);
+    CHECK(0 == std::memcmp(buf, "ABCDEFGH", 8));
+    CHECK(!pipe->IsFull());
+    CHECK(!pipe->CanResume());
+    CHECK(pipe->Read(buf, 4) == 4);
+    CHECK(0 == std::memcmp(buf, "IJKL", 4));
+    CHECK(pipe->CanResume());
+    pipe->Write("UVWXYZ", 6);
+    pipe->CloseWrite();
+    CHECK(!pipe->IsEndOfStream());
+
+    // read the rest
+    CHECK(pipe->Read(buf, sizeof(buf)) == 14);
+    CHECK(0 == std::memcmp(buf, "MNOPQRSTUVWXYZ", 14));
+    CHECK(pipe->Read(buf, sizeof(buf)) == 0);
+    CHECK(pipe->IsEmpty());
+    CHECK(pipe->IsEndOfStream());
+    CHECK(pipe->NumBytesRead() == 26);
+}
+
+#if ORYOL_HAS_THREADS
+//------------------------------------------------------------------------------
+TEST(ChunkPipeThreadTest) {
+    // a writer thread which honours the back-pressure, and a reader
+    static const int32 numBytes = 4 * 1024 * 1024;
+    static const int32 chunkSize = 1000;
+    static const int32 capacity = 64 * 1024;
+    Ptr<ChunkPipe> pipe = ChunkPipe::Create(capacity);
+    std::thread writer([pipe]() {
+        uint8 chunk[chunkSize];
+        int32 numWritten = 0;
+        while (numWritten < numBytes) {
+            if (pipe->IsFull()) {
+                while (!pipe->CanResume()) {
+                    std::this_thread::yield();
+                }
+            }
+            int32 num = numBytes - numWritten;
+            num = num > chunkSize ? chunkSize : num;
+            for (int32 i = 0; i < num; i++) {
+                chunk[i] = uint8(numWritten + i);
+            }
+            pipe->Write(chunk, num);
+            numWritten += num;
+        }
+        pipe->CloseWrite();
+    });
+    int32 numRead = 0;
+    bool allValid = true;
+    uint8 buf[777];
+    while (!pipe->IsEndOfStream()) {
+        const int32 num = pipe->Read(buf, sizeof(buf));
+        for (int32 i = 0; i < num; i++) {
+            allValid &= (buf[i] == uint8(numRead + i));
+        }
+        numRead += num;
+    }
+    writer.join();
+    CHECK(numRead == numBytes);
+    CHECK(allValid);
+    CHECK(pipe->MaxBuffered() < capacity + chunkSize);
+}
+#endif
@@ -0,0 +1,194 @@
+//------------------------------------------------------------------------------
+//  DiskCacheTest.cc
+//  Test IO::DiskCache.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/DiskCache.h"
+#include "IO/MemoryStream.h"
+#include <cstdio>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::IO;
+
+#if ORYOL_LINUX || ORYOL_MACOS
+static const char* cacheDir = "/tmp/oryol_disk_cache_test";
+
+//------------------------------------------------------------------------------
+static Ptr<Stream>
+makeBody(int32 size, uint8 seed) {
+    Ptr<MemoryStream> stream = MemoryStream::Create();
+    stream->SetContentType("application/octet-stream");
+    stream->Open(OpenMode::WriteOnly);
+    uint8* ptr = stream->MapWrite(size);
+    for (int32 i = 0; i < size; i++) {
+        ptr[i] = uint8(i + seed);
+    }
+    stream->UnmapWrite();
+    stream->Close();
+    return stream;
+}
+
+//------------------------------------------------------------------------------
+static bool
+checkBody(const Ptr<Stream>& stream, int32 offset, int32 size, uint8 seed) {
+    if (!stream.isValid() || (stream->Size() != size)) {
+        return false;
+    }
+    stream->Open(OpenMode::ReadOnly);
+    const uint8* ptr = stream->MapRead(nullptr);
+    bool valid = true;
+    for (int32 i = 0; i < size; i++) {
+        valid &= (ptr[i] == uint8(offset + i + seed));
+    }
+    stream->UnmapRead();
+    stream->Close();
+    return valid;
+}
+
+//------------------------------------------------------------------------------
+static void
+clearCacheDir() {
+    std::remove("/tmp/oryol_disk_cache_test/pack.bin");
+    std::remove("/tmp/oryol_disk_cache_test/index.bin");
+}
+
+//------------------------------------------------------------------------------
+TEST(DiskCacheTest) {
+    clearCacheDir();
+    const URL url0("http://www.flohofwoe.net/a.bin");
+    const URL url1("http://www.flohofwoe.net/b.bin");
+    const URL url2("http://www.flohofwoe.net/c.bin");
+
+    DiskCache* cache = DiskCache::CreateSingle(cacheDir, 10000);
+    CHECK(cache->ByteBudget() == 10000);
+    CHECK(cache->NumEntries() == 0);
+    CHECK(!cache->Lookup(url0).isValid());
+    CHECK(cache->NumMisses() == 1);
+
+    // store and look up, also a range
+    CHECK(cache->Store(url0, "\"etag0\"", makeBody(3000, 0)));
+    CHECK(cache->Contains(url0));
+    CHECK(cache->GetValidator(url0) == "\"etag0\"");
+    CHECK(cache->NumEntries() == 1);
+    CHECK(cache->NumBytes() == 3000);
+    Ptr<Stream> stream = cache->Lookup(url0);
+    CHECK(checkBody(stream, 0, 3000, 0));
+    CHECK(stream->GetContentType() == "application/octet-stream");
+    CHECK(checkBody(cache->Lookup(url0, 100, 50), 100, 50, 0));
+    CHECK(checkBody(cache->Lookup(url0, 2990, 100), 2990, 10, 0));
+    CHECK(!cache->Lookup(url0, 3000, 10).isValid());
+    CHECK(cache->NumHits() == 3);
+
+    // same validator doesn't write again, a new validator replaces the entry
+    const int32 packSize = cache->PackSize();
+    CHECK(cache->Store(url0, "\"etag0\"", makeBody(3000, 0)));
+    CHECK(cache->PackSize() == packSize);
+    CHECK(cache->Store(url0, "\"etag1\"", makeBody(3000, 1)));
+    // ...the old body is more than half of the pack, so the pack was compacted
+    CHECK(cache->PackSize() == packSize);
+    CHECK(cache->NumEntries() == 1);
+    CHECK(cache->NumBytes() == 3000);
+    CHECK(cache->GetValidator(url0) == "\"etag1\"");
+    CHECK(checkBody(cache->Lookup(url0), 0, 3000, 1));
+
+    // empty bodies, bodies bigger than the budget and bodies
+    // without a validator are not cached
+    CHECK(!cache->Store(url1, "\"etag2\"", makeBody(0, 0)));
+    CHECK(!cache->Store(url1, "\"etag2\"", makeBody(10001, 0)));
+    CHECK(!cache->Store(url1, "", makeBody(100, 0)));
+    CHECK(!cache->Contains(url1));
+
+    // the least recently used entry is evicted
+    CHECK(cache->Store(url1, "\"etag2\"", makeBody(4000, 2)));
+    CHECK(cache->Lookup(url0).isValid());
+    CHECK(cache->Store(url2, "\"etag3\"", makeBody(4000, 3)));
+    CHECK(cache->Contains(url0));
+    CHECK(!cache->Contains(url1));
+    CHECK(cache->Contains(url2));
+    CHECK(cache->NumBytes() == 7000);
+    CHECK(cache->NumBytes() <= cache->ByteBudget());
+
+    // compaction drops the dead bytes, streams mapped before stay valid
+    Ptr<Stream> before = cache->Lookup(url2);
+    cache->Compact();
+    CHECK(cache->PackSize() == 7000 + 2 * 12);
+    CHECK(checkBody(before, 0, 4000, 3));
+    CHECK(checkBody(cache->Lookup(url0), 0, 3000, 1));
+    CHECK(checkBody(cache->Lookup(url2), 0, 4000, 3));
+
+    // warm restart serves the same entries
+    cache->Remove(url2);
+    CHECK(!cache->Contains(url2));
+    DiskCache::DestroySingle();
+    cache = DiskCache::CreateSingle(cacheDir, 10000);
+    CHECK(cache->NumEntries() == 1);
+    CHECK(cache->GetValidator(url0) == "\"etag1\"");
+    CHECK(checkBody(cache->Lookup(url0), 0, 3000, 1));
+    CHECK(!cache->Contains(url2));
+    DiskCache::DestroySingle();
+
+    // an entry which doesn't match its pack header is dropped
+    std::FILE* fp = std::fopen("/tmp/oryol_disk_cache_test/pack.bin", "r+b");
+    CHECK(nullptr != fp);
+    const uint64 badKey = 0;
+    std::fwrite(&badKey, sizeof(badKey), 1, fp);
+    std::fclose(fp);
+    cache = DiskCache::CreateSingle(cacheDir, 10000);
+    CHECK(cache->NumEntries() == 0);
+    CHECK(!cache->Lookup(url0).isValid());
+    DiskCache::DestroySingle();
+    clearCacheDir();
+}
+
+//------------------------------------------------------------------------------
+TEST(DiskCacheIncrementalCompactTest) {
+    clearCacheDir();
+    const URL url0("http://www.flohofwoe.net/a.bin");
+    const URL url1("http://www.flohofwoe.net/b.bin");
+    const URL url2("http://www.flohofwoe.net/c.bin");
+    const URL url3("http://www.flohofwoe.net/d.bin");
+    const int32 size = 700 * 1024;
+    DiskCache* cache = DiskCache::CreateSingle(cacheDir, 8 * 1024 * 1024);
+
+    // bytes appended to the pack behind the cache's back don't
+    // confuse the offset of the next body
+    CHECK(cache->Store(url0, "\"a0\"", makeBody(size, 0)));
+    std::FILE* fp = std::fopen("/tmp/oryol_disk_cache_test/pack.bin", "ab");
+    CHECK(nullptr != fp);
+    std::fputs("garbage", fp);
+    std::fclose(fp);
+    CHECK(cache->Store(url1, "\"b0\"", makeBody(size, 1)));
+    CHECK(cache->Store(url2, "\"c0\"", makeBody(size, 2)));
+    CHECK(checkBody(cache->Lookup(url1), 0, size, 1));
+
+    // replace entries until the pack holds more dead than live bytes,
+    // the compaction step of a Store only copies CompactStepBytes
+    CHECK(cache->Store(url0, "\"a1\"", makeBody(size, 3)));
+    CHECK(cache->Store(url1, "\"b1\"", makeBody(size, 4)));
+    const int32 packSize = cache->PackSize();
+    CHECK(cache->Store(url2, "\"c1\"", makeBody(size, 5)));
+    CHECK(cache->PackSize() == packSize + size + 12);
+
+    // entries stored and removed while the compaction is pending
+    cache->Remove(url1);
+    CHECK(cache->Store(url3, "\"d0\"", makeBody(size, 7)));
+    CHECK(checkBody(cache->Lookup(url2), 0, size, 5));
+    // (url1 had already been copied, and remains as dead bytes)
+    CHECK(cache->PackSize() == 4 * (size + 12));
+    CHECK(checkBody(cache->Lookup(url0), 0, size, 3));
+    CHECK(!cache->Contains(url1));
+    CHECK(checkBody(cache->Lookup(url2), 0, size, 5));
+    CHECK(checkBody(cache->Lookup(url3), 0, size, 7));
+
+    // ...and the index matches the new pack
+    DiskCache::DestroySingle();
+    cache = DiskCache::CreateSingle(cacheDir, 8 * 1024 * 1024);
+    CHECK(cache->NumEntries() == 3);
+    CHECK(checkBody(cache->Lookup(url0), 0, size, 3));
+    CHECK(checkBody(cache->Lookup(url3), 0, size, 7));
+    DiskCache::DestroySingle();
+    clearCacheDir();
+}
+#endif
@@ -78,7 +78,94 @@ TEST(IOFacadeTest) {
     stream->Close();
     CHECK(str == msg->GetURL().Get());
     
+    // a URL scheme without filesystem fails, but the request is handled
+    Ptr<IOProtocol::Get> noFsMsg = ioFacade->LoadFile("nofs://blub.com/blob.txt");
+    while (!noFsMsg->Handled()) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(noFsMsg->GetStatus() == IOStatus::NotFound);
+    CHECK(!noFsMsg->GetErrorDesc().Empty());
+    CHECK(!noFsMsg->GetStream().isValid());
+
     // FIXME: dynamically add/remove/replace filesystems, ...
     
     IOFacade::DestroySingle();
 }
+
+//------------------------------------------------------------------------------
+static StringAtom
+readURL(const Ptr<IOProtocol::Get>& msg) {
+    StringAtom str;
+    const Ptr<Stream>& stream = msg->GetStream();
+    stream->Open(OpenMode::ReadOnly);
+    Ptr<BinaryStreamReader> reader = BinaryStreamReader::Create(stream);
+    reader->Read(str);
+    stream->Close();
+    return str;
+}
+
+//------------------------------------------------------------------------------
+TEST(IOFacadePreloadTest) {
+    CoreFacade::Instance()->RunLoop()->Run();
+    IOFacade* ioFacade = IOFacade::CreateSingle();
+    ioFacade->RegisterFileSystem("test", Creator<TestFileSystem,FileSystem>());
+    CHECK(ioFacade->IsPreloadingFinished());
+    const int32 numGetBefore = numGetHandled;
+
+    // duplicate URLs are only loaded once
+    ioFacade->AddPreloadFile("test://blub.com/a.txt");
+    ioFacade->AddPreloadFile("test://blub.com/b.txt");
+    ioFacade->AddPreloadFile("test://blub.com/a.txt");
+    CHECK(ioFacade->NumPreloadFiles() == 2);
+    while (!ioFacade->IsPreloadingFinished()) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CoreFacade::Instance()->RunLoop()->Run();
+    CHECK(numGetHandled == numGetBefore + 2);
+    CHECK(ioFacade->NumPreloadFilesDone() == 2);
+    CHECK(ioFacade->NumPreloadFilesFailed() == 0);
+    CHECK(ioFacade->NumPreloadBytesDone() > 0);
+
+    // preloaded files are handled right away without IO
+    Ptr<IOProtocol::Get> msg = ioFacade->LoadFile("test://blub.com/a.txt");
+    CHECK(msg->Handled());
+    CHECK(msg->GetStatus() == IOStatus::OK);
+    CHECK(readURL(msg) == "test://blub.com/a.txt");
+    CHECK(numGetHandled == numGetBefore + 2);
+
+    // each request gets its own stream, which can be open at the same time
+    Ptr<IOProtocol::Get> msg2 = ioFacade->LoadFile("test://blub.com/a.txt");
+    CHECK(msg2->Handled());
+    CHECK(msg2->GetStream() != msg->GetStream());
+    msg->GetStream()->Open(OpenMode::ReadOnly);
+    CHECK(readURL(msg2) == "test://blub.com/a.txt");
+    msg->GetStream()->Close();
+    msg2 = nullptr;
+
+    // a file which is still being preloaded is only loaded once
+    ioFacade->AddPreloadFile("test://blub.com/c.txt");
+    msg = ioFacade->LoadFile("test://blub.com/c.txt");
+    while (!msg->Handled()) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(msg->GetStatus() == IOStatus::OK);
+    CHECK(readURL(msg) == "test://blub.com/c.txt");
+    CHECK(numGetHandled == numGetBefore + 3);
+
+    // files which haven't been preloaded, or have been discarded go through IO
+    msg = ioFacade->LoadFile("test://blub.com/d.txt");
+    while (!msg->Handled()) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(numGetHandled == numGetBefore + 4);
+    ioFacade->DiscardPreloadedFiles();
+    CHECK(ioFacade->NumPreloadFiles() == 0);
+    msg = ioFacade->LoadFile("test://blub.com/a.txt");
+    while (!msg->Handled()) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(numGetHandled == numGetBefore + 5);
+
+    msg = 0;
+    IOFacade::DestroySingle();
+}
@@ -0,0 +1,170 @@
+//------------------------------------------------------------------------------
+//  InflaterTest.cc
+//  Test IO::Inflater.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "IO/Inflater.h"
+#include "IO/MemoryStream.h"
+#include "Core/Containers/Array.h"
+#include "Core/Memory/Memory.h"
+#include "zlib/zlib.h"
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::IO;
+
+static const int32 dataSize = 200000;
+
+//------------------------------------------------------------------------------
+static uint8
+dataByte(int32 i) {
+    return uint8((i * 13) ^ (i >> 7));
+}
+
+//------------------------------------------------------------------------------
+static Array<uint8>
+compress(int windowBits) {
+    Array<uint8> src;
+    src.Reserve(dataSize);
+    for (int32 i = 0; i < dataSize; i++) {
+        src.AddBack(dataByte(i));
+    }
+    z_stream strm;
+    Memory::Clear(&strm, sizeof(strm));
+    deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY);
+    Array<uint8> dst;
+    const int32 maxSize = int32(deflateBound(&strm, dataSize));
+    for (int32 i = 0; i < maxSize; i++) {
+        dst.AddBack(0);
+    }
+    strm.next_in = &src[0];
+    strm.avail_in = dataSize;
+    strm.next_out = &dst[0];
+    strm.avail_out = maxSize;
+    deflate(&strm, Z_FINISH);
+    const int32 size = int32(strm.total_out);
+    deflateEnd(&strm);
+    while (dst.Size() > size) {
+        dst.Erase(dst.Size() - 1);
+    }
+    return dst;
+}
+
+//------------------------------------------------------------------------------
+static bool
+checkStream(const Ptr<MemoryStream>& stream) {
+    if (stream->Size() != dataSize) {
+        return false;
+    }
+    stream->Open(OpenMode::ReadOnly);
+    const uint8* ptr = stream->MapRead(nullptr);
+    bool valid = true;
+    for (int32 i = 0; i < dataSize; i++) {
+        valid &= (ptr[i] == dataByte(i));
+    }
+    stream->UnmapRead();
+    stream->Close();
+    return valid;
+}
+
+//------------------------------------------------------------------------------
+TEST(InflaterTest) {
+    Inflater inflater;
+    CHECK(!inflater.IsActive());
+
+    // gzip, zlib and raw deflate are detected, in one chunk and in small chunks
+    const int windowBits[3] = { MAX_WBITS + 16, MAX_WBITS, -MAX_WBITS };
+    for (int format = 0; format < 3; format++) {
+        const Array<uint8> data = compress(windowBits[format]);
+        const int32 chunkSizes[3] = { data.Size(), 1000, 1 };
+        for (int32 chunkSize : chunkSizes) {
+            Ptr<MemoryStream> stream = MemoryStream::Create();
+            stream->Open(OpenMode::WriteOnly);
+            inflater.Begin();
+            CHECK(inflater.IsActive());
+            bool ok = true;
+            for (int32 pos = 0; pos < data.Size(); pos += chunkSize) {
+                const int32 num = (pos + chunkSize) > data.Size() ? data.Size() - pos : chunkSize;
+                ok &= inflater.Inflate(&data[pos], num, stream);
+            }
+            CHECK(ok);
+            CHECK(inflater.IsFinished());
+            CHECK(inflater.NumBytesOut() == dataSize);
+            inflater.End();
+            stream->Close();
+            CHECK(checkStream(stream));
+        }
+    }
+
+    // inflate into a pipe
+    const Array<uint8> gzData = compress(MAX_WBITS + 16);
+    Ptr<ChunkPipe> pipe = ChunkPipe::Create();
+    int32 numConsumed = 0;
+    inflater.Begin();
+    CHECK(inflater.InflateToPipe(&gzData[0], gzData.Size(), pipe, &numConsumed));
+    CHECK(numConsumed == gzData.Size());
+    CHECK(inflater.IsFinished());
+    inflater.End();
+    CHECK(pipe->NumBuffered() == dataSize);
+    uint8 buf[1000];
+    CHECK(pipe->Read(buf, sizeof(buf)) == 1000);
+    CHECK((buf[0] == dataByte(0)) && (buf[999] == dataByte(999)));
+
+    // inflating stops while the pipe is full, and continues with the rest
+    Ptr<ChunkPipe> smallPipe = ChunkPipe::Create(16 * 1024);
+    inflater.Begin();
+    int32 pos = 0;
+    int32 numRead = 0;
+    bool allValid = true;
+    while (!inflater.IsFinished()) {
+        CHECK(inflater.InflateToPipe(&gzData[pos], gzData.Size() - pos, smallPipe, &numConsumed));
+        pos += numConsumed;
+        int32 num = 0;
+        while ((num = smallPipe->Read(buf, sizeof(buf))) > 0) {
+            for (int32 i = 0; i < num; i++) {
+                allValid &= (buf[i] == dataByte(numRead + i));
+            }
+            numRead += num;
+        }
+    }
+    inflater.End();
+    CHECK(allValid);
+    CHECK(numRead == dataSize);
+    CHECK(pos == gzData.Size());
+    CHECK(smallPipe->MaxBuffered() <= (smallPipe->Capacity() + Inflater::ChunkSize));
+
+    // only a range of the decompressed data is written
+    Ptr<MemoryStream> rangeStream = MemoryStream::Create();
+    rangeStream->Open(OpenMode::WriteOnly);
+    inflater.Begin(50000, 1000);
+    CHECK(inflater.Inflate(&gzData[0], gzData.Size(), rangeStream));
+    CHECK(inflater.IsFinished());
+    CHECK(inflater.NumBytesOut() < dataSize);
+    inflater.End();
+    rangeStream->Close();
+    CHECK(rangeStream->Size() == 1000);
+    rangeStream->Open(OpenMode::ReadOnly);
+    const uint8* rangePtr = rangeStream->MapRead(nullptr);
+    CHECK((rangePtr[0] == dataByte(50000)) && (rangePtr[999] == dataByte(50999)));
+    rangeStream->UnmapRead();
+    rangeStream->Close();
+
+    // truncated data isn't finished, corrupt data is an error
+    Ptr<MemoryStream> stream = MemoryStream::Create();
+    stream->Open(OpenMode::WriteOnly);
+    inflater.Begin();
+    CHECK(inflater.Inflate(&gzData[0], gzData.Size() / 2, stream));
+    CHECK(!inflater.IsFinished());
+    CHECK(!inflater.HasError());
+    inflater.End();
+    Array<uint8> badData = gzData;
+    for (int32 i = 20; i < 40; i++) {
+        badData[i] = 0xFF;
+    }
+    inflater.Begin();
+    CHECK(!inflater.Inflate(&badData[0], badData.Size(), stream));
+    CHECK(inflater.HasError());
+    inflater.End();
+    stream->Close();
+}
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+//  LocalFileSystemBenchmarkTest.cc
+//  Measure latency and throughput of loading local files from 4 KB to
+//  1 GB through a memory-mapped MappedFileStream, compared to copying
+//  the file into a MemoryStream. Files are read from a warm page cache.
+//  This runs with every IOTest, so by default sizes stop at 4 MB, set
+//  the environment variable ORYOL_BENCH_LARGE_FILES=1 to also measure
+//  16 MB, 256 MB and 1 GB files (needs that much space in /tmp).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/CoreFacade.h"
+#include "Core/Log.h"
+#include "IO/IOFacade.h"
+#include "IO/LocalFileSystem.h"
+#include "IO/MappedFileStream.h"
+#include "IO/MemoryStream.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::IO;
+using namespace std::chrono;
+
+#if ORYOL_LINUX || ORYOL_MACOS
+static const char* benchPath = "/tmp/oryol_local_fs_bench.bin";
+
+//------------------------------------------------------------------------------
+static void
+writeBenchFile(int32 size) {
+    static const int32 chunkSize = 1<<20;
+    static uint8 chunk[chunkSize];
+    for (int32 i = 0; i < chunkSize; i++) {
+        chunk[i] = uint8(i * 7);
+    }
+    std::FILE* fp = std::fopen(benchPath, "wb");
+    for (int32 written = 0; written < size; written += chunkSize) {
+        const int32 num = (size - written) < chunkSize ? (size - written) : chunkSize;
+        std::fwrite(chunk, 1, num, fp);
+    }
+    std::fclose(fp);
+}
+
+//------------------------------------------------------------------------------
+static Ptr<Stream>
+loadMapped(int32 size) {
+    Ptr<MappedFileStream> stream = MappedFileStream::Create();
+    IOStatus::Code status = stream->MapFile(benchPath, 0, EndOfStream);
+    o_assert(IOStatus::OK == status);
+    return stream;
+}
+
+//------------------------------------------------------------------------------
+static Ptr<Stream>
+loadCopied(int32 size) {
+    Ptr<MemoryStream> stream = MemoryStream::Create();
+    stream->Open(OpenMode::WriteOnly);
+    uint8* dst = stream->MapWrite(size);
+    std::FILE* fp = std::fopen(benchPath, "rb");
+    const int32 numRead = int32(std::fread(dst, 1, size, fp));
+    o_assert(numRead == size);
+    std::fclose(fp);
+    stream->UnmapWrite();
+    stream->Close();
+    return stream;
+}
+
+//------------------------------------------------------------------------------
+static uint64
+sumStream(const Ptr<Stream>& stream, bool touchAll) {
+    stream->Open(OpenMode::ReadOnly);
+    const uint8* end = nullptr;
+    const uint8* ptr = stream->MapRead(&end);
+    uint64 sum = 0;
+    if (touchAll) {
+        const uint64* ptr64 = (const uint64*) ptr;
+        const int32 num = int32(end - ptr) / sizeof(uint64);
+        for (int32 i = 0; i < num; i++) {
+            sum += ptr64[i];
+        }
+    }
+    else {
+        sum = ptr[0];
+    }
+    stream->UnmapRead();
+    stream->Close();
+    return sum;
+}
+
+//------------------------------------------------------------------------------
+static void
+benchmark(const char* name, Ptr<Stream> (*load)(int32), int32 size, const char* sizeName) {
+    const int64 budget = 64 * 1024 * 1024;
+    int32 numIters = int32(budget / size);
+    numIters = numIters < 2 ? 2 : (numIters > 1000 ? 1000 : numIters);
+
+    // latency: load and access the first byte
+    uint64 sum = 0;
+    time_point<system_clock> start = system_clock::now();
+    for (int32 i = 0; i < numIters; i++) {
+        sum += sumStream(load(size), false);
+    }
+    duration<double> dur = system_clock::now() - start;
+    const double latency = (dur.count() * 1000000.0) / numIters;
+
+    // throughput: load and read every byte
+    start = system_clock::now();
+    for (int32 i = 0; i < numIters; i++) {
+        sum += sumStream(load(size), true);
+    }
+    dur = system_clock::now() - start;
+    const double mbPerSec = (double(size) * numIters) / (dur.count() * 1024.0 * 1024.0);
+    Log::Info("LocalFileSystem (%s, %s): latency %.1f usec, throughput %.1f MB/sec (%d iterations, sum %llu)\n",
+        name, sizeName, latency, mbPerSec, numIters, (unsigned long long) sum);
+}
+
+//------------------------------------------------------------------------------
+TEST(LocalFileSystemBenchmark) {
+    struct {
+        int32 size;
+        const char* name;
+        bool large;
+    } sizes[] = {
+        { 4 * 1024, "4 KB", false },
+        { 64 * 1024, "64 KB", false },
+        { 1024 * 1024, "1 MB", false },
+        { 4 * 1024 * 1024, "4 MB", false },
+        { 16 * 1024 * 1024, "16 MB", true },
+        { 256 * 1024 * 1024, "256 MB", true },
+        { 1024 * 1024 * 1024, "1 GB", true },
+    };
+    const char* largeEnv = std::getenv("ORYOL_BENCH_LARGE_FILES");
+    const bool largeFiles = (nullptr != largeEnv) && (0 != std::atoi(largeEnv));
+    for (const auto& s : sizes) {
+        if (s.large && !largeFiles) {
+            continue;
+        }
+        writeBenchFile(s.size);
+        benchmark("mmap", &loadMapped, s.size, s.name);
+        benchmark("copy", &loadCopied, s.size, s.name);
+    }
+
+    // round-trip latency of a small file:// request through the IO lanes
+    writeBenchFile(4 * 1024);
+    CoreFacade::Instance()->RunLoop()->Run();
+    IOFacade* ioFacade = IOFacade::CreateSingle();
+    ioFacade->RegisterFileSystem("file", Creator<LocalFileSystem,FileSystem>());
+    const int32 numRequests = 100;
+    int32 numOk = 0;
+    time_point<system_clock> start = system_clock::now();
+    for (int32 i = 0; i < numRequests; i++) {
+        Ptr<IOProtocol::Get> req = ioFacade->LoadFile("file:///tmp/oryol_local_fs_bench.bin");
+        while (!req->Handled()) {
+            CoreFacade::Instance()->RunLoop()->Run();
+        }
+        if (IOStatus::OK == req->GetStatus()) {
+            numOk++;
+        }
+    }
+    duration<double> dur = system_clock::now() - start;
+    Log::Info("LocalFileSystem (IOFacade, 4 KB): %.1f usec per request\n", (dur.count() * 1000000.0) / numRequests);
+    CHECK(numOk == numRequests);
+    IOFacade::DestroySingle();
+    std::remove(benchPath);
+}
+#endif
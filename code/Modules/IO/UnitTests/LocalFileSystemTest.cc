@@ -0,0 +1,296 @@
+//------------------------------------------------------------------------------
+//  LocalFileSystemTest.cc
+//  Test the file:// filesystem and MappedFileStream.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/CoreFacade.h"
+#include "IO/IOFacade.h"
+#include "IO/LocalFileSystem.h"
+#include "IO/MappedFileStream.h"
+#include "IO/DiskCache.h"
+#include "Core/Memory/Memory.h"
+#include "zlib/zlib.h"
+#include <cstdio>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::IO;
+
+#if ORYOL_LINUX || ORYOL_MACOS
+static const char* testPath = "/tmp/oryol_local_fs_test.bin";
+static const int32 testSize = 10000;
+
+//------------------------------------------------------------------------------
+static void
+writeTestFile() {
+    std::FILE* fp = std::fopen(testPath, "wb");
+    for (int32 i = 0; i < testSize; i++) {
+        std::fputc(i & 0xFF, fp);
+    }
+    std::fclose(fp);
+}
+
+//------------------------------------------------------------------------------
+static void
+writeGzipFile(const char* path) {
+    uint8 src[testSize];
+    for (int32 i = 0; i < testSize; i++) {
+        src[i] = i & 0xFF;
+    }
+    uint8 dst[testSize];
+    z_stream strm;
+    Memory::Clear(&strm, sizeof(strm));
+    deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+    strm.next_in = src;
+    strm.avail_in = testSize;
+    strm.next_out = dst;
+    strm.avail_out = testSize;
+    deflate(&strm, Z_FINISH);
+    std::FILE* fp = std::fopen(path, "wb");
+    std::fwrite(dst, 1, strm.total_out, fp);
+    std::fclose(fp);
+    deflateEnd(&strm);
+}
+
+//------------------------------------------------------------------------------
+static Ptr<IOProtocol::Get>
+waitHandled(const Ptr<IOProtocol::Get>& req) {
+    while (!req->Handled()) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    return req;
+}
+
+//------------------------------------------------------------------------------
+TEST(MappedFileStreamTest) {
+    writeTestFile();
+
+    // map the whole file
+    Ptr<MappedFileStream> stream = MappedFileStream::Create();
+    CHECK(stream->MapFile(testPath, 0, EndOfStream) == IOStatus::OK);
+    CHECK(stream->Size() == testSize);
+    CHECK(stream->FileSize() == testSize);
+    stream->Open(OpenMode::ReadOnly);
+    const uint8* maxPtr = nullptr;
+    const uint8* ptr = stream->MapRead(&maxPtr);
+    CHECK(nullptr != ptr);
+    CHECK(maxPtr == ptr + testSize);
+    bool allValid = true;
+    for (int32 i = 0; i < testSize; i++) {
+        allValid &= (ptr[i] == (i & 0xFF));
+    }
+    CHECK(allValid);
+    stream->UnmapRead();
+    uint8 buf[16];
+    stream->SetReadPosition(testSize - 4);
+    CHECK(stream->Read(buf, 16) == 4);
+    CHECK(buf[0] == ((testSize - 4) & 0xFF));
+    CHECK(stream->IsEndOfStream());
+    stream->Close();
+    stream->DiscardContent();
+    CHECK(stream->Size() == 0);
+
+    // map a range which isn't page-aligned, and is clamped at the end of the file
+    CHECK(stream->MapFile(testPath, 4097, 100000) == IOStatus::OK);
+    CHECK(stream->Size() == testSize - 4097);
+    stream->Open(OpenMode::ReadOnly);
+    ptr = stream->MapRead(nullptr);
+    CHECK(ptr[0] == (4097 & 0xFF));
+    CHECK(ptr[1] == (4098 & 0xFF));
+    stream->Close();
+    stream->DiscardContent();
+
+    // empty range at the end, and errors
+    CHECK(stream->MapFile(testPath, testSize, EndOfStream) == IOStatus::OK);
+    CHECK(stream->Size() == 0);
+    stream->DiscardContent();
+    CHECK(stream->MapFile(testPath, testSize + 1, EndOfStream) == IOStatus::RequestedRangeNotSatisfiable);
+    CHECK(stream->MapFile("/tmp/oryol_does_not_exist.bin", 0, EndOfStream) == IOStatus::NotFound);
+    CHECK(stream->MapFile("/tmp", 0, EndOfStream) == IOStatus::Forbidden);
+    std::remove(testPath);
+}
+
+//------------------------------------------------------------------------------
+TEST(LocalFileSystemTest) {
+    writeTestFile();
+    // flush a pending IOFacade runloop callback removal from previous tests
+    CoreFacade::Instance()->RunLoop()->Run();
+    IOFacade* ioFacade = IOFacade::CreateSingle();
+    ioFacade->RegisterFileSystem("file", Creator<LocalFileSystem,FileSystem>());
+
+    // load the whole file
+    Ptr<IOProtocol::Get> req = waitHandled(ioFacade->LoadFile("file:///tmp/oryol_local_fs_test.bin"));
+    CHECK(req->GetStatus() == IOStatus::OK);
+    const Ptr<Stream>& stream = req->GetStream();
+    CHECK(stream.isValid());
+    CHECK(stream->Size() == testSize);
+    stream->Open(OpenMode::ReadOnly);
+    const uint8* ptr = stream->MapRead(nullptr);
+    CHECK((ptr[0] == 0) && (ptr[255] == 255) && (ptr[256] == 0));
+    stream->Close();
+
+    // load a range, EndOffset is inclusive
+    Ptr<IOProtocol::Get> rangeReq = waitHandled(ioFacade->LoadFileRange("file://localhost/tmp/oryol_local_fs_test.bin", 10, 19));
+    CHECK(rangeReq->GetStatus() == IOStatus::PartialContent);
+    CHECK(rangeReq->GetStream()->Size() == 10);
+    rangeReq->GetStream()->Open(OpenMode::ReadOnly);
+    CHECK(rangeReq->GetStream()->MapRead(nullptr)[0] == 10);
+    rangeReq->GetStream()->Close();
+
+    // load several ranges with one mapping, the last range is clamped at the end of the file
+    const URL url("file:///tmp/oryol_local_fs_test.bin");
+    Ptr<IOProtocol::GetRanges> rangesReq = ioFacade->LoadFileRanges(url, Array<int32>({ 5000, 300, 9990 }), Array<int32>({ 5009, 304, 10100 }));
+    waitHandled(rangesReq);
+    CHECK(rangesReq->GetStatus() == IOStatus::PartialContent);
+    CHECK(rangesReq->GetStream()->Size() == testSize - 300);
+    const Array<Ptr<Stream>>& rangeStreams = rangesReq->GetRangeStreams();
+    CHECK(rangeStreams.Size() == 3);
+    const int32 rangeStarts[3] = { 5000, 300, 9990 };
+    const int32 rangeSizes[3] = { 10, 5, 10 };
+    for (int32 i = 0; i < rangeStreams.Size(); i++) {
+        CHECK(rangeStreams[i]->Size() == rangeSizes[i]);
+        uint8 rangeBuf[32];
+        rangeStreams[i]->Open(OpenMode::ReadOnly);
+        CHECK(rangeStreams[i]->Read(rangeBuf, sizeof(rangeBuf)) == rangeSizes[i]);
+        rangeStreams[i]->Close();
+        bool rangeValid = true;
+        for (int32 j = 0; j < rangeSizes[i]; j++) {
+            rangeValid &= (rangeBuf[j] == ((rangeStarts[i] + j) & 0xFF));
+        }
+        CHECK(rangeValid);
+    }
+    // a range behind the end of the file fails the whole request
+    rangesReq = ioFacade->LoadFileRanges(url, Array<int32>({ 0, testSize }), Array<int32>({ 9, testSize + 9 }));
+    waitHandled(rangesReq);
+    CHECK(rangesReq->GetStatus() == IOStatus::RequestedRangeNotSatisfiable);
+    CHECK(rangesReq->GetRangeStreams().Empty());
+
+    // file not found, and non-local host
+    Ptr<IOProtocol::Get> failReq = waitHandled(ioFacade->LoadFile("file:///tmp/oryol_does_not_exist.bin"));
+    CHECK(failReq->GetStatus() == IOStatus::NotFound);
+    CHECK(!failReq->GetStream().isValid());
+    CHECK(failReq->GetErrorDesc().IsValid());
+    failReq = waitHandled(ioFacade->LoadFile("file://bla.com/tmp/oryol_local_fs_test.bin"));
+    CHECK(failReq->GetStatus() == IOStatus::BadRequest);
+
+    // stream a bigger file through a small pipe, the reader drains the pipe slowly
+    static const char* bigPath = "/tmp/oryol_local_fs_stream.bin";
+    static const int32 bigSize = 1024 * 1024;
+    std::FILE* fp = std::fopen(bigPath, "wb");
+    for (int32 i = 0; i < bigSize; i++) {
+        std::fputc((i * 7) & 0xFF, fp);
+    }
+    std::fclose(fp);
+    const int32 pipeCapacity = 128 * 1024;
+    Ptr<IOProtocol::Get> streamReq = ioFacade->StreamFile("file:///tmp/oryol_local_fs_stream.bin", pipeCapacity);
+    const Ptr<ChunkPipe>& pipe = streamReq->GetPipe();
+    int32 numRead = 0;
+    bool allValid = true;
+    uint8 buf[4096];
+    while (!(streamReq->Handled() && pipe->IsEmpty())) {
+        CoreFacade::Instance()->RunLoop()->Run();
+        const int32 num = pipe->Read(buf, sizeof(buf));
+        for (int32 i = 0; i < num; i++) {
+            allValid &= (buf[i] == (((numRead + i) * 7) & 0xFF));
+        }
+        numRead += num;
+    }
+    CHECK(streamReq->GetStatus() == IOStatus::OK);
+    CHECK(pipe->IsEndOfStream());
+    CHECK(pipe->GetContentLength() == bigSize);
+    CHECK(numRead == bigSize);
+    CHECK(allValid);
+    CHECK(pipe->MaxBuffered() <= pipeCapacity + LocalFileSystem::StreamChunkSize);
+
+    // a stream paused by a full pipe doesn't count as transferring
+    Ptr<LocalFileSystem> localFs = LocalFileSystem::Create();
+    Ptr<IOProtocol::Get> pausedReq = IOProtocol::Get::Create();
+    pausedReq->SetURL("file:///tmp/oryol_local_fs_stream.bin");
+    pausedReq->SetPipe(ChunkPipe::Create(pipeCapacity));
+    localFs->onGet(pausedReq);
+    localFs->DoWork();
+    CHECK(localFs->HasPendingRequests());
+    CHECK(!localFs->IsTransferring());
+    while (!pausedReq->GetPipe()->IsEmpty()) {
+        pausedReq->GetPipe()->Read(buf, sizeof(buf));
+    }
+    CHECK(localFs->IsTransferring());
+    pausedReq->SetCancelled();
+    localFs->DoWork();
+    CHECK(!localFs->HasPendingRequests());
+    CHECK(!localFs->IsTransferring());
+    CHECK(pausedReq->GetStatus() == IOStatus::Cancelled);
+    std::remove(bigPath);
+
+    // a missing file is loaded from its .gz version
+    static const char* gzPath = "/tmp/oryol_local_fs_packed.bin.gz";
+    writeGzipFile(gzPath);
+    Ptr<IOProtocol::Get> gzReq = waitHandled(ioFacade->LoadFile("file:///tmp/oryol_local_fs_packed.bin"));
+    CHECK(gzReq->GetStatus() == IOStatus::OK);
+    CHECK(gzReq->GetStream()->Size() == testSize);
+    gzReq->GetStream()->Open(OpenMode::ReadOnly);
+    ptr = gzReq->GetStream()->MapRead(nullptr);
+    CHECK((ptr[0] == 0) && (ptr[255] == 255) && (ptr[testSize - 1] == ((testSize - 1) & 0xFF)));
+    gzReq->GetStream()->Close();
+    gzReq = waitHandled(ioFacade->LoadFileRange("file:///tmp/oryol_local_fs_packed.bin", 1000, 1009));
+    CHECK(gzReq->GetStatus() == IOStatus::PartialContent);
+    CHECK(gzReq->GetStream()->Size() == 10);
+    gzReq->GetStream()->Open(OpenMode::ReadOnly);
+    CHECK(gzReq->GetStream()->MapRead(nullptr)[0] == (1000 & 0xFF));
+    gzReq->GetStream()->Close();
+    // ...a corrupt .gz file fails
+    std::FILE* gzFile = std::fopen(gzPath, "r+b");
+    std::fseek(gzFile, 20, SEEK_SET);
+    std::fputs("corrupt corrupt corrupt", gzFile);
+    std::fclose(gzFile);
+    gzReq = waitHandled(ioFacade->LoadFile("file:///tmp/oryol_local_fs_packed.bin"));
+    CHECK(gzReq->GetStatus() == IOStatus::DownloadError);
+    std::remove(gzPath);
+
+    req = 0;
+    rangeReq = 0;
+    rangesReq = 0;
+    failReq = 0;
+    streamReq = 0;
+    gzReq = 0;
+    IOFacade::DestroySingle();
+    std::remove(testPath);
+}
+
+//------------------------------------------------------------------------------
+TEST(LocalFileSystemDiskCacheTest) {
+    writeTestFile();
+    std::remove("/tmp/oryol_local_fs_cache/pack.bin");
+    std::remove("/tmp/oryol_local_fs_cache/index.bin");
+    CoreFacade::Instance()->RunLoop()->Run();
+    IOFacade* ioFacade = IOFacade::CreateSingle();
+    ioFacade->RegisterFileSystem("file", Creator<LocalFileSystem,FileSystem>());
+    ioFacade->SetupDiskCache("/tmp/oryol_local_fs_cache", 1024 * 1024);
+
+    // plain loads don't touch the cache
+    Ptr<IOProtocol::Get> req = waitHandled(ioFacade->LoadFile("file:///tmp/oryol_local_fs_test.bin"));
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(req->GetStream()->Size() == testSize);
+    CHECK(!DiskCache::Instance()->Contains(req->GetURL()));
+    CHECK(DiskCache::Instance()->NumMisses() == 0);
+
+    // local files have no validator, so cached loads are never stored
+    req = waitHandled(ioFacade->LoadCachedFile("file:///tmp/oryol_local_fs_test.bin"));
+    CHECK(req->GetStatus() == IOStatus::OK);
+    CHECK(req->GetStream()->Size() == testSize);
+    CHECK(req->GetValidator().Empty());
+    CHECK(!DiskCache::Instance()->Contains(req->GetURL()));
+    CHECK(DiskCache::Instance()->NumMisses() == 1);
+
+    // ...and after the file is gone, the cache can't serve it
+    std::remove(testPath);
+    req = waitHandled(ioFacade->LoadCachedFile("file:///tmp/oryol_local_fs_test.bin"));
+    CHECK(req->GetStatus() == IOStatus::NotFound);
+    CHECK(DiskCache::Instance()->NumHits() == 0);
+    req = 0;
+    IOFacade::DestroySingle();
+    std::remove("/tmp/oryol_local_fs_cache/pack.bin");
+    std::remove("/tmp/oryol_local_fs_cache/index.bin");
+}
+#endif
@@ -104,4 +104,20 @@ TEST(MemoryStreamTest) {
     
     /// @todo: test with small initial capacity and small min/max grow
     Ptr<MemoryStream> stream1 = MemoryStream::Create(4, 4, 8);
+
+    // pre-size with Reserve(), writing then doesn't grow the stream
+    Ptr<MemoryStream> stream2 = MemoryStream::Create();
+    stream2->Open(OpenMode::WriteOnly);
+    stream2->Reserve(100000);
+    CHECK(stream2->Capacity() == 100000);
+    for (int32 i = 0; i < 2500; i++) {
+        stream2->Write(readData, 40);
+    }
+    CHECK(stream2->Size() == 100000);
+    CHECK(stream2->Capacity() == 100000);
+    stream2->Reserve(16);
+    CHECK(stream2->Capacity() == 100016);
+    stream2->Trim();
+    CHECK(stream2->Capacity() == 100000);
+    stream2->Close();
 }
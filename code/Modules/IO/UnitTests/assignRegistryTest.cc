@@ -33,5 +33,14 @@ TEST(assignRegistryTest) {
     res = reg->ResolveAssigns("blub:");
     CHECK(res == "http://www.flohofwoe.net/blub/");
     
+    // resolve from StringView, only writes result if there were assigns
+    String resolved;
+    CHECK(reg->ResolveAssigns(StringView("blub:file.txt"), resolved));
+    CHECK(resolved == "http://www.flohofwoe.net/blub/file.txt");
+    CHECK(!reg->ResolveAssigns(StringView("http://www.flohofwoe.net/"), resolved));
+    CHECK(resolved == "http://www.flohofwoe.net/blub/file.txt");
+    CHECK(!reg->ResolveAssigns(StringView("blob:file.txt"), resolved));
+    CHECK(reg->ResolveAssigns("blob:file.txt") == "blob:file.txt");
+    
     assignRegistry::DestroySingle();
 }
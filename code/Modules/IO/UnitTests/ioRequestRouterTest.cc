@@ -0,0 +1,296 @@
+//------------------------------------------------------------------------------
+//  ioRequestRouterTest.cc
+//  Test lane scheduling in the ioRequestRouter.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Core/CoreFacade.h"
+#include "Core/String/StringBuilder.h"
+#include "IO/IOFacade.h"
+#include "IO/MemoryStream.h"
+#include "IO/SubStream.h"
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::IO;
+
+#if ORYOL_HAS_THREADS
+#include <mutex>
+
+// requests are held by the gate filesystem until the test releases them
+static std::mutex gateLock;
+static Array<Ptr<IOProtocol::Get>> gateRequests;
+static Array<String> gateLog;
+
+class GateFileSystem : public FileSystem {
+    OryolClassDecl(GateFileSystem);
+public:
+    virtual void onGet(const Ptr<IOProtocol::Get>& msg) override {
+        std::lock_guard<std::mutex> lock(gateLock);
+        gateRequests.AddBack(msg);
+        gateLog.AddBack(String(msg->GetURL().Path()));
+    };
+    virtual void onGetRange(const Ptr<IOProtocol::GetRange>& msg) override {
+        this->onGet(msg);
+    };
+};
+OryolClassImpl(GateFileSystem);
+
+//------------------------------------------------------------------------------
+static void
+release(int32 num) {
+    std::lock_guard<std::mutex> lock(gateLock);
+    for (int32 i = 0; (i < num) && !gateRequests.Empty(); i++) {
+        gateRequests[0]->SetStatus(IOStatus::OK);
+        gateRequests[0]->SetStream(MemoryStream::Create());
+        gateRequests[0]->SetHandled();
+        gateRequests.Erase(0);
+    }
+}
+
+//------------------------------------------------------------------------------
+static bool
+gateLogContains(const char* path) {
+    std::lock_guard<std::mutex> lock(gateLock);
+    for (const String& str : gateLog) {
+        if (str == path) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+static int32
+numLaneRequests(const Ptr<ioRequestRouter>& router) {
+    int32 num = 0;
+    for (int32 i = 0; i < 4; i++) {
+        num += router->NumLaneRequests(i);
+    }
+    return num;
+}
+
+//------------------------------------------------------------------------------
+static void
+releaseAll(const Ptr<ioRequestRouter>& router) {
+    while ((numLaneRequests(router) > 0) || (router->NumWaitingRequests() > 0)) {
+        release(1000);
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+}
+
+//------------------------------------------------------------------------------
+TEST(ioRequestRouterTest) {
+    CoreFacade::Instance()->RunLoop()->Run();
+    IOFacade* ioFacade = IOFacade::CreateSingle();
+    ioFacade->RegisterFileSystem("gate", Creator<GateFileSystem,FileSystem>());
+    const Ptr<ioRequestRouter>& router = ioFacade->RequestRouter();
+    const int32 maxLaneRequests = ORYOL_IO_MAX_LANE_REQUESTS;
+
+    // requests without host go to the least loaded lane
+    StringBuilder strBuilder;
+    for (int32 i = 0; i < 4 * maxLaneRequests; i++) {
+        strBuilder.Format(64, "gate:///fill%d", i);
+        ioFacade->LoadFile(strBuilder.GetString());
+    }
+    for (int32 i = 0; i < 4; i++) {
+        CHECK(router->NumLaneRequests(i) == maxLaneRequests);
+    }
+    CHECK(router->NumWaitingRequests() == 0);
+
+    // all lanes are full, higher priorities are dispatched first
+    ioFacade->LoadFile("gate:///low0", AnyLane, IOPriority::Low);
+    ioFacade->LoadFile("gate:///low1", AnyLane, IOPriority::Low);
+    ioFacade->LoadFile("gate:///high0", AnyLane, IOPriority::High);
+    ioFacade->LoadFile("gate:///high1", AnyLane, IOPriority::High);
+    CHECK(router->NumWaitingRequests() == 4);
+    while (router->NumWaitingRequests() == 4) {
+        release(1);
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(router->NumWaitingRequests() == 3);
+    while (!gateLogContains("high0")) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(!gateLogContains("high1"));
+    CHECK(!gateLogContains("low0"));
+    releaseAll(router);
+    CHECK(gateLogContains("low1"));
+
+    // requests to the same host stay on one lane
+    ioFacade->LoadFile("gate://hosta.com/a0");
+    ioFacade->LoadFile("gate://hosta.com/a1");
+    ioFacade->LoadFile("gate://hosta.com/a2");
+    int32 hostLane = InvalidIndex;
+    for (int32 i = 0; i < 4; i++) {
+        if (router->NumLaneRequests(i) > 0) {
+            CHECK(InvalidIndex == hostLane);
+            hostLane = i;
+        }
+    }
+    CHECK(InvalidIndex != hostLane);
+    CHECK(router->NumLaneRequests(hostLane) == 3);
+
+    // ...another host goes to another lane
+    ioFacade->LoadFile("gate://hostb.com/b0");
+    CHECK(router->NumLaneRequests(hostLane) == 3);
+    CHECK(numLaneRequests(router) == 4);
+
+    // ...until the host's lane is full
+    for (int32 i = 3; i < maxLaneRequests + 1; i++) {
+        strBuilder.Format(64, "gate://hosta.com/a%d", i);
+        ioFacade->LoadFile(strBuilder.GetString());
+    }
+    CHECK(router->NumLaneRequests(hostLane) == maxLaneRequests);
+    CHECK(numLaneRequests(router) == maxLaneRequests + 2);
+
+    // an explicit lane overrides scheduling, also if the lane is full
+    ioFacade->LoadFile("gate://hosta.com/explicit", hostLane + 4);
+    CHECK(router->NumLaneRequests(hostLane) == maxLaneRequests + 1);
+    CHECK(router->NumWaitingRequests() == 0);
+    releaseAll(router);
+
+    // only the most recently used hosts are remembered
+    for (int32 i = 0; i < 2 * ORYOL_IO_MAX_HOST_LANES; i++) {
+        strBuilder.Format(64, "gate://host%d.com/x", i);
+        ioFacade->LoadFile(strBuilder.GetString());
+        releaseAll(router);
+    }
+    CHECK(router->NumHostLanes() == ORYOL_IO_MAX_HOST_LANES);
+
+    IOFacade::DestroySingle();
+    gateLog.Clear();
+}
+
+//------------------------------------------------------------------------------
+static int32
+numGateRequests() {
+    std::lock_guard<std::mutex> lock(gateLock);
+    return gateRequests.Size();
+}
+
+//------------------------------------------------------------------------------
+TEST(ioRequestRouterCoalesceTest) {
+    CoreFacade::Instance()->RunLoop()->Run();
+    IOFacade* ioFacade = IOFacade::CreateSingle();
+    ioFacade->RegisterFileSystem("gate", Creator<GateFileSystem,FileSystem>());
+    const Ptr<ioRequestRouter>& router = ioFacade->RequestRouter();
+
+    // identical requests are fetched once, the waiting requests get SubStreams on the result
+    Ptr<IOProtocol::Get> get0 = ioFacade->LoadFile("gate://hosta.com/a");
+    Ptr<IOProtocol::Get> get1 = ioFacade->LoadFile("gate://hosta.com/a");
+    Ptr<IOProtocol::Get> get2 = ioFacade->LoadFile("gate://hostb.com/a", 3);
+    Ptr<IOProtocol::Get> get3 = ioFacade->LoadFile("gate://hosta.com/a", 2);
+    Ptr<IOProtocol::GetRange> range0 = ioFacade->LoadFileRange("gate://hosta.com/a", 0, 9);
+    Ptr<IOProtocol::GetRange> range1 = ioFacade->LoadFileRange("gate://hosta.com/a", 0, 9);
+    Ptr<IOProtocol::GetRange> range2 = ioFacade->LoadFileRange("gate://hosta.com/a", 10, 19);
+    Ptr<IOProtocol::Get> stream0 = ioFacade->StreamFile("gate://hosta.com/a");
+    Ptr<IOProtocol::Get> stream1 = ioFacade->StreamFile("gate://hosta.com/a");
+    CHECK(numLaneRequests(router) == 6);
+    while (numGateRequests() < 6) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(!get1->Handled());
+    releaseAll(router);
+    CHECK(get0->Handled() && get1->Handled() && get3->Handled());
+    CHECK(get0->GetStatus() == IOStatus::OK);
+    CHECK(get1->GetStatus() == IOStatus::OK);
+    CHECK(get0->GetStream().isValid());
+    CHECK(get1->GetStream().dynamicCast<SubStream>()->Parent() == get0->GetStream());
+    CHECK(get3->GetStream().dynamicCast<SubStream>()->Parent() == get0->GetStream());
+    CHECK(get1->GetStream() != get3->GetStream());
+    CHECK(get0->GetStream() != get2->GetStream());
+    CHECK(!get2->GetStream().dynamicCast<SubStream>().isValid());
+    CHECK(range1->GetStream().dynamicCast<SubStream>()->Parent() == range0->GetStream());
+    CHECK(!range2->GetStream().dynamicCast<SubStream>().isValid());
+    CHECK(stream0->Handled() && stream1->Handled());
+
+    // after the first request is handled, the same URL is fetched again
+    get0 = ioFacade->LoadFile("gate://hosta.com/a");
+    CHECK(numLaneRequests(router) == 1);
+    releaseAll(router);
+
+    // requests with different options are not coalesced (a conditional
+    // request may be answered with NotModified and no stream)
+    get0 = ioFacade->LoadFile("gate://hosta.com/c");
+    get1 = IOProtocol::Get::Create();
+    get1->SetURL("gate://hosta.com/c");
+    get1->SetCachedValidator("\"v1\"");
+    router->Put(get1);
+    get2 = IOProtocol::Get::Create();
+    get2->SetURL("gate://hosta.com/c");
+    get2->SetTimeout(1000);
+    router->Put(get2);
+    CHECK(numLaneRequests(router) == 3);
+    releaseAll(router);
+    CHECK(get0->Handled() && get1->Handled() && get2->Handled());
+    CHECK(!get1->GetStream().dynamicCast<SubStream>().isValid());
+    CHECK(!get2->GetStream().dynamicCast<SubStream>().isValid());
+
+    // if the first request is cancelled, the other requests are still fetched
+    get0 = ioFacade->LoadFile("gate://hosta.com/b");
+    get1 = ioFacade->LoadFile("gate://hosta.com/b");
+    while (numGateRequests() < 1) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    get0->SetCancelled();
+    {
+        std::lock_guard<std::mutex> lock(gateLock);
+        gateRequests[0]->SetStatus(IOStatus::Cancelled);
+        gateRequests[0]->SetHandled();
+        gateRequests.Erase(0);
+    }
+    while (numGateRequests() < 1) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(!get1->Handled());
+    releaseAll(router);
+    CHECK(get1->GetStatus() == IOStatus::OK);
+
+    // a cancelled waiting request doesn't wait for the first request
+    get0 = ioFacade->LoadFile("gate://hosta.com/c");
+    get1 = ioFacade->LoadFile("gate://hosta.com/c");
+    get1->SetCancelled();
+    CoreFacade::Instance()->RunLoop()->Run();
+    CHECK(get1->Handled());
+    CHECK(get1->GetStatus() == IOStatus::Cancelled);
+    CHECK(!get0->Handled());
+    releaseAll(router);
+    CHECK(get0->GetStatus() == IOStatus::OK);
+
+    // a higher-priority waiting request promotes the first request
+    StringBuilder strBuilder;
+    for (int32 i = 0; i < 4 * ORYOL_IO_MAX_LANE_REQUESTS; i++) {
+        strBuilder.Format(64, "gate:///fill%d", i);
+        ioFacade->LoadFile(strBuilder.GetString());
+    }
+    get0 = ioFacade->LoadFile("gate:///promoted", AnyLane, IOPriority::Low);
+    get2 = ioFacade->LoadFile("gate:///normal", AnyLane, IOPriority::Normal);
+    get1 = ioFacade->LoadFile("gate:///promoted", AnyLane, IOPriority::High);
+    CHECK(get0->GetPriority() == IOPriority::High);
+    CHECK(router->NumWaitingRequests() == 2);
+    while (router->NumWaitingRequests() == 2) {
+        release(1);
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    while (!gateLogContains("promoted")) {
+        CoreFacade::Instance()->RunLoop()->Run();
+    }
+    CHECK(!gateLogContains("normal"));
+    releaseAll(router);
+    CHECK(router->NumWaitingRequests() == 0);
+    CHECK(get1->GetStatus() == IOStatus::OK);
+
+    get0 = 0;
+    get1 = 0;
+    get2 = 0;
+    get3 = 0;
+    range0 = 0;
+    range1 = 0;
+    range2 = 0;
+    stream0 = 0;
+    stream1 = 0;
+    IOFacade::DestroySingle();
+    gateLog.Clear();
+}
+#endif
@@ -65,35 +65,71 @@ assignRegistry::LookupAssign(const String& assign) const {
     return result;
 }
 
+//------------------------------------------------------------------------------
+int32
+assignRegistry::findAssign(const StringView& assign) const {
+    // there are only a few assigns, so a linear search is fine
+    const int32 num = this->assigns.Size();
+    for (int32 i = 0; i < num; i++) {
+        if (this->assigns.KeyAtIndex(i) == assign) {
+            return i;
+        }
+    }
+    return InvalidIndex;
+}
+
 //------------------------------------------------------------------------------
 String
 assignRegistry::ResolveAssigns(const String& str) const {
+    String result;
+    if (this->ResolveAssigns(str.AsStringView(), result)) {
+        return result;
+    }
+    else {
+        return str;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ This only allocates if there are actually assigns to replace, the
+ assign prefix is looked up without creating a String object.
+*/
+bool
+assignRegistry::ResolveAssigns(const StringView& str, String& outResolved) const {
 
     this->rwLock.LockRead();
     
     StringBuilder builder;
-    builder.Set(str);
+    StringView view = str;
     
     // while there are assigns to replace...
     int32 index;
-    while ((index = builder.FindFirstOf(0, EndOfString, ":")) != EndOfString) {
+    bool resolved = false;
+    while ((index = view.FindFirstOf(0, EndOfString, ":")) != EndOfString) {
         // ignore DOS drive letters
         if (index > 1) {
-            String assignString = builder.GetSubString(0, index + 1);
-
             // lookup the assign, ignore unknown assigns, may be URL schemes
-            if (this->assigns.Contains(assignString)) {
+            const int32 assignIndex = this->findAssign(view.GetSubView(0, index + 1));
+            if (InvalidIndex != assignIndex) {
                 
-                // replace assign string
-                builder.SubstituteFirst(assignString, this->assigns[assignString]);
+                // replace assign string, first copy to builder
+                if (!resolved) {
+                    builder.Set(view);
+                    resolved = true;
+                }
+                builder.SubstituteRange(0, index + 1, this->assigns.ValueAtIndex(assignIndex).AsCStr());
+                view = builder.AsStringView();
             }
             else break;
         }
         else break;
     }
-    String result = builder.GetString();
+    if (resolved) {
+        outResolved = builder.GetString();
+    }
     this->rwLock.UnlockRead();
-    return result;
+    return resolved;
 }
 
 //------------------------------------------------------------------------------
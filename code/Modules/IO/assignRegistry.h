@@ -30,10 +30,14 @@ public:
     Core::String LookupAssign(const Core::String& assign) const;
     /// resolve assigns in the provided string
     Core::String ResolveAssigns(const Core::String& str) const;
+    /// resolve assigns in a string view, return false (and don't touch outResolved) if str contains no assigns
+    bool ResolveAssigns(const Core::StringView& str, Core::String& outResolved) const;
     
 private:
     /// setup the standard assigns
     void setStandardAssigns();
+    /// find index of an assign, without creating a String object (call with read-lock)
+    int32 findAssign(const Core::StringView& assign) const;
     
     mutable Core::RWLock rwLock;
     Core::Map<Core::String, Core::String> assigns;
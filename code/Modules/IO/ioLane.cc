@@ -5,6 +5,8 @@
 #include "ioLane.h"
 #include "Messaging/Dispatcher.h"
 #include "IO/schemeRegistry.h"
+#include "IO/DiskCache.h"
+#include "Core/String/StringBuilder.h"
 
 namespace Oryol {
 namespace IO {
@@ -17,7 +19,7 @@ using namespace Messaging;
 //------------------------------------------------------------------------------
 ioLane::ioLane() {
     // let our thread wake up from time to time
-    this->SetTickDuration(100);
+    this->SetTickDuration(IdleTickDuration);
 }
 
 //------------------------------------------------------------------------------
@@ -33,12 +35,12 @@ ioLane::onThreadEnter() {
     // setup a Dispatcher to route messages to safely route messages
     // to this object's callback methods
     Ptr<Dispatcher<IOProtocol>> disp = Dispatcher<IOProtocol>::Create();
-    using namespace std::placeholders;
-    disp->Subscribe<IOProtocol::Get>(std::bind(&ioLane::onGet, this, _1));
-    disp->Subscribe<IOProtocol::GetRange>(std::bind(&ioLane::onGetRange, this, _1));
-    disp->Subscribe<IOProtocol::notifyFileSystemAdded>(std::bind(&ioLane::onNotifyFileSystemAdded, this, _1));
-    disp->Subscribe<IOProtocol::notifyFileSystemReplaced>(std::bind(&ioLane::onNotifyFileSystemReplaced, this, _1));
-    disp->Subscribe<IOProtocol::notifyFileSystemRemoved>(std::bind(&ioLane::onNotifyFileSystemRemoved, this, _1));
+    disp->Subscribe(this, &ioLane::onGet);
+    disp->Subscribe(this, &ioLane::onGetRange);
+    disp->Subscribe(this, &ioLane::onGetRanges);
+    disp->Subscribe(this, &ioLane::onNotifyFileSystemAdded);
+    disp->Subscribe(this, &ioLane::onNotifyFileSystemReplaced);
+    disp->Subscribe(this, &ioLane::onNotifyFileSystemRemoved);
     this->forwardingPort = disp;
 }
 
@@ -46,6 +48,7 @@ ioLane::onThreadEnter() {
 void
 ioLane::onThreadLeave() {
     this->forwardingPort = 0;
+    this->cacheRequests.Clear();
     this->fileSystems.Clear();
     ThreadedQueue::onThreadLeave();
 }
@@ -55,18 +58,26 @@ void
 ioLane::onTick() {
     ThreadedQueue::onTick();
     
-    // also tick our file systems
+    // also tick our file systems, and wake up more often while
+    // a filesystem is moving data (e.g. a HTTP download), but not
+    // while its requests are only waiting (paused streams, retries)
+    bool busy = false;
     for (const auto& kvp : this->fileSystems) {
         kvp.Value()->DoWork();
+        busy |= kvp.Value()->IsTransferring();
     }
+    this->updateCacheRequests();
+    busy |= !this->cacheRequests.Empty();
+    this->tickDuration = busy ? BusyTickDuration : IdleTickDuration;
 }
 
 //------------------------------------------------------------------------------
 Ptr<FileSystem>
 ioLane::fileSystemForURL(const URL& url) {
     StringAtom scheme = url.Scheme();
-    if (this->fileSystems.Contains(scheme)) {
-        return this->fileSystems[scheme];
+    const Ptr<FileSystem>* fileSystem = this->fileSystems.Find(scheme);
+    if (nullptr != fileSystem) {
+        return *fileSystem;
     }
     else {
         Log::Warn("ioLane::fileSystemForURL: no filesystem registered for URL scheme '%s'!\n", scheme.AsCStr());
@@ -74,6 +85,21 @@ ioLane::fileSystemForURL(const URL& url) {
     }
 }
 
+//------------------------------------------------------------------------------
+/**
+ A request must always be handled, the router only frees the lane
+ slot of a request (and completes its coalesced waiters) once it
+ has been handled.
+*/
+void
+ioLane::failNoFileSystem(const Ptr<IOProtocol::Get>& msg) {
+    StringBuilder builder;
+    builder.Format(256, "%s: no filesystem registered for URL scheme", msg->GetURL().AsCStr());
+    msg->SetStatus(IOStatus::NotFound);
+    msg->SetErrorDesc(builder.GetString());
+    msg->SetHandled();
+}
+
 //------------------------------------------------------------------------------
 void
 ioLane::onGet(const Ptr<IOProtocol::Get>& msg) {
@@ -85,7 +111,10 @@ ioLane::onGet(const Ptr<IOProtocol::Get>& msg) {
     else {
         Ptr<FileSystem> fs = this->fileSystemForURL(msg->GetURL());
         if (fs) {
-            fs->onGet(msg);
+            this->forwardGet(fs, msg, 0, EndOfStream, IOStatus::OK);
+        }
+        else {
+            this->failNoFileSystem(msg);
         }
     }
 }
@@ -98,9 +127,141 @@ ioLane::onGetRange(const Ptr<IOProtocol::GetRange>& msg) {
         msg->SetStatus(IOStatus::Cancelled);
         msg->SetHandled();
     }
-    Ptr<FileSystem> fs = this->fileSystemForURL(msg->GetURL());
-    if (fs) {
-        fs->onGetRange(msg);
+    else {
+        // ranges are served from a cached complete file, but are not written to the cache
+        const int32 startOffset = msg->GetStartOffset();
+        const int32 endOffset = msg->GetEndOffset();
+        Ptr<FileSystem> fs = this->fileSystemForURL(msg->GetURL());
+        if (fs) {
+            if ((startOffset >= 0) && (endOffset >= startOffset)) {
+                this->forwardGet(fs, msg, startOffset, (endOffset - startOffset) + 1, IOStatus::PartialContent);
+            }
+            else {
+                fs->onGetRange(msg);
+            }
+        }
+        else {
+            this->failNoFileSystem(msg);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioLane::onGetRanges(const Ptr<IOProtocol::GetRanges>& msg) {
+    if (msg->Cancelled()) {
+        // message has been cancelled, don't waste time with it
+        msg->SetStatus(IOStatus::Cancelled);
+        msg->SetHandled();
+    }
+    else {
+        Ptr<FileSystem> fs = this->fileSystemForURL(msg->GetURL());
+        if (fs) {
+            fs->onGetRanges(msg);
+        }
+        else {
+            this->failNoFileSystem(msg);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Requests which don't involve the DiskCache go directly to the filesystem.
+ Otherwise the filesystem gets a proxy request: a cached copy is never
+ served without asking the origin, so the proxy carries the validator of
+ the cached copy for a conditional request. The original request is
+ handled in updateCacheRequests() once the proxy has been handled, this
+ also makes sure that a result is written to the cache before the
+ requester can access the result stream.
+*/
+void
+ioLane::forwardGet(const Ptr<FileSystem>& fs, const Ptr<IOProtocol::Get>& msg, int32 offset, int32 numBytes, IOStatus::Code okStatus) {
+    const bool isRange = msg->IsA<IOProtocol::GetRange>();
+    const bool useCache = DiskCache::HasInstance() && !msg->GetPipe().isValid();
+    const bool cacheRead = useCache && msg->GetCacheReadEnabled();
+    const bool cacheWrite = useCache && msg->GetCacheWriteEnabled() && !isRange;
+    if (!(cacheRead || cacheWrite)) {
+        if (isRange) {
+            fs->onGetRange(msg.staticCast<IOProtocol::GetRange>());
+        }
+        else {
+            fs->onGet(msg);
+        }
+        return;
+    }
+
+    cacheRequest req;
+    req.msg = msg;
+    req.okStatus = okStatus;
+    req.store = cacheWrite;
+    if (cacheRead) {
+        req.cached = DiskCache::Instance()->Lookup(msg->GetURL(), offset, numBytes, &req.validator);
+    }
+    Ptr<IOProtocol::GetRange> rangeProxy;
+    if (isRange) {
+        const Ptr<IOProtocol::GetRange> rangeMsg = msg.staticCast<IOProtocol::GetRange>();
+        rangeProxy = IOProtocol::GetRange::Create();
+        rangeProxy->SetStartOffset(rangeMsg->GetStartOffset());
+        rangeProxy->SetEndOffset(rangeMsg->GetEndOffset());
+        req.proxy = rangeProxy;
+    }
+    else {
+        req.proxy = IOProtocol::Get::Create();
+    }
+    req.proxy->SetURL(msg->GetURL());
+    req.proxy->SetLane(msg->GetLane());
+    req.proxy->SetTimeout(msg->GetTimeout());
+    req.proxy->SetMaxRetries(msg->GetMaxRetries());
+    if (req.cached.isValid()) {
+        req.proxy->SetCachedValidator(req.validator);
+    }
+    this->cacheRequests.AddBack(req);
+    if (isRange) {
+        fs->onGetRange(rangeProxy);
+    }
+    else {
+        fs->onGet(req.proxy);
+    }
+    this->updateCacheRequests();
+}
+
+//------------------------------------------------------------------------------
+void
+ioLane::updateCacheRequests() {
+    for (int32 i = this->cacheRequests.Size() - 1; i >= 0; i--) {
+        const cacheRequest& req = this->cacheRequests[i];
+        if (req.msg->Cancelled() && !req.proxy->Cancelled()) {
+            // let the filesystem abort the transfer
+            req.proxy->SetCancelled();
+        }
+        if (req.proxy->Handled()) {
+            const IOStatus::Code status = req.proxy->GetStatus();
+            if ((IOStatus::NotModified == status) && req.cached.isValid()) {
+                // the origin confirmed the cached copy
+                req.msg->SetStatus(req.okStatus);
+                req.msg->SetStream(req.cached);
+                req.msg->SetValidator(req.validator);
+            }
+            else {
+                const Ptr<Stream>& stream = req.proxy->GetStream();
+                const String& validator = req.proxy->GetValidator();
+                const bool changed = (IOStatus::OK == status) || (IOStatus::PartialContent == status);
+                if (changed && req.cached.isValid() && (validator != req.validator)) {
+                    // the cached copy is stale
+                    DiskCache::Instance()->Remove(req.msg->GetURL());
+                }
+                if (req.store && (IOStatus::OK == status) && stream.isValid() && !stream->IsOpen()) {
+                    DiskCache::Instance()->Store(req.msg->GetURL(), validator, stream);
+                }
+                req.msg->SetStatus(status);
+                req.msg->SetStream(stream);
+                req.msg->SetErrorDesc(req.proxy->GetErrorDesc());
+                req.msg->SetValidator(validator);
+            }
+            req.msg->SetHandled();
+            this->cacheRequests.Erase(i);
+        }
     }
 }
 
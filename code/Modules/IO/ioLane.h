@@ -7,7 +7,7 @@
     @todo: IO::ioLane description
 */
 #include "Messaging/ThreadedQueue.h"
-#include "Core/Containers/Map.h"
+#include "Core/Containers/HashMap.h"
 #include "Core/String/StringAtom.h"
 #include "IO/IOProtocol.h"
 #include "IO/FileSystem.h"
@@ -23,6 +23,11 @@ public:
     /// destructor
     virtual ~ioLane();
     
+    /// tick duration in millisecs while no requests are transferring
+    static const uint32 IdleTickDuration = 100;
+    /// tick duration in millisecs while a filesystem is transferring data
+    static const uint32 BusyTickDuration = 1;
+
 private:
     /// lookup filesystem for URL
     Core::Ptr<FileSystem> fileSystemForURL(const URL& url);
@@ -36,14 +41,39 @@ private:
     void onGet(const Core::Ptr<IOProtocol::Get>& msg);
     /// callback for IOProtocol::GetRange
     void onGetRange(const Core::Ptr<IOProtocol::GetRange>& msg);
+    /// callback for IOProtocol::GetRanges
+    void onGetRanges(const Core::Ptr<IOProtocol::GetRanges>& msg);
     /// callback for IOProtocol::notifyFileSystemAdded
     void onNotifyFileSystemAdded(const Core::Ptr<IOProtocol::notifyFileSystemAdded>& msg);
     /// callback for IOProtocol::notifyFileSystemReplaced
     void onNotifyFileSystemReplaced(const Core::Ptr<IOProtocol::notifyFileSystemReplaced>& msg);
     /// callback for IOProtocol::notifyFileSystemRemoved
     void onNotifyFileSystemRemoved(const Core::Ptr<IOProtocol::notifyFileSystemRemoved>& msg);
+    /// forward a Get or GetRange request to a filesystem, through a proxy if the DiskCache is involved
+    void forwardGet(const Core::Ptr<FileSystem>& fs, const Core::Ptr<IOProtocol::Get>& msg, int32 offset, int32 numBytes, IOStatus::Code okStatus);
+    /// handle requests whose proxy has been handled, update the DiskCache
+    void updateCacheRequests();
+    /// complete a request for a URL scheme without filesystem with NotFound
+    void failNoFileSystem(const Core::Ptr<IOProtocol::Get>& msg);
+
+    /// hash function for URL schemes
+    struct schemeHasher {
+        uint32 operator()(const Core::StringAtom& scheme) const {
+            return uint32(scheme.Hash());
+        };
+    };
+    Core::HashMap<Core::StringAtom, Core::Ptr<FileSystem>, schemeHasher> fileSystems;
 
-    Core::Map<Core::StringAtom, Core::Ptr<FileSystem>> fileSystems;
+    /// a request which revalidates a cached copy, and/or whose result is written to the DiskCache
+    struct cacheRequest {
+        Core::Ptr<IOProtocol::Get> msg;
+        Core::Ptr<IOProtocol::Get> proxy;
+        Core::Ptr<Stream> cached;
+        Core::String validator;
+        IOStatus::Code okStatus;
+        bool store;
+    };
+    Core::Array<cacheRequest> cacheRequests;
 };
     
 } // namespace IO
@@ -3,6 +3,8 @@
 //------------------------------------------------------------------------------
 #include "Pre.h"
 #include "ioRequestRouter.h"
+#include "Core/String/StringBuilder.h"
+#include "IO/SubStream.h"
 
 namespace Oryol {
 namespace IO {
@@ -12,14 +14,19 @@ using namespace Messaging;
 
 //------------------------------------------------------------------------------
 ioRequestRouter::ioRequestRouter(int32 numLanes_) :
-numLanes(numLanes_) {
+numLanes(numLanes_),
+numPromotedRequests(0),
+hostLaneUseCount(0) {
+    o_assert(numLanes_ > 0);
 
     // create ioLanes
     this->ioLanes.Reserve(this->numLanes);
+    this->laneRequests.Reserve(this->numLanes);
     for (int32 i = 0; i < this->numLanes; i++) {
         Ptr<ioLane> newLane = ioLane::Create();
         newLane->StartThread();
         this->ioLanes.AddBack(newLane);
+        this->laneRequests.AddBack(Array<Ptr<IOProtocol::Request>>());
     }
 }
 
@@ -34,21 +41,30 @@ ioRequestRouter::~ioRequestRouter() {
 //------------------------------------------------------------------------------
 bool
 ioRequestRouter::Put(const Ptr<Message>& msg) {
-    // is it a notify message for all lanes?
-    Ptr<IOProtocol::notifyLanes> notifyMsg = msg.dynamicCast<IOProtocol::notifyLanes>();
-    if (notifyMsg.isValid()) {
+    // is it a notify message for all lanes? (type tag tests, no dynamic_cast)
+    if (msg->IsA<IOProtocol::notifyLanes>()) {
         for (const auto& lane : this->ioLanes) {
             lane->Put(msg);
         }
         return true;
     }
-    else {
-        Ptr<IOProtocol::Request> req = msg.dynamicCast<IOProtocol::Request>();
-        if (req.isValid()) {
-            const int32 laneIndex = req->GetLane() % this->numLanes;
-            this->ioLanes[laneIndex]->Put(msg);
+    else if (msg->IsA<IOProtocol::Request>()) {
+        Ptr<IOProtocol::Request> req = msg.staticCast<IOProtocol::Request>();
+        if (msg->IsA<IOProtocol::Get>() && this->coalesce(msg.staticCast<IOProtocol::Get>())) {
             return true;
         }
+        if (AnyLane != req->GetLane()) {
+            // explicit lane overrides scheduling
+            this->dispatch(req->GetLane() % this->numLanes, req);
+        }
+        else {
+            const int32 priority = req->GetPriority();
+            o_assert((priority >= 0) && (priority < IOPriority::NumPriorities));
+            this->waitingRequests[priority].Enqueue(req);
+            this->updateLaneRequests();
+            this->dispatchWaitingRequests();
+        }
+        return true;
     }
     // fallthrough: unrecognized message
     Log::Warn("ioRequestRouter::Put(): unrecognized message received!\n");
@@ -61,6 +77,249 @@ ioRequestRouter::DoWork() {
     for (const auto& lane : this->ioLanes) {
         lane->DoWork();
     }
+    this->updateLaneRequests();
+    this->updateCoalescedRequests();
+    this->dispatchWaitingRequests();
+}
+
+//------------------------------------------------------------------------------
+bool
+ioRequestRouter::coalesce(const Ptr<IOProtocol::Get>& msg) {
+    if (msg->GetPipe().isValid() || msg->IsA<IOProtocol::GetRanges>()) {
+        // streaming and multi-range requests are never shared
+        return false;
+    }
+    // only requests which would produce the same result are shared, the key
+    // holds the URL, the range and all request options (URLs can't contain
+    // spaces, and the cached validator comes last)
+    int32 startOffset = 0;
+    int32 endOffset = EndOfStream;
+    if (msg->IsA<IOProtocol::GetRange>()) {
+        Ptr<IOProtocol::GetRange> rangeReq = msg.staticCast<IOProtocol::GetRange>();
+        startOffset = rangeReq->GetStartOffset();
+        endOffset = rangeReq->GetEndOffset();
+    }
+    const String& cachedValidator = msg->GetCachedValidator();
+    StringBuilder strBuilder;
+    strBuilder.Format(msg->GetURL().Get().Length() + cachedValidator.Length() + 96, "%s %d-%d %d %d %d%d %s",
+        msg->GetURL().AsCStr(), startOffset, endOffset,
+        msg->GetTimeout(), msg->GetMaxRetries(),
+        msg->GetCacheReadEnabled() ? 1 : 0, msg->GetCacheWriteEnabled() ? 1 : 0,
+        cachedValidator.AsCStr());
+    const String key = strBuilder.GetString();
+    if (this->inFlightGets.Contains(key)) {
+        const Ptr<IOProtocol::Get>& first = this->inFlightGets[key];
+        if (!first->Handled()) {
+            this->coalescedRequests.AddBack(coalescedRequest{ msg, first });
+            if (msg->GetPriority() > first->GetPriority()) {
+                // don't let the waiting request inherit a lower priority
+                this->promote(first, msg->GetPriority());
+            }
+            return true;
+        }
+        else {
+            // not in flight anymore, this request becomes the new first request
+            this->inFlightGets[key] = msg;
+            return false;
+        }
+    }
+    else {
+        this->inFlightGets.Insert(key, msg);
+        return false;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioRequestRouter::updateCoalescedRequests() {
+    Array<Ptr<IOProtocol::Get>> retry;
+    for (int32 i = this->coalescedRequests.Size() - 1; i >= 0; i--) {
+        const coalescedRequest& req = this->coalescedRequests[i];
+        if (req.msg->Cancelled()) {
+            // don't keep cancelled requests waiting for the first request
+            req.msg->SetStatus(IOStatus::Cancelled);
+            req.msg->SetHandled();
+            this->coalescedRequests.EraseSwap(i);
+        }
+        else if (req.first->Handled()) {
+            const Ptr<Stream>& stream = req.first->GetStream();
+            if (IOStatus::Cancelled == req.first->GetStatus()) {
+                // only the first request was cancelled
+                retry.AddBack(req.msg);
+            }
+            else if (stream.isValid() && stream->IsOpen()) {
+                // the stream is being read, try again next time
+                continue;
+            }
+            else {
+                req.msg->SetStatus(req.first->GetStatus());
+                if (stream.isValid()) {
+                    req.msg->SetStream(SubStream::Create(stream, 0, stream->Size()));
+                }
+                req.msg->SetErrorDesc(req.first->GetErrorDesc());
+                req.msg->SetValidator(req.first->GetValidator());
+                req.msg->SetHandled();
+            }
+            this->coalescedRequests.EraseSwap(i);
+        }
+    }
+    for (int32 i = this->inFlightGets.Size() - 1; i >= 0; i--) {
+        if (this->inFlightGets.ValueAtIndex(i)->Handled()) {
+            this->inFlightGets.EraseIndex(i);
+        }
+    }
+    for (const auto& msg : retry) {
+        this->Put(msg);
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioRequestRouter::updateLaneRequests() {
+    for (auto& requests : this->laneRequests) {
+        for (int32 i = requests.Size() - 1; i >= 0; i--) {
+            if (requests[i]->Handled()) {
+                requests.EraseSwap(i);
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+ioRequestRouter::dispatchWaitingRequests() {
+    for (int32 priority = IOPriority::NumPriorities - 1; priority >= 0; priority--) {
+        Queue<Ptr<IOProtocol::Request>>& queue = this->waitingRequests[priority];
+        while (!queue.Empty()) {
+            if (priority != queue[0]->GetPriority()) {
+                // stale entry of a promoted request
+                queue.Dequeue();
+                this->numPromotedRequests--;
+                continue;
+            }
+            if (!this->hasFreeLaneSlot()) {
+                return;
+            }
+            Ptr<IOProtocol::Request> req = queue.Dequeue();
+            this->dispatch(this->selectLane(req), req);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Moves a request which waits in the router into a higher-priority queue.
+ The entry in the old queue is left behind and skipped when it's
+ dequeued (its priority doesn't match the queue anymore). Requests which
+ have already been dispatched into a lane are not changed, lanes
+ ignore priorities.
+*/
+void
+ioRequestRouter::promote(const Ptr<IOProtocol::Request>& req, IOPriority::Code priority) {
+    const Queue<Ptr<IOProtocol::Request>>& queue = this->waitingRequests[req->GetPriority()];
+    for (int32 i = 0; i < queue.Size(); i++) {
+        if (queue[i] == req) {
+            req->SetPriority(priority);
+            this->waitingRequests[priority].Enqueue(req);
+            this->numPromotedRequests++;
+            return;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+bool
+ioRequestRouter::hasFreeLaneSlot() const {
+    for (const auto& requests : this->laneRequests) {
+        if (requests.Size() < ORYOL_IO_MAX_LANE_REQUESTS) {
+            return true;
+        }
+    }
+    return false;
+}
+
+//------------------------------------------------------------------------------
+int32
+ioRequestRouter::selectLane(const Ptr<IOProtocol::Request>& req) {
+    // keep requests to the same host on the same lane
+    String host;
+    if (req->GetURL().HasHost()) {
+        host = req->GetURL().HostAndPort();
+        if (this->hostLanes.Contains(host)) {
+            hostLane& entry = this->hostLanes[host];
+            if (this->laneRequests[entry.laneIndex].Size() < ORYOL_IO_MAX_LANE_REQUESTS) {
+                entry.lastUse = ++this->hostLaneUseCount;
+                return entry.laneIndex;
+            }
+        }
+    }
+
+    // otherwise use the least loaded lane
+    int32 laneIndex = InvalidIndex;
+    int32 minRequests = ORYOL_IO_MAX_LANE_REQUESTS;
+    for (int32 i = 0; i < this->numLanes; i++) {
+        const int32 numRequests = this->laneRequests[i].Size();
+        if (numRequests < minRequests) {
+            laneIndex = i;
+            minRequests = numRequests;
+        }
+    }
+    if ((InvalidIndex != laneIndex) && host.IsValid()) {
+        this->setHostLane(host, laneIndex);
+    }
+    return laneIndex;
+}
+
+//------------------------------------------------------------------------------
+void
+ioRequestRouter::setHostLane(const String& host, int32 laneIndex) {
+    const int64 useCount = ++this->hostLaneUseCount;
+    if (this->hostLanes.Contains(host)) {
+        hostLane& entry = this->hostLanes[host];
+        entry.laneIndex = laneIndex;
+        entry.lastUse = useCount;
+        return;
+    }
+    if (this->hostLanes.Size() >= ORYOL_IO_MAX_HOST_LANES) {
+        // forget the least recently used host
+        int32 lruIndex = 0;
+        for (int32 i = 1; i < this->hostLanes.Size(); i++) {
+            if (this->hostLanes.ValueAtIndex(i).lastUse < this->hostLanes.ValueAtIndex(lruIndex).lastUse) {
+                lruIndex = i;
+            }
+        }
+        this->hostLanes.EraseIndex(lruIndex);
+    }
+    this->hostLanes.Insert(host, hostLane{ laneIndex, useCount });
+}
+
+//------------------------------------------------------------------------------
+void
+ioRequestRouter::dispatch(int32 laneIndex, const Ptr<IOProtocol::Request>& req) {
+    this->laneRequests[laneIndex].AddBack(req);
+    this->ioLanes[laneIndex]->Put(req);
+}
+
+//------------------------------------------------------------------------------
+int32
+ioRequestRouter::NumWaitingRequests() const {
+    int32 num = 0;
+    for (int32 priority = 0; priority < IOPriority::NumPriorities; priority++) {
+        num += this->waitingRequests[priority].Size();
+    }
+    return num - this->numPromotedRequests;
+}
+
+//------------------------------------------------------------------------------
+int32
+ioRequestRouter::NumLaneRequests(int32 laneIndex) const {
+    return this->laneRequests[laneIndex].Size();
+}
+
+//------------------------------------------------------------------------------
+int32
+ioRequestRouter::NumHostLanes() const {
+    return this->hostLanes.Size();
 }
 
 } // namespace IO
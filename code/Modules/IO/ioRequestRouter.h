@@ -4,11 +4,52 @@
     @class Oryol::IO::ioRequestRouter
     @brief private: front end router port of the IO system
     
-    @todo: ioRequestRouter description
+    The ioRequestRouter distributes IO requests over the IO lanes. A
+    request with an explicit lane index goes straight into that lane
+    (modulo the number of lanes), requests with AnyLane are scheduled
+    by the router:
+
+    - each lane gets at most ORYOL_IO_MAX_LANE_REQUESTS unhandled
+      requests, the other requests wait in the router, and are dispatched
+      by priority (and in order within the same priority) when lanes
+      get free slots; this is the only place where priorities matter,
+      inside a lane requests are handled in put-order, so priorities
+      have no effect until all lanes are full
+    - requests to the same host go to the same lane, so that the
+      lane's filesystem can reuse its connections, unless that lane
+      is full; the router remembers the lanes of the last
+      ORYOL_IO_MAX_HOST_LANES hosts
+    - other requests go to the lane with the fewest unhandled requests
+
+    Identical Get and GetRange requests (see below) which are
+    put while a first request is in flight are not dispatched, instead
+    they are handled together with the first request:
+
+    - each waiting request receives its own SubStream on the first
+      request's result stream, so that the requesters don't share a
+      read position; the SubStreams are created on the main thread
+      once the first request's stream isn't open (being read)
+    - if a waiting request has a higher priority than the first request
+      while the first request still waits in the router, the first
+      request is promoted to that priority
+    - a cancelled waiting request is handled (as cancelled) right
+      away, if only the first request is cancelled, the waiting
+      requests are put again
+
+    Only requests with the same URL, range, Timeout, MaxRetries, cache
+    flags and CachedValidator are coalesced (a conditional request may
+    be answered with NotModified, which an unconditional requester
+    can't use). Streaming requests (with a ChunkPipe) are never coalesced.
+    
+    Notify messages are forwarded to all lanes.
 */
 #include "Core/Config.h"
+#include "Core/Containers/Array.h"
+#include "Core/Containers/Map.h"
+#include "Core/Containers/Queue.h"
 #include "Messaging/Port.h"
 #include "IO/ioLane.h"
+#include "IO/IOPriority.h"
 
 namespace Oryol {
 namespace IO {
@@ -25,11 +66,55 @@ public:
     virtual bool Put(const Core::Ptr<Messaging::Message>& msg) override;
     /// perform work, this will be invoked on downstream ports
     virtual void DoWork() override;
+
+    /// get number of requests waiting in the router
+    int32 NumWaitingRequests() const;
+    /// get number of unhandled requests in a lane
+    int32 NumLaneRequests(int32 laneIndex) const;
+    /// get number of hosts with a remembered lane
+    int32 NumHostLanes() const;
     
 private:
+    /// forget handled requests
+    void updateLaneRequests();
+    /// coalesce a Get request with an identical in-flight request, returns true if coalesced
+    bool coalesce(const Core::Ptr<IOProtocol::Get>& msg);
+    /// handle coalesced requests whose first request has been handled
+    void updateCoalescedRequests();
+    /// raise the priority of a request which waits in the router
+    void promote(const Core::Ptr<IOProtocol::Request>& req, IOPriority::Code priority);
+    /// dispatch waiting requests to lanes with free slots
+    void dispatchWaitingRequests();
+    /// test if any lane can take another request
+    bool hasFreeLaneSlot() const;
+    /// select a lane for a request, returns InvalidIndex if all lanes are full
+    int32 selectLane(const Core::Ptr<IOProtocol::Request>& req);
+    /// put a request into a lane
+    void dispatch(int32 laneIndex, const Core::Ptr<IOProtocol::Request>& req);
+    /// remember the lane of a host, evicts the least recently used host if needed
+    void setHostLane(const Core::String& host, int32 laneIndex);
+
     int32 numLanes;
     Core::Array<Core::Ptr<IO::ioLane>> ioLanes;
+    Core::Array<Core::Array<Core::Ptr<IOProtocol::Request>>> laneRequests;
+    Core::Queue<Core::Ptr<IOProtocol::Request>> waitingRequests[IOPriority::NumPriorities];
+    int32 numPromotedRequests;  // stale queue entries left behind by promote()
+    /// the lane of a host, and when it was last used
+    struct hostLane {
+        int32 laneIndex;
+        int64 lastUse;
+    };
+    Core::Map<Core::String, hostLane> hostLanes;
+    int64 hostLaneUseCount;
+
+    /// a request which waits for an identical in-flight request
+    struct coalescedRequest {
+        Core::Ptr<IOProtocol::Get> msg;
+        Core::Ptr<IOProtocol::Get> first;
+    };
+    Core::Map<Core::String, Core::Ptr<IOProtocol::Get>> inFlightGets;
+    Core::Array<coalescedRequest> coalescedRequests;
 };
     
 } // namespace IO
-} // namespace Oryol
\ No newline at end of file
+} // namespace Oryol
@@ -10,8 +10,28 @@
     be given as a template argument.
  
     When a Message arrives in the Put method, the subscribed handler function
-    is looked up in a jump table and called. If no handler function exists
-    for the message, nothing will happen.
+    is looked up in a jump table and called. The jump table holds
+    MessageHandler delegates, so subscribing never allocates, and calling
+    a handler is a single indirect call.
+
+    Handlers can be global functions, object methods, or small lambdas:
+
+    @code
+    dispatcher->Subscribe<TestMsg>(&HandleTestMsg);
+    dispatcher->Subscribe(this, &MyClass::onTestMsg);
+    dispatcher->Subscribe<TestMsg>([this](const Ptr<TestMsg>& msg) { ... });
+    @endcode
+    
+    If no handler function exists for the message, nothing will happen.
+    Protocol membership is checked with the message's type tag (see
+    Message), so routing a message costs one compare, one mask test and
+    one table lookup.
+    
+    NOTE: Subscribe() used to take a std::function. Code which passes
+    a std::function (or a lambda which captures by value more than
+    MessageHandler::MaxCallableSize bytes, or non-trivially copyable
+    objects like a Ptr) no longer compiles. Bind an object method
+    instead, or capture a pointer to the state the lambda needs.
  
     The message handler function is expected to "handle" the message, which
     means to set the Handled flag of the message at some point in time.
@@ -21,14 +41,12 @@
     The Dispatcher will never "own" the message, it only looks up and
     calls the handler function subscribed to a specific message.
 */
-#include <functional>
 #include "Messaging/Port.h"
+#include "Messaging/MessageHandler.h"
 
 namespace Oryol {
 namespace Messaging {
 
-typedef std::function<void(const Core::Ptr<Message>&)> HandlerFunc;
-
 template<class PROTOCOL> class Dispatcher : public Port {
     OryolClassDecl(Dispatcher);
 public:
@@ -40,13 +58,20 @@ public:
     /// put a message into the port
     virtual bool Put(const Core::Ptr<Message>& msg) override;
     
-    /// bind a function to a message
-    template<class MSG> void Subscribe(std::function<void(const Core::Ptr<MSG>&)> func);
+    /// bind a global function to a message
+    template<class MSG> void Subscribe(void(*func)(const Core::Ptr<MSG>&));
+    /// bind an object method to a message
+    template<class MSG, class CLASS> void Subscribe(CLASS* obj, void(CLASS::*method)(const Core::Ptr<MSG>&));
+    /// bind a small, trivially copyable callable (e.g. a lambda) to a message
+    template<class MSG, class CALLABLE> void Subscribe(const CALLABLE& callable);
     /// unsubscribe from a specific message
     template<class MSG> void Unsubscribe();
     
 private:
-    HandlerFunc jumpTable[PROTOCOL::MessageId::NumMessageIds];
+    /// set a jump table entry
+    template<class MSG> void setHandler(const MessageHandler& handler);
+
+    MessageHandler jumpTable[PROTOCOL::MessageId::NumMessageIds];
 };
 
 //------------------------------------------------------------------------------
@@ -64,14 +89,14 @@ Dispatcher<PROTOCOL>::~Dispatcher() {
 //------------------------------------------------------------------------------
 template<class PROTOCOL> bool
 Dispatcher<PROTOCOL>::Put(const Core::Ptr<Message>& msg) {
-    // only consider messages of our protocol, ignore others
-    if (msg->IsMemberOf(PROTOCOL::GetProtocolId())) {
-    
-        MessageIdType msgId = msg->MessageId();
-        o_assert((msgId >= 0) && (msgId < PROTOCOL::MessageId::NumMessageIds));
-        
+    // only consider messages of our protocol, ignore others, messages
+    // of a derived protocol have message ids beyond our jump table
+    const MessageIdType msgId = msg->MessageId();
+    if (msg->IsMemberOf<PROTOCOL>() && (msgId < PROTOCOL::MessageId::NumMessageIds)) {
+        o_assert(msgId >= 0);
+
         // check if a handler function has been set
-        if (this->jumpTable[msgId]) {
+        if (this->jumpTable[msgId].IsValid()) {
             // call the handler function
             this->jumpTable[msgId](msg);
             return true;
@@ -82,13 +107,28 @@ Dispatcher<PROTOCOL>::Put(const Core::Ptr<Message>& msg) {
 
 //------------------------------------------------------------------------------
 template<class PROTOCOL> template<class MSG> void
-Dispatcher<PROTOCOL>::Subscribe(std::function<void(const Core::Ptr<MSG>&)> func) {
+Dispatcher<PROTOCOL>::setHandler(const MessageHandler& handler) {
     const MessageIdType classMsgId = MSG::ClassMessageId();
     o_assert((classMsgId >= 0) && (classMsgId < PROTOCOL::MessageId::NumMessageIds));
-    
-    /// @todo: is this safe?
-    o_assert(sizeof(HandlerFunc) == sizeof(func));
-    this->jumpTable[classMsgId] = *(HandlerFunc*)&func;
+    this->jumpTable[classMsgId] = handler;
+}
+
+//------------------------------------------------------------------------------
+template<class PROTOCOL> template<class MSG> void
+Dispatcher<PROTOCOL>::Subscribe(void(*func)(const Core::Ptr<MSG>&)) {
+    this->setHandler<MSG>(MessageHandler::Function<MSG>(func));
+}
+
+//------------------------------------------------------------------------------
+template<class PROTOCOL> template<class MSG, class CLASS> void
+Dispatcher<PROTOCOL>::Subscribe(CLASS* obj, void(CLASS::*method)(const Core::Ptr<MSG>&)) {
+    this->setHandler<MSG>(MessageHandler::Method<MSG,CLASS>(obj, method));
+}
+
+//------------------------------------------------------------------------------
+template<class PROTOCOL> template<class MSG, class CALLABLE> void
+Dispatcher<PROTOCOL>::Subscribe(const CALLABLE& callable) {
+    this->setHandler<MSG>(MessageHandler::Callable<MSG,CALLABLE>(callable));
 }
 
 //------------------------------------------------------------------------------
@@ -96,7 +136,7 @@ template<class PROTOCOL> template<class MSG> void
 Dispatcher<PROTOCOL>::Unsubscribe() {
     const MessageIdType classMsgId = MSG::ClassMessageId();
     o_assert((classMsgId >= 0) && (classMsgId < PROTOCOL::MessageId::NumMessageIds));
-    this->jumpTable[classMsgId] = HandlerFunc();
+    this->jumpTable[classMsgId] = MessageHandler();
 }
 
 } // namespace Messaging
@@ -15,9 +15,9 @@ Message::~Message() {
 }
 
 //------------------------------------------------------------------------------
-bool
-Message::IsMemberOf(ProtocolIdType protId) const {
-    return false;
+ProtocolIdType
+Message::ProtocolId() const {
+    return InvalidProtocolId;
 }
 
 //------------------------------------------------------------------------------
@@ -50,24 +50,28 @@ Message::Cancelled() const {
     return this->cancelled;
 }
 
+//------------------------------------------------------------------------------
+bool
+Message::IsSerializable() const {
+    return true;
+}
+
 //------------------------------------------------------------------------------
 int32
 Message::EncodedSize() const {
-    /// @todo: this should include some sort of header information
+    // the frame header is written by the MessageCodec
     return 0;
 }
 
 //------------------------------------------------------------------------------
 uint8*
 Message::Encode(uint8* dstPtr, const uint8* maxValidPtr) const {
-    // @todo: this should write a header with the MessageId
     return dstPtr;
 }
 
 //------------------------------------------------------------------------------
 const uint8*
 Message::Decode(const uint8* srcPtr, const uint8* maxValidPtr) {
-    /// @todo: this should decode the header
     return srcPtr;
 }
     
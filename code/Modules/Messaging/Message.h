@@ -3,6 +3,20 @@
 /**
     @class Oryol::Messaging::Message
     @brief base class for messages
+
+    Each message carries a type tag which is set by the generated
+    constructors: the id of the base protocol of its protocol hierarchy,
+    and a bit mask with one bit for the message id of its own class and
+    each parent class. This allows to check protocol membership and
+    message class with one compare and one mask test, without
+    virtual calls or dynamic_cast:
+
+    @code
+    if (msg->IsA<IOProtocol::Get>()) {
+        Ptr<IOProtocol::Get> get = msg.staticCast<IOProtocol::Get>();
+        ...
+    }
+    @endcode
 */
 #include "Core/Config.h"
 #include "Core/RefCounted.h"
@@ -19,10 +33,16 @@ public:
     /// destructor
     virtual ~Message();
     
-    /// test if this message belongs to a protocol
-    virtual bool IsMemberOf(ProtocolIdType protId) const;
+    /// test if this message (or one of its parent classes) is defined in PROTOCOL
+    template<class PROTOCOL> bool IsMemberOf() const;
+    /// test if this message is an instance of MSG, or of a class derived from MSG
+    template<class MSG> bool IsA() const;
+    /// get the id of the protocol which defines the message class
+    virtual ProtocolIdType ProtocolId() const;
     /// get the class message id
     static MessageIdType ClassMessageId();
+    /// get the class type bits (message ids of the class and its parent classes)
+    static uint64 ClassTypeBits();
     /// get the object message id
     MessageIdType MessageId() const;
     /// set message to Handled state
@@ -35,7 +55,11 @@ public:
     bool Handled() const;
     /// return true if the message is in cancelled state
     bool Cancelled() const;
+    /// reset the message to its default state (called when a recycled message is released)
+    virtual void Reset();
     
+    /// return false if the message class has no serializer methods (serialize="false")
+    virtual bool IsSerializable() const;
     /// get the encoded size of the message
     virtual int32 EncodedSize() const;
     /// encode the message to raw memory, maxBytes must be at least EncodedSize()
@@ -45,6 +69,8 @@ public:
 
 protected:
     MessageIdType msgId;
+    ProtocolIdType baseProtId;
+    uint64 typeBits;
     #if ORYOL_HAS_ATOMIC
     std::atomic<bool> handled;
     std::atomic<bool> cancelled;
@@ -57,6 +83,8 @@ protected:
 //------------------------------------------------------------------------------
 inline Message::Message() :
 msgId(InvalidMessageId),
+baseProtId(InvalidProtocolId),
+typeBits(0),
 handled(false),
 cancelled(false) {
     // empty
@@ -68,5 +96,30 @@ Message::MessageId() const {
     return this->msgId;
 }
 
+//------------------------------------------------------------------------------
+inline void
+Message::Reset() {
+    this->handled = false;
+    this->cancelled = false;
+}
+
+//------------------------------------------------------------------------------
+inline uint64
+Message::ClassTypeBits() {
+    return 0;
+}
+
+//------------------------------------------------------------------------------
+template<class PROTOCOL> bool
+Message::IsMemberOf() const {
+    return (this->baseProtId == PROTOCOL::GetBaseProtocolId()) && (0 != (this->typeBits & PROTOCOL::GetMessageIdBits()));
+}
+
+//------------------------------------------------------------------------------
+template<class MSG> bool
+Message::IsA() const {
+    return (this->baseProtId == MSG::ClassBaseProtocolId()) && (0 != (this->typeBits & (uint64(1) << MSG::ClassMessageId())));
+}
+
 } // namespace Messaging
 } // namespace Oryol
\ No newline at end of file
@@ -0,0 +1,166 @@
+//------------------------------------------------------------------------------
+//  MessageCodec.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "MessageCodec.h"
+#include "Messaging/Serializer.h"
+#include "Core/Memory/Memory.h"
+
+namespace Oryol {
+namespace Messaging {
+
+using namespace Core;
+
+//------------------------------------------------------------------------------
+MessageCodec::MessageCodec() :
+buffer(nullptr),
+capacity(0),
+size(0),
+numMessages(0) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+MessageCodec::~MessageCodec() {
+    if (nullptr != this->buffer) {
+        Memory::Free(this->buffer);
+        this->buffer = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+MessageCodec::grow(int32 numBytes) {
+    int32 newCapacity = this->capacity > 0 ? this->capacity * 2 : 4096;
+    while (newCapacity < (this->size + numBytes)) {
+        newCapacity *= 2;
+    }
+    this->buffer = (uint8*) Memory::ReAlloc(this->buffer, newCapacity);
+    this->capacity = newCapacity;
+}
+
+//------------------------------------------------------------------------------
+void
+MessageCodec::Encode(const Queue<Ptr<Message>>& msgs) {
+    const int32 numMsgs = msgs.Size();
+    for (int32 i = 0; i < numMsgs; i++) {
+        this->Encode(msgs[i]);
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ The payload is encoded right behind the header space, and the header
+ is written once the payload length is known. If the payload doesn't
+ fit, the buffer grows and the message is encoded again. A frame which
+ is too big is only dropped after encoding, since its size is not
+ known before.
+*/
+bool
+MessageCodec::Encode(const Ptr<Message>& msg, int32 maxFrameSize) {
+    o_assert(msg.isValid());
+    if (!msg->IsSerializable()) {
+        return false;
+    }
+    uint8* payloadEnd = nullptr;
+    do {
+        if ((this->capacity - this->size) <= HeaderSize) {
+            this->grow(HeaderSize + 1);
+        }
+        uint8* payloadStart = this->buffer + this->size + HeaderSize;
+        payloadEnd = msg->Encode(payloadStart, this->buffer + this->capacity);
+        if (nullptr == payloadEnd) {
+            this->grow(this->capacity - this->size + 1);
+        }
+    } while (nullptr == payloadEnd);
+    
+    const uint8* maxPtr = this->buffer + this->capacity;
+    const int32 payloadSize = int32(payloadEnd - (this->buffer + this->size + HeaderSize));
+    if ((maxFrameSize > 0) && ((HeaderSize + payloadSize) > maxFrameSize)) {
+        return false;
+    }
+    uint8* dstPtr = this->buffer + this->size;
+    dstPtr = Serializer::Encode<ProtocolIdType>(msg->ProtocolId(), dstPtr, maxPtr);
+    dstPtr = Serializer::Encode<MessageIdType>(msg->MessageId(), dstPtr, maxPtr);
+    dstPtr = Serializer::Encode<int32>(payloadSize, dstPtr, maxPtr);
+    o_assert(nullptr != dstPtr);
+    this->size += HeaderSize + payloadSize;
+    this->numMessages++;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+MessageCodec::Clear() {
+    this->size = 0;
+    this->numMessages = 0;
+}
+
+//------------------------------------------------------------------------------
+const uint8*
+MessageCodec::Data() const {
+    return this->buffer;
+}
+
+//------------------------------------------------------------------------------
+int32
+MessageCodec::Size() const {
+    return this->size;
+}
+
+//------------------------------------------------------------------------------
+int32
+MessageCodec::NumMessages() const {
+    return this->numMessages;
+}
+
+//------------------------------------------------------------------------------
+/**
+ Message ids are only unique within a protocol hierarchy, so a frame
+ is only decoded if the message class created from its message id 
+ belongs to the protocol in the frame header, other frames are skipped.
+ Messages decoded before a corrupt frame stay in outMsgs.
+*/
+bool
+MessageCodec::Decode(const ProtocolFactory& factory, const uint8* ptr, int32 numBytes, Queue<Ptr<Message>>& outMsgs, int32* outNumConsumed) {
+    o_assert((nullptr != ptr) || (0 == numBytes));
+    const uint8* startPtr = ptr;
+    const uint8* maxPtr = ptr + numBytes;
+    if (nullptr != outNumConsumed) {
+        *outNumConsumed = 0;
+    }
+    while (ptr < maxPtr) {
+        ProtocolIdType protId = InvalidProtocolId;
+        MessageIdType msgId = InvalidMessageId;
+        int32 payloadSize = 0;
+        ptr = Serializer::Decode<ProtocolIdType>(ptr, maxPtr, protId);
+        ptr = Serializer::Decode<MessageIdType>(ptr, maxPtr, msgId);
+        ptr = Serializer::Decode<int32>(ptr, maxPtr, payloadSize);
+        if ((nullptr != ptr) && (payloadSize < 0)) {
+            return false;
+        }
+        if ((nullptr == ptr) || (payloadSize > (maxPtr - ptr))) {
+            // truncated frame, ok if the rest of the frame is still to come
+            return nullptr != outNumConsumed;
+        }
+        const uint8* payloadEnd = ptr + payloadSize;
+        if ((msgId >= 0) && (msgId < factory.numMessageIds)) {
+            Ptr<Message> msg = factory.create(msgId);
+            if (msg->ProtocolId() == protId) {
+                if (msg->Decode(ptr, payloadEnd) != payloadEnd) {
+                    // payload doesn't match the message
+                    return false;
+                }
+                outMsgs.Enqueue(std::move(msg));
+            }
+        }
+        ptr = payloadEnd;
+        if (nullptr != outNumConsumed) {
+            *outNumConsumed = int32(ptr - startPtr);
+        }
+    }
+    return true;
+}
+
+} // namespace Messaging
+} // namespace Oryol
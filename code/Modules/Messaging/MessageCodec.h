@@ -0,0 +1,105 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Messaging::MessageCodec
+    @brief encode and decode batches of messages as framed byte streams
+    
+    The MessageCodec encodes a queue of messages into one contiguous
+    memory buffer, for instance to send a batch of messages to another
+    process, or to write them into a replay log. Each message is written
+    as a frame with a 12-byte header (protocol id, message id and payload
+    length) followed by the payload written by Message::Encode():
+
+    @code
+    MessageCodec codec;
+    codec.Encode(msgQueue);
+    send(codec.Data(), codec.Size());
+    ...
+    Queue<Ptr<Message>> received;
+    MessageCodec::Decode<MyProtocol>(ptr, numBytes, received);
+    @endcode
+    
+    Encoding is a single pass over the messages: the payload is encoded
+    directly into the buffer, and the buffer only grows (and the message
+    is encoded again) if a message doesn't fit. The buffer is kept
+    between batches, Clear() only resets the size. Messages of a class
+    with serialize="false" are not encoded (they would decode as
+    empty messages).
+    
+    Decoding creates the messages through the Factory of the protocol
+    given as template argument. Frames with a message which isn't
+    part of that protocol are skipped. Code which isn't templated on
+    the protocol (like the SocketPort) keeps a ProtocolFactory instead.
+    When decoding a byte stream which may end in the middle of a frame,
+    pass outNumConsumed, decoding then stops before the incomplete frame.
+*/
+#include "Core/Types.h"
+#include "Core/Ptr.h"
+#include "Core/Containers/Queue.h"
+#include "Messaging/Message.h"
+
+namespace Oryol {
+namespace Messaging {
+
+class MessageCodec {
+public:
+    /// constructor
+    MessageCodec();
+    /// destructor
+    ~MessageCodec();
+
+    /// size of the frame header
+    static const int32 HeaderSize = 12;
+    /// the message factory of a protocol
+    struct ProtocolFactory {
+        Core::Ptr<Message> (*create)(MessageIdType msgId);
+        int32 numMessageIds;
+    };
+    /// get the message factory of a protocol
+    template<class PROTOCOL> static ProtocolFactory FactoryOf();
+    
+    /// append all messages in a queue to the buffer, the queue isn't changed
+    void Encode(const Core::Queue<Core::Ptr<Message>>& msgs);
+    /// append a single message, returns false (and appends nothing) if the message isn't serializable, or the frame would be bigger than maxFrameSize (0: no limit)
+    bool Encode(const Core::Ptr<Message>& msg, int32 maxFrameSize=0);
+    /// reset the buffer size to 0 (keeps the allocated memory)
+    void Clear();
+    /// get pointer to the encoded frames
+    const uint8* Data() const;
+    /// get size of the encoded frames in bytes
+    int32 Size() const;
+    /// get the number of encoded messages since the last Clear()
+    int32 NumMessages() const;
+
+    /// decode frames and append the messages to a queue, returns false if the data is corrupt
+    template<class PROTOCOL> static bool Decode(const uint8* ptr, int32 numBytes, Core::Queue<Core::Ptr<Message>>& outMsgs);
+    /// decode frames through a protocol factory, optionally stop before an incomplete frame
+    static bool Decode(const ProtocolFactory& factory, const uint8* ptr, int32 numBytes, Core::Queue<Core::Ptr<Message>>& outMsgs, int32* outNumConsumed=nullptr);
+
+private:
+    /// make room for at least numBytes more bytes
+    void grow(int32 numBytes);
+
+    uint8* buffer;
+    int32 capacity;
+    int32 size;
+    int32 numMessages;
+};
+
+//------------------------------------------------------------------------------
+template<class PROTOCOL> MessageCodec::ProtocolFactory
+MessageCodec::FactoryOf() {
+    ProtocolFactory factory;
+    factory.create = &PROTOCOL::Factory::Create;
+    factory.numMessageIds = PROTOCOL::MessageId::NumMessageIds;
+    return factory;
+}
+
+//------------------------------------------------------------------------------
+template<class PROTOCOL> bool
+MessageCodec::Decode(const uint8* ptr, int32 numBytes, Core::Queue<Core::Ptr<Message>>& outMsgs) {
+    return Decode(FactoryOf<PROTOCOL>(), ptr, numBytes, outMsgs);
+}
+
+} // namespace Messaging
+} // namespace Oryol
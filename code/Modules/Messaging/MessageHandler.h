@@ -0,0 +1,147 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Messaging::MessageHandler
+    @brief non-allocating delegate for message handler functions
+
+    A MessageHandler stores a typed message handler in a small inline
+    buffer, and calls it through a single function pointer. It never
+    allocates, and it never type-erases through std::function. The
+    following can be bound:
+
+    - a global function or static class method: void(const Ptr<MSG>&)
+    - an object and a member function: void (CLASS::*)(const Ptr<MSG>&)
+    - a small, trivially copyable callable, for instance a lambda
+      which captures pointers or references (up to MaxCallableSize bytes)
+
+    The message is passed to the handler as Ptr<MSG> without a cast
+    check, the caller is responsible that only messages of class MSG
+    (or derived) are passed (the Dispatcher does this with the message
+    type tags).
+*/
+#include "Core/Types.h"
+#include "Core/Assert.h"
+#include "Core/Ptr.h"
+#include "Messaging/Message.h"
+#include <cstring>
+#include <type_traits>
+
+namespace Oryol {
+namespace Messaging {
+
+class MessageHandler {
+public:
+    /// max size of an inline callable
+    static const int32 MaxCallableSize = 4 * sizeof(void*);
+
+    /// default constructor, creates an invalid handler
+    MessageHandler();
+    /// bind a global function
+    template<class MSG> static MessageHandler Function(void(*func)(const Core::Ptr<MSG>&));
+    /// bind an object and a member function
+    template<class MSG, class CLASS> static MessageHandler Method(CLASS* obj, void(CLASS::*method)(const Core::Ptr<MSG>&));
+    /// bind a small, trivially copyable callable
+    template<class MSG, class CALLABLE> static MessageHandler Callable(const CALLABLE& callable);
+
+    /// return true if a handler is bound
+    bool IsValid() const;
+    /// call the handler
+    void operator()(const Core::Ptr<Message>& msg) const;
+
+private:
+    typedef void (*thunkFunc)(const void* storage, const Core::Ptr<Message>& msg);
+
+    template<class MSG> static void functionThunk(const void* storage, const Core::Ptr<Message>& msg);
+    template<class MSG, class CLASS> static void methodThunk(const void* storage, const Core::Ptr<Message>& msg);
+    template<class MSG, class CALLABLE> static void callableThunk(const void* storage, const Core::Ptr<Message>& msg);
+
+    /// an object and member function pointer
+    template<class MSG, class CLASS> struct boundMethod {
+        CLASS* obj;
+        void (CLASS::*method)(const Core::Ptr<MSG>&);
+    };
+
+    thunkFunc thunk;
+    union {
+        void* alignDummy;
+        uint8 storage[MaxCallableSize];
+    };
+};
+
+//------------------------------------------------------------------------------
+inline
+MessageHandler::MessageHandler() :
+thunk(nullptr) {
+    // empty
+}
+
+//------------------------------------------------------------------------------
+template<class MSG> MessageHandler
+MessageHandler::Function(void(*func)(const Core::Ptr<MSG>&)) {
+    o_assert(nullptr != func);
+    MessageHandler handler;
+    handler.thunk = &functionThunk<MSG>;
+    std::memcpy(handler.storage, &func, sizeof(func));
+    return handler;
+}
+
+//------------------------------------------------------------------------------
+template<class MSG, class CLASS> MessageHandler
+MessageHandler::Method(CLASS* obj, void(CLASS::*method)(const Core::Ptr<MSG>&)) {
+    static_assert(sizeof(boundMethod<MSG,CLASS>) <= MaxCallableSize, "member function pointer too big");
+    o_assert((nullptr != obj) && (nullptr != method));
+    MessageHandler handler;
+    handler.thunk = &methodThunk<MSG,CLASS>;
+    boundMethod<MSG,CLASS> bound{ obj, method };
+    std::memcpy(handler.storage, &bound, sizeof(bound));
+    return handler;
+}
+
+//------------------------------------------------------------------------------
+template<class MSG, class CALLABLE> MessageHandler
+MessageHandler::Callable(const CALLABLE& callable) {
+    static_assert(sizeof(CALLABLE) <= MaxCallableSize, "callable too big for MessageHandler");
+    static_assert(std::is_trivially_copyable<CALLABLE>::value, "callable must be trivially copyable");
+    static_assert(std::alignment_of<CALLABLE>::value <= std::alignment_of<void*>::value, "callable alignment too big");
+    MessageHandler handler;
+    handler.thunk = &callableThunk<MSG,CALLABLE>;
+    std::memcpy(handler.storage, &callable, sizeof(callable));
+    return handler;
+}
+
+//------------------------------------------------------------------------------
+inline bool
+MessageHandler::IsValid() const {
+    return nullptr != this->thunk;
+}
+
+//------------------------------------------------------------------------------
+inline void
+MessageHandler::operator()(const Core::Ptr<Message>& msg) const {
+    o_assert(nullptr != this->thunk);
+    this->thunk(this->storage, msg);
+}
+
+//------------------------------------------------------------------------------
+template<class MSG> void
+MessageHandler::functionThunk(const void* storage, const Core::Ptr<Message>& msg) {
+    void (*func)(const Core::Ptr<MSG>&);
+    std::memcpy(&func, storage, sizeof(func));
+    func(msg.staticCast<MSG>());
+}
+
+//------------------------------------------------------------------------------
+template<class MSG, class CLASS> void
+MessageHandler::methodThunk(const void* storage, const Core::Ptr<Message>& msg) {
+    const boundMethod<MSG,CLASS>* bound = (const boundMethod<MSG,CLASS>*) storage;
+    (bound->obj->*bound->method)(msg.staticCast<MSG>());
+}
+
+//------------------------------------------------------------------------------
+template<class MSG, class CALLABLE> void
+MessageHandler::callableThunk(const void* storage, const Core::Ptr<Message>& msg) {
+    (*(const CALLABLE*)storage)(msg.staticCast<MSG>());
+}
+
+} // namespace Messaging
+} // namespace Oryol
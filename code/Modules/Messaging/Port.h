@@ -14,7 +14,8 @@
     Ports can be connected to message handling networks. 
     
     By default, Messages are forwarded through smart pointers, encoding/decoding
-    will only happen when process boundaries are crossed.
+    will only happen when process boundaries are crossed (see SocketPort
+    and ShmPort).
 */
 #include "Core/RefCounted.h"
 #include "Core/String/StringAtom.h"
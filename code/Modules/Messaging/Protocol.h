@@ -18,6 +18,14 @@ public:
     static ProtocolIdType GetProtocolId() {
         return 'BASE';
     };
+    /// get the protocol id of the base protocol of the protocol hierarchy
+    static ProtocolIdType GetBaseProtocolId() {
+        return 'BASE';
+    };
+    /// get the type bits of the message ids defined in this protocol
+    static uint64 GetMessageIdBits() {
+        return 0;
+    };
 
     /// protocol message ids
     class MessageId {
@@ -7,14 +7,32 @@
     This is a simple template class which knows how to 
     encode/decode a specific data type (the template arg) to and from
     a plain-old-data memory region.
+
+    Encode and decode calls can be chained without checking each
+    result: if a call runs out of space it returns nullptr, and
+    all following calls with a nullptr position return nullptr as well.
+    Arrays of arithmetic and enum values are copied as a single memory
+    block. Arrays of other POD types are encoded element by element,
+    so that a Serializer specialization of the element type is used.
+    If a POD type has no specialization, specialize SerializeAsBlock
+    to get the block copy for its arrays:
+
+    @code
+    template<> struct SerializeAsBlock<MyPodStruct> : std::true_type { };
+    @endcode
 */
 #include <string.h>
+#include <type_traits>
 #include "Core/Types.h"
 #include "Core/String/String.h"
 #include "Core/String/StringAtom.h"
 
 namespace Oryol {
 namespace Messaging {
+
+/// arrays of TYPE are encoded with a single memcpy (TYPE must have no Serializer specialization)
+template<typename TYPE> struct SerializeAsBlock : std::integral_constant<bool,
+    std::is_arithmetic<TYPE>::value || std::is_enum<TYPE>::value> { };
     
 class Serializer {
 public:
@@ -43,7 +61,7 @@ Serializer::EncodedSize(const TYPE& val) {
 template<typename TYPE> inline uint8*
 Serializer::Encode(const TYPE& val, uint8* dstPtr, const uint8* maxPtr) {
     static_assert(std::is_pod<TYPE>::value, "Serializer::Encode(): Type not POD, must provide specialization!");
-    if ((dstPtr + sizeof(TYPE)) <= maxPtr) {
+    if ((nullptr != dstPtr) && ((dstPtr + sizeof(TYPE)) <= maxPtr)) {
         // must copy byte-wise because of alignment restrictions
         // hopefully this will be an intrinsic
         memcpy(dstPtr, &val, sizeof(TYPE));
@@ -59,7 +77,7 @@ Serializer::Encode(const TYPE& val, uint8* dstPtr, const uint8* maxPtr) {
 template<typename TYPE> inline const uint8*
 Serializer::Decode(const uint8* srcPtr, const uint8* maxPtr, TYPE& outVal) {
     static_assert(std::is_pod<TYPE>::value, "Serializer::Encode(): Type not POD, must provide specialization!");
-    if ((srcPtr + sizeof(TYPE)) <= maxPtr) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(TYPE)) <= maxPtr)) {
         // must copy byte-wise because of alignment restrictions
         // hopefully this will be an intrinsic
         memcpy(&outVal, srcPtr, sizeof(TYPE));
@@ -80,7 +98,7 @@ Serializer::EncodedSize(const Core::String& val) {
 //------------------------------------------------------------------------------
 template<> inline uint8*
 Serializer::Encode(const Core::String& val, uint8* dstPtr, const uint8* maxPtr) {
-    if ((dstPtr + EncodedSize(val)) <= maxPtr) {
+    if ((nullptr != dstPtr) && ((dstPtr + EncodedSize(val)) <= maxPtr)) {
         const int32 len = val.Length();
         dstPtr = Serializer::Encode<int32>(len, dstPtr, maxPtr);
         o_assert(nullptr != dstPtr);
@@ -96,12 +114,12 @@ Serializer::Encode(const Core::String& val, uint8* dstPtr, const uint8* maxPtr)
 //------------------------------------------------------------------------------
 template<> inline const uint8*
 Serializer::Decode(const uint8* srcPtr, const uint8* maxPtr, Core::String& outVal) {
-    if ((srcPtr + sizeof(int32)) <= maxPtr) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(int32)) <= maxPtr)) {
         // read length
         int32 len = 0;
         srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, len);
         o_assert(nullptr != srcPtr);
-        if ((srcPtr + len) <= maxPtr) {
+        if ((len >= 0) && (len <= (maxPtr - srcPtr))) {
             // read and assign string data
             outVal.Assign((const char*)srcPtr, 0, len);
             return srcPtr + len;
@@ -120,7 +138,7 @@ Serializer::EncodedSize(const Core::StringAtom& val) {
 //------------------------------------------------------------------------------
 template<> inline uint8*
 Serializer::Encode(const Core::StringAtom& val, uint8* dstPtr, const uint8* maxPtr) {
-    if ((dstPtr + EncodedSize(val)) <= maxPtr) {
+    if ((nullptr != dstPtr) && ((dstPtr + EncodedSize(val)) <= maxPtr)) {
         const int32 len = val.Length();
         dstPtr = Serializer::Encode<int32>(len, dstPtr, maxPtr);
         o_assert(nullptr != dstPtr);
@@ -136,15 +154,14 @@ Serializer::Encode(const Core::StringAtom& val, uint8* dstPtr, const uint8* maxP
 //------------------------------------------------------------------------------
 template<> inline const uint8*
 Serializer::Decode(const uint8* srcPtr, const uint8* maxPtr, Core::StringAtom& outVal) {
-    if ((srcPtr + sizeof(int32)) <= maxPtr) {
+    if ((nullptr != srcPtr) && ((srcPtr + sizeof(int32)) <= maxPtr)) {
         // read length
         int32 len = 0;
         srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, len);
         o_assert(nullptr != srcPtr);
-        if ((srcPtr + len) <= maxPtr) {
-            /// @todo: meh, must create temp string
-            Core::String str((const char*) srcPtr, 0, len);
-            outVal = str;
+        if ((len >= 0) && (len <= (maxPtr - srcPtr))) {
+            // intern directly from the source buffer
+            outVal = Core::StringAtom((const char*) srcPtr, len);
             return srcPtr + len;
         }
     }
@@ -155,64 +172,91 @@ Serializer::Decode(const uint8* srcPtr, const uint8* maxPtr, Core::StringAtom& o
 //------------------------------------------------------------------------------
 template<typename TYPE> inline int32
 Serializer::EncodedArraySize(const Core::Array<TYPE>& vals) {
-    if (vals.Size() > 0) {
+    // the number of elements is always written, also for empty arrays
+    if (SerializeAsBlock<TYPE>::value) {
+        return sizeof(int32) + vals.Size() * sizeof(TYPE);
+    }
+    else {
         int32 size = sizeof(int32);
         for (const TYPE& val : vals) {
             size += Serializer::EncodedSize<TYPE>(val);
         }
         return size;
     }
-    else {
-        // if the array is empty, we still need to write the number of elements
-        // (which is 0)
-        return sizeof(int32);
-    }
 }
     
 //------------------------------------------------------------------------------
+/**
+ Each element checks the remaining space itself, so the array
+ is only traversed once.
+*/
 template<typename TYPE> inline uint8*
 Serializer::EncodeArray(const Core::Array<TYPE>& vals, uint8* dstPtr, const uint8* maxPtr) {
-    if ((dstPtr + EncodedArraySize<TYPE>(vals)) <= maxPtr) {
-        const int32 numElements = vals.Size();
-        dstPtr = Serializer::Encode<int32>(numElements, dstPtr, maxPtr);
-        if (numElements > 0) {
-            for (const TYPE& val : vals) {
-                dstPtr = Serializer::Encode<TYPE>(val, dstPtr, maxPtr);
-                o_assert(nullptr != dstPtr);
+    const int32 numElements = vals.Size();
+    dstPtr = Serializer::Encode<int32>(numElements, dstPtr, maxPtr);
+    if ((nullptr == dstPtr) || (0 == numElements)) {
+        return dstPtr;
+    }
+    if (SerializeAsBlock<TYPE>::value) {
+        const int32 numBytes = numElements * sizeof(TYPE);
+        if (numBytes <= (maxPtr - dstPtr)) {
+            memcpy(dstPtr, &vals[0], numBytes);
+            return dstPtr + numBytes;
+        }
+        // not enough space
+        return nullptr;
+    }
+    else {
+        for (const TYPE& val : vals) {
+            dstPtr = Serializer::Encode<TYPE>(val, dstPtr, maxPtr);
+            if (nullptr == dstPtr) {
+                // not enough space
+                return nullptr;
             }
         }
-        // success
         return dstPtr;
     }
-    // fallthrough: not enough space
-    return nullptr;
 }
     
 //------------------------------------------------------------------------------
 template<typename TYPE> inline const uint8*
 Serializer::DecodeArray(const uint8* srcPtr, const uint8* maxPtr, Core::Array<TYPE>& outVals) {
+    static_assert(!SerializeAsBlock<TYPE>::value || std::is_pod<TYPE>::value, "Serializer::DecodeArray(): SerializeAsBlock type not POD!");
     o_assert(outVals.Size() == 0);
-    if ((srcPtr + sizeof(int32)) < maxPtr) {
-        // read number of elements
-        int32 numElements = 0;
-        srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, numElements);
-        if (numElements > 0) {
-            outVals.Reserve(numElements);
-            for (int32 i = 0; i < numElements; i++) {
-                TYPE val;
-                srcPtr = Serializer::Decode<TYPE>(srcPtr, maxPtr, val);
-                if (nullptr == srcPtr) {
-                    // not enough data
-                    outVals.Clear();
-                    return nullptr;
-                }
-                outVals.AddBack(val);
+    // read number of elements
+    int32 numElements = 0;
+    srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, numElements);
+    if ((nullptr == srcPtr) || (numElements < 0)) {
+        // not enough data
+        return nullptr;
+    }
+    if (0 == numElements) {
+        return srcPtr;
+    }
+    if (SerializeAsBlock<TYPE>::value) {
+        if (int64(numElements) * int64(sizeof(TYPE)) <= int64(maxPtr - srcPtr)) {
+            outVals.AddBack((const TYPE*) srcPtr, numElements);
+            return srcPtr + numElements * sizeof(TYPE);
+        }
+        // not enough data
+        return nullptr;
+    }
+    else if (numElements <= (maxPtr - srcPtr)) {
+        // (each element takes at least one byte, this rejects bogus counts before allocating)
+        outVals.Reserve(numElements);
+        for (int32 i = 0; i < numElements; i++) {
+            TYPE val;
+            srcPtr = Serializer::Decode<TYPE>(srcPtr, maxPtr, val);
+            if (nullptr == srcPtr) {
+                // not enough data
+                outVals.Clear();
+                return nullptr;
             }
+            outVals.AddBack(std::move(val));
         }
-        // success
         return srcPtr;
     }
-    // fallthrough not enough data
+    // fallthrough: not enough data
     return nullptr;
 }
 
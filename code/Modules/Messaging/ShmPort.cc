@@ -0,0 +1,377 @@
+//------------------------------------------------------------------------------
+//  ShmPort.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "ShmPort.h"
+#include "Messaging/Serializer.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#include <new>
+#if ORYOL_LINUX || ORYOL_MACOS
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Oryol {
+namespace Messaging {
+
+OryolClassImpl(ShmPort);
+
+using namespace Core;
+
+static const uint32 RegionMagic = 'OSHM';
+
+//------------------------------------------------------------------------------
+ShmPort::ShmPort(const MessageCodec::ProtocolFactory& factory_, const Ptr<Port>& forwardingPort_) :
+factory(factory_),
+forwardingPort(forwardingPort_),
+isOwner(false),
+mapping(nullptr),
+mappingSize(0),
+ringCapacity(0),
+sendRing(nullptr),
+sendData(nullptr),
+recvRing(nullptr),
+recvData(nullptr),
+sendOffset(0),
+numBytesSent(0),
+numBytesReceived(0) {
+    o_assert(nullptr != factory_.create);
+}
+
+//------------------------------------------------------------------------------
+ShmPort::~ShmPort() {
+    this->Close();
+}
+
+//------------------------------------------------------------------------------
+bool
+ShmPort::Setup(const String& name_, int32 ringCapacity_) {
+    o_assert(!this->IsOpen());
+    o_assert(ringCapacity_ > MessageCodec::HeaderSize);
+    #if ORYOL_LINUX || ORYOL_MACOS
+    // ring positions are masked, so the capacity must be a power of 2
+    int32 capacity = 1024;
+    while (capacity < ringCapacity_) {
+        capacity <<= 1;
+    }
+    const int32 size = sizeof(regionHeader) + 2 * capacity;
+    // an existing region may still be in use by another process
+    const int shmFd = ::shm_open(name_.AsCStr(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if ((shmFd < 0) && (EEXIST == errno)) {
+        Log::Warn("ShmPort: '%s' already exists (use ShmPort::Unlink() to remove a stale region)\n", name_.AsCStr());
+        return false;
+    }
+    if ((shmFd < 0) || (::ftruncate(shmFd, size) < 0)) {
+        Log::Warn("ShmPort: failed to create '%s' (%s)\n", name_.AsCStr(), std::strerror(errno));
+        if (shmFd >= 0) {
+            ::close(shmFd);
+            ::shm_unlink(name_.AsCStr());
+        }
+        return false;
+    }
+    this->name = name_;
+    if (!this->map(shmFd, size, true)) {
+        ::shm_unlink(name_.AsCStr());
+        return false;
+    }
+    regionHeader* header = (regionHeader*) this->mapping;
+    for (int32 i = 0; i < 2; i++) {
+        new(&header->rings[i].writePos) std::atomic<uint32>(0);
+        new(&header->rings[i].readPos) std::atomic<uint32>(0);
+    }
+    header->ringCapacity = capacity;
+    this->ringCapacity = capacity;
+    // the magic number is written last, so Open() doesn't see a half-initialized header
+    std::atomic_thread_fence(std::memory_order_release);
+    header->magic = RegionMagic;
+    this->sendRing = &header->rings[0];
+    this->recvRing = &header->rings[1];
+    this->sendData = (uint8*) (header + 1);
+    this->recvData = this->sendData + capacity;
+    return true;
+    #else
+    Log::Warn("ShmPort: not supported on this platform\n");
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+ShmPort::Open(const String& name_) {
+    o_assert(!this->IsOpen());
+    #if ORYOL_LINUX || ORYOL_MACOS
+    const int shmFd = ::shm_open(name_.AsCStr(), O_RDWR, 0600);
+    struct stat st;
+    if ((shmFd < 0) || (::fstat(shmFd, &st) < 0)) {
+        Log::Warn("ShmPort: failed to open '%s' (%s)\n", name_.AsCStr(), std::strerror(errno));
+        if (shmFd >= 0) {
+            ::close(shmFd);
+        }
+        return false;
+    }
+    if (st.st_size <= int32(sizeof(regionHeader))) {
+        Log::Warn("ShmPort: '%s' isn't a message region\n", name_.AsCStr());
+        ::close(shmFd);
+        return false;
+    }
+    this->name = name_;
+    if (!this->map(shmFd, int32(st.st_size), false)) {
+        return false;
+    }
+    const regionHeader* header = (const regionHeader*) this->mapping;
+    const int32 capacity = header->ringCapacity;
+    if ((RegionMagic != header->magic) || (this->mappingSize != int32(sizeof(regionHeader) + 2 * capacity))) {
+        Log::Warn("ShmPort: '%s' isn't a message region\n", name_.AsCStr());
+        this->Close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    this->ringCapacity = capacity;
+    // the other side of the rings created in Setup()
+    this->sendRing = &((regionHeader*) this->mapping)->rings[1];
+    this->recvRing = &((regionHeader*) this->mapping)->rings[0];
+    this->recvData = (const uint8*) (header + 1);
+    this->sendData = (uint8*) (header + 1) + capacity;
+    return true;
+    #else
+    Log::Warn("ShmPort: not supported on this platform\n");
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+ShmPort::Unlink(const String& name_) {
+    #if ORYOL_LINUX || ORYOL_MACOS
+    return 0 == ::shm_unlink(name_.AsCStr());
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+ShmPort::map(int shmFd, int32 size, bool owner) {
+    #if ORYOL_LINUX || ORYOL_MACOS
+    void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, shmFd, 0);
+    // the mapping stays valid after the descriptor is closed
+    ::close(shmFd);
+    if (MAP_FAILED == ptr) {
+        Log::Warn("ShmPort: failed to map '%s' (%s)\n", this->name.AsCStr(), std::strerror(errno));
+        this->name.Clear();
+        return false;
+    }
+    this->mapping = ptr;
+    this->mappingSize = size;
+    this->isOwner = owner;
+    return true;
+    #else
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+ShmPort::Close() {
+    #if ORYOL_LINUX || ORYOL_MACOS
+    if (nullptr != this->mapping) {
+        ::munmap(this->mapping, this->mappingSize);
+        if (this->isOwner) {
+            ::shm_unlink(this->name.AsCStr());
+        }
+    }
+    #endif
+    this->mapping = nullptr;
+    this->mappingSize = 0;
+    this->ringCapacity = 0;
+    this->sendRing = nullptr;
+    this->sendData = nullptr;
+    this->recvRing = nullptr;
+    this->recvData = nullptr;
+    this->isOwner = false;
+    this->name.Clear();
+}
+
+//------------------------------------------------------------------------------
+bool
+ShmPort::IsOpen() const {
+    return nullptr != this->mapping;
+}
+
+//------------------------------------------------------------------------------
+int32
+ShmPort::RingCapacity() const {
+    return this->ringCapacity;
+}
+
+//------------------------------------------------------------------------------
+/**
+ The ring capacity is only known once the region is open, frames
+ which were put before and don't fit are dropped in send().
+*/
+bool
+ShmPort::Put(const Ptr<Message>& msg) {
+    if (this->sendCodec.Size() >= MaxPendingBytes) {
+        // push back until the batch has been sent
+        return false;
+    }
+    if (!msg->IsSerializable()) {
+        Log::Warn("ShmPort: message not serializable, dropped\n");
+        return false;
+    }
+    if (!this->sendCodec.Encode(msg, this->ringCapacity)) {
+        Log::Warn("ShmPort: message bigger than the ring capacity of '%s', dropped\n", this->name.AsCStr());
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+ShmPort::DoWork() {
+    if (this->IsOpen()) {
+        this->send();
+        this->receive();
+    }
+    if (this->forwardingPort.isValid()) {
+        this->forwardingPort->DoWork();
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ Consecutive frames are copied with one memcpy. A frame which doesn't
+ fit between the write position and the end of the ring isn't split,
+ instead the rest of the ring is filled with a padding frame (which
+ has an invalid message id and is skipped by the decoder), or simply
+ skipped if it is too small for a frame header.
+*/
+void
+ShmPort::send() {
+    const uint32 capacity = uint32(this->ringCapacity);
+    const uint32 mask = capacity - 1;
+    const uint8* data = this->sendCodec.Data();
+    const int32 size = this->sendCodec.Size();
+    uint32 writePos = this->sendRing->writePos.load(std::memory_order_relaxed);
+    const uint32 readPos = this->sendRing->readPos.load(std::memory_order_acquire);
+    int32 frameSize = 0;
+    while (this->sendOffset < size) {
+        Serializer::Decode<int32>(data + this->sendOffset + 8, data + size, frameSize);
+        frameSize += MessageCodec::HeaderSize;
+        if (uint32(frameSize) > capacity) {
+            Log::Warn("ShmPort: message bigger than the ring capacity of '%s', dropped\n", this->name.AsCStr());
+            this->sendOffset += frameSize;
+            continue;
+        }
+        const uint32 numFree = capacity - (writePos - readPos);
+        const uint32 numTail = capacity - (writePos & mask);
+        if (uint32(frameSize) > numTail) {
+            if (numFree < numTail) {
+                // ring is full, try again in the next DoWork()
+                break;
+            }
+            if (numTail >= uint32(MessageCodec::HeaderSize)) {
+                uint8* padPtr = this->sendData + (writePos & mask);
+                const uint8* padEnd = padPtr + numTail;
+                padPtr = Serializer::Encode<ProtocolIdType>(InvalidProtocolId, padPtr, padEnd);
+                padPtr = Serializer::Encode<MessageIdType>(InvalidMessageId, padPtr, padEnd);
+                Serializer::Encode<int32>(numTail - MessageCodec::HeaderSize, padPtr, padEnd);
+            }
+            writePos += numTail;
+            this->numBytesSent += numTail;
+            continue;
+        }
+        const uint32 maxBytes = numFree < numTail ? numFree : numTail;
+        if (uint32(frameSize) > maxBytes) {
+            break;
+        }
+        // gather following frames which fit as well
+        int32 numBytes = frameSize;
+        while ((this->sendOffset + numBytes) < size) {
+            Serializer::Decode<int32>(data + this->sendOffset + numBytes + 8, data + size, frameSize);
+            frameSize += MessageCodec::HeaderSize;
+            if (uint32(numBytes + frameSize) > maxBytes) {
+                break;
+            }
+            numBytes += frameSize;
+        }
+        Memory::Copy(data + this->sendOffset, this->sendData + (writePos & mask), numBytes);
+        writePos += numBytes;
+        this->sendOffset += numBytes;
+        this->numBytesSent += numBytes;
+    }
+    this->sendRing->writePos.store(writePos, std::memory_order_release);
+    if (this->sendOffset == size) {
+        this->sendCodec.Clear();
+        this->sendOffset = 0;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ The writer only writes complete frames, so everything between the
+ read and write position (up to the end of the ring) can be decoded
+ in one go, right from the shared memory.
+*/
+void
+ShmPort::receive() {
+    const uint32 capacity = uint32(this->ringCapacity);
+    const uint32 mask = capacity - 1;
+    uint32 readPos = this->recvRing->readPos.load(std::memory_order_relaxed);
+    const uint32 writePos = this->recvRing->writePos.load(std::memory_order_acquire);
+    while (readPos != writePos) {
+        const uint32 offset = readPos & mask;
+        const uint32 numTail = capacity - offset;
+        if (numTail < uint32(MessageCodec::HeaderSize)) {
+            // the writer skipped the end of the ring
+            readPos += numTail;
+            this->numBytesReceived += numTail;
+            continue;
+        }
+        const uint32 numBytes = (writePos - readPos) < numTail ? (writePos - readPos) : numTail;
+        int32 numConsumed = 0;
+        if (!MessageCodec::Decode(this->factory, this->recvData + offset, numBytes, this->recvQueue, &numConsumed) ||
+            (uint32(numConsumed) != numBytes)) {
+            Log::Warn("ShmPort: corrupt message data in '%s'\n", this->name.AsCStr());
+            readPos = writePos;
+            break;
+        }
+        readPos += numBytes;
+        this->numBytesReceived += numBytes;
+    }
+    this->recvRing->readPos.store(readPos, std::memory_order_release);
+    if (this->forwardingPort.isValid()) {
+        while (!this->recvQueue.Empty()) {
+            this->forwardingPort->Put(this->recvQueue.Dequeue());
+        }
+    }
+    else {
+        this->recvQueue.Clear();
+    }
+}
+
+//------------------------------------------------------------------------------
+int64
+ShmPort::NumBytesSent() const {
+    return this->numBytesSent;
+}
+
+//------------------------------------------------------------------------------
+int64
+ShmPort::NumBytesReceived() const {
+    return this->numBytesReceived;
+}
+
+//------------------------------------------------------------------------------
+int32
+ShmPort::NumBytesPending() const {
+    return this->sendCodec.Size() - this->sendOffset;
+}
+
+} // namespace Messaging
+} // namespace Oryol
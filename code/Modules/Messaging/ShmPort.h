@@ -0,0 +1,125 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Messaging::ShmPort
+    @brief exchange messages with another process through shared memory
+    
+    A ShmPort works like a SocketPort, but transfers the encoded messages
+    through a named shared-memory region with one ring buffer per 
+    direction. One process sets up the region, the other process opens
+    it by name:
+    
+    @code
+    // process A
+    Ptr<ShmPort> port = ShmPort::Create(MessageCodec::FactoryOf<MyProtocol>(), dispatcher);
+    port->Setup("/myapp.msgs", 4 * 1024 * 1024);
+    // process B
+    Ptr<ShmPort> port = ShmPort::Create(MessageCodec::FactoryOf<MyProtocol>(), dispatcher);
+    port->Open("/myapp.msgs");
+    port->Put(msg);
+    @endcode
+    
+    Put() encodes the message into a local batch, DoWork() copies the
+    batch into the ring as far as there is room, and decodes incoming 
+    messages directly from the ring memory (no copy into a receive 
+    buffer), and forwards them to the forwarding port. Frames never
+    wrap around the end of a ring, so that each frame is contiguous,
+    the end of the ring is skipped instead. The read and write positions
+    of each ring are atomic counters, there's no locking.
+    
+    Put() rejects a message whose frame doesn't fit into the ring
+    capacity (and, like the SocketPort, any message while the unsent
+    batch holds MaxPendingBytes). Setup() fails if a region with the
+    same name exists, a stale region left behind by a crashed process
+    must be removed explicitly with Unlink(). As with the SocketPort,
+    the state of a sent message object isn't updated by the other
+    process. ShmPorts are only available on Linux and OSX.
+*/
+#include "Messaging/Port.h"
+#include "Messaging/MessageCodec.h"
+#include "Core/String/String.h"
+#include <atomic>
+
+namespace Oryol {
+namespace Messaging {
+    
+class ShmPort : public Port {
+    OryolClassDecl(ShmPort);
+public:
+    /// constructor with the protocol factory for decoding, and the port which receives incoming messages
+    ShmPort(const MessageCodec::ProtocolFactory& factory, const Core::Ptr<Port>& forwardingPort);
+    /// destructor
+    virtual ~ShmPort();
+    
+    /// create a shared-memory region (name must start with a slash), capacity is rounded up to a power of 2
+    bool Setup(const Core::String& name, int32 ringCapacity=DefaultRingCapacity);
+    /// open a shared-memory region created by another process
+    bool Open(const Core::String& name);
+    /// remove a stale shared-memory region (e.g. left behind by a crashed process), returns false if it doesn't exist
+    static bool Unlink(const Core::String& name);
+    /// unmap the shared-memory region (and remove it if created by Setup)
+    void Close();
+    /// return true if the shared-memory region is mapped
+    bool IsOpen() const;
+    /// get the capacity of each ring in bytes
+    int32 RingCapacity() const;
+    
+    /// put a message into the port, sent on the next DoWork(), returns false if the batch is full, or the message too big or not serializable
+    virtual bool Put(const Core::Ptr<Message>& msg) override;
+    /// send pending messages, receive and forward incoming messages
+    virtual void DoWork() override;
+    
+    /// get the number of bytes written to the send ring (including padding)
+    int64 NumBytesSent() const;
+    /// get the number of bytes read from the receive ring (including padding)
+    int64 NumBytesReceived() const;
+    /// get the number of bytes waiting for room in the ring
+    int32 NumBytesPending() const;
+
+    /// default capacity of each ring
+    static const int32 DefaultRingCapacity = 1024 * 1024;
+    /// Put() refuses messages while the unsent batch is bigger than this
+    static const int32 MaxPendingBytes = 16 * 1024 * 1024;
+
+private:
+    /// read and write position of a ring, on separate cache lines
+    struct ringHeader {
+        std::atomic<uint32> writePos;
+        uint8 pad0[60];
+        std::atomic<uint32> readPos;
+        uint8 pad1[60];
+    };
+    /// the header at the start of the shared-memory region
+    struct regionHeader {
+        uint32 magic;
+        int32 ringCapacity;
+        uint8 pad[56];
+        ringHeader rings[2];
+    };
+    /// map the region and setup the ring pointers
+    bool map(int shmFd, int32 size, bool owner);
+    /// copy as many frames from the batch into the send ring as possible
+    void send();
+    /// decode and forward messages from the receive ring
+    void receive();
+    
+    MessageCodec::ProtocolFactory factory;
+    Core::Ptr<Port> forwardingPort;
+    Core::String name;
+    bool isOwner;
+    void* mapping;
+    int32 mappingSize;
+    int32 ringCapacity;
+    ringHeader* sendRing;
+    uint8* sendData;
+    ringHeader* recvRing;
+    const uint8* recvData;
+    MessageCodec sendCodec;
+    int32 sendOffset;
+    Core::Queue<Core::Ptr<Message>> recvQueue;
+    int64 numBytesSent;
+    int64 numBytesReceived;
+};
+    
+} // namespace Messaging
+} // namespace Oryol
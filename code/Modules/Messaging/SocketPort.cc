@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+//  SocketPort.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "SocketPort.h"
+#include "Core/Memory/Memory.h"
+#include "Core/Log.h"
+#if ORYOL_LINUX || ORYOL_MACOS
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/stat.h>
+#endif
+
+namespace Oryol {
+namespace Messaging {
+
+OryolClassImpl(SocketPort);
+
+using namespace Core;
+
+//------------------------------------------------------------------------------
+SocketPort::SocketPort(const MessageCodec::ProtocolFactory& factory_, const Ptr<Port>& forwardingPort_) :
+factory(factory_),
+forwardingPort(forwardingPort_),
+listenFd(-1),
+fd(-1),
+sendOffset(0),
+recvBuffer(nullptr),
+recvCapacity(0),
+recvSize(0),
+numBytesSent(0),
+numBytesReceived(0) {
+    o_assert(nullptr != factory_.create);
+}
+
+//------------------------------------------------------------------------------
+SocketPort::~SocketPort() {
+    this->Close();
+    if (nullptr != this->recvBuffer) {
+        Memory::Free(this->recvBuffer);
+        this->recvBuffer = nullptr;
+    }
+}
+
+//------------------------------------------------------------------------------
+/**
+ A socket file left behind by a crashed process would make bind() fail.
+ It is only removed if it really is a socket, and nobody listens on it
+ (connecting is refused), a regular file or the socket of a live
+ process is never touched. Returns false if something else is in the way.
+*/
+#if ORYOL_LINUX || ORYOL_MACOS
+static bool
+removeStaleSocket(const sockaddr_un& addr) {
+    struct stat st;
+    if (::lstat(addr.sun_path, &st) < 0) {
+        // nothing there
+        return ENOENT == errno;
+    }
+    if (!S_ISSOCK(st.st_mode)) {
+        return false;
+    }
+    const int probeFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probeFd < 0) {
+        return false;
+    }
+    const bool refused = (::connect(probeFd, (const sockaddr*) &addr, sizeof(addr)) < 0) && (ECONNREFUSED == errno);
+    ::close(probeFd);
+    return refused && (0 == ::unlink(addr.sun_path));
+}
+#endif
+
+//------------------------------------------------------------------------------
+bool
+SocketPort::Listen(const String& path) {
+    o_assert((this->listenFd < 0) && (this->fd < 0));
+    #if ORYOL_LINUX || ORYOL_MACOS
+    sockaddr_un addr;
+    Memory::Clear(&addr, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.Length() >= int32(sizeof(addr.sun_path))) {
+        Log::Warn("SocketPort: socket path '%s' too long\n", path.AsCStr());
+        return false;
+    }
+    std::strcpy(addr.sun_path, path.AsCStr());
+    if (!removeStaleSocket(addr)) {
+        Log::Warn("SocketPort: '%s' already exists and is not a stale socket\n", path.AsCStr());
+        return false;
+    }
+    this->listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((this->listenFd < 0) ||
+        (::bind(this->listenFd, (sockaddr*) &addr, sizeof(addr)) < 0) ||
+        (::listen(this->listenFd, 1) < 0)) {
+        Log::Warn("SocketPort: failed to listen on '%s' (%s)\n", path.AsCStr(), std::strerror(errno));
+        this->Close();
+        return false;
+    }
+    ::fcntl(this->listenFd, F_SETFL, ::fcntl(this->listenFd, F_GETFL, 0) | O_NONBLOCK);
+    this->listenPath = path;
+    return true;
+    #else
+    Log::Warn("SocketPort: not supported on this platform\n");
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+SocketPort::Connect(const String& path) {
+    o_assert((this->listenFd < 0) && (this->fd < 0));
+    #if ORYOL_LINUX || ORYOL_MACOS
+    sockaddr_un addr;
+    Memory::Clear(&addr, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path.Length() >= int32(sizeof(addr.sun_path))) {
+        Log::Warn("SocketPort: socket path '%s' too long\n", path.AsCStr());
+        return false;
+    }
+    std::strcpy(addr.sun_path, path.AsCStr());
+    const int socketFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if ((socketFd < 0) || (::connect(socketFd, (sockaddr*) &addr, sizeof(addr)) < 0)) {
+        Log::Warn("SocketPort: failed to connect to '%s' (%s)\n", path.AsCStr(), std::strerror(errno));
+        if (socketFd >= 0) {
+            ::close(socketFd);
+        }
+        return false;
+    }
+    this->setupSocket(socketFd);
+    return true;
+    #else
+    Log::Warn("SocketPort: not supported on this platform\n");
+    return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+SocketPort::setupSocket(int socketFd) {
+    #if ORYOL_LINUX || ORYOL_MACOS
+    ::fcntl(socketFd, F_SETFL, ::fcntl(socketFd, F_GETFL, 0) | O_NONBLOCK);
+    #if ORYOL_MACOS
+    // don't raise SIGPIPE when the other process is gone
+    int noSigPipe = 1;
+    ::setsockopt(socketFd, SOL_SOCKET, SO_NOSIGPIPE, &noSigPipe, sizeof(noSigPipe));
+    #endif
+    this->fd = socketFd;
+    this->recvSize = 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+SocketPort::Close() {
+    #if ORYOL_LINUX || ORYOL_MACOS
+    if (this->fd >= 0) {
+        ::close(this->fd);
+        this->fd = -1;
+    }
+    this->sendCodec.Clear();
+    this->sendOffset = 0;
+    if (this->listenFd >= 0) {
+        ::close(this->listenFd);
+        this->listenFd = -1;
+        ::unlink(this->listenPath.AsCStr());
+        this->listenPath.Clear();
+    }
+    #endif
+}
+
+//------------------------------------------------------------------------------
+void
+SocketPort::disconnect(const char* reason) {
+    Log::Info("SocketPort: connection closed (%s)\n", reason);
+    #if ORYOL_LINUX || ORYOL_MACOS
+    ::close(this->fd);
+    #endif
+    this->fd = -1;
+    this->recvSize = 0;
+    // a partially sent frame would corrupt the next connection
+    this->sendCodec.Clear();
+    this->sendOffset = 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+SocketPort::IsConnected() const {
+    return this->fd >= 0;
+}
+
+//------------------------------------------------------------------------------
+bool
+SocketPort::Put(const Ptr<Message>& msg) {
+    if (this->sendCodec.Size() >= MaxPendingBytes) {
+        // push back until the batch has been sent
+        return false;
+    }
+    if (!msg->IsSerializable()) {
+        Log::Warn("SocketPort: message not serializable, dropped\n");
+        return false;
+    }
+    if (!this->sendCodec.Encode(msg, MaxFrameSize)) {
+        Log::Warn("SocketPort: message bigger than MaxFrameSize, dropped\n");
+        return false;
+    }
+    return true;
+}
+
+//------------------------------------------------------------------------------
+void
+SocketPort::DoWork() {
+    #if ORYOL_LINUX || ORYOL_MACOS
+    if ((this->fd < 0) && (this->listenFd >= 0)) {
+        const int socketFd = ::accept(this->listenFd, nullptr, nullptr);
+        if (socketFd >= 0) {
+            this->setupSocket(socketFd);
+        }
+    }
+    if (this->fd >= 0) {
+        this->send();
+    }
+    if (this->fd >= 0) {
+        this->receive();
+    }
+    #endif
+    if (this->forwardingPort.isValid()) {
+        this->forwardingPort->DoWork();
+    }
+}
+
+//------------------------------------------------------------------------------
+void
+SocketPort::send() {
+    #if ORYOL_LINUX || ORYOL_MACOS
+    #if ORYOL_LINUX
+    const int flags = MSG_NOSIGNAL;
+    #else
+    const int flags = 0;
+    #endif
+    while (this->sendOffset < this->sendCodec.Size()) {
+        const ssize_t res = ::send(this->fd, this->sendCodec.Data() + this->sendOffset, this->sendCodec.Size() - this->sendOffset, flags);
+        if (res > 0) {
+            this->sendOffset += int32(res);
+            this->numBytesSent += res;
+        }
+        else if ((res < 0) && ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno))) {
+            // socket buffer is full, try again in the next DoWork()
+            return;
+        }
+        else {
+            this->disconnect(std::strerror(errno));
+            return;
+        }
+    }
+    // the whole batch has been sent
+    this->sendCodec.Clear();
+    this->sendOffset = 0;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+/**
+ Complete frames are decoded right from the receive buffer, only the
+ start of an incomplete frame is moved to the front of the buffer.
+*/
+void
+SocketPort::receive() {
+    #if ORYOL_LINUX || ORYOL_MACOS
+    for (;;) {
+        if (this->recvSize == this->recvCapacity) {
+            // an incomplete frame fills the whole buffer
+            if (this->recvCapacity >= MaxFrameSize) {
+                this->disconnect("frame too big");
+                return;
+            }
+            this->recvCapacity = this->recvCapacity > 0 ? this->recvCapacity * 2 : 64 * 1024;
+            this->recvBuffer = (uint8*) Memory::ReAlloc(this->recvBuffer, this->recvCapacity);
+        }
+        const ssize_t res = ::recv(this->fd, this->recvBuffer + this->recvSize, this->recvCapacity - this->recvSize, 0);
+        if (res > 0) {
+            this->recvSize += int32(res);
+            this->numBytesReceived += res;
+            int32 numConsumed = 0;
+            if (!MessageCodec::Decode(this->factory, this->recvBuffer, this->recvSize, this->recvQueue, &numConsumed)) {
+                this->disconnect("corrupt message data");
+                break;
+            }
+            if (numConsumed > 0) {
+                this->recvSize -= numConsumed;
+                if (this->recvSize > 0) {
+                    Memory::Move(this->recvBuffer + numConsumed, this->recvBuffer, this->recvSize);
+                }
+            }
+        }
+        else if (0 == res) {
+            this->disconnect("closed by other process");
+            break;
+        }
+        else if ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (EINTR == errno)) {
+            break;
+        }
+        else {
+            this->disconnect(std::strerror(errno));
+            break;
+        }
+    }
+    #endif
+    if (this->forwardingPort.isValid()) {
+        while (!this->recvQueue.Empty()) {
+            this->forwardingPort->Put(this->recvQueue.Dequeue());
+        }
+    }
+    else {
+        this->recvQueue.Clear();
+    }
+}
+
+//------------------------------------------------------------------------------
+int64
+SocketPort::NumBytesSent() const {
+    return this->numBytesSent;
+}
+
+//------------------------------------------------------------------------------
+int64
+SocketPort::NumBytesReceived() const {
+    return this->numBytesReceived;
+}
+
+//------------------------------------------------------------------------------
+int32
+SocketPort::NumBytesPending() const {
+    return this->sendCodec.Size() - this->sendOffset;
+}
+
+} // namespace Messaging
+} // namespace Oryol
@@ -0,0 +1,103 @@
+#pragma once
+//------------------------------------------------------------------------------
+/**
+    @class Oryol::Messaging::SocketPort
+    @brief exchange messages with another process over a Unix domain socket
+    
+    A SocketPort connects to a SocketPort in another process through a
+    Unix domain socket: one side listens on a socket path, the other
+    side connects to it. Messages put into the port are encoded into
+    a batch (see MessageCodec), DoWork() sends the batch, and receives
+    incoming messages, decodes them through the protocol factory and
+    forwards them to the forwarding port:
+    
+    @code
+    // process A
+    Ptr<SocketPort> port = SocketPort::Create(MessageCodec::FactoryOf<MyProtocol>(), dispatcher);
+    port->Listen("/tmp/myapp.sock");
+    // process B
+    Ptr<SocketPort> port = SocketPort::Create(MessageCodec::FactoryOf<MyProtocol>(), dispatcher);
+    port->Connect("/tmp/myapp.sock");
+    port->Put(msg);
+    @endcode
+    
+    The socket is non-blocking, DoWork() never waits, messages which
+    can't be sent yet stay in the batch. Once the batch holds
+    MaxPendingBytes, Put() returns false until it has been sent, and
+    when the connection is lost, the unsent batch is dropped. Incoming
+    frames are decoded directly from the receive buffer.
+    
+    Only the encoded message crosses the process boundary, the state
+    of the sent message object (Handled, Cancelled) is not updated by
+    the other process, results must be sent back as messages.
+    
+    SocketPorts are only available on Linux and OSX.
+*/
+#include "Messaging/Port.h"
+#include "Messaging/MessageCodec.h"
+#include "Core/String/String.h"
+
+namespace Oryol {
+namespace Messaging {
+    
+class SocketPort : public Port {
+    OryolClassDecl(SocketPort);
+public:
+    /// constructor with the protocol factory for decoding, and the port which receives incoming messages
+    SocketPort(const MessageCodec::ProtocolFactory& factory, const Core::Ptr<Port>& forwardingPort);
+    /// destructor
+    virtual ~SocketPort();
+    
+    /// listen on a socket path for the other process to connect, returns false on error (only a stale socket file is replaced)
+    bool Listen(const Core::String& path);
+    /// connect to the socket path of a listening SocketPort, returns false on error
+    bool Connect(const Core::String& path);
+    /// close the connection (and stop listening)
+    void Close();
+    /// return true if connected to the other process
+    bool IsConnected() const;
+    
+    /// put a message into the port, sent on the next DoWork(), returns false if the batch is full, or the message too big or not serializable
+    virtual bool Put(const Core::Ptr<Message>& msg) override;
+    /// send pending messages, receive and forward incoming messages
+    virtual void DoWork() override;
+    
+    /// get the number of sent bytes
+    int64 NumBytesSent() const;
+    /// get the number of received bytes
+    int64 NumBytesReceived() const;
+    /// get the number of bytes waiting to be sent
+    int32 NumBytesPending() const;
+
+    /// upper limit for the size of a sent or received frame
+    static const int32 MaxFrameSize = 64 * 1024 * 1024;
+    /// Put() refuses messages while the unsent batch is bigger than this
+    static const int32 MaxPendingBytes = 16 * 1024 * 1024;
+
+private:
+    /// configure a connected socket
+    void setupSocket(int socketFd);
+    /// close the connection after an error
+    void disconnect(const char* reason);
+    /// send as much of the batch as possible
+    void send();
+    /// receive and forward messages
+    void receive();
+    
+    MessageCodec::ProtocolFactory factory;
+    Core::Ptr<Port> forwardingPort;
+    Core::String listenPath;
+    int listenFd;
+    int fd;
+    MessageCodec sendCodec;
+    int32 sendOffset;
+    uint8* recvBuffer;
+    int32 recvCapacity;
+    int32 recvSize;
+    Core::Queue<Core::Ptr<Message>> recvQueue;
+    int64 numBytesSent;
+    int64 numBytesReceived;
+};
+    
+} // namespace Messaging
+} // namespace Oryol
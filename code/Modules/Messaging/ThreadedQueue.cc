@@ -20,6 +20,11 @@ using namespace Core;
 */
 ThreadedQueue::ThreadedQueue() :
 tickDuration(0),
+#if ORYOL_HAS_THREADS
+multipleProducers(false),
+#endif
+queueDepth(0),
+highWaterMark(0),
 threadStarted(false),
 threadStopRequested(false),
 threadStopped(false) {
@@ -32,6 +37,11 @@ threadStopped(false) {
 ThreadedQueue::ThreadedQueue(const Ptr<Port>& port_) :
 tickDuration(0),
 forwardingPort(port_),
+#if ORYOL_HAS_THREADS
+multipleProducers(false),
+#endif
+queueDepth(0),
+highWaterMark(0),
 threadStarted(false),
 threadStopRequested(false),
 threadStopped(false) {
@@ -66,6 +76,62 @@ ThreadedQueue::GetTickDuration() const {
     return this->tickDuration;
 }
 
+//------------------------------------------------------------------------------
+/**
+ Switch to the lock-free ring buffer transport with a fixed capacity
+ (rounded up to the next power of 2). With multipleProducers, Put() 
+ may be called from any thread, otherwise only from the creation thread.
+ If the platform has no threads, the message queues are pumped in 
+ DoWork() as usual, and this method has no effect.
+*/
+void
+ThreadedQueue::SetRingBuffer(int32 capacity, bool multipleProducers_) {
+    o_assert(!this->threadStarted);
+    #if ORYOL_HAS_THREADS
+        this->ringBuffer.setup(capacity);
+        this->multipleProducers = multipleProducers_;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+bool
+ThreadedQueue::IsRingBuffer() const {
+    #if ORYOL_HAS_THREADS
+        return this->ringBuffer.isValid();
+    #else
+        return false;
+    #endif
+}
+
+//------------------------------------------------------------------------------
+int32
+ThreadedQueue::GetQueueDepth() const {
+    return this->queueDepth.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int32
+ThreadedQueue::GetHighWaterMark() const {
+    return this->highWaterMark.load(std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+void
+ThreadedQueue::ResetHighWaterMark() {
+    this->highWaterMark.store(this->queueDepth.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+//------------------------------------------------------------------------------
+int32
+ThreadedQueue::incrQueueDepth() {
+    const int32 prevDepth = this->queueDepth.fetch_add(1, std::memory_order_acq_rel);
+    int32 hwm = this->highWaterMark.load(std::memory_order_relaxed);
+    while ((prevDepth >= hwm) && !this->highWaterMark.compare_exchange_weak(hwm, prevDepth + 1, std::memory_order_relaxed)) {
+        // retry
+    }
+    return prevDepth;
+}
+
 //------------------------------------------------------------------------------
 void
 ThreadedQueue::StartThread() {
@@ -83,11 +149,15 @@ ThreadedQueue::StartThread() {
 void
 ThreadedQueue::StopThread() {
     o_assert(this->threadStarted);
-    this->threadStopRequested = true;
     #if ORYOL_HAS_THREADS
+        {
+            std::lock_guard<std::mutex> lock(this->wakeupMutex);
+            this->threadStopRequested = true;
+        }
         this->wakeup.notify_one();
         this->thread.join();
     #else
+        this->threadStopRequested = true;
         this->onThreadLeave();
     #endif
     this->threadStopped = true;
@@ -96,9 +166,28 @@ ThreadedQueue::StopThread() {
 //------------------------------------------------------------------------------
 bool
 ThreadedQueue::Put(const Ptr<Message>& msg) {
-    o_assert(this->isCreateThread());
     o_assert(this->threadStarted);
     o_assert(!this->threadStopped);
+    #if ORYOL_HAS_THREADS
+    if (this->ringBuffer.isValid()) {
+        o_assert(this->multipleProducers || this->isCreateThread());
+        const int32 prevDepth = this->incrQueueDepth();
+        Ptr<Message> m(msg);
+        while (!(this->multipleProducers ? this->ringBuffer.enqueue(std::move(m)) : this->ringBuffer.enqueueSingle(std::move(m)))) {
+            // ring buffer is full, the worker thread is awake and draining it
+            std::this_thread::yield();
+        }
+        if (0 == prevDepth) {
+            // queue went from empty to non-empty, the worker may be sleeping,
+            // taking the lock guarantees it is either waiting or will see the new depth
+            std::lock_guard<std::mutex> lock(this->wakeupMutex);
+            this->wakeup.notify_one();
+        }
+        return true;
+    }
+    #endif
+    o_assert(this->isCreateThread());
+    this->incrQueueDepth();
     this->writeQueue.Enqueue(msg);
     return true;
 }
@@ -106,10 +195,16 @@ ThreadedQueue::Put(const Ptr<Message>& msg) {
 //------------------------------------------------------------------------------
 void
 ThreadedQueue::DoWork() {
-    // move messages to transfer queue and wake up thread
-    o_assert(this->isCreateThread());
     o_assert(this->threadStarted);
     o_assert(!this->threadStopped);
+    #if ORYOL_HAS_THREADS
+    if (this->ringBuffer.isValid()) {
+        // nothing to do, Put() already wakes up the thread when necessary
+        return;
+    }
+    #endif
+    // move messages to transfer queue and wake up thread
+    o_assert(this->isCreateThread());
     if (!this->writeQueue.Empty()) {
         this->moveWriteToTransferQueue();
     }
@@ -123,6 +218,7 @@ ThreadedQueue::DoWork() {
         // FIXME: we could do without all those queue transfers here!
         this->moveTransferToReadQueue();
         while (!this->readQueue.Empty()) {
+            this->queueDepth.fetch_sub(1, std::memory_order_relaxed);
             this->onMessage(std::move(this->readQueue.Dequeue()));
         }
         this->onTick();
@@ -195,6 +291,12 @@ ThreadedQueue::threadFunc(ThreadedQueue* self) {
     // notify subclass that thread has been entered
     self->onThreadEnter();
     
+    if (self->ringBuffer.isValid()) {
+        self->ringBufferLoop();
+        self->onThreadLeave();
+        return;
+    }
+    
     // the message processing loop waits for messages to arrive,
     // and forwards them to the forwardingPort
     while (!self->threadStopRequested) {
@@ -214,6 +316,7 @@ ThreadedQueue::threadFunc(ThreadedQueue* self) {
         
         // now process the messages, this happens without locking
         while (!self->readQueue.Empty()) {
+            self->queueDepth.fetch_sub(1, std::memory_order_relaxed);
             self->onMessage(std::move(self->readQueue.Dequeue()));
         }
         self->onTick();
@@ -222,6 +325,51 @@ ThreadedQueue::threadFunc(ThreadedQueue* self) {
     // notify subclass that we're about to leave the thread
     self->onThreadLeave();
 }
+
+//------------------------------------------------------------------------------
+/**
+ The worker loop in ring buffer mode. The thread only goes to sleep
+ when the queue depth is 0, and Put() only signals the thread when
+ the depth goes from 0 to 1. The queue depth is incremented before a
+ message is pushed into the ring, so a depth > 0 may briefly
+ mean that a producer hasn't finished writing its message yet.
+*/
+void
+ThreadedQueue::ringBufferLoop() {
+    const int32 maxMessagesPerTick = this->ringBuffer.capacity();
+    Ptr<Message> msg;
+    while (!this->threadStopRequested) {
+        {
+            std::unique_lock<std::mutex> lock(this->wakeupMutex);
+            auto hasWork = [this]() {
+                return this->threadStopRequested || (this->queueDepth.load(std::memory_order_acquire) > 0);
+            };
+            if (0 != this->tickDuration) {
+                this->wakeup.wait_for(lock, std::chrono::milliseconds(this->tickDuration), hasWork);
+            }
+            else {
+                this->wakeup.wait(lock, hasWork);
+            }
+        }
+        
+        // process messages without locking, but give onTick() a chance
+        // to run when producers keep the queue busy
+        int32 numMessages = 0;
+        while ((numMessages < maxMessagesPerTick) && (this->queueDepth.load(std::memory_order_acquire) > 0)) {
+            if (this->ringBuffer.dequeue(msg)) {
+                this->queueDepth.fetch_sub(1, std::memory_order_release);
+                this->onMessage(msg);
+                msg = nullptr;
+                numMessages++;
+            }
+            else {
+                // a producer has claimed a slot but not published the message yet
+                std::this_thread::yield();
+            }
+        }
+        this->onTick();
+    }
+}
 #endif
 
 //------------------------------------------------------------------------------
@@ -20,11 +20,24 @@
     process messages from the read queue without locking.  When the read queue
     is empty it will check the transfer queue for more messages, and if this
     is empty, go to sleep.
+    
+    Alternatively, SetRingBuffer() switches to a bounded lock-free ring 
+    buffer: Put() pushes the message directly into the ring, and only
+    wakes the worker thread when the queue goes from empty to non-empty,
+    DoWork() isn't needed to move messages to the worker. By default
+    only the creation thread may call Put() (single-producer fast path),
+    with multipleProducers enabled, any thread may call Put(). When the 
+    ring is full, Put() yields until the worker has made room.
+    
+    GetQueueDepth() and GetHighWaterMark() report the number of messages
+    which have been put but not yet forwarded, in both modes.
 */
 #include "Core/Config.h"
 #include "Messaging/Port.h"
 #include "Core/Containers/Queue.h"
+#include <atomic>
 #if ORYOL_HAS_THREADS
+#include "Core/Threading/mpscRingBuffer.h"
 #include <thread>
 #include <mutex>
 #include <condition_variable>
@@ -47,6 +60,16 @@ public:
     void SetTickDuration(uint32 milliSecs);
     /// get optional tick-rate in millisecs
     uint32 GetTickDuration() const;
+    /// use the lock-free ring buffer transport, must be called before StartThread()
+    void SetRingBuffer(int32 capacity, bool multipleProducers=false);
+    /// return true if the ring buffer transport is used
+    bool IsRingBuffer() const;
+    /// get number of messages which have been put but not yet forwarded
+    int32 GetQueueDepth() const;
+    /// get the max queue depth since start or last ResetHighWaterMark()
+    int32 GetHighWaterMark() const;
+    /// reset the high-water mark
+    void ResetHighWaterMark();
     /// start the handler thread, this cannot happen in the constructor
     virtual void StartThread();
     /// stop the handler thread, this cannot happen in the destructor
@@ -77,6 +100,12 @@ protected:
     void moveWriteToTransferQueue();
     /// move messages from transfer queue to read queue
     void moveTransferToReadQueue();
+    /// increment queue depth, return previous depth
+    int32 incrQueueDepth();
+    #if ORYOL_HAS_THREADS
+    /// the thread loop in ring buffer mode
+    void ringBufferLoop();
+    #endif
     
     uint32 tickDuration;
     Core::Queue<Core::Ptr<Message>> writeQueue;     // written by sender thread
@@ -91,7 +120,11 @@ protected:
     std::mutex transferQueueLock;
     std::mutex wakeupMutex;
     std::condition_variable wakeup;
+    Core::mpscRingBuffer<Core::Ptr<Message>> ringBuffer;
+    bool multipleProducers;
     #endif
+    std::atomic<int32> queueDepth;
+    std::atomic<int32> highWaterMark;
     bool threadStarted;
     bool threadStopRequested;
     bool threadStopped;
@@ -13,6 +13,8 @@ typedef uint32 ProtocolIdType;
 static const ProtocolIdType InvalidProtocolId = 0xFFFFFFFF;
 typedef int32 MessageIdType;
 static const MessageIdType InvalidMessageId = -1;
+/// max number of message ids in a protocol hierarchy (one bit per id in a message's type bits)
+static const int32 MaxNumMessageIds = 64;
         
 } // namespace Messaging
 } // namespace Oryol
\ No newline at end of file
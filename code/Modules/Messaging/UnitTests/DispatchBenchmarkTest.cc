@@ -0,0 +1,138 @@
+//------------------------------------------------------------------------------
+//  DispatchBenchmarkTest.cc
+//  Test message type tags, and measure message routing with type tags
+//  against dynamic_cast, and Dispatcher::Put() throughput.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Messaging/Dispatcher.h"
+#include "Messaging/UnitTests/TestProtocol.h"
+#include "Messaging/UnitTests/TestProtocol2.h"
+#include "Core/Containers/Array.h"
+#include <chrono>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::Messaging;
+using namespace std::chrono;
+
+static const int NumMessages = 1000000;
+static const int NumDistinctMessages = 1024;
+static int numHandled = 0;
+static void HandleMsg1(const Ptr<TestProtocol::TestMsg1>& msg) {
+    numHandled++;
+}
+static void HandleMsg2(const Ptr<TestProtocol::TestMsg2>& msg) {
+    numHandled++;
+}
+
+//------------------------------------------------------------------------------
+static Array<Ptr<Message>>
+createMessages() {
+    Array<Ptr<Message>> msgs;
+    msgs.Reserve(NumDistinctMessages);
+    for (int i = 0; i < NumDistinctMessages; i++) {
+        switch (i & 3) {
+            case 0: msgs.AddBack(TestProtocol::TestMsg1::Create()); break;
+            case 1: msgs.AddBack(TestProtocol::TestMsg2::Create()); break;
+            case 2: msgs.AddBack(TestProtocol::TestArrayMsg::Create()); break;
+            default: msgs.AddBack(TestProtocol2::TestMsgEx::Create()); break;
+        }
+    }
+    return msgs;
+}
+
+//------------------------------------------------------------------------------
+static void
+logResult(const char* name, const time_point<system_clock>& start) {
+    duration<double> dur = system_clock::now() - start;
+    Log::Info("Dispatch (%s): %d msgs in %f sec, %.0f msgs/sec\n",
+        name, NumMessages, dur.count(), NumMessages / dur.count());
+}
+
+//------------------------------------------------------------------------------
+TEST(MessageTypeTagTest) {
+    Ptr<Message> msg1 = TestProtocol::TestMsg1::Create();
+    Ptr<Message> msg2 = TestProtocol::TestMsg2::Create();
+    Ptr<Message> msgEx = TestProtocol2::TestMsgEx::Create();
+    Ptr<Message> base = Message::Create();
+
+    CHECK(msg1->IsA<TestProtocol::TestMsg1>());
+    CHECK(!msg1->IsA<TestProtocol::TestMsg2>());
+    CHECK(!msg1->IsA<TestProtocol2::TestMsgEx>());
+    CHECK(msg2->IsA<TestProtocol::TestMsg1>());
+    CHECK(msg2->IsA<TestProtocol::TestMsg2>());
+    CHECK(msgEx->IsA<TestProtocol::TestMsg1>());
+    CHECK(msgEx->IsA<TestProtocol2::TestMsgEx>());
+    CHECK(!msgEx->IsA<TestProtocol::TestMsg2>());
+    CHECK(!base->IsA<TestProtocol::TestMsg1>());
+
+    CHECK(msg1->IsMemberOf<TestProtocol>());
+    CHECK(!msg1->IsMemberOf<TestProtocol2>());
+    CHECK(msgEx->IsMemberOf<TestProtocol>());
+    CHECK(msgEx->IsMemberOf<TestProtocol2>());
+    CHECK(!base->IsMemberOf<TestProtocol>());
+    CHECK(TestProtocol2::GetBaseProtocolId() == TestProtocol::GetProtocolId());
+
+    // a message of a derived protocol is ignored by the parent protocol's dispatcher
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe<TestProtocol::TestMsg1>(&HandleMsg1);
+    numHandled = 0;
+    CHECK(disp->Put(msg1));
+    CHECK(!disp->Put(msgEx));
+    CHECK(!disp->Put(base));
+    CHECK(numHandled == 1);
+}
+
+//------------------------------------------------------------------------------
+TEST(DispatchBenchmark) {
+    Array<Ptr<Message>> msgs = createMessages();
+
+    // route with dynamic_cast
+    int numMatches = 0;
+    time_point<system_clock> start = system_clock::now();
+    for (int i = 0; i < NumMessages; i++) {
+        const Ptr<Message>& msg = msgs[i & (NumDistinctMessages - 1)];
+        if (msg.dynamicCast<TestProtocol2::TestMsgEx>().isValid()) {
+            numMatches += 3;
+        }
+        else if (msg.dynamicCast<TestProtocol::TestMsg2>().isValid()) {
+            numMatches += 2;
+        }
+        else if (msg.dynamicCast<TestProtocol::TestMsg1>().isValid()) {
+            numMatches += 1;
+        }
+    }
+    logResult("dynamic_cast", start);
+    CHECK(numMatches == (NumMessages / 4) * 6);
+
+    // route with type tags
+    numMatches = 0;
+    start = system_clock::now();
+    for (int i = 0; i < NumMessages; i++) {
+        const Ptr<Message>& msg = msgs[i & (NumDistinctMessages - 1)];
+        if (msg->IsA<TestProtocol2::TestMsgEx>()) {
+            numMatches += 3;
+        }
+        else if (msg->IsA<TestProtocol::TestMsg2>()) {
+            numMatches += 2;
+        }
+        else if (msg->IsA<TestProtocol::TestMsg1>()) {
+            numMatches += 1;
+        }
+    }
+    logResult("type tags", start);
+    CHECK(numMatches == (NumMessages / 4) * 6);
+
+    // Dispatcher::Put()
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe<TestProtocol::TestMsg1>(&HandleMsg1);
+    disp->Subscribe<TestProtocol::TestMsg2>(&HandleMsg2);
+    numHandled = 0;
+    start = system_clock::now();
+    for (int i = 0; i < NumMessages; i++) {
+        disp->Put(msgs[i & (NumDistinctMessages - 1)]);
+    }
+    logResult("Dispatcher::Put", start);
+    CHECK(numHandled == (NumMessages / 4) * 2);
+}
@@ -7,10 +7,13 @@
 #include "Messaging/Broadcaster.h"
 #include "TestProtocol.h"
 #include "TestProtocol2.h"
+#include <functional>
+#include <chrono>
 
 using namespace Oryol;
 using namespace Oryol::Core;
 using namespace Oryol::Messaging;
+using namespace std::chrono;
 
 // a global message handler function
 static int32 val = 0;
@@ -36,6 +39,17 @@ public:
     int32 val = 0;
 };
 
+// a handler class without checks, for the benchmark
+class BenchmarkHandlerClass {
+public:
+    void Handle(const Ptr<TestProtocol::TestMsg2>& msg) {
+        this->val++;
+    };
+
+    int32 val = 0;
+};
+
+//------------------------------------------------------------------------------
 TEST(DispatcherTest) {
     
     // build a broad caster with 2 dispatchers
@@ -47,9 +61,15 @@ TEST(DispatcherTest) {
     disp0->Subscribe<TestProtocol::TestMsg1>(&GlobalHandler);
 
     // define an object method as callback function
-    using namespace std::placeholders;
     HandlerClass handlerObj;
-    disp0->Subscribe<TestProtocol::TestMsg2>(std::bind(&HandlerClass::Handle, &handlerObj, _1));
+    disp0->Subscribe(&handlerObj, &HandlerClass::Handle);
+
+    // and a lambda
+    int32 numExMsgs = 0;
+    disp1->Subscribe<TestProtocol2::TestMsgEx>([&numExMsgs](const Ptr<TestProtocol2::TestMsgEx>& msg) {
+        CHECK(msg->GetExVal2() == 12);
+        numExMsgs++;
+    });
     
     // add dispatchers
     sink->Subscribe(disp0);
@@ -70,9 +90,63 @@ TEST(DispatcherTest) {
     sink->Put(msg1);
     CHECK(handlerObj.val == 1);
 
+    Ptr<TestProtocol2::TestMsgEx> msg2 = TestProtocol2::TestMsgEx::Create();
+    msg2->SetExVal2(12);
+    sink->Put(msg2);
+    CHECK(numExMsgs == 1);
+    CHECK(val == 1);
+
+    // unsubscribed messages are not handled
+    disp0->Unsubscribe<TestProtocol::TestMsg2>();
+    CHECK(!disp0->Put(msg1));
+    CHECK(handlerObj.val == 1);
+
     sink = 0;
     disp0 = 0;
     disp1 = 0;
 }
 
+//------------------------------------------------------------------------------
+TEST(DispatcherBenchmark) {
+    const int32 numMessages = 1000000;
+    Ptr<Message> msg = TestProtocol::TestMsg2::Create();
+    const MessageIdType msgId = msg->MessageId();
+    BenchmarkHandlerClass handlerObj;
+
+    // before: jump table of std::function objects created with std::bind
+    using namespace std::placeholders;
+    std::function<void(const Ptr<TestProtocol::TestMsg2>&)> func = std::bind(&BenchmarkHandlerClass::Handle, &handlerObj, _1);
+    std::function<void(const Ptr<Message>&)> funcTable[TestProtocol::MessageId::NumMessageIds];
+    funcTable[msgId] = *(std::function<void(const Ptr<Message>&)>*)&func;
+    time_point<system_clock> start = system_clock::now();
+    for (int32 i = 0; i < numMessages; i++) {
+        funcTable[msg->MessageId()](msg);
+    }
+    duration<double> dur = system_clock::now() - start;
+    Log::Info("Dispatcher (std::function): %d msgs in %f sec, %.0f msgs/sec\n", numMessages, dur.count(), numMessages / dur.count());
+    CHECK(handlerObj.val == numMessages);
 
+    // after: jump table of MessageHandler delegates
+    handlerObj.val = 0;
+    MessageHandler handlerTable[TestProtocol::MessageId::NumMessageIds];
+    handlerTable[msgId] = MessageHandler::Method(&handlerObj, &BenchmarkHandlerClass::Handle);
+    start = system_clock::now();
+    for (int32 i = 0; i < numMessages; i++) {
+        handlerTable[msg->MessageId()](msg);
+    }
+    dur = system_clock::now() - start;
+    Log::Info("Dispatcher (MessageHandler): %d msgs in %f sec, %.0f msgs/sec\n", numMessages, dur.count(), numMessages / dur.count());
+    CHECK(handlerObj.val == numMessages);
+
+    // the whole Dispatcher::Put()
+    handlerObj.val = 0;
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe(&handlerObj, &BenchmarkHandlerClass::Handle);
+    start = system_clock::now();
+    for (int32 i = 0; i < numMessages; i++) {
+        disp->Put(msg);
+    }
+    dur = system_clock::now() - start;
+    Log::Info("Dispatcher (Put): %d msgs in %f sec, %.0f msgs/sec\n", numMessages, dur.count(), numMessages / dur.count());
+    CHECK(handlerObj.val == numMessages);
+}
@@ -0,0 +1,109 @@
+//------------------------------------------------------------------------------
+//  MessageCodecTest.cc
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Messaging/MessageCodec.h"
+#include "TestProtocol.h"
+#include "TestProtocol2.h"
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::Messaging;
+
+//------------------------------------------------------------------------------
+TEST(MessageCodecTest) {
+    
+    // build a mixed batch of messages
+    Queue<Ptr<Message>> msgs;
+    for (int32 i = 0; i < 100; i++) {
+        Ptr<TestProtocol::TestMsg1> msg1 = TestProtocol::TestMsg1::Create();
+        msg1->SetInt32Val(i);
+        msg1->SetFloat64Val(i * 0.5);
+        msgs.Enqueue(msg1);
+        
+        Ptr<TestProtocol::TestMsg2> msg2 = TestProtocol::TestMsg2::Create();
+        msg2->SetInt8Val(int8(i));
+        msg2->SetStringVal("Message2");
+        msg2->SetStringAtomVal("Atom");
+        msgs.Enqueue(msg2);
+        
+        Ptr<TestProtocol::TestArrayMsg> arrayMsg = TestProtocol::TestArrayMsg::Create();
+        Array<int32> ints;
+        for (int32 j = 0; j < i; j++) {
+            ints.AddBack(j);
+        }
+        arrayMsg->SetInt32ArrayVal(ints);
+        arrayMsg->SetStringArrayVal(Array<String>({ "Bla", "Blub" }));
+        msgs.Enqueue(arrayMsg);
+    }
+    
+    // encode in one go, the queue stays intact
+    MessageCodec codec;
+    codec.Encode(msgs);
+    CHECK(msgs.Size() == 300);
+    CHECK(codec.NumMessages() == 300);
+    int32 expectedSize = 0;
+    for (int32 i = 0; i < msgs.Size(); i++) {
+        expectedSize += MessageCodec::HeaderSize + msgs[i]->EncodedSize();
+    }
+    CHECK(codec.Size() == expectedSize);
+    
+    // decode through the protocol factory
+    Queue<Ptr<Message>> decoded;
+    CHECK(MessageCodec::Decode<TestProtocol>(codec.Data(), codec.Size(), decoded));
+    CHECK(decoded.Size() == 300);
+    bool allValid = true;
+    for (int32 i = 0; i < 100; i++) {
+        Ptr<Message> msg = decoded.Dequeue();
+        allValid &= (msg->MessageId() == TestProtocol::MessageId::TestMsg1Id);
+        Ptr<TestProtocol::TestMsg1> msg1 = msg.dynamicCast<TestProtocol::TestMsg1>();
+        allValid &= (msg1->GetInt32Val() == i) && (msg1->GetFloat64Val() == i * 0.5) && (msg1->GetInt16Val() == -1);
+        
+        Ptr<TestProtocol::TestMsg2> msg2 = decoded.Dequeue().dynamicCast<TestProtocol::TestMsg2>();
+        allValid &= msg2.isValid() && (msg2->GetInt8Val() == int8(i));
+        allValid &= (msg2->GetStringVal() == "Message2") && (msg2->GetStringAtomVal() == "Atom");
+        
+        Ptr<TestProtocol::TestArrayMsg> arrayMsg = decoded.Dequeue().dynamicCast<TestProtocol::TestArrayMsg>();
+        allValid &= arrayMsg.isValid() && (arrayMsg->GetInt32ArrayVal().Size() == i);
+        for (int32 j = 0; j < arrayMsg->GetInt32ArrayVal().Size(); j++) {
+            allValid &= (arrayMsg->GetInt32ArrayVal()[j] == j);
+        }
+        allValid &= (arrayMsg->GetStringArrayVal().Size() == 2) && (arrayMsg->GetStringArrayVal()[1] == "Blub");
+    }
+    CHECK(allValid);
+    
+    // a derived protocol can decode messages of its parent protocol, 
+    // but not the other way around (those frames are skipped)
+    codec.Clear();
+    CHECK(codec.Size() == 0);
+    Ptr<TestProtocol2::TestMsgEx> msgEx = TestProtocol2::TestMsgEx::Create();
+    msgEx->SetExVal2(12);
+    codec.Encode(msgEx);
+    codec.Encode(msgs[0]);
+    CHECK(MessageCodec::Decode<TestProtocol2>(codec.Data(), codec.Size(), decoded));
+    CHECK(decoded.Size() == 2);
+    CHECK(decoded.Dequeue().dynamicCast<TestProtocol2::TestMsgEx>()->GetExVal2() == 12);
+    CHECK(decoded.Dequeue()->MessageId() == TestProtocol::MessageId::TestMsg1Id);
+    CHECK(MessageCodec::Decode<TestProtocol>(codec.Data(), codec.Size(), decoded));
+    CHECK(decoded.Size() == 1);
+    decoded.Clear();
+    
+    // messages without serializer methods are refused
+    const int32 sizeBefore = codec.Size();
+    Ptr<TestProtocol::TestLocalMsg> localMsg = TestProtocol::TestLocalMsg::Create();
+    CHECK(!localMsg->IsSerializable());
+    CHECK(msgs[0]->IsSerializable());
+    CHECK(!codec.Encode(localMsg));
+    CHECK(codec.Size() == sizeBefore);
+
+    // truncated and corrupt data fails
+    CHECK(!MessageCodec::Decode<TestProtocol>(codec.Data(), codec.Size() - 1, decoded));
+    uint8 corrupt[64];
+    memcpy(corrupt, codec.Data(), MessageCodec::HeaderSize);
+    const int32 badSize = -5;
+    memcpy(corrupt + 8, &badSize, sizeof(badSize));
+    CHECK(!MessageCodec::Decode<TestProtocol2>(corrupt, sizeof(corrupt), decoded));
+    CHECK(MessageCodec::Decode<TestProtocol>(nullptr, 0, decoded));
+    CHECK(decoded.Empty());
+}
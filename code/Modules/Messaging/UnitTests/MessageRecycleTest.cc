@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+//  MessageRecycleTest.cc
+//  Test recycling of messages with the recycle="true" attribute.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Messaging/UnitTests/TestProtocol.h"
+#include "Messaging/UnitTests/TestProtocol2.h"
+#include "Core/Memory/LinearAllocator.h"
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::Messaging;
+
+//------------------------------------------------------------------------------
+TEST(MessageRecycleTest) {
+
+    // a released message is reset, and returned by the next Create(),
+    // arrays keep their capacity
+    Ptr<TestProtocol::TestArrayMsg> arrayMsg = TestProtocol::TestArrayMsg::Create();
+    Array<int32> ints;
+    for (int32 i = 0; i < 100; i++) {
+        ints.AddBack(i);
+    }
+    arrayMsg->SetInt32ArrayVal(ints);
+    Array<String> strings;
+    strings.AddBack("Bla");
+    strings.AddBack("Blub");
+    arrayMsg->SetStringArrayVal(strings);
+    arrayMsg->SetHandled();
+    const int32 capacity = arrayMsg->GetInt32ArrayVal().Capacity();
+    CHECK(capacity >= 100);
+    const TestProtocol::TestArrayMsg* ptr = arrayMsg.get();
+    const int32 numRecycled = TestProtocol::TestArrayMsg::NumRecycled();
+    arrayMsg = nullptr;
+    arrayMsg = TestProtocol::TestArrayMsg::Create();
+    CHECK(arrayMsg.get() == ptr);
+    CHECK(TestProtocol::TestArrayMsg::NumRecycled() == numRecycled + 1);
+    CHECK(arrayMsg->GetInt32ArrayVal().Empty());
+    CHECK(arrayMsg->GetInt32ArrayVal().Capacity() == capacity);
+    CHECK(arrayMsg->GetStringArrayVal().Empty());
+    CHECK(arrayMsg->Pending());
+    CHECK(!arrayMsg->Handled());
+    CHECK(arrayMsg->MessageId() == TestProtocol::MessageId::TestArrayMsgId);
+    CHECK(arrayMsg->IsA<TestProtocol::TestArrayMsg>());
+
+    // all fields, also those of the parent class, are set back to their defaults
+    Ptr<TestProtocol::TestMsg2> msg2 = TestProtocol::TestMsg2::Create();
+    msg2->SetInt16Val(16);
+    msg2->SetInt32Val(32);
+    msg2->SetFloat32Val(1.0f);
+    msg2->SetStringVal("Bla");
+    msg2->SetStringAtomVal("Blub");
+    msg2->SetCancelled();
+    msg2 = nullptr;
+    msg2 = TestProtocol::TestMsg2::Create();
+    CHECK(msg2->GetInt16Val() == -1);
+    CHECK(msg2->GetInt32Val() == 0);
+    CHECK(msg2->GetFloat32Val() == 123.0f);
+    CHECK(msg2->GetStringVal() == "Test");
+    CHECK(!msg2->GetStringAtomVal().IsValid());
+    CHECK(!msg2->Cancelled());
+
+    // Reset() is virtual, resetting through the parent class resets all fields
+    msg2->SetInt16Val(16);
+    msg2->SetStringVal("Bla");
+    Ptr<TestProtocol::TestMsg1> msg1 = msg2;
+    msg1->Reset();
+    CHECK(msg2->GetInt16Val() == -1);
+    CHECK(msg2->GetStringVal() == "Test");
+
+    // derived classes which don't opt in are not recycled
+    Ptr<TestProtocol2::TestMsgEx> msgEx = TestProtocol2::TestMsgEx::Create();
+    msgEx->SetExVal2(12);
+    msgEx = nullptr;
+    msgEx = TestProtocol2::TestMsgEx::Create();
+    CHECK(msgEx->GetExVal2() == 0);
+
+    // many messages in flight, more than the free-list holds
+    Array<Ptr<TestProtocol::TestArrayMsg>> msgs;
+    for (int32 i = 0; i < 1000; i++) {
+        msgs.AddBack(TestProtocol::TestArrayMsg::Create());
+        msgs.Back()->SetInt32ArrayVal(ints);
+    }
+    msgs.Clear();
+    for (int32 i = 0; i < 1000; i++) {
+        msgs.AddBack(TestProtocol::TestArrayMsg::Create());
+        CHECK(msgs.Back()->GetInt32ArrayVal().Empty());
+    }
+
+    // the free-list is empty now, a message created while a thread
+    // allocator is installed doesn't capture it, because the message
+    // may be recycled long after the allocator has been reset
+    {
+        LinearAllocator linAlloc(64 * 1024);
+        ThreadAllocatorScope scope(&linAlloc);
+        arrayMsg = TestProtocol::TestArrayMsg::Create();
+        arrayMsg->SetInt32ArrayVal(ints);
+        CHECK(linAlloc.Size() == 0);
+    }
+    arrayMsg = nullptr;
+}
@@ -18,6 +18,34 @@ struct podStruct {
     int16 blob;
 };
 
+// a POD struct with Serializer specializations (packed, without padding)
+struct packedStruct {
+    int32 bla;
+    int8 blub;
+    int16 blob;
+};
+
+namespace Oryol {
+namespace Messaging {
+template<> inline int32
+Serializer::EncodedSize<packedStruct>(const packedStruct& val) {
+    return 7;
+}
+template<> inline uint8*
+Serializer::Encode<packedStruct>(const packedStruct& val, uint8* dstPtr, const uint8* maxPtr) {
+    dstPtr = Serializer::Encode<int32>(val.bla, dstPtr, maxPtr);
+    dstPtr = Serializer::Encode<int8>(val.blub, dstPtr, maxPtr);
+    return Serializer::Encode<int16>(val.blob, dstPtr, maxPtr);
+}
+template<> inline const uint8*
+Serializer::Decode<packedStruct>(const uint8* srcPtr, const uint8* maxPtr, packedStruct& outVal) {
+    srcPtr = Serializer::Decode<int32>(srcPtr, maxPtr, outVal.bla);
+    srcPtr = Serializer::Decode<int8>(srcPtr, maxPtr, outVal.blub);
+    return Serializer::Decode<int16>(srcPtr, maxPtr, outVal.blob);
+}
+} // namespace Messaging
+} // namespace Oryol
+
 TEST(SerializerTest) {
     
     // scratch space
@@ -84,6 +112,45 @@ TEST(SerializerTest) {
     CHECK(1 == int32ArrayRead[0]);
     CHECK(2 == int32ArrayRead[1]);
     CHECK(3 == int32ArrayRead[2]);
+    
+    // test Array of POD structs, and an empty array at the end of the data
+    Array<podStruct> podArrayWrite({ { 1, 2, 3 }, { 4, 5, 6 } });
+    Array<podStruct> podArrayRead;
+    Array<int32> emptyArrayRead;
+    const int32 podArraySize = sizeof(int32) + 2 * sizeof(podStruct);
+    CHECK(Serializer::EncodedArraySize<podStruct>(podArrayWrite) == podArraySize);
+    encodePtr = Serializer::EncodeArray<podStruct>(podArrayWrite, space, maxPtr);
+    encodePtr = Serializer::EncodeArray<int32>(Array<int32>(), encodePtr, maxPtr);
+    CHECK(encodePtr == space + podArraySize + 4);
+    decodePtr = Serializer::DecodeArray<podStruct>(space, encodePtr, podArrayRead);
+    decodePtr = Serializer::DecodeArray<int32>(decodePtr, encodePtr, emptyArrayRead);
+    CHECK(decodePtr == encodePtr);
+    CHECK(podArrayRead.Size() == 2);
+    CHECK((podArrayRead[1].bla == 4) && (podArrayRead[1].blub == 5) && (podArrayRead[1].blob == 6));
+    CHECK(emptyArrayRead.Empty());
+
+    // arrays of POD structs use the Serializer specializations of the struct
+    Array<packedStruct> packedArrayWrite({ { 1, 2, 3 }, { 4, 5, 6 } });
+    Array<packedStruct> packedArrayRead;
+    CHECK(Serializer::EncodedArraySize<packedStruct>(packedArrayWrite) == 4 + 2 * 7);
+    encodePtr = Serializer::EncodeArray<packedStruct>(packedArrayWrite, space, maxPtr);
+    CHECK(encodePtr == space + 4 + 2 * 7);
+    CHECK(Serializer::DecodeArray<packedStruct>(space, encodePtr, packedArrayRead) == encodePtr);
+    CHECK(packedArrayRead.Size() == 2);
+    CHECK((packedArrayRead[1].bla == 4) && (packedArrayRead[1].blub == 5) && (packedArrayRead[1].blob == 6));
+    
+    // running out of space returns nullptr, and chained calls keep returning nullptr
+    Array<String> strArrayWrite({ "ABC", "DEF" });
+    Array<String> strArrayRead;
+    CHECK(Serializer::EncodeArray<String>(strArrayWrite, space, space + 16) == nullptr);
+    CHECK(Serializer::EncodeArray<podStruct>(podArrayWrite, space, space + podArraySize - 1) == nullptr);
+    CHECK(Serializer::Encode<int32>(1, nullptr, maxPtr) == nullptr);
+    CHECK(Serializer::Encode<String>(strWrite, nullptr, maxPtr) == nullptr);
+    CHECK(Serializer::EncodeArray<String>(strArrayWrite, space, space + 18) == space + 18);
+    CHECK(Serializer::DecodeArray<String>(space, space + 17, strArrayRead) == nullptr);
+    CHECK(strArrayRead.Empty());
+    CHECK(Serializer::DecodeArray<String>(space, space + 18, strArrayRead) == space + 18);
+    CHECK((strArrayRead.Size() == 2) && (strArrayRead[1] == "DEF"));
 }
 
 
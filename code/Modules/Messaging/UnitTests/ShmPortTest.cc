@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------------
+//  ShmPortTest.cc
+//  Test messaging between ShmPorts, and measure the throughput.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Messaging/ShmPort.h"
+#include "Messaging/Dispatcher.h"
+#include "Core/Log.h"
+#include "TestProtocol.h"
+#include <chrono>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::Messaging;
+using namespace std::chrono;
+
+#if ORYOL_LINUX || ORYOL_MACOS
+//------------------------------------------------------------------------------
+TEST(ShmPortTest) {
+    const MessageCodec::ProtocolFactory factory = MessageCodec::FactoryOf<TestProtocol>();
+    
+    // collect received messages on both sides
+    int32 numMsg1 = 0;
+    int32 numMsg2 = 0;
+    bool allValid = true;
+    Ptr<Dispatcher<TestProtocol>> dispatcher = Dispatcher<TestProtocol>::Create();
+    dispatcher->Subscribe<TestProtocol::TestMsg1>([&numMsg1, &allValid](const Ptr<TestProtocol::TestMsg1>& msg) {
+        allValid &= (msg->GetInt32Val() == numMsg1);
+        numMsg1++;
+    });
+    Ptr<Dispatcher<TestProtocol>> replyDispatcher = Dispatcher<TestProtocol>::Create();
+    replyDispatcher->Subscribe<TestProtocol::TestMsg2>([&numMsg2, &allValid](const Ptr<TestProtocol::TestMsg2>& msg) {
+        allValid &= (msg->GetStringVal() == "Reply") && (msg->GetStringAtomVal() == "Atom");
+        numMsg2++;
+    });
+    
+    Ptr<ShmPort> owner = ShmPort::Create(factory, dispatcher);
+    Ptr<ShmPort> peer = ShmPort::Create(factory, replyDispatcher);
+    ShmPort::Unlink("/oryol_shm_port_test");
+    CHECK(!peer->Open("/oryol_shm_port_test"));
+    CHECK(owner->Setup("/oryol_shm_port_test", 6000));
+    CHECK(owner->RingCapacity() == 8192);
+    CHECK(peer->Open("/oryol_shm_port_test"));
+    CHECK(peer->RingCapacity() == 8192);
+
+    // an existing region isn't replaced
+    Ptr<ShmPort> other = ShmPort::Create(factory, Ptr<Port>());
+    CHECK(!other->Setup("/oryol_shm_port_test", 6000));
+
+    // a message which doesn't fit into the ring is rejected
+    Ptr<TestProtocol::TestArrayMsg> bigMsg = TestProtocol::TestArrayMsg::Create();
+    Array<int32> ints;
+    for (int32 i = 0; i < 3000; i++) {
+        ints.AddBack(i);
+    }
+    bigMsg->SetInt32ArrayVal(ints);
+    CHECK(!peer->Put(bigMsg));
+    CHECK(peer->NumBytesPending() == 0);
+    
+    // many more messages than fit into the small ring, frames of
+    // different size wrap around the end of the ring many times
+    const int32 numMsgs = 100000;
+    time_point<system_clock> start = system_clock::now();
+    for (int32 i = 0; i < numMsgs; i++) {
+        Ptr<TestProtocol::TestMsg1> msg = TestProtocol::TestMsg1::Create();
+        msg->SetInt32Val(i);
+        peer->Put(msg);
+        if ((i % 10) == 0) {
+            Ptr<TestProtocol::TestMsg2> reply = TestProtocol::TestMsg2::Create();
+            reply->SetStringVal("Reply");
+            reply->SetStringAtomVal("Atom");
+            owner->Put(reply);
+        }
+    }
+    while ((numMsg1 < numMsgs) || (numMsg2 < numMsgs / 10)) {
+        peer->DoWork();
+        owner->DoWork();
+    }
+    duration<double> dur = system_clock::now() - start;
+    Log::Info("ShmPort: %d msgs in %f sec, %.0f msgs/sec\n", numMsgs, dur.count(), numMsgs / dur.count());
+    CHECK(numMsg1 == numMsgs);
+    CHECK(numMsg2 == numMsgs / 10);
+    CHECK(allValid);
+    CHECK(peer->NumBytesPending() == 0);
+    CHECK(owner->NumBytesPending() == 0);
+    CHECK(peer->NumBytesSent() == owner->NumBytesReceived());
+    CHECK(owner->NumBytesSent() == peer->NumBytesReceived());
+    
+    // the region is removed by the owner
+    peer->Close();
+    owner->Close();
+    CHECK(!owner->IsOpen());
+    CHECK(!peer->Open("/oryol_shm_port_test"));
+}
+#endif
@@ -0,0 +1,203 @@
+//------------------------------------------------------------------------------
+//  SocketPortTest.cc
+//  Test messaging between SocketPorts, and measure the throughput.
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Messaging/SocketPort.h"
+#include "Messaging/Dispatcher.h"
+#include "Core/Log.h"
+#include "TestProtocol.h"
+#include <chrono>
+#if ORYOL_LINUX || ORYOL_MACOS
+#include <unistd.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cstdio>
+#include <cstring>
+#endif
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::Messaging;
+using namespace std::chrono;
+
+#if ORYOL_LINUX || ORYOL_MACOS
+static const char* socketPath = "/tmp/oryol_socket_port_test.sock";
+
+//------------------------------------------------------------------------------
+TEST(SocketPortTest) {
+    const MessageCodec::ProtocolFactory factory = MessageCodec::FactoryOf<TestProtocol>();
+    
+    // collect received messages
+    int32 numMsg1 = 0;
+    int32 numArrayMsgs = 0;
+    bool allValid = true;
+    Ptr<Dispatcher<TestProtocol>> dispatcher = Dispatcher<TestProtocol>::Create();
+    dispatcher->Subscribe<TestProtocol::TestMsg1>([&numMsg1, &allValid](const Ptr<TestProtocol::TestMsg1>& msg) {
+        allValid &= (msg->GetInt32Val() == numMsg1) && (msg->GetInt16Val() == -1);
+        numMsg1++;
+    });
+    dispatcher->Subscribe<TestProtocol::TestArrayMsg>([&numArrayMsgs, &allValid](const Ptr<TestProtocol::TestArrayMsg>& msg) {
+        allValid &= (msg->GetInt32ArrayVal().Size() == 1000) && (msg->GetInt32ArrayVal()[999] == 999);
+        numArrayMsgs++;
+    });
+    
+    Ptr<SocketPort> server = SocketPort::Create(factory, dispatcher);
+    Ptr<SocketPort> client = SocketPort::Create(factory, Ptr<Port>());
+    CHECK(!client->Connect(socketPath));
+    CHECK(server->Listen(socketPath));
+    CHECK(client->Connect(socketPath));
+    CHECK(client->IsConnected());
+    server->DoWork();
+    CHECK(server->IsConnected());
+    
+    // send a big batch with small messages and big array messages, the
+    // socket buffer fills up, and the rest is sent in later DoWork() calls
+    const int32 numMsgs = 100000;
+    Array<int32> ints;
+    for (int32 i = 0; i < 1000; i++) {
+        ints.AddBack(i);
+    }
+    time_point<system_clock> start = system_clock::now();
+    for (int32 i = 0; i < numMsgs; i++) {
+        Ptr<TestProtocol::TestMsg1> msg = TestProtocol::TestMsg1::Create();
+        msg->SetInt32Val(i);
+        client->Put(msg);
+        if ((i % 1000) == 0) {
+            Ptr<TestProtocol::TestArrayMsg> arrayMsg = TestProtocol::TestArrayMsg::Create();
+            arrayMsg->SetInt32ArrayVal(ints);
+            client->Put(arrayMsg);
+        }
+    }
+    while (numMsg1 < numMsgs) {
+        client->DoWork();
+        server->DoWork();
+    }
+    duration<double> dur = system_clock::now() - start;
+    Log::Info("SocketPort: %d msgs in %f sec, %.0f msgs/sec\n", numMsgs, dur.count(), numMsgs / dur.count());
+    CHECK(numMsg1 == numMsgs);
+    CHECK(numArrayMsgs == 100);
+    CHECK(allValid);
+    CHECK(client->NumBytesPending() == 0);
+    CHECK(client->NumBytesSent() == server->NumBytesReceived());
+    
+    // the connection goes away with the client, the unsent batch is dropped
+    Ptr<TestProtocol::TestArrayMsg> bigMsg = TestProtocol::TestArrayMsg::Create();
+    bigMsg->SetInt32ArrayVal(ints);
+    for (int32 i = 0; i < 1000; i++) {
+        server->Put(bigMsg);
+    }
+    CHECK(server->NumBytesPending() > 0);
+    client->Close();
+    while (server->IsConnected()) {
+        server->DoWork();
+    }
+    CHECK(server->NumBytesPending() == 0);
+    server->Close();
+    CHECK(0 != access(socketPath, F_OK));
+
+    // Put() pushes back once the unsent batch is full
+    int32 numPut = 0;
+    while (client->Put(bigMsg)) {
+        numPut++;
+    }
+    CHECK(client->NumBytesPending() >= SocketPort::MaxPendingBytes);
+    CHECK(client->NumBytesPending() < (SocketPort::MaxPendingBytes + 5000));
+    CHECK(numPut > 0);
+    client->Close();
+    CHECK(client->NumBytesPending() == 0);
+}
+
+//------------------------------------------------------------------------------
+TEST(SocketPortListenTest) {
+    const MessageCodec::ProtocolFactory factory = MessageCodec::FactoryOf<TestProtocol>();
+    static const char* listenPath = "/tmp/oryol_socket_port_listen.sock";
+    std::remove(listenPath);
+
+    // a regular file at the path is never removed
+    std::FILE* fp = std::fopen(listenPath, "wb");
+    std::fputc('x', fp);
+    std::fclose(fp);
+    Ptr<SocketPort> port = SocketPort::Create(factory, Ptr<Port>());
+    CHECK(!port->Listen(listenPath));
+    fp = std::fopen(listenPath, "rb");
+    CHECK(nullptr != fp);
+    if (fp) {
+        CHECK('x' == std::fgetc(fp));
+        std::fclose(fp);
+    }
+    std::remove(listenPath);
+
+    // the socket of a live listener isn't taken over
+    CHECK(port->Listen(listenPath));
+    Ptr<SocketPort> other = SocketPort::Create(factory, Ptr<Port>());
+    CHECK(!other->Listen(listenPath));
+    port->Close();
+
+    // a stale socket file (left behind by a crashed process) is replaced
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, listenPath);
+    const int staleFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    CHECK(0 == ::bind(staleFd, (sockaddr*) &addr, sizeof(addr)));
+    ::close(staleFd);
+    CHECK(other->Listen(listenPath));
+    other->Close();
+}
+
+//------------------------------------------------------------------------------
+TEST(SocketPortProcessTest) {
+    const MessageCodec::ProtocolFactory factory = MessageCodec::FactoryOf<TestProtocol>();
+    int32 numEchoed = 0;
+    Ptr<Dispatcher<TestProtocol>> dispatcher = Dispatcher<TestProtocol>::Create();
+    dispatcher->Subscribe<TestProtocol::TestMsg2>([&numEchoed](const Ptr<TestProtocol::TestMsg2>& msg) {
+        if (msg->GetStringVal() == "Echo") {
+            numEchoed++;
+        }
+    });
+    Ptr<SocketPort> port = SocketPort::Create(factory, dispatcher);
+    CHECK(port->Listen(socketPath));
+    
+    const pid_t pid = fork();
+    if (0 == pid) {
+        // child process: connect and send the received messages back
+        Ptr<Dispatcher<TestProtocol>> echo = Dispatcher<TestProtocol>::Create();
+        Ptr<SocketPort> childPort = SocketPort::Create(factory, echo);
+        SocketPort* childPortPtr = childPort.get();
+        echo->Subscribe<TestProtocol::TestMsg2>([childPortPtr](const Ptr<TestProtocol::TestMsg2>& msg) {
+            childPortPtr->Put(msg);
+        });
+        if (!childPort->Connect(socketPath)) {
+            _exit(1);
+        }
+        while (childPort->IsConnected()) {
+            childPort->DoWork();
+            usleep(100);
+        }
+        _exit(0);
+    }
+    CHECK(pid > 0);
+    const int32 numMsgs = 1000;
+    for (int32 i = 0; i < numMsgs; i++) {
+        Ptr<TestProtocol::TestMsg2> msg = TestProtocol::TestMsg2::Create();
+        msg->SetStringVal("Echo");
+        port->Put(msg);
+    }
+    time_point<system_clock> start = system_clock::now();
+    while ((numEchoed < numMsgs) && ((system_clock::now() - start) < seconds(10))) {
+        port->DoWork();
+        usleep(100);
+    }
+    CHECK(numEchoed == numMsgs);
+    
+    // closing the connection ends the child process
+    port->Close();
+    int status = 0;
+    CHECK(pid == waitpid(pid, &status, 0));
+    CHECK(WIFEXITED(status) && (0 == WEXITSTATUS(status)));
+}
+#endif
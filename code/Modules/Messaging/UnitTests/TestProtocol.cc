@@ -1,5 +1,5 @@
 //-----------------------------------------------------------------------------
-// #version:2# machine generated, do not edit!
+// #version:7# machine generated, do not edit!
 //-----------------------------------------------------------------------------
 #include "Pre.h"
 #include "TestProtocol.h"
@@ -7,12 +7,14 @@
 namespace Oryol {
 namespace Messaging {
 OryolClassPoolAllocImpl(TestProtocol::TestMsg1);
-OryolClassPoolAllocImpl(TestProtocol::TestMsg2);
-OryolClassPoolAllocImpl(TestProtocol::TestArrayMsg);
+OryolClassRecycleImpl(TestProtocol::TestMsg2);
+OryolClassRecycleImpl(TestProtocol::TestArrayMsg);
+OryolClassPoolAllocImpl(TestProtocol::TestLocalMsg);
 TestProtocol::CreateCallback TestProtocol::jumpTable[TestProtocol::MessageId::NumMessageIds] = { 
     &TestProtocol::TestMsg1::FactoryCreate,
     &TestProtocol::TestMsg2::FactoryCreate,
     &TestProtocol::TestArrayMsg::FactoryCreate,
+    &TestProtocol::TestLocalMsg::FactoryCreate,
 };
 Core::Ptr<Messaging::Message>
 TestProtocol::Factory::Create(Messaging::MessageIdType id) {
@@ -1,6 +1,6 @@
 #pragma once
 //-----------------------------------------------------------------------------
-/* #version:2#
+/* #version:7#
     machine generated, do not edit!
 */
 #include <cstring>
@@ -17,12 +17,19 @@ public:
     static Messaging::ProtocolIdType GetProtocolId() {
         return 'TSTP';
     };
+    static Messaging::ProtocolIdType GetBaseProtocolId() {
+        return 'TSTP';
+    };
+    static uint64 GetMessageIdBits() {
+        return (uint64(1) << MessageId::TestMsg1Id) | (uint64(1) << MessageId::TestMsg2Id) | (uint64(1) << MessageId::TestArrayMsgId) | (uint64(1) << MessageId::TestLocalMsgId);
+    };
     class MessageId {
     public:
         enum {
             TestMsg1Id = Messaging::Protocol::MessageId::NumMessageIds, 
             TestMsg2Id,
             TestArrayMsgId,
+            TestLocalMsgId,
             NumMessageIds
         };
         static const char* ToString(Messaging::MessageIdType c) {
@@ -30,6 +37,7 @@ public:
                 case TestMsg1Id: return "TestMsg1Id";
                 case TestMsg2Id: return "TestMsg2Id";
                 case TestArrayMsgId: return "TestArrayMsgId";
+                case TestLocalMsgId: return "TestLocalMsgId";
                 default: return "InvalidMessageId";
             }
         };
@@ -37,9 +45,11 @@ public:
             if (std::strcmp("TestMsg1Id", str) == 0) return TestMsg1Id;
             if (std::strcmp("TestMsg2Id", str) == 0) return TestMsg2Id;
             if (std::strcmp("TestArrayMsgId", str) == 0) return TestArrayMsgId;
+            if (std::strcmp("TestLocalMsgId", str) == 0) return TestLocalMsgId;
             return Messaging::InvalidMessageId;
         };
     };
+    static_assert(MessageId::NumMessageIds <= Messaging::MaxNumMessageIds, "too many message ids in protocol hierarchy");
     typedef Core::Ptr<Messaging::Message> (*CreateCallback)();
     static CreateCallback jumpTable[TestProtocol::MessageId::NumMessageIds];
     class Factory {
@@ -51,6 +61,21 @@ public:
     public:
         TestMsg1() {
             this->msgId = MessageId::TestMsg1Id;
+            this->baseProtId = TestProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+            this->int8val = 0;
+            this->int16val = -1;
+            this->int32val = 0;
+            this->int64val = 0;
+            this->uint8val = 0;
+            this->uint16val = 0;
+            this->uint32val = 0;
+            this->uint64val = 0;
+            this->float32val = 123.0f;
+            this->float64val = 12.0;
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
             this->int8val = 0;
             this->int16val = -1;
             this->int32val = 0;
@@ -68,9 +93,14 @@ public:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::TestMsg1Id;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'TSTP') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return TestProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::TestMsg1Id) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'TSTP';
         };
         virtual int32 EncodedSize() const override;
         virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const override;
@@ -148,11 +178,18 @@ private:
         float64 float64val;
     };
     class TestMsg2 : public TestMsg1 {
-        OryolClassPoolAllocDecl(TestMsg2);
+        OryolClassRecycleDecl(TestMsg2);
     public:
         TestMsg2() {
             this->msgId = MessageId::TestMsg2Id;
+            this->baseProtId = TestProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+            this->stringval = "Test";
+        };
+        virtual void Reset() override {
+            TestMsg1::Reset();
             this->stringval = "Test";
+            this->stringatomval = Core::StringAtom();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -160,9 +197,14 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::TestMsg2Id;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'TSTP') return true;
-            else return TestMsg1::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return TestProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::TestMsg2Id) | TestMsg1::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'TSTP';
         };
         virtual int32 EncodedSize() const override;
         virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const override;
@@ -184,10 +226,17 @@ private:
         Core::StringAtom stringatomval;
     };
     class TestArrayMsg : public Messaging::Message {
-        OryolClassPoolAllocDecl(TestArrayMsg);
+        OryolClassRecycleDecl(TestArrayMsg);
     public:
         TestArrayMsg() {
             this->msgId = MessageId::TestArrayMsgId;
+            this->baseProtId = TestProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
+            this->int32arrayval.Clear();
+            this->stringarrayval.Clear();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -195,9 +244,14 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::TestArrayMsgId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'TSTP') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return TestProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::TestArrayMsgId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'TSTP';
         };
         virtual int32 EncodedSize() const override;
         virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const override;
@@ -218,6 +272,46 @@ private:
         Core::Array<int32> int32arrayval;
         Core::Array<Core::String> stringarrayval;
     };
+    class TestLocalMsg : public Messaging::Message {
+        OryolClassPoolAllocDecl(TestLocalMsg);
+    public:
+        TestLocalMsg() {
+            this->msgId = MessageId::TestLocalMsgId;
+            this->baseProtId = TestProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+            this->int32val = 0;
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
+            this->int32val = 0;
+        };
+        static Core::Ptr<Messaging::Message> FactoryCreate() {
+            return Create();
+        };
+        static Messaging::MessageIdType ClassMessageId() {
+            return MessageId::TestLocalMsgId;
+        };
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return TestProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::TestLocalMsgId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'TSTP';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
+        };
+        void SetInt32Val(int32 val) {
+            this->int32val = val;
+        };
+        int32 GetInt32Val() const {
+            return this->int32val;
+        };
+private:
+        int32 int32val;
+    };
 };
 }
 }
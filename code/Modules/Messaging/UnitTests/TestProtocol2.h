@@ -1,6 +1,6 @@
 #pragma once
 //-----------------------------------------------------------------------------
-/* #version:2#
+/* #version:7#
     machine generated, do not edit!
 */
 #include <cstring>
@@ -15,6 +15,12 @@ public:
     static Messaging::ProtocolIdType GetProtocolId() {
         return 'TSP2';
     };
+    static Messaging::ProtocolIdType GetBaseProtocolId() {
+        return Messaging::TestProtocol::GetBaseProtocolId();
+    };
+    static uint64 GetMessageIdBits() {
+        return (uint64(1) << MessageId::TestMsgExId);
+    };
     class MessageId {
     public:
         enum {
@@ -32,6 +38,7 @@ public:
             return Messaging::InvalidMessageId;
         };
     };
+    static_assert(MessageId::NumMessageIds <= Messaging::MaxNumMessageIds, "too many message ids in protocol hierarchy");
     typedef Core::Ptr<Messaging::Message> (*CreateCallback)();
     static CreateCallback jumpTable[TestProtocol2::MessageId::NumMessageIds];
     class Factory {
@@ -43,6 +50,12 @@ public:
     public:
         TestMsgEx() {
             this->msgId = MessageId::TestMsgExId;
+            this->baseProtId = TestProtocol2::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+            this->exval2 = 0;
+        };
+        virtual void Reset() override {
+            Messaging::TestProtocol::TestMsg1::Reset();
             this->exval2 = 0;
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
@@ -51,9 +64,14 @@ public:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::TestMsgExId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'TSP2') return true;
-            else return Messaging::TestProtocol::TestMsg1::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return TestProtocol2::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::TestMsgExId) | Messaging::TestProtocol::TestMsg1::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'TSP2';
         };
         virtual int32 EncodedSize() const override;
         virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const override;
@@ -0,0 +1,114 @@
+//------------------------------------------------------------------------------
+//  ThreadedQueueBenchmarkTest.cc
+//  Measure ThreadedQueue throughput (messages/sec) with the locked
+//  transfer queue, and the lock-free ring buffer (single and multiple
+//  producers).
+//------------------------------------------------------------------------------
+#include "Pre.h"
+#include "UnitTest++/src/UnitTest++.h"
+#include "Messaging/ThreadedQueue.h"
+#include "Messaging/Dispatcher.h"
+#include "Messaging/UnitTests/TestProtocol.h"
+#include "Core/CoreFacade.h"
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace Oryol;
+using namespace Oryol::Core;
+using namespace Oryol::Messaging;
+using namespace std::chrono;
+
+static const int NumMessages = 1000000;
+static std::atomic<int> numHandled(0);
+static void HandleBenchmarkMsg(const Ptr<TestProtocol::TestMsg1>& msg) {
+    numHandled++;
+}
+
+//------------------------------------------------------------------------------
+static Ptr<Dispatcher<TestProtocol>>
+createDispatcher() {
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe<TestProtocol::TestMsg1>(&HandleBenchmarkMsg);
+    return disp;
+}
+
+//------------------------------------------------------------------------------
+static void
+logResult(const char* name, const Ptr<ThreadedQueue>& queue, const time_point<system_clock>& start) {
+    duration<double> dur = system_clock::now() - start;
+    Log::Info("ThreadedQueue (%s): %d msgs in %f sec, %.0f msgs/sec, high-water mark: %d\n",
+        name, NumMessages, dur.count(), NumMessages / dur.count(), queue->GetHighWaterMark());
+}
+
+//------------------------------------------------------------------------------
+TEST(ThreadedQueueBenchmark) {
+
+    // locked transfer queue, messages move to the thread in DoWork()
+    {
+        Ptr<ThreadedQueue> queue = ThreadedQueue::Create(createDispatcher());
+        queue->StartThread();
+        numHandled = 0;
+        time_point<system_clock> start = system_clock::now();
+        for (int i = 0; i < NumMessages; i++) {
+            queue->Put(TestProtocol::TestMsg1::Create());
+            if ((i & 1023) == 1023) {
+                queue->DoWork();
+            }
+        }
+        while (numHandled < NumMessages) {
+            queue->DoWork();
+            std::this_thread::yield();
+        }
+        logResult("locked", queue, start);
+        CHECK(numHandled == NumMessages);
+        queue->StopThread();
+    }
+
+    // lock-free ring buffer, single producer
+    {
+        Ptr<ThreadedQueue> queue = ThreadedQueue::Create(createDispatcher());
+        queue->SetRingBuffer(1024);
+        queue->StartThread();
+        numHandled = 0;
+        time_point<system_clock> start = system_clock::now();
+        for (int i = 0; i < NumMessages; i++) {
+            queue->Put(TestProtocol::TestMsg1::Create());
+        }
+        while (numHandled < NumMessages) {
+            std::this_thread::yield();
+        }
+        logResult("ring, 1 producer", queue, start);
+        CHECK(numHandled == NumMessages);
+        queue->StopThread();
+    }
+
+    // lock-free ring buffer, multiple producers
+    {
+        const int numThreads = 4;
+        Ptr<ThreadedQueue> queue = ThreadedQueue::Create(createDispatcher());
+        queue->SetRingBuffer(1024, true);
+        queue->StartThread();
+        numHandled = 0;
+        time_point<system_clock> start = system_clock::now();
+        std::thread threads[numThreads];
+        for (int i = 0; i < numThreads; i++) {
+            threads[i] = std::thread([&queue, numThreads]() {
+                CoreFacade::EnterThread();
+                for (int j = 0; j < NumMessages / numThreads; j++) {
+                    queue->Put(TestProtocol::TestMsg1::Create());
+                }
+                CoreFacade::LeaveThread();
+            });
+        }
+        for (int i = 0; i < numThreads; i++) {
+            threads[i].join();
+        }
+        while (numHandled < NumMessages) {
+            std::this_thread::yield();
+        }
+        logResult("ring, 4 producers", queue, start);
+        CHECK(numHandled == NumMessages);
+        queue->StopThread();
+    }
+}
@@ -6,6 +6,8 @@
 #include "Messaging/ThreadedQueue.h"
 #include "Messaging/Dispatcher.h"
 #include "Messaging/UnitTests/TestProtocol.h"
+#include "Core/CoreFacade.h"
+#include <atomic>
 #include <chrono>
 #include <thread>
 
@@ -28,6 +30,12 @@ static void HandleTestMsg2(const Ptr<TestProtocol::TestMsg2>& msg) {
     msg->SetHandled();
 }
 
+static std::atomic<int> value2(0);
+static void HandleTestMsg1Atomic(const Ptr<TestProtocol::TestMsg1>& msg) {
+    value2++;
+    msg->SetHandled();
+}
+
 TEST(ThreadedQueueTest) {
 
     // create a Dispatcher port, this will run in the worker thread!
@@ -45,6 +53,10 @@ TEST(ThreadedQueueTest) {
     Ptr<TestProtocol::TestMsg2> msg2 = TestProtocol::TestMsg2::Create();
     threadedQueue->Put(msg2);
     
+    // messages wait in the write queue until DoWork()
+    CHECK(threadedQueue->GetQueueDepth() == 2);
+    CHECK(threadedQueue->GetHighWaterMark() == 2);
+    
     // do a busy loop...
     while (!(msg1->Handled() && msg2->Handled())) {
         threadedQueue->DoWork();
@@ -52,6 +64,9 @@ TEST(ThreadedQueueTest) {
     }
     CHECK(value0 == 1);
     CHECK(value1 == 1);
+    CHECK(threadedQueue->GetQueueDepth() == 0);
+    threadedQueue->ResetHighWaterMark();
+    CHECK(threadedQueue->GetHighWaterMark() == 0);
     
     // now let's create some pressure on the thread...
     time_point<system_clock> start, end;
@@ -79,3 +94,58 @@ TEST(ThreadedQueueTest) {
     threadedQueue = 0;
 }
 
+
+TEST(ThreadedQueueRingBufferTest) {
+
+    Ptr<Dispatcher<TestProtocol>> disp = Dispatcher<TestProtocol>::Create();
+    disp->Subscribe<TestProtocol::TestMsg1>(&HandleTestMsg1Atomic);
+    
+    // single producer: no DoWork() necessary, and a full ring buffer blocks the producer
+    Ptr<ThreadedQueue> spscQueue = ThreadedQueue::Create(disp);
+    spscQueue->SetRingBuffer(64);
+    CHECK(spscQueue->IsRingBuffer());
+    spscQueue->StartThread();
+    value2 = 0;
+    Ptr<TestProtocol::TestMsg1> msg;
+    for (int i = 0; i < 10000; i++) {
+        msg = TestProtocol::TestMsg1::Create();
+        spscQueue->Put(msg);
+    }
+    while (!msg->Handled()) {
+        std::this_thread::yield();
+    }
+    CHECK(value2 == 10000);
+    CHECK(spscQueue->GetQueueDepth() == 0);
+    CHECK(spscQueue->GetHighWaterMark() >= 1);
+    CHECK(spscQueue->GetHighWaterMark() <= 10000);
+    spscQueue->StopThread();
+    spscQueue = 0;
+    
+    // multiple producers: Put() from several threads
+    Ptr<ThreadedQueue> mpscQueue = ThreadedQueue::Create(disp);
+    mpscQueue->SetRingBuffer(256, true);
+    mpscQueue->StartThread();
+    value2 = 0;
+    const int numThreads = 4;
+    const int numMsgsPerThread = 10000;
+    std::thread threads[numThreads];
+    for (int i = 0; i < numThreads; i++) {
+        threads[i] = std::thread([&mpscQueue, numMsgsPerThread]() {
+            CoreFacade::EnterThread();
+            for (int j = 0; j < numMsgsPerThread; j++) {
+                mpscQueue->Put(TestProtocol::TestMsg1::Create());
+            }
+            CoreFacade::LeaveThread();
+        });
+    }
+    for (int i = 0; i < numThreads; i++) {
+        threads[i].join();
+    }
+    while (value2 < numThreads * numMsgsPerThread) {
+        std::this_thread::yield();
+    }
+    CHECK(value2 == numThreads * numMsgsPerThread);
+    mpscQueue->StopThread();
+    CHECK(mpscQueue->GetQueueDepth() == 0);
+    mpscQueue = 0;
+}
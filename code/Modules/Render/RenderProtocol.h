@@ -1,6 +1,6 @@
 #pragma once
 //-----------------------------------------------------------------------------
-/* #version:2#
+/* #version:7#
     machine generated, do not edit!
 */
 #include <cstring>
@@ -15,6 +15,12 @@ public:
     static Messaging::ProtocolIdType GetProtocolId() {
         return 'RRPT';
     };
+    static Messaging::ProtocolIdType GetBaseProtocolId() {
+        return 'RRPT';
+    };
+    static uint64 GetMessageIdBits() {
+        return (uint64(1) << MessageId::DisplaySetupId) | (uint64(1) << MessageId::DisplayDiscardedId) | (uint64(1) << MessageId::DisplayModifiedId);
+    };
     class MessageId {
     public:
         enum {
@@ -38,6 +44,7 @@ public:
             return Messaging::InvalidMessageId;
         };
     };
+    static_assert(MessageId::NumMessageIds <= Messaging::MaxNumMessageIds, "too many message ids in protocol hierarchy");
     typedef Core::Ptr<Messaging::Message> (*CreateCallback)();
     static CreateCallback jumpTable[RenderProtocol::MessageId::NumMessageIds];
     class Factory {
@@ -49,6 +56,11 @@ public:
     public:
         DisplaySetup() {
             this->msgId = MessageId::DisplaySetupId;
+            this->baseProtId = RenderProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -56,9 +68,17 @@ public:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::DisplaySetupId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'RRPT') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return RenderProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::DisplaySetupId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'RRPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
 private:
     };
@@ -67,6 +87,11 @@ private:
     public:
         DisplayDiscarded() {
             this->msgId = MessageId::DisplayDiscardedId;
+            this->baseProtId = RenderProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -74,9 +99,17 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::DisplayDiscardedId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'RRPT') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return RenderProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::DisplayDiscardedId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'RRPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
 private:
     };
@@ -85,6 +118,11 @@ private:
     public:
         DisplayModified() {
             this->msgId = MessageId::DisplayModifiedId;
+            this->baseProtId = RenderProtocol::GetBaseProtocolId();
+            this->typeBits = ClassTypeBits();
+        };
+        virtual void Reset() override {
+            Messaging::Message::Reset();
         };
         static Core::Ptr<Messaging::Message> FactoryCreate() {
             return Create();
@@ -92,9 +130,17 @@ private:
         static Messaging::MessageIdType ClassMessageId() {
             return MessageId::DisplayModifiedId;
         };
-        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {
-            if (protId == 'RRPT') return true;
-            else return Messaging::Message::IsMemberOf(protId);
+        static Messaging::ProtocolIdType ClassBaseProtocolId() {
+            return RenderProtocol::GetBaseProtocolId();
+        };
+        static uint64 ClassTypeBits() {
+            return (uint64(1) << MessageId::DisplayModifiedId) | Messaging::Message::ClassTypeBits();
+        };
+        virtual Messaging::ProtocolIdType ProtocolId() const {
+            return 'RRPT';
+        };
+        virtual bool IsSerializable() const override {
+            return false;
         };
 private:
     };
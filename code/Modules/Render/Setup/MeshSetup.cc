@@ -13,7 +13,8 @@ using namespace Resource;
 MeshSetup::MeshSetup() :
 vertexUsage(Usage::InvalidUsage),
 indexUsage(Usage::InvalidUsage),
-ioLane(0),
+ioLane(IO::AnyLane),
+ioPriority(IO::IOPriority::Normal),
 setupFromFile(false),
 setupFromData(false) {
     // empty
@@ -114,5 +115,17 @@ MeshSetup::GetIOLane() const {
     return this->ioLane;
 }
 
+//------------------------------------------------------------------------------
+void
+MeshSetup::SetIOPriority(IO::IOPriority::Code pri) {
+    this->ioPriority = pri;
+}
+
+//------------------------------------------------------------------------------
+IO::IOPriority::Code
+MeshSetup::GetIOPriority() const {
+    return this->ioPriority;
+}
+
 } // namespace Render
 } // namespace Oryol
\ No newline at end of file
@@ -6,6 +6,7 @@
 */
 #include "Resource/Locator.h"
 #include "Render/Core/Enums.h"
+#include "IO/IOPriority.h"
 
 namespace Oryol {
 namespace Render {
@@ -13,7 +14,7 @@ namespace Render {
 class MeshSetup {
 public:
     /// setup from file with creation parameters
-    static MeshSetup FromFile(const Resource::Locator& loc, int32 ioLane=0, Usage::Code vertexUsage=Usage::Immutable, Usage::Code indexUsage=Usage::Immutable);
+    static MeshSetup FromFile(const Resource::Locator& loc, int32 ioLane=IO::AnyLane, Usage::Code vertexUsage=Usage::Immutable, Usage::Code indexUsage=Usage::Immutable);
     /// setup from file with blueprint
     static MeshSetup FromFile(const Resource::Locator& loc, const MeshSetup& blueprint);
     /// setup from from data provided in separate stream object
@@ -38,16 +39,21 @@ public:
     void SetIndexUsage(Usage::Code usg);
     /// get index-data usage
     Usage::Code GetIndexUsage() const;
-    /// set ioLane index
+    /// set ioLane index (default is IO::AnyLane)
     void SetIOLane(int32 lane);
     /// get ioLane index
     int32 GetIOLane() const;
+    /// set IO request priority (default is IO::IOPriority::Normal)
+    void SetIOPriority(IO::IOPriority::Code pri);
+    /// get IO request priority
+    IO::IOPriority::Code GetIOPriority() const;
     
 private:
     Resource::Locator locator;
     Usage::Code vertexUsage;
     Usage::Code indexUsage;
     int32 ioLane;
+    IO::IOPriority::Code ioPriority;
     bool setupFromFile : 1;
     bool setupFromData : 1;
 };
@@ -16,7 +16,8 @@ shouldSetupFromData(false),
 shouldSetupAsRenderTarget(false),
 isRelSizeRenderTarget(false),
 hasSharedDepth(false),
-ioLane(0),
+ioLane(IO::AnyLane),
+ioPriority(IO::IOPriority::Normal),
 width(0),
 height(0),
 relWidth(0.0f),
@@ -98,12 +99,30 @@ TextureSetup::AsSharedDepthRenderTarget(const Locator& loc, PixelFormat::Code co
     return setup;
 }
 
+//------------------------------------------------------------------------------
+void
+TextureSetup::SetIOLane(int32 lane) {
+    this->ioLane = lane;
+}
+
 //------------------------------------------------------------------------------
 int32
 TextureSetup::GetIOLane() const {
     return this->ioLane;
 }
 
+//------------------------------------------------------------------------------
+void
+TextureSetup::SetIOPriority(IO::IOPriority::Code pri) {
+    this->ioPriority = pri;
+}
+
+//------------------------------------------------------------------------------
+IO::IOPriority::Code
+TextureSetup::GetIOPriority() const {
+    return this->ioPriority;
+}
+
 //------------------------------------------------------------------------------
 bool
 TextureSetup::ShouldSetupFromFile() const {
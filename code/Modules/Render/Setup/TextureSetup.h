@@ -8,6 +8,7 @@
 #include "Resource/Locator.h"
 #include "Resource/Id.h"
 #include "Render/Core/Enums.h"
+#include "IO/IOPriority.h"
 
 namespace Oryol {
 namespace Render {
@@ -37,8 +38,14 @@ public:
     bool HasDepth() const;
     /// return true if render target with shared depth buffer
     bool HasSharedDepth() const;
+    /// set ioLane index (default is IO::AnyLane)
+    void SetIOLane(int32 lane);
     /// get ioLane index
     int32 GetIOLane() const;
+    /// set IO request priority (default is IO::IOPriority::Normal)
+    void SetIOPriority(IO::IOPriority::Code pri);
+    /// get IO request priority
+    IO::IOPriority::Code GetIOPriority() const;
     
     /// get the resource locator
     const Resource::Locator& GetLocator() const;
@@ -88,6 +95,7 @@ private:
     
     Resource::Locator locator;
     int32 ioLane;
+    IO::IOPriority::Code ioPriority;
     int32 width;
     int32 height;
     float32 relWidth;
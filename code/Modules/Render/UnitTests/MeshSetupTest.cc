@@ -16,7 +16,7 @@ TEST(MeshSetupTest) {
     CHECK(s0.GetLocator() == "s0");
     CHECK(s0.GetVertexUsage() == Usage::Immutable);
     CHECK(s0.GetIndexUsage() == Usage::Immutable);
-    CHECK(s0.GetIOLane() == 0);
+    CHECK(s0.GetIOLane() == IO::AnyLane);
     
     MeshSetup s1 = MeshSetup::FromFile("s1", 1, Usage::DynamicStream, Usage::DynamicWrite);
     CHECK(s1.ShouldSetupFromFile());
@@ -40,7 +40,7 @@ TEST(MeshSetupTest) {
     CHECK(s3.GetLocator() == "s3");
     CHECK(s3.GetVertexUsage() == Usage::Immutable);
     CHECK(s3.GetIndexUsage() == Usage::Immutable);
-    CHECK(s0.GetIOLane() == 0);
+    CHECK(s0.GetIOLane() == IO::AnyLane);
     
     MeshSetup s4 = MeshSetup::FromData("s4", Usage::DynamicStream, Usage::DynamicWrite);
     CHECK(!s4.ShouldSetupFromFile());
@@ -48,7 +48,7 @@ TEST(MeshSetupTest) {
     CHECK(s4.GetLocator() == "s4");
     CHECK(s4.GetVertexUsage() == Usage::DynamicStream);
     CHECK(s4.GetIndexUsage() == Usage::DynamicWrite);
-    CHECK(s4.GetIOLane() == 0);
+    CHECK(s4.GetIOLane() == IO::AnyLane);
     
     MeshSetup s5 = MeshSetup::FromData("s5", s4);
     CHECK(!s5.ShouldSetupFromFile());
@@ -56,7 +56,7 @@ TEST(MeshSetupTest) {
     CHECK(s5.GetLocator() == "s5");
     CHECK(s5.GetVertexUsage() == Usage::DynamicStream);
     CHECK(s5.GetIndexUsage() == Usage::DynamicWrite);
-    CHECK(s5.GetIOLane() == 0);
+    CHECK(s5.GetIOLane() == IO::AnyLane);
     
     MeshSetup s6(s0);
     s6.SetVertexUsage(Usage::DynamicStream);
@@ -65,4 +65,7 @@ TEST(MeshSetupTest) {
     CHECK(s6.GetVertexUsage() == Usage::DynamicWrite);
     s6.SetIOLane(2);
     CHECK(s6.GetIOLane() == 2);
+    CHECK(s6.GetIOPriority() == IO::IOPriority::Normal);
+    s6.SetIOPriority(IO::IOPriority::High);
+    CHECK(s6.GetIOPriority() == IO::IOPriority::High);
 }
@@ -63,7 +63,7 @@ glTextureLoader::Load(texture& tex) const {
     
     if (state == Resource::State::Setup) {
         // start loading the resource
-        tex.setIORequest(IOFacade::Instance()->LoadFile(setup.GetLocator().Location(), setup.GetIOLane()));
+        tex.setIORequest(IOFacade::Instance()->LoadFile(setup.GetLocator().Location(), setup.GetIOLane(), setup.GetIOPriority()));
         tex.setState(Resource::State::Pending);
         return;
     }
@@ -93,10 +93,9 @@ Registry::AddResource(const Locator& loc, const Id& id, const Array<Id>& deps) {
 const Registry::Entry*
 Registry::findEntryByLocator(const Locator& loc) const {
     if (loc.IsShared()) {
-        const int32 mapIndex = this->locatorIndexMap.FindIndex(loc);
-        if (InvalidIndex != mapIndex) {
-            const int32 entryIndex = this->locatorIndexMap.ValueAtIndex(mapIndex);
-            return &(this->entries[entryIndex]);
+        const int32* entryIndex = this->locatorIndexMap.Find(loc);
+        if (nullptr != entryIndex) {
+            return &(this->entries[*entryIndex]);
         }
     }
     return nullptr;
@@ -105,10 +104,9 @@ Registry::findEntryByLocator(const Locator& loc) const {
 //------------------------------------------------------------------------------
 const Registry::Entry*
 Registry::findEntryById(const Id& id) const {
-    const int32 mapIndex = this->idIndexMap.FindIndex(id);
-    if (InvalidIndex != mapIndex) {
-        const int32 entryIndex = this->idIndexMap.ValueAtIndex(mapIndex);
-        return &(this->entries[entryIndex]);
+    const int32* entryIndex = this->idIndexMap.Find(id);
+    if (nullptr != entryIndex) {
+        return &(this->entries[*entryIndex]);
     }
     return nullptr;
 }
@@ -145,9 +143,9 @@ Registry::ReleaseResource(const Id& id, Array<Id>& outRemoved) {
     outRemoved.Clear();
     this->decrUseCount(id, outRemoved);
     for (const Id& id : outRemoved) {
-        const int32 mapIndex = this->idIndexMap.FindIndex(id);
-        if (InvalidIndex != mapIndex) {
-            const int32 entryIndex = this->idIndexMap.ValueAtIndex(mapIndex);
+        const int32* mapValue = this->idIndexMap.Find(id);
+        if (nullptr != mapValue) {
+            const int32 entryIndex = *mapValue;
             o_assert(this->entries[entryIndex].useCount == 0);
             o_assert(this->entries[entryIndex].id == id);
             Locator loc = this->entries[entryIndex].locator;
@@ -159,20 +157,13 @@ Registry::ReleaseResource(const Id& id, Array<Id>& outRemoved) {
                 this->locatorIndexMap.Erase(loc);
             }
             
-            // fixup the index maps (see elementBuffer)
+            // fixup the index maps for the entry which was swapped into the gap
             const int32 swappedIndex = this->entries.Size();
             if (entryIndex != swappedIndex) {
-                for (auto& elm : this->idIndexMap) {
-                    if (swappedIndex == elm.value) {
-                        elm.value = entryIndex;
-                        break;
-                    }
-                }
-                for (auto& elm : this->locatorIndexMap) {
-                    if (swappedIndex == elm.value) {
-                        elm.value = entryIndex;
-                        break;
-                    }
+                const Entry& swappedEntry = this->entries[entryIndex];
+                this->idIndexMap[swappedEntry.id] = entryIndex;
+                if (swappedEntry.locator.IsShared()) {
+                    this->locatorIndexMap[swappedEntry.locator] = entryIndex;
                 }
             }
             
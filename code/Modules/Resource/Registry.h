@@ -7,7 +7,7 @@
 #include "Resource/Locator.h"
 #include "Resource/Id.h"
 #include "Core/Containers/Array.h"
-#include "Core/Containers/Map.h"
+#include "Core/Containers/HashMap.h"
 
 namespace Oryol {
 namespace Resource {
@@ -81,6 +81,19 @@ private:
         Id deps[MaxNumDependents];
     };
     
+    /// hash function for locators
+    struct locatorHasher {
+        uint32 operator()(const Locator& loc) const {
+            return uint32(loc.Location().Hash()) ^ loc.Signature();
+        };
+    };
+    /// hash function for resource ids
+    struct idHasher {
+        uint32 operator()(const Id& id) const {
+            return id.UniqueStamp() ^ ((uint32(id.Type()) << 16) | id.SlotIndex());
+        };
+    };
+    
     /// find an entry by locator
     const Entry* findEntryByLocator(const Locator& loc) const;
     /// find an entry by id
@@ -88,8 +101,8 @@ private:
     
     bool isValid;
     Core::Array<Entry> entries;
-    Core::Map<Locator, int32> locatorIndexMap;
-    Core::Map<Id, int32> idIndexMap;
+    Core::HashMap<Locator, int32, locatorHasher> locatorIndexMap;
+    Core::HashMap<Id, int32, idHasher> idIndexMap;
 };
     
 } // namespace Resource
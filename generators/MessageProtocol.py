@@ -6,7 +6,7 @@ import os
 import sys
 import util
 
-Version = 2
+Version = 7
 
 #-------------------------------------------------------------------------------
 def checkValidAttr(attr) :
@@ -49,6 +49,23 @@ def writeProtocolMethods(f, xmlRoot) :
     f.write("        return '{}';\n".format(xmlRoot.get('id')))
     f.write('    };\n')
 
+    # the base protocol id identifies the message id space of the protocol hierarchy
+    f.write('    static Messaging::ProtocolIdType GetBaseProtocolId() {\n')
+    if xmlRoot.get('parent') :
+        f.write('        return ' + xmlRoot.get('parent') + '::GetBaseProtocolId();\n')
+    else :
+        f.write("        return '{}';\n".format(xmlRoot.get('id')))
+    f.write('    };\n')
+
+    # type bits of the message ids defined in this protocol
+    msgBits = ['(uint64(1) << MessageId::' + msg.get('name') + 'Id)' for msg in xmlRoot.findall('Message')]
+    f.write('    static uint64 GetMessageIdBits() {\n')
+    if msgBits :
+        f.write('        return ' + ' | '.join(msgBits) + ';\n')
+    else :
+        f.write('        return 0;\n')
+    f.write('    };\n')
+
 #-------------------------------------------------------------------------------
 def writeMessageIdEnum(f, xmlRoot) :
     '''
@@ -84,6 +101,7 @@ def writeMessageIdEnum(f, xmlRoot) :
     f.write('            return Messaging::InvalidMessageId;\n')
     f.write('        };\n')
     f.write('    };\n')
+    f.write('    static_assert(MessageId::NumMessageIds <= Messaging::MaxNumMessageIds, "too many message ids in protocol hierarchy");\n')
     f.write('    typedef Core::Ptr<Messaging::Message> (*CreateCallback)();\n')
     f.write('    static CreateCallback jumpTable[' + protocol + '::MessageId::NumMessageIds];\n')
 
@@ -182,22 +200,47 @@ def getArrayType(attrType) :
     # strip the 'Core::Array<' at the left, and the '>' at the right
     return attrType[12:-1]
 
+#-------------------------------------------------------------------------------
+def isContainerType(attrType) :
+    '''
+    Test if the type string is a container type which can be cleared
+    without releasing its capacity.
+    '''
+    for prefix in ('Core::Array<', 'Core::Map<', 'Core::Set<', 'Core::HashMap<', 'Core::HashSet<', 'Core::Queue<') :
+        if attrType.startswith(prefix) :
+            return True
+    return False
+
+#-------------------------------------------------------------------------------
+def isRecycled(msg) :
+    '''
+    Test if the message class is recycled instead of destroyed (opt-in
+    through the recycle="true" message attribute).
+    '''
+    return msg.get('recycle', 'false') == 'true'
+
 #-------------------------------------------------------------------------------
 def writeMessageClasses(f, xmlRoot) :
     '''
     Write the message classes to the generated C++ header
     '''
     protocolId = xmlRoot.get('id')
+    protocol = xmlRoot.get('name')
     for msg in xmlRoot.findall('Message') :
         msgClassName = msg.get('name')
         msgParentClassName = msg.get('parent', 'Messaging::Message')
         f.write('    class ' + msgClassName + ' : public ' + msgParentClassName + ' {\n')
-        f.write('        OryolClassPoolAllocDecl(' + msgClassName + ');\n')
+        if isRecycled(msg) :
+            f.write('        OryolClassRecycleDecl(' + msgClassName + ');\n')
+        else :
+            f.write('        OryolClassPoolAllocDecl(' + msgClassName + ');\n')
         f.write('    public:\n')
 
         # write constructor
         f.write('        ' + msgClassName + '() {\n')
         f.write('            this->msgId = MessageId::' + msgClassName + 'Id;\n')
+        f.write('            this->baseProtId = ' + protocol + '::GetBaseProtocolId();\n')
+        f.write('            this->typeBits = ClassTypeBits();\n')
         for attr in msg.findall('Attr') :
             attrName = attr.get('name').lower()
             defValue = getAttrDefaultValue(attr)
@@ -205,6 +248,22 @@ def writeMessageClasses(f, xmlRoot) :
                 f.write('            this->' + attrName + ' = ' + defValue + ';\n')
         f.write('        };\n')
 
+        # reset to default state, containers keep their capacity (virtual,
+        # so that resetting through a parent class pointer resets all fields)
+        f.write('        virtual void Reset() override {\n')
+        f.write('            ' + msgParentClassName + '::Reset();\n')
+        for attr in msg.findall('Attr') :
+            attrName = attr.get('name').lower()
+            attrType = attr.get('type')
+            defValue = getAttrDefaultValue(attr)
+            if isContainerType(attrType) :
+                f.write('            this->' + attrName + '.Clear();\n')
+            elif defValue :
+                f.write('            this->' + attrName + ' = ' + defValue + ';\n')
+            else :
+                f.write('            this->' + attrName + ' = ' + attrType + '();\n')
+        f.write('        };\n')
+
         # special factory create method
         f.write('        static Core::Ptr<Messaging::Message> FactoryCreate() {\n')
         f.write('            return Create();\n')
@@ -215,17 +274,26 @@ def writeMessageClasses(f, xmlRoot) :
         f.write('            return MessageId::' + msgClassName + 'Id;\n')
         f.write('        };\n')
 
-        # virtual method which checks whether the method belongs to a protocol
-        f.write('        virtual bool IsMemberOf(Messaging::ProtocolIdType protId) const {\n')
-        f.write("            if (protId == '" + protocolId + "') return true;\n")
-        f.write('            else return ' + msgParentClassName + '::IsMemberOf(protId);\n')
-        f.write('        };\n') 
+        # type tag of the class: base protocol id, and the message ids of the class and its parents
+        f.write('        static Messaging::ProtocolIdType ClassBaseProtocolId() {\n')
+        f.write('            return ' + protocol + '::GetBaseProtocolId();\n')
+        f.write('        };\n')
+        f.write('        static uint64 ClassTypeBits() {\n')
+        f.write('            return (uint64(1) << MessageId::' + msgClassName + 'Id) | ' + msgParentClassName + '::ClassTypeBits();\n')
+        f.write('        };\n')
+        f.write('        virtual Messaging::ProtocolIdType ProtocolId() const {\n')
+        f.write("            return '" + protocolId + "';\n")
+        f.write('        };\n')
 
         # write serializer methods
         if msg.get('serialize', 'true') == 'true' :
             f.write('        virtual int32 EncodedSize() const override;\n')
             f.write('        virtual uint8* Encode(uint8* dstPtr, const uint8* maxValidPtr) const override;\n')
             f.write('        virtual const uint8* Decode(const uint8* srcPtr, const uint8* maxValidPtr) override;\n')
+        else :
+            f.write('        virtual bool IsSerializable() const override {\n')
+            f.write('            return false;\n')
+            f.write('        };\n')
 
         # write setters/getters
         for attr in msg.findall('Attr') :
@@ -358,7 +426,10 @@ def generateSource(xmlTree, absSourcePath) :
     f.write('namespace ' + nameSpace + ' {\n')
     for msg in xmlRoot.findall('Message') :
         msgClassName = msg.get('name')
-        f.write('OryolClassPoolAllocImpl(' + protocol + '::' + msgClassName + ');\n')
+        if isRecycled(msg) :
+            f.write('OryolClassRecycleImpl(' + protocol + '::' + msgClassName + ');\n')
+        else :
+            f.write('OryolClassPoolAllocImpl(' + protocol + '::' + msgClassName + ');\n')
         
     writeFactoryClassImpl(f, xmlRoot)
     writeSerializeMethods(f, xmlRoot)